@@ -1211,6 +1211,9 @@ public:
 	TArray<FAnimNotifyEvent> ActiveAnimNotifyState;
 
 private:
+	/** Built by TriggerAnimNotifies then swapped with ActiveAnimNotifyState, so neither is reallocated every tick. Empty outside of it */
+	TArray<FAnimNotifyEvent> PendingAnimNotifyState;
+
 	/** Reset Animation Curves */
 	void ResetAnimationCurves();
 
@@ -58,9 +58,11 @@ private:
 	FQuat RotationOffsetQuat;
 
 protected:
-	// Spawns the ParticleSystemComponent. Called from Notify.
+	// Spawns the ParticleSystemComponent. Called from Notify, or from UAnimNotifyBatchSubsystem when spawns are batched.
 	virtual UParticleSystemComponent* SpawnParticleSystem(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation);
 
+	friend class UAnimNotifyBatchSubsystem;
+
 public:
 
 	// Should attach to the bone/socket
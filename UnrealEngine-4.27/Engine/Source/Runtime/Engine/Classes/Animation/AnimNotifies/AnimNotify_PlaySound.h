@@ -29,6 +29,9 @@ public:
 #endif
 	// End UAnimNotify interface
 
+	// Plays Sound. Called from Notify, or from UAnimNotifyBatchSubsystem when spawns are batched.
+	void SpawnSound(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation);
+
 	// Sound to Play
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="AnimNotify", meta=(ExposeOnSpawn = true))
 	USoundBase* Sound;
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "AnimNotifyBatchSubsystem.generated.h"
+
+class UAnimNotify;
+class UAnimNotify_PlayParticleEffect;
+class UAnimNotify_PlaySound;
+class UAnimSequenceBase;
+class USkeletalMeshComponent;
+
+/** A sound or particle system notify waiting for UAnimNotifyBatchSubsystem to spawn it */
+USTRUCT()
+struct FAnimNotifySpawnRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UAnimNotify* Notify = nullptr;
+
+	UPROPERTY()
+	USkeletalMeshComponent* MeshComp = nullptr;
+
+	UPROPERTY()
+	UAnimSequenceBase* Animation = nullptr;
+
+	/** Sound or particle system the notify spawns, requests are grouped by it */
+	UPROPERTY()
+	UObject* Asset = nullptr;
+};
+
+/**
+ * Collects the sounds and particle systems that play sound and play particle effect notifies spawn while a world's actors tick when
+ * a.Notify.BatchSpawns is on, and spawns them all at once after the actors have ticked. Requests are spawned grouped by asset, and at
+ * most a.Notify.MaxSpawnsPerAsset of each asset are spawned in a frame, so a crowd hitting the same footstep on the same frame only
+ * spawns a handful. The request arrays are kept from frame to frame.
+ *
+ * Notifies fired outside of the actor tick, while the world is paused or from a component ticking on its own for instance, spawn
+ * straight away, as nothing would flush them.
+ */
+UCLASS()
+class ENGINE_API UAnimNotifyBatchSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Queues Notify's sound if batching is on and actors are ticking in MeshComp's world, returns false if the caller should spawn it itself */
+	static bool QueueSound(UAnimNotify_PlaySound* Notify, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation);
+
+	/** Queues Notify's particle system if batching is on and actors are ticking in MeshComp's world, returns false if the caller should spawn it itself */
+	static bool QueueParticleSystem(UAnimNotify_PlayParticleEffect* Notify, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation);
+
+	/** Adds a request to the sounds spawned by the next flush */
+	void AddSoundRequest(const FAnimNotifySpawnRequest& Request) { SoundRequests.Add(Request); }
+
+	/** Adds a request to the particle systems spawned by the next flush */
+	void AddParticleSystemRequest(const FAnimNotifySpawnRequest& Request) { ParticleSystemRequests.Add(Request); }
+
+	/** Spawns everything queued so far */
+	void Flush();
+
+	/** Number of requests waiting for the next flush */
+	int32 GetNumQueued() const { return SoundRequests.Num() + ParticleSystemRequests.Num(); }
+
+	/** Whether the world's actors are ticking, the only time requests are queued */
+	bool IsInActorTick() const { return bInActorTick; }
+
+	//~USubsystem interface
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+	//~End of USubsystem interface
+
+protected:
+
+	//~UWorldSubsystem interface
+	bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+	/** Plays the sound of a sound request, called by Flush */
+	virtual void SpawnSound(const FAnimNotifySpawnRequest& Request);
+
+	/** Spawns the particle system of a particle system request, called by Flush */
+	virtual void SpawnParticleSystem(const FAnimNotifySpawnRequest& Request);
+
+private:
+
+	/** Finds the subsystem of MeshComp's world when batching is on and its actors are ticking */
+	static UAnimNotifyBatchSubsystem* GetForComponent(const USkeletalMeshComponent* MeshComp);
+
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+
+	UPROPERTY()
+	TArray<FAnimNotifySpawnRequest> SoundRequests;
+
+	UPROPERTY()
+	TArray<FAnimNotifySpawnRequest> ParticleSystemRequests;
+
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+
+	/** Set between the world's pre and post actor tick */
+	bool bInActorTick = false;
+};
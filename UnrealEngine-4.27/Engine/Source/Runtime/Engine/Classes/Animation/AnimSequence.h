@@ -25,6 +25,7 @@
 
 typedef TArray<FTransform> FTransformArrayA2;
 
+class UAnimSequence;
 class USkeletalMesh;
 struct FAnimCompressContext;
 struct FAnimSequenceDecompressionContext;
@@ -196,6 +197,23 @@ struct ENGINE_API FRequestAnimCompressionParams
 	void InitFrameStrippingFromPlatform(const class ITargetPlatform* TargetPlatform);
 };
 
+// One pose to extract in a UAnimSequence::GetAnimationPoses batch
+struct FAnimSequencePoseRequest
+{
+	FAnimSequencePoseRequest(const UAnimSequence* InSequence, FAnimationPoseData& InOutAnimationPoseData, const FAnimExtractContext& InExtractionContext)
+		: Sequence(InSequence)
+		, OutAnimationPoseData(&InOutAnimationPoseData)
+		, ExtractionContext(InExtractionContext)
+	{}
+
+	const UAnimSequence* Sequence;
+
+	// Pose, curves and attributes to fill, the pose's bone container says which bones to extract
+	FAnimationPoseData* OutAnimationPoseData;
+
+	FAnimExtractContext ExtractionContext;
+};
+
 UCLASS(config=Engine, hidecategories=(UObject, Length), BlueprintType)
 class ENGINE_API UAnimSequence : public UAnimSequenceBase
 {
@@ -456,6 +474,14 @@ public:
 	*/
 	void GetBonePose(struct FAnimationPoseData& OutAnimationPoseData, const FAnimExtractContext& ExtractionContext, bool bForceUseRawData = false) const;
 
+	/**
+	* Extracts several poses, of any sequences, times and bone containers, the same as calling GetAnimationPose on each.
+	* Their compressed data is decompressed together, so keys shared by requests on the same sequence at nearby times are decoded once.
+	*
+	* @param	Requests			Sequences, poses to fill and extraction contexts
+	*/
+	static void GetAnimationPoses(TArrayView<const FAnimSequencePoseRequest> Requests);
+
 	const TArray<FRawAnimSequenceTrack>& GetRawAnimationData() const { return RawAnimationData; }
 
 #if WITH_EDITORONLY_DATA
@@ -892,6 +918,12 @@ public:
 	/** Take a set of marker positions and validates them against a requested start position, updating them as desired */
 	void ValidateCurrentPosition(const FMarkerSyncAnimPosition& Position, bool bPlayingForwards, bool bLooping, float&CurrentTime, FMarkerPair& PreviousMarker, FMarkerPair& NextMarker) const;
 	bool UseRawDataForPoseExtraction(const FBoneContainer& RequiredBones) const;
+
+	/** Does the part of GetBonePose before decompression: ref pose, curves, and the whole raw data path. Returns true if the compressed data still needs decompressing into the pose. */
+	bool PrepareBonePose(FAnimationPoseData& OutAnimationPoseData, const FAnimExtractContext& ExtractionContext, bool bForceUseRawData) const;
+
+	/** Parameters to decompress this sequence's compressed data into OutPose */
+	FAnimPoseDecompressionRequest MakePoseDecompressionRequest(FCompactPose& OutPose, const FAnimExtractContext& ExtractionContext) const;
 	// Should we be always using our raw data (i.e is our compressed data stale)
 	bool bUseRawDataOnly;
 
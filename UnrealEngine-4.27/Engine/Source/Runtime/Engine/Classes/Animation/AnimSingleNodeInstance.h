@@ -104,6 +104,12 @@ public:
 	/** Get the current playback time */
 	float GetCurrentTime() const;
 
+	/** Get the current playback time from the thread updating or evaluating this instance */
+	float GetCurrentTimeOnAnyThread() const;
+
+	/** Set the time the next evaluation samples the asset at from the thread evaluating this instance, without firing notifies */
+	void SetCurrentTimeOnAnyThread(float InTime);
+
 	/** Get the current play rate multiplier */
 	float GetPlayRate() const;
 
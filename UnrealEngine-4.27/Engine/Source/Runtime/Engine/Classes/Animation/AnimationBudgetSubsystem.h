@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "AnimationBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/** Scheduling state of one component registered with UAnimationBudgetSubsystem */
+USTRUCT()
+struct FAnimationBudgetComponentState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	USkeletalMeshComponent* Component = nullptr;
+
+	/** Smoothed cost of a frame the component updated and evaluated on, in ms */
+	float UpdateCostMs = 0.0f;
+
+	/** Smoothed cost of a frame the component skipped or interpolated on, in ms */
+	float SkippedCostMs = 0.0f;
+
+	/** Higher is more important, 0 when not rendered */
+	float Significance = 0.0f;
+
+	/** Time since the component last updated, handed to it as its delta time when it next does */
+	float AccumulatedDeltaTime = 0.0f;
+
+	/** Update the component once every TickRate frames */
+	int32 TickRate = 1;
+
+	/** Frames since the component last updated, 0 on a frame it updates */
+	int32 FramesSinceUpdate = 0;
+
+	/** Whether the component updated on the frame its cost was measured for */
+	bool bUpdatedLastFrame = false;
+
+	/** Whether the component is controlled by a player, and always updates */
+	bool bAlwaysUpdate = false;
+
+	/** Average cost per frame when updating once every InTickRate frames, in ms */
+	float GetAmortizedCostMs(int32 InTickRate) const
+	{
+		return (UpdateCostMs + (InTickRate - 1) * SkippedCostMs) / InTickRate;
+	}
+};
+
+/**
+ * Keeps the animation of the skeletal mesh components that enable update rate optimizations within a per frame budget of
+ * a.Budget.BudgetMs, instead of the fixed skip rates FAnimUpdateRateParameters picks from screen size.
+ *
+ * The cost of each component is measured on the frames it ticks. Before actors tick, components are ranked by significance and
+ * every one is given the lowest tick rate up to a.Budget.MaxTickRate whose amortized cost still fits, most significant first. Then
+ * each component either updates and evaluates this frame, interpolates towards its last evaluated pose, or skips, driven through
+ * the external tick rate control of USkinnedMeshComponent. Managed components have their own update rate optimizations turned off.
+ */
+UCLASS()
+class ENGINE_API UAnimationBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Starts scheduling Component once it enables update rate optimizations */
+	void RegisterComponent(USkeletalMeshComponent* Component);
+
+	/** Stops scheduling Component, giving it its own update rate optimizations back */
+	void UnregisterComponent(USkeletalMeshComponent* Component);
+
+	/** Number of components currently scheduled */
+	int32 GetNumManagedComponents() const;
+
+	/** Number of components updating less than every frame */
+	int32 GetNumThrottledComponents() const { return NumThrottledComponents; }
+
+	/** Measured cost of the managed components last frame, in ms */
+	float GetBudgetUsedMs() const { return BudgetUsedMs; }
+
+	//~USubsystem interface
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+	//~End of USubsystem interface
+
+protected:
+
+	//~UWorldSubsystem interface
+	bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+	/** Gives the components their tick rates for this frame */
+	void AllocateBudget(float BudgetMs, int32 MaxTickRate);
+
+	/** Sets up Component to update, interpolate or skip this frame */
+	void ApplyTickRate(FAnimationBudgetComponentState& State, float DeltaSeconds, int32 MaxInterpolationRate);
+
+	/** Every registered component, managed or not */
+	UPROPERTY()
+	TArray<FAnimationBudgetComponentState> ComponentStates;
+
+	/** Indices into ComponentStates of the components scheduled this frame, most significant first */
+	TArray<int32> SortedIndices;
+
+private:
+
+	/** Measures last frame and decides what every component does this one */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+
+	/** Updates the cost and significance of a component, returning false if it can't be scheduled this frame */
+	bool UpdateComponentState(FAnimationBudgetComponentState& State);
+
+	/** Hands Component's tick rate control to this subsystem */
+	void StartManaging(FAnimationBudgetComponentState& State, int32 MaxTickRate);
+
+	/** Gives Component its own tick rate control back */
+	void StopManaging(USkeletalMeshComponent* Component);
+
+	/** Removes the state at Index, moving the last one into its place */
+	void RemoveComponentState(int32 Index);
+
+	FDelegateHandle PreActorTickHandle;
+
+	int32 NumThrottledComponents = 0;
+
+	float BudgetUsedMs = 0.0f;
+};
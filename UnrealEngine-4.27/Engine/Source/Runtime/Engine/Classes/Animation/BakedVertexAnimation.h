@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	BakedVertexAnimation.h: Animation sequence baked into vertex animation textures.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+
+#include "BakedVertexAnimation.generated.h"
+
+class UAnimSequence;
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+class USkeletalMesh;
+class UStaticMesh;
+class UTexture2D;
+struct FBoneContainer;
+
+/**
+ * An animation sequence played on one LOD of a skeletal mesh, baked into textures so distant crowds can draw it as instanced static meshes.
+ * See USkeletalMeshComponent::BakedVertexAnimation.
+ *
+ * Row N of PositionTexture holds the offset of every vertex from the reference pose at frame N, and the same texel of NormalTexture its normal.
+ * StaticMesh is the baked LOD, with the texel column of each vertex in UV channel 1. Material reads them back through the parameters named
+ * below, and the per instance custom data: 0 is the world time the animation started at, 1 the play rate.
+ */
+UCLASS(BlueprintType)
+class ENGINE_API UBakedVertexAnimation : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+	/** Mesh to bake */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Source)
+	USkeletalMesh* SourceMesh;
+
+	/** Sequence to bake, played in a loop */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Source)
+	UAnimSequence* SourceSequence;
+
+	/** LOD of SourceMesh to bake, usually the one distant characters would use. Its render data needs CPU access. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Source, meta = (ClampMin = "0"))
+	int32 SourceLODIndex;
+
+	/** Frames baked per second of animation */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Source, meta = (ClampMin = "1", UIMin = "1", UIMax = "60"))
+	float SampleRate;
+
+	/** Material reading the baked textures, applied to every section of StaticMesh */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rendering)
+	UMaterialInterface* Material;
+
+	/** Baked LOD as a static mesh */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	UStaticMesh* StaticMesh;
+
+	/** Offsets from the reference pose, one row per frame, one column per vertex */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	UTexture2D* PositionTexture;
+
+	/** Skinned normals, laid out like PositionTexture */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	UTexture2D* NormalTexture;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	int32 NumVertices;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	int32 NumFrames;
+
+	/** Length of the baked sequence, in seconds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Baked)
+	float PlayLength;
+
+	/** Material parameter names set on the instances of Material */
+	static const FName PositionTextureParameterName;
+	static const FName NormalTextureParameterName;
+	static const FName NumFramesParameterName;
+	static const FName PlayLengthParameterName;
+
+	/**
+	 * Bakes SourceSequence on SourceLODIndex of SourceMesh into StaticMesh, PositionTexture and NormalTexture.
+	 * @return false and why in OutError if the sources can't be baked.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Animation")
+	bool Bake(FString& OutError);
+
+	/** Whether Bake succeeded and the asset can be drawn */
+	bool IsBaked() const;
+
+	/** Creates an instance of Material with the baked textures and timing set */
+	UMaterialInstanceDynamic* CreateMaterialInstance(UObject* Outer) const;
+
+protected:
+
+	/** Fills OutComponentSpaceTransforms, one per bone of SourceMesh, with the pose of SourceSequence at Time. Called by Bake for every frame. */
+	virtual void EvaluateComponentSpacePose(float Time, const FBoneContainer& BoneContainer, TArray<FTransform>& OutComponentSpaceTransforms) const;
+};
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Stats/Stats.h"
+
+#include "BakedVertexAnimationSubsystem.generated.h"
+
+class UBakedVertexAnimation;
+class UInstancedStaticMeshComponent;
+class USkeletalMeshComponent;
+
+/** Instances drawing every component currently using one baked vertex animation */
+USTRUCT()
+struct FBakedVertexAnimationBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances = nullptr;
+
+	/** Component drawn by each instance, in instance order */
+	UPROPERTY()
+	TArray<USkeletalMeshComponent*> Owners;
+};
+
+/**
+ * Switches skeletal mesh components with a USkeletalMeshComponent::BakedVertexAnimation to it once every view is further than their
+ * BakedVertexAnimationDistance, and back once one comes closer.
+ *
+ * Switched components stop ticking and drawing, and are drawn instead by one instanced static mesh per baked animation. The material
+ * plays the animation from the time it started at, stored in the instance custom data, so nothing is updated per frame unless the
+ * component moves.
+ */
+UCLASS()
+class ENGINE_API UBakedVertexAnimationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Starts checking whether Component should use its baked vertex animation */
+	void RegisterComponent(USkeletalMeshComponent* Component);
+
+	/** Stops checking Component, switching it back to skeletal animation if needed */
+	void UnregisterComponent(USkeletalMeshComponent* Component);
+
+	/** Number of components currently drawn from a baked vertex animation */
+	int32 GetNumBakedComponents() const;
+
+protected:
+
+	//~FTickableGameObject interface
+
+	void Tick(float DeltaTime) override;
+
+	TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UBakedVertexAnimationSubsystem, STATGROUP_Tickables); }
+
+	//~End of FTickableGameObject interface
+
+	//~USubsystem interface
+	void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~UWorldSubsystem interface
+	bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+private:
+
+	/** Moves Component to the instances of its baked vertex animation */
+	void SwitchToBaked(USkeletalMeshComponent* Component);
+
+	/** Removes Component from its instances and lets it animate again */
+	void SwitchToSkeletal(USkeletalMeshComponent* Component);
+
+	/** Components with a baked vertex animation, whether they are using it or not */
+	UPROPERTY()
+	TArray<USkeletalMeshComponent*> Components;
+
+	UPROPERTY()
+	TMap<UBakedVertexAnimation*, FBakedVertexAnimationBatch> Batches;
+};
@@ -116,6 +116,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Rendering|Material")
 	void SetScalarParameterValueOnMaterials(const FName ParameterName, const float ParameterValue);
 
+	/** Same as SetScalarParameterValueOnMaterials for each parameter, but sets all of a material's parameters in one go */
+	void SetScalarParameterValuesOnMaterials(const TMap<FName, float>& Parameters);
+
 	/** Set all occurrences of Vector Material Parameters with ParameterName in the set of materials of the SkeletalMesh to ParameterValue */
 	UFUNCTION(BlueprintCallable, Category = "Rendering|Material")
 	void SetVectorParameterValueOnMaterials(const FName ParameterName, const FVector ParameterValue);
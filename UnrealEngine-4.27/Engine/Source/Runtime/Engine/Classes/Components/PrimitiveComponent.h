@@ -291,6 +291,14 @@ public:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, BlueprintReadWrite, Category=Collision)
 	uint8 bMultiBodyOverlap:1;
 
+	/**
+	 * If true, overlap updates for this component are gathered by the world and run as one parallel batch at the end of the frame,
+	 * instead of running an overlap query every time the component moves. Begin/End overlap events are delayed until then.
+	 * Useful for large numbers of moving triggers or pickups. Requires p.DeferredOverlapUpdates to be enabled.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, BlueprintReadWrite, Category=Collision)
+	uint8 bDeferOverlapUpdates:1;
+
 	/**
 	 * If true, component sweeps with this component should trace against complex collision during movement (for example, each triangle of a mesh).
 	 * If false, collision will be resolved against simple collision bounds instead.
@@ -315,6 +315,7 @@ class ENGINE_API USkeletalMeshComponent : public USkinnedMeshComponent, public I
 
 	friend class FSkinnedMeshComponentRecreateRenderStateContext;
 	friend class FParallelAnimationCompletionTask;
+	friend class FParallelAnimationEvaluationTask;
 	friend class USkeletalMesh; 
 	friend class UAnimInstance;
 	friend struct FAnimNode_LinkedAnimGraph;
@@ -528,6 +529,25 @@ public:
 	/** whether we need to teleport cloth. */
 	EClothingTeleportMode ClothTeleportMode;
 
+	/**
+	 * Baked animation to draw this component with once every view is further than BakedVertexAnimationDistance. While it is used
+	 * the component doesn't tick or draw, and is drawn as an instance of the baked static mesh instead. See UBakedVertexAnimationSubsystem.
+	 * Use SetBakedVertexAnimation to change it on a registered component.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, BlueprintReadOnly, Category = LOD)
+	class UBakedVertexAnimation* BakedVertexAnimation;
+
+	/** Distance from the closest view past which BakedVertexAnimation is used, 0 never uses it */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, BlueprintReadOnly, Category = LOD, meta = (ClampMin = "0", UIMin = "0"))
+	float BakedVertexAnimationDistance;
+
+	/** Changes BakedVertexAnimation, switching the component back to skeletal animation first if it was drawn from the previous one */
+	UFUNCTION(BlueprintCallable, Category = "Components|SkeletalMesh")
+	void SetBakedVertexAnimation(class UBakedVertexAnimation* InBakedVertexAnimation);
+
+	/** Whether the component is currently drawn from BakedVertexAnimation */
+	bool IsUsingBakedVertexAnimation() const { return bUsingBakedVertexAnimation; }
+
 protected:
 	/** Whether to use Animation Blueprint or play Single Animation Asset. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Animation)
@@ -598,6 +618,35 @@ private:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = SkeletalMesh)
 	uint8 bAllowAnimCurveEvaluation : 1;
 
+	/** Whether the component is drawn from BakedVertexAnimation instead of animating */
+	uint8 bUsingBakedVertexAnimation : 1;
+
+	/** Whether the component was ticking before it switched to BakedVertexAnimation */
+	uint8 bTickEnabledBeforeBakedVertexAnimation : 1;
+
+	/** Index of the component's instance in its UBakedVertexAnimationSubsystem batch */
+	int32 BakedVertexAnimationInstanceIndex;
+
+	friend class UBakedVertexAnimationSubsystem;
+
+	/** Whether UAnimationBudgetSubsystem controls when the component updates, in place of its update rate optimizations */
+	uint8 bManagedByAnimationBudget : 1;
+
+	/** Whether the component had update rate optimizations enabled before UAnimationBudgetSubsystem took over */
+	uint8 bUpdateRateOptimizationsBeforeAnimationBudget : 1;
+
+	/** Index of the component in its UAnimationBudgetSubsystem */
+	int32 AnimationBudgetIndex;
+
+	/**
+	 * Cycles spent ticking the component on the game thread, and evaluating it on a worker, since UAnimationBudgetSubsystem last read them.
+	 * Kept apart as the evaluation task can finish while the game thread is still in TickComponent.
+	 */
+	uint32 AnimationBudgetGameThreadCycles;
+	uint32 AnimationBudgetWorkerCycles;
+
+	friend class UAnimationBudgetSubsystem;
+
 	/** DEPRECATED. Use bAllowAnimCurveEvaluation instead */
 	UE_DEPRECATED(4.18, "This property is deprecated. Please use bAllowAnimCurveEvaluatiuon instead. Note that the meaning is reversed.")	
 	UPROPERTY()
@@ -1577,6 +1626,7 @@ public:
 protected:
 	virtual void OnRegister() override;
 	virtual void OnUnregister() override;
+	virtual bool ShouldCreateRenderState() const override;
 	virtual bool ShouldCreatePhysicsState() const override;
 	virtual void OnCreatePhysicsState() override;
 	virtual void OnDestroyPhysicsState() override;
@@ -549,6 +549,9 @@ public:
 	void TickDemoPlayback(float DeltaSeconds);
 	
 	void FinalizeFastForward(const double StartTime);
+
+	/** Ignores the bunches of actors that are spawned and destroyed within the packets this fast forward will process, see demo.FastForwardSkipDestroyedActors */
+	bool IgnoreActorsDestroyedDuringFastForward();
 	
 	void SpawnDemoRecSpectator( UNetConnection* Connection, const FURL& ListenURL);
 
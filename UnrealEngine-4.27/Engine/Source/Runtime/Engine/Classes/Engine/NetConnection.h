@@ -15,6 +15,7 @@
 #include "GameFramework/UpdateLevelVisibilityLevelInfo.h"
 #include "Engine/NetDriver.h"
 #include "Net/DataBunch.h"
+#include "Net/NetPacketSendQueue.h"
 #include "Net/NetPacketNotify.h"
 #include "Engine/Player.h"
 #include "Engine/Channel.h"
@@ -564,6 +565,12 @@ public:
 	int32				InitOutReliable;
 	int32				InitInReliable;
 
+	/** Pooled copies of incoming bunches that channels hold on to across packets (out of order reliables, partials, queued bunches) */
+	FInBunchArena		InBunchArena;
+
+	/** Packets FlushNet has built this tick but not sent yet, when net.BatchSends is enabled */
+	FNetPacketSendQueue	BatchedSends;
+
 	// Network version
 	uint32				EngineNetworkProtocolVersion;
 	uint32				GameNetworkProtocolVersion;
@@ -854,6 +861,18 @@ public:
 	ENGINE_API virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
 		PURE_VIRTUAL(UNetConnection::LowLevelSend,);
 
+	/**
+	 * Sends the packets FlushNet queued during the tick when net.BatchSends is enabled, in the order they were built.
+	 * The default sends them one at a time through LowLevelSend. Connections whose socket can write several datagrams
+	 * with one call (sendmmsg, UDP segmentation offload) should override this and fall back to LowLevelSend otherwise.
+	 *
+	 * @param Packets		The queued packets, only valid for the duration of the call
+	 */
+	ENGINE_API virtual void LowLevelSendBatch(TArrayView<FQueuedOutPacket> Packets);
+
+	/** Sends any packets queued by FlushNet, called by the driver once all connections have ticked */
+	ENGINE_API void FlushBatchedSends();
+
 	/** Validates the FBitWriter to make sure it's not in an error state */
 	ENGINE_API virtual void ValidateSendBuffer();
 
@@ -1200,6 +1219,8 @@ public:
 	 */
 	void SetIgnoreActorBunches(bool bInIgnoreActorBunches, TSet<FNetworkGUID>&& InIgnoredBunchGuids);
 
+	bool IsIgnoringActorBunches() const { return bIgnoreActorBunches; }
+
 	/**
 	 * Sets whether or not we should track released channel indices, see also SetIgnoreReservedChannels
 	 * Should only be used with InternalAck.
@@ -1385,6 +1406,9 @@ private:
 	bool CheckOutgoingPacketEmulation(FOutPacketTraits& Traits);
 #endif
 
+	/** Sends the packet FlushNet built, or queues it for FlushBatchedSends when sends are being batched */
+	void SendOrQueuePacket(uint8* Data, int32 CountBits, FOutPacketTraits& Traits);
+
 	/** Write packetHeader */
 	void WritePacketHeader(FBitWriter& Writer);
 
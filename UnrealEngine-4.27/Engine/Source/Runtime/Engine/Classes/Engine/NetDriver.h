@@ -326,6 +326,7 @@ class FVoicePacket;
 class StatelessConnectHandlerComponent;
 class UNetConnection;
 class UReplicationDriver;
+class FNetReplicationPolicy;
 struct FNetworkObjectInfo;
 class UChannel;
 class IAnalyticsProvider;
@@ -590,6 +591,48 @@ struct FCompareFActorPriority
 	}
 };
 
+/**
+ * Prioritized actor list for one connection, built on a worker thread by ServerReplicateActors_PrioritizeActorsParallel.
+ * Changes the serial path would make while prioritizing are recorded here and applied on the game thread afterwards.
+ */
+struct FConnectionPrioritizedActors
+{
+	/** Storage for the priorities, PriorityActors points into this */
+	TArray<FActorPriority> PriorityList;
+
+	/** Relevant actors sorted by priority */
+	TArray<FActorPriority*> PriorityActors;
+
+	/** Channels to close because the actor is no longer relevant to this connection */
+	TArray<class UActorChannel*> ChannelsToClose;
+
+	/** Channels whose actor wants to go dormant */
+	TArray<class UActorChannel*> ChannelsToStartDormancy;
+
+	/** Considered actors without AActor::bParallelNetPrioritization, prioritized on the game thread by ServerReplicateActors_FinishPrioritizeActorsParallel */
+	TArray<FNetworkObjectInfo*> GameThreadActors;
+
+	/** Temporary actors already sent to the connection, which are skipped */
+	TSet<const class AActor*> SentTemporaries;
+
+	int32 NumDeletedActors = 0;
+
+	/** Actors skipped because net.RelevancyGrid placed them too far from every viewer */
+	int32 NumRelevancyGridCulledActors = 0;
+
+	void Reset()
+	{
+		PriorityList.Reset();
+		PriorityActors.Reset();
+		ChannelsToClose.Reset();
+		ChannelsToStartDormancy.Reset();
+		GameThreadActors.Reset();
+		SentTemporaries.Reset();
+		NumDeletedActors = 0;
+		NumRelevancyGridCulledActors = 0;
+	}
+};
+
 /** Used to specify properties of a channel type */
 USTRUCT()
 struct ENGINE_API FChannelDefinition
@@ -1276,6 +1319,15 @@ public:
 	 */
 	ENGINE_API virtual int32 ServerReplicateActors(float DeltaSeconds);
 
+	/**
+	 * Creates the replication policy ServerReplicateActors uses while net.ReplicationPolicy is enabled.
+	 * Override to return a subclass of FNetReplicationPolicy that schedules actors differently.
+	 */
+	ENGINE_API virtual TSharedPtr<FNetReplicationPolicy> CreateReplicationPolicy();
+
+	/** Returns the replication policy if net.ReplicationPolicy is enabled and ServerReplicateActors has run since */
+	FNetReplicationPolicy* GetReplicationPolicy() const { return ReplicationPolicy.Get(); }
+
 	/**
 	 * Process a remote function call on some actor destined for a remote location
 	 *
@@ -1663,6 +1715,35 @@ protected:
 	void ServerReplicateActors_BuildConsiderList( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime );
 	int32 ServerReplicateActors_PrioritizeActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*> ConsiderList, const bool bCPUSaturated, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors );
 	int32 ServerReplicateActors_ProcessPrioritizedActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FActorPriority** PriorityActors, const int32 FinalSortedCount, int32& OutUpdated );
+
+	/**
+	 * Thread safe version of ServerReplicateActors_PrioritizeActors used by net.ParallelPrioritizeActors.
+	 * Only reads from the driver, the connection and the considered actors; channel changes are returned in OutResult.
+	 * Actors without AActor::bParallelNetPrioritization are left in OutResult.GameThreadActors, see ServerReplicateActors_FinishPrioritizeActorsParallel.
+	 */
+	void ServerReplicateActors_PrioritizeActorsParallel( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*>& ConsiderList, FConnectionPrioritizedActors& OutResult ) const;
+
+	/** Prioritizes the actors ServerReplicateActors_PrioritizeActorsParallel left for the game thread, and sorts the result */
+	void ServerReplicateActors_FinishPrioritizeActorsParallel( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FConnectionPrioritizedActors& InOutResult ) const;
+
+	/** Adds a considered actor to Result if it is relevant to the connection, shared by both passes of parallel prioritization */
+	void PrioritizeActorParallel( UNetConnection* Connection, const TWeakObjectPtr<UNetConnection>& WeakConnection, const TArray<FNetViewer>& ConnectionViewers, FNetworkObjectInfo* ActorInfo, const bool bLowNetBandwidth, FConnectionPrioritizedActors& Result ) const;
+
+	/** Whether ServerReplicateActors should prioritize the given number of connections on worker threads this frame */
+	bool ShouldPrioritizeActorsInParallel( const int32 NumClientsToTick, const bool bCPUSaturated ) const;
+
+	/**
+	 * Adds the actor to OutConsiderList if it is ready to replicate, updating its next update time and calling PreReplication on it.
+	 * Actors that shouldn't be in the network object list anymore are added to OutActorsToRemove.
+	 */
+	void ServerReplicateActors_ConsiderActor( FNetworkObjectInfo* ActorInfo, const float ServerTickTime, const bool bUseRelevancyGrid, TArray<FNetworkObjectInfo*>& OutConsiderList, TArray<AActor*>& OutActorsToRemove, int32& OutNumInitiallyDormant );
+
+	/** Versions of BuildConsiderList and PrioritizeActors used with net.ReplicationPolicy, see FNetReplicationPolicy */
+	void ServerReplicateActors_BuildConsiderListFromPolicy( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime );
+	int32 ServerReplicateActors_PrioritizeActorsFromPolicy( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*>& ConsiderList, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors );
+
+	/** Creates or destroys the replication policy to match net.ReplicationPolicy */
+	void UpdateReplicationPolicy();
 #endif
 
 	/** Used to handle any NetDriver specific cleanup once a level has been removed from the world. */
@@ -1747,6 +1828,9 @@ private:
 	/** Stores the list of objects to replicate into the replay stream. This should be a TUniquePtr, but it appears the generated.cpp file needs the full definition of the pointed-to type. */
 	TSharedPtr<FNetworkObjectList> NetworkObjects;
 
+	/** Cached actor lists used by ServerReplicateActors with net.ReplicationPolicy, null otherwise */
+	TSharedPtr<FNetReplicationPolicy> ReplicationPolicy;
+
 	/** Set to "Lagging" on the server when all client connections are near timing out. We are lagging on the client when the server connection is near timed out. */
 	ENetworkLagState::Type LagState;
 
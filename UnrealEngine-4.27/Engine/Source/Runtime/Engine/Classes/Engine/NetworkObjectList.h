@@ -7,6 +7,20 @@
 
 class AActor;
 class FArchive;
+struct FNetViewer;
+
+/** Which list of FNetworkRelevancyGrid an object is in */
+enum class ENetRelevancyGridList : uint8
+{
+	/** Not tracked by the grid */
+	None,
+	/** In the grid cell containing its location, it can only be relevant to nearby viewers */
+	Cell,
+	/** Relevancy doesn't depend on distance (always relevant, no root component, or a cull distance beyond the grid query radius) */
+	AlwaysRelevant,
+	/** May be relevant through its owner, instigator or attach parent regardless of distance */
+	OwnerRelevant,
+};
 
 /**
  * Struct to store an actor pointer and any internal metadata for that actor used
@@ -60,6 +74,25 @@ struct FNetworkObjectInfo
 	/** Force this object to be considered relevant for at least one update */
 	uint32 ForceRelevantFrame = 0;
 
+	/** Which list of the relevancy grid this object is in, see FNetworkRelevancyGrid */
+	ENetRelevancyGridList RelevancyGridList = ENetRelevancyGridList::None;
+
+	/** Relevancy grid cell the object was last added to, only valid when RelevancyGridList is Cell */
+	FIntPoint RelevancyGridCell = FIntPoint::ZeroValue;
+
+	/** Frames between visits of the update schedule bucket the object is in, 0 if it isn't scheduled, see FNetworkUpdateSchedule */
+	int32 UpdateScheduleInterval = 0;
+
+	/** Last replication frame the object was added to the net driver's consider list on */
+	uint32 ConsiderListFrame = 0;
+
+	/** Slot of its update schedule bucket the object is in, and its index in that slot */
+	int32 UpdateScheduleSlot = 0;
+	int32 UpdateScheduleSlotIndex = INDEX_NONE;
+
+	/** Last replication frame the object was gathered for consideration on, so it isn't gathered twice in one frame */
+	uint32 UpdateScheduleGatherFrame = 0;
+
 	FNetworkObjectInfo()
 		: Actor(nullptr)
 		, NextUpdateTime(0.0)
@@ -116,6 +149,167 @@ struct FNetworkObjectKeyFuncs : BaseKeyFuncs<TSharedPtr<FNetworkObjectInfo>, AAc
 	}
 };
 
+/** An object entering or leaving a cell or side list of FNetworkRelevancyGrid, recorded while change tracking is enabled */
+struct FNetRelevancyGridChange
+{
+	/** Only used as a key, the object may have been destroyed since */
+	const FNetworkObjectInfo* ObjectInfo;
+
+	ENetRelevancyGridList OldList;
+	ENetRelevancyGridList NewList;
+
+	/** Only valid when the matching list is Cell */
+	FIntPoint OldCell;
+	FIntPoint NewCell;
+};
+
+/**
+ * Spatial hash of replicated actors, used by net.RelevancyGrid to skip relevancy checks for actors too far from every viewer of a connection.
+ *
+ * Objects whose relevancy only depends on their distance to the viewer are bucketed by location into square cells on the XY plane,
+ * and are moved between cells when they are considered for replication, and by FNetworkObjectList::UpdateRelevancyGridSlice whether
+ * or not they are. Everything else is kept in side lists and is always checked.
+ *
+ * With SetTrackChanges, objects moving between cells and lists are also recorded, so FNetReplicationPolicy can keep per-connection
+ * actor lists up to date without gathering them again.
+ */
+class ENGINE_API FNetworkRelevancyGrid
+{
+public:
+	FNetworkRelevancyGrid();
+
+	/** Sets the cell size and the largest cull distance cell queries cover, removing every object if either changed */
+	void SetCellSizeAndQueryRadius(const float InCellSize, const float InQueryRadius);
+
+	/** Adds the object, or moves it to the cell or side list matching the actor's current state */
+	void Update(FNetworkObjectInfo& ObjectInfo);
+
+	/** Removes the object from the grid */
+	void Remove(FNetworkObjectInfo& ObjectInfo);
+
+	/** Removes every object from the grid */
+	void Reset();
+
+	/**
+	 * Adds every object in a cell within the query radius of any of the viewers, and every object in a side list, to OutObjects.
+	 * Only the cells around the viewers are visited. Objects in other cells can only be relevant to the viewers through an open
+	 * channel or by being one of them, which the caller has to check with IsInNearbyCell.
+	 */
+	void GatherCandidateObjects(const TArray<FNetViewer>& Viewers, TArray<FNetworkObjectInfo*>& OutObjects) const;
+
+	/** Returns true if the object is in one of the cells GatherCandidateObjects visits for these viewers */
+	bool IsInNearbyCell(const FNetworkObjectInfo& ObjectInfo, const TArray<FNetViewer>& Viewers) const;
+
+	/**
+	 * Adds the coordinates of every cell within the query radius of any point of the viewers' cells to OutCells, whether or not it holds objects.
+	 * Unlike GatherCandidateObjects the result only depends on which cell each viewer is in.
+	 */
+	void GatherNearbyCells(const TArray<FNetViewer>& Viewers, TSet<FIntPoint>& OutCells) const;
+
+	/** Returns the coordinates of the cell containing Location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Returns true if the object is in a cell, and so can only be relevant to viewers within the query radius */
+	static bool IsInCell(const FNetworkObjectInfo& ObjectInfo) { return ObjectInfo.RelevancyGridList == ENetRelevancyGridList::Cell; }
+
+	int32 GetNumCellObjects() const { return NumCellObjects; }
+	int32 GetNumCells() const { return Cells.Num(); }
+	int32 GetNumAlwaysRelevantObjects() const { return AlwaysRelevantObjects.Num(); }
+	int32 GetNumOwnerRelevantObjects() const { return OwnerRelevantObjects.Num(); }
+	int32 GetNumObjects() const { return NumCellObjects + AlwaysRelevantObjects.Num() + OwnerRelevantObjects.Num(); }
+
+	float GetCellSize() const { return CellSize; }
+	float GetQueryRadius() const { return QueryRadius; }
+
+	/** Adds every object in one of the cells, and every object in a side list, to OutObjects */
+	void GatherObjectsInCells(const TSet<FIntPoint>& InCells, TSet<const FNetworkObjectInfo*>& OutObjects) const;
+
+	/** Starts or stops recording the objects that enter or leave a cell or side list, see GetChanges */
+	void SetTrackChanges(const bool bInTrackChanges);
+
+	/** Returns the changes recorded since the last ClearChanges, only meaningful if WasResetSinceChangesCleared is false */
+	const TArray<FNetRelevancyGridChange>& GetChanges() const { return Changes; }
+
+	/** Returns true if the grid was reset, or recorded too many changes to be worth replaying, since the last ClearChanges */
+	bool WasResetSinceChangesCleared() const { return bResetSinceChangesCleared; }
+
+	void ClearChanges();
+
+	void CountBytes(FArchive& Ar) const;
+
+private:
+	/** Removes the object from its cell or side list without recording a change */
+	void RemoveFromList(FNetworkObjectInfo& ObjectInfo);
+
+	void RecordChange(const FNetworkObjectInfo& ObjectInfo, const ENetRelevancyGridList OldList, const FIntPoint& OldCell);
+
+	/** Cell coordinates to the objects in that cell */
+	TMap<FIntPoint, TArray<FNetworkObjectInfo*>> Cells;
+
+	/** Objects that entered or left a cell or side list since the last ClearChanges, while bTrackChanges is set */
+	TArray<FNetRelevancyGridChange> Changes;
+	bool bTrackChanges;
+	bool bResetSinceChangesCleared;
+
+	TSet<FNetworkObjectInfo*> AlwaysRelevantObjects;
+	TSet<FNetworkObjectInfo*> OwnerRelevantObjects;
+
+	int32 NumCellObjects;
+	float CellSize;
+	float QueryRadius;
+};
+
+/**
+ * Replicated actors bucketed by how many replication frames apart they want to be considered, used by FNetReplicationPolicy.
+ *
+ * A bucket with an interval of N frames is split into N slots and one slot is visited each frame, so every object is visited
+ * once per interval and the work done each frame depends on update frequencies rather than on the number of objects.
+ */
+class ENGINE_API FNetworkUpdateSchedule
+{
+public:
+	/** Objects asking for a longer interval are visited at this one */
+	static constexpr int32 MaxIntervalFrames = 255;
+
+	FNetworkUpdateSchedule();
+
+	/** Adds the object, or moves it to the bucket for IntervalFrames if it is in another one */
+	void Update(FNetworkObjectInfo& ObjectInfo, const int32 IntervalFrames);
+
+	/** Removes the object from the schedule */
+	void Remove(FNetworkObjectInfo& ObjectInfo);
+
+	/** Removes every object from the schedule */
+	void Reset();
+
+	/** Adds the objects visited on Frame to OutObjects, shortest intervals first, skipping objects already gathered on that frame */
+	void GatherDueObjects(const uint32 Frame, TArray<FNetworkObjectInfo*>& OutObjects);
+
+	int32 GetNumObjects() const { return NumObjects; }
+	int32 GetNumBuckets() const { return Buckets.Num(); }
+
+	void CountBytes(FArchive& Ar) const;
+
+private:
+	struct FBucket
+	{
+		int32 IntervalFrames;
+
+		/** Slot new objects are added to, so objects of a bucket are spread over its slots */
+		int32 NextSlot;
+
+		TArray<TArray<FNetworkObjectInfo*>> Slots;
+	};
+
+	FBucket& FindOrAddBucket(const int32 IntervalFrames);
+	FBucket* FindBucket(const int32 IntervalFrames);
+
+	/** Sorted by interval */
+	TArray<FBucket> Buckets;
+
+	int32 NumObjects;
+};
+
 /**
  * Stores the list of replicated actors for a given UNetDriver.
  */
@@ -227,6 +421,24 @@ public:
 
 	int32 GetNumDormantActorsForConnection( UNetConnection* const Connection ) const;
 
+	/** Returns the spatial index of the tracked actors, only kept up to date while net.RelevancyGrid is enabled */
+	FNetworkRelevancyGrid& GetRelevancyGrid() { return RelevancyGrid; }
+	const FNetworkRelevancyGrid& GetRelevancyGrid() const { return RelevancyGrid; }
+
+	/**
+	 * Moves the next slice of the active objects to their current relevancy grid cell, sized so every active object is visited over
+	 * NumFrames calls. Keeps the cells of objects that moved while they weren't considered for replication from going stale.
+	 */
+	void UpdateRelevancyGridSlice(const int32 NumFrames);
+
+	/** Returns the update frequency buckets of the tracked actors, only kept up to date while the schedule is enabled */
+	FNetworkUpdateSchedule& GetUpdateSchedule() { return UpdateSchedule; }
+	const FNetworkUpdateSchedule& GetUpdateSchedule() const { return UpdateSchedule; }
+
+	/** Enables or disables the update schedule, enabling it schedules every tracked actor to be visited on the next frame */
+	void SetUpdateScheduleEnabled(const bool bEnabled);
+	bool IsUpdateScheduleEnabled() const { return bUpdateScheduleEnabled; }
+
 	/** Force this actor to be relevant for at least one update */
 	UE_DEPRECATED(4.22, "Please use the ForceActorRelevantNextUpdate which takes a net driver instead.")
 	void ForceActorRelevantNextUpdate(AActor* const Actor, const FName NetDriverName);
@@ -244,4 +456,12 @@ private:
 	FNetworkObjectSet ObjectsDormantOnAllConnections;
 
 	TMap<TWeakObjectPtr<UNetConnection>, int32 > NumDormantObjectsPerConnection;
+
+	FNetworkRelevancyGrid RelevancyGrid;
+
+	/** Index in ActiveNetworkObjects the next UpdateRelevancyGridSlice starts at */
+	int32 RelevancyGridSliceIndex = 0;
+
+	FNetworkUpdateSchedule UpdateSchedule;
+	bool bUpdateScheduleEnabled = false;
 };
@@ -28,6 +28,7 @@
 #include "UObject/CoreNet.h"
 #include "Net/DataBunch.h"
 #include "Net/NetAnalyticsTypes.h"
+#include "Net/NetworkGuidMap.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "PackageMapClient.generated.h"
 
@@ -275,7 +276,7 @@ public:
 	 */
 	void ReportSyncLoadedGUIDs();
 
-	TMap< FNetworkGUID, FNetGuidCacheObject >		ObjectLookup;
+	TNetworkGUIDMap< FNetGuidCacheObject >			ObjectLookup;
 	TMap< TWeakObjectPtr< UObject >, FNetworkGUID >	NetGUIDLookup;
 	int32											UniqueNetIDs[2];
 
@@ -354,6 +355,16 @@ private:
 	 */
 	TMap<FNetworkGUID, TWeakPtr<FQueuedBunchObjectReference>> QueuedBunchObjectReferences;
 
+	/** Tracks how long it takes a joining client to resolve the exports it was sent, from the first export bunch until its async loads have drained */
+	void NoteExportBunchReceived(const int32 NumGUIDsInBunch);
+	void TryLogJoinInProgress();
+
+	double JoinStartTime;
+	int32 JoinNumExportBunches;
+	int32 JoinNumExportedGUIDs;
+	int32 JoinNumAsyncLoads;
+	bool bJoinInProgressLogged;
+
 #if CSV_PROFILER
 public:
 
@@ -1170,6 +1170,7 @@ public:
 			, bBuildSimpleCollision(false)
 			, bCommitMeshDescription(true)
 			, bAllowCpuAccess(false)
+			, bUseFullPrecisionUVs(false)
 		{}
 
 		/**
@@ -1198,6 +1199,11 @@ public:
 		 * Ored with the value of bAllowCpuAccess on the static mesh. Set to false by default.
 		 */
 		bool bAllowCpuAccess;
+
+		/**
+		 * Stores UVs as 32 bit floats instead of half floats, for UVs holding more than a texture coordinate. Set to false by default.
+		 */
+		bool bUseFullPrecisionUVs;
 	};
 
 	/**
@@ -15,6 +15,7 @@
 #include "Engine/EngineBaseTypes.h"
 #include "CollisionQueryParams.h"
 #include "WorldCollision.h"
+#include "DeferredOverlapUpdates.h"
 #include "GameFramework/Pawn.h"
 #include "EngineDefines.h"
 #include "Engine/Blueprint.h"
@@ -1387,6 +1388,9 @@ private:
 	/** The state of async tracing - abstracted into its own object for easier reference */
 	FWorldAsyncTraceState AsyncTraceState;
 
+	/** Overlap updates gathered this frame from components with bDeferOverlapUpdates, run as one batch at the end of the tick */
+	FDeferredOverlapUpdates DeferredOverlapUpdates;
+
 #if WITH_EDITOR
 	/**	Objects currently being debugged in Kismet	*/
 	FBlueprintToDebuggedObjectMap BlueprintObjectsBeingDebugged;
@@ -2225,6 +2229,24 @@ public:
 	 */
 	bool IsTraceHandleValid(const FTraceHandle& Handle, bool bOverlapTrace);
 
+	/**
+	 * Run a batch of traces that share the same shape and query parameters, splitting the work evenly across worker threads.
+	 * Unlike the Async* functions the results are available as soon as this returns, without per trace handles or delegates.
+	 * Requests of the same call that are exact duplicates of each other (same start, end, channel and trace type) are only traced once.
+	 * Nothing is kept between calls, so callers that want duplicates collapsed across a frame have to gather their requests into one batch.
+	 *
+	 * @param	Requests		Traces to run
+	 * @param	OutHits			One result per request, in the same order as Requests. bBlockingHit is false for traces that didn't hit anything.
+	 *							For Multi requests this is the blocking hit, if any.
+	 * @param	CollisionShape	Shape swept by every trace in the batch, line traces if this is FCollisionShape::LineShape
+	 * @param	Params			Additional parameters used for every trace in the batch
+	 * @param	ResponseParam	ResponseContainer used for every trace in the batch
+	 * @param	OutMultiHits	If set, one array per request receiving every hit of Multi requests, as returned by the Multi trace functions, and empty for other requests.
+	 *							Required if any request is Multi.
+	 * @return	Number of requests that had a blocking hit
+	 */
+	int32 BatchTraceByChannel(TArrayView<const FBatchTraceRequest> Requests, TArray<FHitResult>& OutHits, const FCollisionShape& CollisionShape = FCollisionShape::LineShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam, TArray<TArray<FHitResult>>* OutMultiHits = nullptr) const;
+
 private:
 	static void GetCollisionProfileChannelAndResponseParams(FName ProfileName, ECollisionChannel& CollisionChannel, FCollisionResponseParams& ResponseParams)
 	{
@@ -2399,6 +2421,9 @@ public:
 	/** Set the physics scene to use by this world */
 	void SetPhysicsScene(FPhysScene* InScene);
 
+	/** Returns the overlap updates deferred to the end of this frame. */
+	FDeferredOverlapUpdates& GetDeferredOverlapUpdates() { return DeferredOverlapUpdates; }
+
 	/**
 	 * Returns the default physics volume and creates it if necessary.
 	 * 
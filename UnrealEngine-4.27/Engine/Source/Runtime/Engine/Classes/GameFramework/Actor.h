@@ -228,6 +228,13 @@ public:
 	UPROPERTY(Category=Replication, EditDefaultsOnly, BlueprintReadWrite)
 	uint8 bNetUseOwnerRelevancy:1;
 
+	/**
+	 * If true, this actor's IsNetRelevantFor, GetNetPriority and GetNetDormancy are safe to call from worker threads, and net.ParallelPrioritizeActors
+	 * may prioritize it off the game thread. Other actors, and actors relevant through their owner, are prioritized on the game thread.
+	 */
+	UPROPERTY(Category=Replication, EditDefaultsOnly, AdvancedDisplay)
+	uint8 bParallelNetPrioritization:1;
+
 	/** If true, this actor will be replicated to network replays (default is true) */
 	UPROPERTY()
 	uint8 bRelevantForNetworkReplays:1;
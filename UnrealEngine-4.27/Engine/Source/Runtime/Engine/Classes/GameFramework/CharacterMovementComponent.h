@@ -104,6 +104,39 @@ public:
 	void SetFromLineTrace(const FHitResult& InHit, const float InSweepFloorDist, const float InLineDist, const bool bIsWalkableFloor);
 };
 
+/** Settings for one reduced update rate level of character movement LOD. */
+USTRUCT(BlueprintType)
+struct ENGINE_API FCharacterMovementLODLevel
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Distance to the nearest viewer, divided by the character's significance, from which this level is used. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CharacterMovementLOD, meta=(ClampMin="0", UIMin="0", ForceUnits=cm))
+	float MinDistance;
+
+	/** Minimum time between movement updates at this level. Movement runs with the accumulated time once it elapses. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CharacterMovementLOD, meta=(ClampMin="0", UIMin="0", ForceUnits=s))
+	float UpdateInterval;
+
+	FCharacterMovementLODLevel()
+		: MinDistance(0.f)
+		, UpdateInterval(0.f)
+	{
+	}
+
+	FCharacterMovementLODLevel(float InMinDistance, float InUpdateInterval)
+		: MinDistance(InMinDistance)
+		, UpdateInterval(InUpdateInterval)
+	{
+	}
+};
+
+/**
+ * Returns the significance of a character for movement LOD. 1 is neutral, higher values keep the character at full rate further away,
+ * and 0 puts it at the lowest movement LOD.
+ */
+DECLARE_DELEGATE_RetVal_OneParam(float, FCharacterMovementLODSignificanceDelegate, const class UCharacterMovementComponent*);
+
 /** 
  * Tick function that calls UCharacterMovementComponent::PostPhysicsTickComponent
  **/
@@ -857,6 +890,51 @@ public:
 	UPROPERTY(Category="Character Movement: Walking", VisibleInstanceOnly, BlueprintReadOnly)
 	FFindFloorResult CurrentFloor;
 
+	/**
+	 * Max horizontal distance between the location predicted for a batched floor query and the location of the actual floor check for the batched result to be used.
+	 * @see bUseBatchedFloorQueries
+	 */
+	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay, meta=(ClampMin="0", UIMin="0", ForceUnits=cm))
+	float BatchedFloorQueryTolerance;
+
+	/**
+	 * Simulated proxies that moved less than this horizontal distance since their last floor check, while walking on a static base, reuse that floor
+	 * (adjusted for their change in height) instead of finding the floor again. Zero disables floor reuse.
+	 * @see SimulatedProxyFloorReuseMaxAge
+	 */
+	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0", UIMin="0", ForceUnits=cm))
+	float SimulatedProxyFloorReuseDistance;
+
+	/** Max time in seconds a simulated proxy reuses a floor result before finding the floor again. */
+	UPROPERTY(Category="Character Movement (Networking)", EditDefaultsOnly, AdvancedDisplay, meta=(ClampMin="0", UIMin="0", ForceUnits=s))
+	float SimulatedProxyFloorReuseMaxAge;
+
+	/**
+	 * If true, non-player characters with authority and simulated proxies that are far from local viewers or not recently rendered
+	 * run their movement at a reduced rate, as set by MovementLODLevels. Visuals are interpolated between updates.
+	 * Requires p.CharacterMovementLOD to be enabled.
+	 */
+	UPROPERTY(Category="Character Movement: LOD", EditAnywhere, BlueprintReadWrite)
+	uint8 bEnableMovementLOD:1;
+
+	/**
+	 * If true, simulated proxies at a reduced movement LOD do not simulate root motion montages, and instead snap to the replicated
+	 * root motion moves with network smoothing. If false, proxies playing root motion always update at full rate.
+	 */
+	UPROPERTY(Category="Character Movement: LOD", EditAnywhere, BlueprintReadWrite)
+	uint8 bMovementLODLightweightProxies:1;
+
+	/** Reduced rate movement LOD levels, in order of increasing distance. Level 0 (full rate) is implied below the first entry. */
+	UPROPERTY(Category="Character Movement: LOD", EditAnywhere, BlueprintReadWrite)
+	TArray<FCharacterMovementLODLevel> MovementLODLevels;
+
+	/** Characters that were not rendered for this many seconds use at least the first reduced movement LOD. Zero ignores render time. */
+	UPROPERTY(Category="Character Movement: LOD", EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", UIMin="0", ForceUnits=s))
+	float MovementLODNotRenderedTime;
+
+	/** Optional game callback to scale the viewer distance used to pick the movement LOD. */
+	static FCharacterMovementLODSignificanceDelegate OnCalculateMovementLODSignificance;
+
 	/**
 	 * Default movement mode when not in water. Used at player startup or when teleported.
 	 * @see DefaultWaterMovementMode
@@ -995,6 +1073,15 @@ public:
 	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
 	uint8 bUseFlatBaseForFloorChecks:1;
 
+	/**
+	 * If true, a floor sweep at the location predicted for the next update is submitted as an async trace at the end of each walking movement update.
+	 * Async traces for all characters run in parallel at the end of the frame, and the next FindFloor() within BatchedFloorQueryTolerance of the
+	 * predicted location uses that result instead of sweeping on the game thread. Requires p.BatchedFloorQueries to be enabled.
+	 * @see BatchedFloorQueryTolerance
+	 */
+	UPROPERTY(Category="Character Movement: Walking", EditAnywhere, BlueprintReadWrite, AdvancedDisplay)
+	uint8 bUseBatchedFloorQueries:1;
+
 	/** Used to prevent reentry of JumpOff() */
 	UPROPERTY()
 	uint8 bPerformingJumpOff:1;
@@ -1061,6 +1148,43 @@ protected:
 	/** remaining time of avoidance velocity lock */
 	float AvoidanceLockTimer;
 
+	/** Async floor sweep submitted at the end of the last movement update, resolved at the start of the next one. */
+	FTraceHandle BatchedFloorQueryHandle;
+
+	/** Result of the batched floor sweep resolved by this frame's movement update, and where the sweep started and ended. */
+	FHitResult BatchedFloorHit;
+	FVector BatchedFloorTraceStart;
+	FVector BatchedFloorTraceEnd;
+
+	/** How much larger than the pawn's capsule the batched floor sweep was, so it covers every capsule within that distance of the prediction. */
+	float BatchedFloorTraceInflation;
+
+	/** Frame BatchedFloorHit was resolved on, it is not used on any other frame. */
+	uint64 BatchedFloorHitFrame;
+
+	/** Location, world time and floor distance of the last full floor check on a simulated proxy, used for floor reuse. */
+	FVector SimulatedProxyFloorLocation;
+	float SimulatedProxyFloorTime;
+	float SimulatedProxyFloorDist;
+
+	/** Floor hit of the last full floor check on a simulated proxy, moved along with the proxy when the floor is reused. */
+	FHitResult SimulatedProxyFloorHit;
+
+	/** Current movement LOD level, 0 being full rate. */
+	int32 MovementLODLevel;
+
+	/** Time accumulated since the last movement update while at a reduced movement LOD. */
+	float MovementLODAccumulatedTime;
+
+	/** World time at which the movement LOD level is next recalculated. */
+	float MovementLODNextCheckTime;
+
+	/** Mesh offset in capsule space hiding the jump of the last reduced rate movement update, blended out until the next update. */
+	FVector MovementLODMeshOffset;
+
+	/** Running average cost of a full movement update in seconds, used to report the time saved by movement LOD. */
+	float MovementLODAverageUpdateTime;
+
 public:
 
 	UPROPERTY(Category="Character Movement: Avoidance", EditAnywhere, BlueprintReadOnly)
@@ -2004,6 +2128,56 @@ public:
 
 protected:
 
+	/**
+	 * Submit an async floor sweep at the location predicted for the next movement update, if bUseBatchedFloorQueries is enabled.
+	 * The result is used by the next FindFloor() if it is within BatchedFloorQueryTolerance of the prediction.
+	 */
+	virtual void SubmitBatchedFloorQuery(float DeltaSeconds);
+
+	/**
+	 * Take the batched floor sweep submitted by the last movement update, keeping its hit for FindFloor() during this update.
+	 * Hits on dynamic bases are dropped, as the base may have moved since the sweep ran, so FindFloor() sweeps again.
+	 */
+	void ResolveBatchedFloorQuery();
+
+	/**
+	 * Check the batched floor sweep resolved this frame is usable as a downward sweep result at CapsuleLocation.
+	 * @return True if OutHit contains a walkable floor hit that can be passed to ComputeFloorDist() as the downward sweep result.
+	 */
+	bool GetBatchedFloorHit(const FVector& CapsuleLocation, float SweepDistance, FHitResult& OutHit) const;
+
+	/**
+	 * Whether a simulated proxy at CapsuleLocation can reuse its last floor check instead of finding the floor again.
+	 * Only flat floors are reused, the floor hit is moved horizontally with the proxy so it has to still be valid there.
+	 */
+	virtual bool CanReuseSimulatedProxyFloor(const FVector& CapsuleLocation) const;
+
+	/** Whether movement LOD can currently reduce the update rate of this character. */
+	virtual bool IsMovementLODAllowed() const;
+
+	/** Pick the movement LOD level from distance to local viewers, render time and significance. */
+	virtual int32 CalculateMovementLODLevel() const;
+
+	/**
+	 * Advance movement LOD for this frame.
+	 * @param DeltaTime				Frame time.
+	 * @param OutMovementDeltaTime	[Out] Time to simulate if movement should update this frame, including time accumulated over skipped frames.
+	 * @return True if movement should update this frame.
+	 */
+	bool TickMovementLOD(float DeltaTime, float& OutMovementDeltaTime);
+
+	/** Interpolate visuals on frames skipped by movement LOD. */
+	virtual void InterpolateMovementLOD(float DeltaTime);
+
+	/** Called after a movement update while movement LOD is allowed, to set up interpolation and track update cost. */
+	void FinishMovementLODUpdate(const FVector& OldLocation, const FQuat& OldRotation, uint32 StartCycles);
+
+	/** Apply MovementLODMeshOffset to the character mesh. */
+	void ApplyMovementLODMeshOffset();
+
+	/** Whether this simulated proxy runs without root motion because of its movement LOD. */
+	bool IsUsingLightweightProxySimulation() const;
+
 	/** Called when the collision capsule touches another primitive component */
 	UFUNCTION()
 	virtual void CapsuleTouched(UPrimitiveComponent* OverlappedComp, AActor* Other, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -21,6 +21,9 @@ class ENGINE_API UMaterialInstanceDynamic : public UMaterialInstance
 	UFUNCTION(BlueprintCallable, meta = (Keywords = "SetFloatParameterValue"), Category = "Rendering|Material")
 	void SetScalarParameterValueByInfo(const FMaterialParameterInfo& ParameterInfo, float Value);
 
+	/** Set several MID scalar (float) parameter values, updating the render thread once for all of them */
+	void SetScalarParameterValues(TArrayView<const TPair<FName, float>> Parameters);
+
 	// NOTE: These Index-related functions should be used VERY carefully, and only in cases where optimization is
 	// critical.  Generally that's only if you're using an unusually high number of parameters in a material AND
 	// setting a huge number of parameters in the same frame.
@@ -11,9 +11,20 @@
 #include "Misc/FeedbackContext.h"
 #include "AnimationCompression.h"
 #include "AnimEncoding.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadSingleton.h"
 
 DEFINE_LOG_CATEGORY(LogAnimationCompression);
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Key Pair Cache Hits"), STAT_AnimKeyPairCacheHits, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Key Pair Cache Misses"), STAT_AnimKeyPairCacheMisses, STATGROUP_Anim);
+
+static TAutoConsoleVariable<int32> CVarKeyPairCacheSize(
+	TEXT("a.Decompression.KeyPairCacheSize"),
+	0,
+	TEXT("Number of sequences per thread whose keys on either side of the last decompressed time are kept decoded, so decompressing them again between the same two frames only interpolates. 0 disables the cache."),
+	ECVF_Default);
+
 UAnimCompress::UAnimCompress(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -666,10 +677,8 @@ void UAnimCompress::ByteSwapOut(ICompressedAnimData& AnimData, TArrayView<uint8>
 	static_cast<FUECompressedAnimData&>(AnimData).ByteSwapOut(CompressedData, MemoryStream);
 }
 
-void UAnimCompress::DecompressPose(FAnimSequenceDecompressionContext& DecompContext, const BoneTrackArray& RotationPairs, const BoneTrackArray& TranslationPairs, const BoneTrackArray& ScalePairs, TArrayView<FTransform>& OutAtoms) const
+static void DecompressPoseFromCodecs(const FUECompressedAnimData& AnimData, FAnimSequenceDecompressionContext& DecompContext, const BoneTrackArray& RotationPairs, const BoneTrackArray& TranslationPairs, const BoneTrackArray& ScalePairs, TArrayView<FTransform>& OutAtoms)
 {
-	const FUECompressedAnimData& AnimData = static_cast<const FUECompressedAnimData&>(DecompContext.CompressedAnimData);
-
 	AnimData.TranslationCodec->GetPoseTranslations(OutAtoms, TranslationPairs, DecompContext);
 
 	AnimData.RotationCodec->GetPoseRotations(OutAtoms, RotationPairs, DecompContext);
@@ -680,6 +689,241 @@ void UAnimCompress::DecompressPose(FAnimSequenceDecompressionContext& DecompCont
 	}
 }
 
+/** Which components of a track's key have been decoded */
+enum EDecodedKeyComponents : uint8
+{
+	DecodedKey_Rotation = 1 << 0,
+	DecodedKey_Translation = 1 << 1,
+	DecodedKey_Scale = 1 << 2,
+};
+
+/**
+ * The tracks of one sequence decoded at the two frames surrounding the last time it was decompressed at. Tracks are decoded the first time
+ * a request needs them, so bone containers asking for different tracks of the same sequence share the entry.
+ */
+struct FDecodedKeyPair
+{
+	const FUECompressedAnimData* AnimData = nullptr;
+	uint32 DecompressionCacheId = 0;
+	uint32 LastUsed = 0;
+
+	/** Frames of the keys in slot 0 and 1, indexed by track */
+	int32 Frames[2] = { INDEX_NONE, INDEX_NONE };
+	TArray<FTransform> Keys[2];
+	TArray<uint8> DecodedComponents[2];
+
+	void Reset(const FUECompressedAnimData& InAnimData)
+	{
+		AnimData = &InAnimData;
+		DecompressionCacheId = InAnimData.DecompressionCacheId;
+		Frames[0] = Frames[1] = INDEX_NONE;
+
+		const int32 NumTracks = InAnimData.CompressedTrackOffsets.Num() / (InAnimData.KeyEncodingFormat == AKF_PerTrackCompression ? 2 : 4);
+		for (int32 Slot = 0; Slot < 2; ++Slot)
+		{
+			Keys[Slot].Reset(NumTracks);
+			Keys[Slot].SetNum(NumTracks);
+			DecodedComponents[Slot].Reset(NumTracks);
+			DecodedComponents[Slot].SetNumZeroed(NumTracks);
+		}
+	}
+
+	/** Moves the entry to a new pair of frames, keeping the decoded keys of a frame it already has */
+	void SetFrames(const int32 Frame0, const int32 Frame1)
+	{
+		if (Frames[0] == Frame0 && Frames[1] == Frame1)
+		{
+			return;
+		}
+
+		if (Frames[0] == Frame0)
+		{
+			FMemory::Memzero(DecodedComponents[1].GetData(), DecodedComponents[1].Num());
+		}
+		else if (Frames[1] == Frame0)
+		{
+			// Playing forward, the later key of the previous pair is the earlier key of this one
+			Swap(Keys[0], Keys[1]);
+			Swap(DecodedComponents[0], DecodedComponents[1]);
+			FMemory::Memzero(DecodedComponents[1].GetData(), DecodedComponents[1].Num());
+		}
+		else
+		{
+			FMemory::Memzero(DecodedComponents[0].GetData(), DecodedComponents[0].Num());
+			FMemory::Memzero(DecodedComponents[1].GetData(), DecodedComponents[1].Num());
+		}
+
+		Frames[0] = Frame0;
+		Frames[1] = Frame1;
+	}
+};
+
+struct FKeyPairCache : public TThreadSingleton<FKeyPairCache>
+{
+	TArray<FDecodedKeyPair> Entries;
+	uint32 UseCount = 0;
+
+	/** Tracks missing from each slot, as pairs writing to the track's own index in the slot's keys */
+	BoneTrackArray MissingRotationPairs[2];
+	BoneTrackArray MissingTranslationPairs[2];
+	BoneTrackArray MissingScalePairs[2];
+
+	FDecodedKeyPair& FindOrAdd(const FUECompressedAnimData& AnimData, const int32 MaxEntries)
+	{
+		if (Entries.Num() > MaxEntries)
+		{
+			Entries.SetNum(MaxEntries);
+		}
+
+		++UseCount;
+
+		int32 LeastRecentlyUsedIndex = INDEX_NONE;
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			FDecodedKeyPair& Entry = Entries[EntryIndex];
+			// Compressed data freed since can leave its address to new data, which gets a new id
+			if (Entry.AnimData == &AnimData && Entry.DecompressionCacheId == AnimData.DecompressionCacheId)
+			{
+				Entry.LastUsed = UseCount;
+				return Entry;
+			}
+
+			if (LeastRecentlyUsedIndex == INDEX_NONE || Entry.LastUsed < Entries[LeastRecentlyUsedIndex].LastUsed)
+			{
+				LeastRecentlyUsedIndex = EntryIndex;
+			}
+		}
+
+		FDecodedKeyPair& Entry = Entries.Num() < MaxEntries ? Entries.AddDefaulted_GetRef() : Entries[LeastRecentlyUsedIndex];
+		Entry.Reset(AnimData);
+		Entry.LastUsed = UseCount;
+		return Entry;
+	}
+};
+
+static void GatherMissingKeys(FDecodedKeyPair& Entry, const BoneTrackArray& Pairs, const uint8 Component, const int32 NumSlots, BoneTrackArray (&OutMissingPairs)[2])
+{
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		OutMissingPairs[Slot].Reset();
+
+		uint8* DecodedComponents = Entry.DecodedComponents[Slot].GetData();
+		for (const BoneTrackPair& Pair : Pairs)
+		{
+			if ((DecodedComponents[Pair.TrackIndex] & Component) == 0)
+			{
+				DecodedComponents[Pair.TrackIndex] |= Component;
+				OutMissingPairs[Slot].Add(BoneTrackPair(Pair.TrackIndex, Pair.TrackIndex));
+			}
+		}
+	}
+}
+
+/**
+ * Decompresses a pose by interpolating between the keys decoded at the frames on either side of the time, decoding the ones this thread
+ * doesn't have yet. Keys are sampled at frames, so the result matches the codecs' for tracks keyed on frames, which is every track of the
+ * UE codecs but the ones a constant key lerp reduction left with keys between frames, and those stay within a fraction of a frame of it.
+ */
+static void DecompressPoseFromKeyPairCache(const FUECompressedAnimData& AnimData, const int32 MaxEntries, FAnimSequenceDecompressionContext& DecompContext, const BoneTrackArray& RotationPairs, const BoneTrackArray& TranslationPairs, const BoneTrackArray& ScalePairs, TArrayView<FTransform>& OutAtoms)
+{
+	// Same frame search TimeToIndex does for a track with a key on every frame
+	const int32 LastFrame = AnimData.CompressedNumberOfFrames - 1;
+	int32 Frame0 = 0;
+	int32 Frame1 = 0;
+	float Alpha = 0.0f;
+	if (DecompContext.RelativePos >= 1.0f)
+	{
+		Frame0 = Frame1 = LastFrame;
+	}
+	else if (DecompContext.RelativePos > 0.0f)
+	{
+		const float FramePos = DecompContext.RelativePos * (float)LastFrame;
+		const float FramePosFloor = FMath::FloorToFloat(FramePos);
+		Frame0 = FMath::Min(FMath::TruncToInt(FramePosFloor), LastFrame);
+		Frame1 = FMath::Min(Frame0 + 1, LastFrame);
+		Alpha = DecompContext.Interpolation == EAnimInterpolationType::Step ? 0.0f : FramePos - FramePosFloor;
+	}
+
+	FKeyPairCache& Cache = FKeyPairCache::Get();
+	FDecodedKeyPair& Entry = Cache.FindOrAdd(AnimData, MaxEntries);
+	Entry.SetFrames(Frame0, Frame1);
+
+	const bool bHasScale = AnimData.CompressedScaleOffsets.IsValid();
+	const int32 NumSlots = Frame0 != Frame1 ? 2 : 1;
+	GatherMissingKeys(Entry, RotationPairs, DecodedKey_Rotation, NumSlots, Cache.MissingRotationPairs);
+	GatherMissingKeys(Entry, TranslationPairs, DecodedKey_Translation, NumSlots, Cache.MissingTranslationPairs);
+	if (bHasScale)
+	{
+		GatherMissingKeys(Entry, ScalePairs, DecodedKey_Scale, NumSlots, Cache.MissingScalePairs);
+	}
+
+	bool bMissed = false;
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		if (Cache.MissingRotationPairs[Slot].Num() == 0 && Cache.MissingTranslationPairs[Slot].Num() == 0 && (!bHasScale || Cache.MissingScalePairs[Slot].Num() == 0))
+		{
+			continue;
+		}
+		bMissed = true;
+
+		// Nudged past the frame so float error can't land the codecs' key search on the key before it
+		FAnimSequenceDecompressionContext FrameContext(DecompContext.SequenceLength, DecompContext.Interpolation, DecompContext.AnimName, DecompContext.CompressedAnimData);
+		FrameContext.Time = DecompContext.SequenceLength * (float)Entry.Frames[Slot] / (float)LastFrame;
+		FrameContext.RelativePos = Entry.Frames[Slot] == LastFrame ? 1.0f : ((float)Entry.Frames[Slot] + KINDA_SMALL_NUMBER) / (float)LastFrame;
+
+		TArrayView<FTransform> Keys(Entry.Keys[Slot]);
+		DecompressPoseFromCodecs(AnimData, FrameContext, Cache.MissingRotationPairs[Slot], Cache.MissingTranslationPairs[Slot], Cache.MissingScalePairs[Slot], Keys);
+	}
+
+	if (bMissed)
+	{
+		INC_DWORD_STAT(STAT_AnimKeyPairCacheMisses);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_AnimKeyPairCacheHits);
+	}
+
+	const FTransform* Keys0 = Entry.Keys[0].GetData();
+	const FTransform* Keys1 = Entry.Keys[NumSlots - 1].GetData();
+
+	for (const BoneTrackPair& Pair : TranslationPairs)
+	{
+		OutAtoms[Pair.AtomIndex].SetTranslation(FMath::Lerp(Keys0[Pair.TrackIndex].GetTranslation(), Keys1[Pair.TrackIndex].GetTranslation(), Alpha));
+	}
+
+	for (const BoneTrackPair& Pair : RotationPairs)
+	{
+		// Fast linear quaternion interpolation, as the codecs do
+		FQuat BlendedQuat = FQuat::FastLerp(Keys0[Pair.TrackIndex].GetRotation(), Keys1[Pair.TrackIndex].GetRotation(), Alpha);
+		BlendedQuat.Normalize();
+		OutAtoms[Pair.AtomIndex].SetRotation(BlendedQuat);
+	}
+
+	if (bHasScale)
+	{
+		for (const BoneTrackPair& Pair : ScalePairs)
+		{
+			OutAtoms[Pair.AtomIndex].SetScale3D(FMath::Lerp(Keys0[Pair.TrackIndex].GetScale3D(), Keys1[Pair.TrackIndex].GetScale3D(), Alpha));
+		}
+	}
+}
+
+void UAnimCompress::DecompressPose(FAnimSequenceDecompressionContext& DecompContext, const BoneTrackArray& RotationPairs, const BoneTrackArray& TranslationPairs, const BoneTrackArray& ScalePairs, TArrayView<FTransform>& OutAtoms) const
+{
+	const FUECompressedAnimData& AnimData = static_cast<const FUECompressedAnimData&>(DecompContext.CompressedAnimData);
+
+	const int32 KeyPairCacheSize = CVarKeyPairCacheSize.GetValueOnAnyThread();
+	if (KeyPairCacheSize > 0 && AnimData.CompressedNumberOfFrames > 1)
+	{
+		DecompressPoseFromKeyPairCache(AnimData, KeyPairCacheSize, DecompContext, RotationPairs, TranslationPairs, ScalePairs, OutAtoms);
+	}
+	else
+	{
+		DecompressPoseFromCodecs(AnimData, DecompContext, RotationPairs, TranslationPairs, ScalePairs, OutAtoms);
+	}
+}
+
 void UAnimCompress::DecompressBone(FAnimSequenceDecompressionContext& DecompContext, int32 TrackIndex, FTransform& OutAtom) const
 {
 	// Initialize to identity to set the scale and in case of a missing rotation or translation codec
@@ -11,6 +11,7 @@
 #include "Animation/AnimCurveCompressionSettings.h"
 #include "AnimationRuntime.h"
 #include "UObject/FortniteMainBranchObjectVersion.h"
+#include "HAL/ThreadSafeCounter.h"
 
 CSV_DECLARE_CATEGORY_MODULE_EXTERN(ENGINE_API, Animation);
 
@@ -272,6 +273,14 @@ void FUECompressedAnimData::InitViewsFromBuffer(const TArrayView<uint8> BulkData
 	InitArrayView(CompressedByteStream, BulkDataPtr);
 
 	check((BulkDataPtr - BulkData.GetData()) == BulkData.Num());
+
+	DecompressionCacheId = MakeDecompressionCacheId();
+}
+
+uint32 FUECompressedAnimData::MakeDecompressionCacheId()
+{
+	static FThreadSafeCounter NextDecompressionCacheId;
+	return (uint32)NextDecompressionCacheId.Increment();
 }
 
 template<typename T>
@@ -879,6 +888,57 @@ void DecompressPose(FCompactPose& OutPose, const FCompressedAnimSequence& Compre
 	}
 }
 
+void DecompressPose(const FAnimPoseDecompressionRequest& Request)
+{
+	DecompressPose(*Request.OutPose, *Request.CompressedData, *Request.ExtractionContext, Request.Skeleton, Request.SequenceLength, Request.Interpolation, Request.bIsBakedAdditive,
+		*Request.RetargetTransforms, Request.SourceName, Request.RootMotionReset);
+}
+
+/** Touches what DecompressPose reads first for a request, so it is on its way to the cache while the previous request decodes */
+static void PrefetchDecompressionRequest(const FAnimPoseDecompressionRequest& Request)
+{
+	FPlatformMisc::Prefetch(Request.CompressedData->CompressedTrackToSkeletonMapTable.GetData());
+	FPlatformMisc::Prefetch(Request.CompressedData->CompressedDataStructure.Get());
+	FPlatformMisc::Prefetch(Request.OutPose->GetBoneContainer().GetSkeletonToPoseBoneIndexArray().GetData());
+	FPlatformMisc::Prefetch(Request.OutPose->GetBones().GetData());
+}
+
+void DecompressPoses(TArrayView<const FAnimPoseDecompressionRequest> Requests)
+{
+	const int32 NumRequests = Requests.Num();
+	if (NumRequests == 0)
+	{
+		return;
+	}
+
+	// Group requests by sequence and sort them by time, so the decompression key pair cache decodes the keys surrounding a time once
+	// for every request near it, and a sequence moving forward reuses the later key of the previous pair
+	TArray<int32, TInlineAllocator<16>> Order;
+	Order.SetNumUninitialized(NumRequests);
+	for (int32 RequestIndex = 0; RequestIndex < NumRequests; ++RequestIndex)
+	{
+		Order[RequestIndex] = RequestIndex;
+	}
+
+	Order.Sort([&Requests](const int32 A, const int32 B)
+	{
+		const ICompressedAnimData* DataA = Requests[A].CompressedData->CompressedDataStructure.Get();
+		const ICompressedAnimData* DataB = Requests[B].CompressedData->CompressedDataStructure.Get();
+		return DataA != DataB ? DataA < DataB : Requests[A].ExtractionContext->CurrentTime < Requests[B].ExtractionContext->CurrentTime;
+	});
+
+	PrefetchDecompressionRequest(Requests[Order[0]]);
+	for (int32 OrderIndex = 0; OrderIndex < NumRequests; ++OrderIndex)
+	{
+		if (OrderIndex + 1 < NumRequests)
+		{
+			PrefetchDecompressionRequest(Requests[Order[OrderIndex + 1]]);
+		}
+
+		DecompressPose(Requests[Order[OrderIndex]]);
+	}
+}
+
 FArchive& operator<<(FArchive& Ar, FCompressedOffsetData& D)
 {
 	Ar << D.OffsetData << D.StripSize;
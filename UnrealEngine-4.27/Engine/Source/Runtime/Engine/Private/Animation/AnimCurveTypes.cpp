@@ -4,9 +4,168 @@
 #include "UObject/FrameworkObjectVersion.h"
 #include "UObject/AnimObjectVersion.h"
 #include "Math/RandomStream.h"
+#include "HAL/IConsoleManager.h"
+#if INTEL_ISPC
+#include "AnimCurveTypes.ispc.generated.h"
+#endif
 
 DECLARE_CYCLE_STAT(TEXT("EvalRawCurveData"), STAT_EvalRawCurveData, STATGROUP_Anim);
 
+#if INTEL_ISPC
+static TAutoConsoleVariable<int32> CVarCurveBlendingISPC(
+	TEXT("a.CurveBlending.ISPC"),
+	1,
+	TEXT("If 1, blended curve lerps, additives and overrides run through the ISPC kernels that blend a vector of curves at a time. If 0, they run a curve at a time."),
+	ECVF_Default);
+#endif
+
+/** Whether the FBlendedCurveKernels below go through the ISPC kernels */
+static FORCEINLINE bool UseCurveBlendingISPC()
+{
+#if INTEL_ISPC
+	return CVarCurveBlendingISPC.GetValueOnAnyThread() != 0;
+#else
+	return false;
+#endif
+}
+
+/////////////////////////////////////////////////////
+// FBlendedCurveKernels
+
+static FORCEINLINE bool IsCurveValid(const uint32 ValidWord, const int32 Bit)
+{
+	return ((ValidWord >> Bit) & 1) != 0;
+}
+
+void FBlendedCurveKernels::Lerp(float* OutWeights, uint32* OutValid, const float* WeightsA, const uint32* ValidA, const float* WeightsB, const uint32* ValidB, float Alpha, int32 Num)
+{
+	if (UseCurveBlendingISPC())
+	{
+#if INTEL_ISPC
+		ispc::LerpCurves(OutWeights, OutValid, WeightsA, ValidA, WeightsB, ValidB, Alpha, Num);
+#endif
+	}
+	else
+	{
+		for (int32 Word = 0; Word * NumBitsPerDWORD < Num; ++Word)
+		{
+			const uint32 Valid = ValidA[Word] | ValidB[Word];
+			OutValid[Word] = Valid;
+
+			const int32 FirstCurve = Word * NumBitsPerDWORD;
+			const int32 NumWordCurves = FMath::Min<int32>(NumBitsPerDWORD, Num - FirstCurve);
+			for (int32 Bit = 0; Bit < NumWordCurves; ++Bit)
+			{
+				const int32 Curve = FirstCurve + Bit;
+				OutWeights[Curve] = IsCurveValid(Valid, Bit) ? FMath::Lerp(WeightsA[Curve], WeightsB[Curve], Alpha) : 0.f;
+			}
+		}
+	}
+}
+
+void FBlendedCurveKernels::LerpTo(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, float Alpha, int32 Num)
+{
+	if (UseCurveBlendingISPC())
+	{
+#if INTEL_ISPC
+		ispc::LerpCurvesTo(Weights, Valid, OtherWeights, OtherValid, Alpha, Num);
+#endif
+	}
+	else
+	{
+		for (int32 Word = 0; Word * NumBitsPerDWORD < Num; ++Word)
+		{
+			const uint32 EitherValid = Valid[Word] | OtherValid[Word];
+			Valid[Word] = EitherValid;
+
+			const int32 FirstCurve = Word * NumBitsPerDWORD;
+			const int32 NumWordCurves = FMath::Min<int32>(NumBitsPerDWORD, Num - FirstCurve);
+			for (int32 Bit = 0; Bit < NumWordCurves; ++Bit)
+			{
+				const int32 Curve = FirstCurve + Bit;
+				Weights[Curve] = IsCurveValid(EitherValid, Bit) ? FMath::Lerp(Weights[Curve], OtherWeights[Curve], Alpha) : Weights[Curve];
+			}
+		}
+	}
+}
+
+void FBlendedCurveKernels::Accumulate(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, float Scale, int32 Num)
+{
+	if (UseCurveBlendingISPC())
+	{
+#if INTEL_ISPC
+		ispc::AccumulateCurves(Weights, Valid, OtherWeights, OtherValid, Scale, Num);
+#endif
+	}
+	else
+	{
+		for (int32 Word = 0; Word * NumBitsPerDWORD < Num; ++Word)
+		{
+			const uint32 EitherValid = Valid[Word] | OtherValid[Word];
+			Valid[Word] = EitherValid;
+
+			const int32 FirstCurve = Word * NumBitsPerDWORD;
+			const int32 NumWordCurves = FMath::Min<int32>(NumBitsPerDWORD, Num - FirstCurve);
+			for (int32 Bit = 0; Bit < NumWordCurves; ++Bit)
+			{
+				const int32 Curve = FirstCurve + Bit;
+				Weights[Curve] = IsCurveValid(EitherValid, Bit) ? Weights[Curve] + OtherWeights[Curve] * Scale : Weights[Curve];
+			}
+		}
+	}
+}
+
+void FBlendedCurveKernels::Combine(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, int32 Num)
+{
+	if (UseCurveBlendingISPC())
+	{
+#if INTEL_ISPC
+		ispc::CombineCurves(Weights, Valid, OtherWeights, OtherValid, Num);
+#endif
+	}
+	else
+	{
+		for (int32 Word = 0; Word * NumBitsPerDWORD < Num; ++Word)
+		{
+			const uint32 ValidToCombine = OtherValid[Word];
+			Valid[Word] |= ValidToCombine;
+
+			const int32 FirstCurve = Word * NumBitsPerDWORD;
+			const int32 NumWordCurves = FMath::Min<int32>(NumBitsPerDWORD, Num - FirstCurve);
+			for (int32 Bit = 0; Bit < NumWordCurves; ++Bit)
+			{
+				const int32 Curve = FirstCurve + Bit;
+				Weights[Curve] = IsCurveValid(ValidToCombine, Bit) ? OtherWeights[Curve] : Weights[Curve];
+			}
+		}
+	}
+}
+
+void FBlendedCurveKernels::Scale(float* Weights, const uint32* Valid, float Scale, int32 Num)
+{
+	if (UseCurveBlendingISPC())
+	{
+#if INTEL_ISPC
+		ispc::ScaleCurves(Weights, Valid, Scale, Num);
+#endif
+	}
+	else
+	{
+		for (int32 Word = 0; Word * NumBitsPerDWORD < Num; ++Word)
+		{
+			const uint32 ValidToScale = Valid[Word];
+
+			const int32 FirstCurve = Word * NumBitsPerDWORD;
+			const int32 NumWordCurves = FMath::Min<int32>(NumBitsPerDWORD, Num - FirstCurve);
+			for (int32 Bit = 0; Bit < NumWordCurves; ++Bit)
+			{
+				const int32 Curve = FirstCurve + Bit;
+				Weights[Curve] = IsCurveValid(ValidToScale, Bit) ? Weights[Curve] * Scale : Weights[Curve];
+			}
+		}
+	}
+}
+
 /////////////////////////////////////////////////////
 // FFloatCurve
 
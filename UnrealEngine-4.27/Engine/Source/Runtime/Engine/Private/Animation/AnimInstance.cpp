@@ -42,6 +42,7 @@ DEFINE_STAT(STAT_UpdateRBJoints);
 DEFINE_STAT(STAT_FinalizeAnimationUpdate);
 DEFINE_STAT(STAT_GetAnimationPose);
 DEFINE_STAT(STAT_AnimTriggerAnimNotifies);
+DEFINE_STAT(STAT_AnimNotifiesTriggered);
 DEFINE_STAT(STAT_RefreshBoneTransforms);
 DEFINE_STAT(STAT_InterpolateSkippedFrames);
 DEFINE_STAT(STAT_AnimTickTime);
@@ -1348,12 +1349,15 @@ void UAnimInstance::TriggerAnimNotifies(float DeltaSeconds)
 	SCOPE_CYCLE_COUNTER(STAT_AnimTriggerAnimNotifies);
 	USkeletalMeshComponent* SkelMeshComp = GetSkelMeshComponent();
 
-	// Array that will replace the 'ActiveAnimNotifyState' at the end of this function.
-	TArray<FAnimNotifyEvent> NewActiveAnimNotifyState;
-	NewActiveAnimNotifyState.Reserve(NotifyQueue.AnimNotifies.Num());
+	INC_DWORD_STAT_BY(STAT_AnimNotifiesTriggered, NotifyQueue.AnimNotifies.Num());
+
+	// Array that will replace the 'ActiveAnimNotifyState' at the end of this function. Swapped with it rather than moved, so both
+	// keep their allocation from tick to tick.
+	TArray<FAnimNotifyEvent> NewActiveAnimNotifyState = MoveTemp(PendingAnimNotifyState);
+	NewActiveAnimNotifyState.Reset();
 
 	// AnimNotifyState freshly added that need their 'NotifyBegin' event called.
-	TArray<const FAnimNotifyEvent *> NotifyStateBeginEvent;
+	TArray<const FAnimNotifyEvent *, TInlineAllocator<8>> NotifyStateBeginEvent;
 
 	for (int32 Index=0; Index<NotifyQueue.AnimNotifies.Num(); Index++)
 	{
@@ -1405,8 +1409,10 @@ void UAnimInstance::TriggerAnimNotifies(float DeltaSeconds)
 		}
 	}
 
-	// Switch our arrays.
-	ActiveAnimNotifyState = MoveTemp(NewActiveAnimNotifyState);
+	// Switch our arrays, keeping the old one's allocation for the next tick.
+	Swap(ActiveAnimNotifyState, NewActiveAnimNotifyState);
+	NewActiveAnimNotifyState.Reset();
+	PendingAnimNotifyState = MoveTemp(NewActiveAnimNotifyState);
 
 	// Tick currently active AnimNotifyState
 	for(const FAnimNotifyEvent& AnimNotifyEvent : ActiveAnimNotifyState)
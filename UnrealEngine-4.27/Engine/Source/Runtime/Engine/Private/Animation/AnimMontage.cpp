@@ -2430,7 +2430,8 @@ void FAnimMontageInstance::HandleEvents(float PreviousTrackPos, float CurrentTra
 	// now get active Notifies based on how it advanced
 	if (AnimInstance.IsValid())
 	{
-		TArray<FAnimNotifyEventReference> NotitfyRefs;
+		FScopedAnimNotifyScratch NotifyScratch;
+		TArray<FAnimNotifyEventReference>& NotitfyRefs = NotifyScratch.Get();
 		TMap<FName, TArray<FAnimNotifyEventReference>> NotifyMap;
 
 		// We already break up AnimMontage update to handle looping, so we guarantee that PreviousPos and CurrentPos are contiguous.
@@ -0,0 +1,213 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/AnimNotifyBatchSubsystem.h"
+#include "Animation/AnimStats.h"
+#include "Animation/AnimNotifies/AnimNotify_PlayParticleEffect.h"
+#include "Animation/AnimNotifies/AnimNotify_PlaySound.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+
+DEFINE_STAT(STAT_AnimNotifyBatchFlush);
+DEFINE_STAT(STAT_AnimNotifyBatchSounds);
+DEFINE_STAT(STAT_AnimNotifyBatchParticleSystems);
+DEFINE_STAT(STAT_AnimNotifyBatchDropped);
+
+static TAutoConsoleVariable<int32> CVarAnimNotifyBatchSpawns(
+	TEXT("a.Notify.BatchSpawns"),
+	0,
+	TEXT("If 1, sounds and particle systems from play sound and play particle effect notifies are queued while actors tick and spawned together, grouped by asset, once they have all ticked."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimNotifyMaxSpawnsPerAsset(
+	TEXT("a.Notify.MaxSpawnsPerAsset"),
+	0,
+	TEXT("When batching notify spawns, the most times one sound or particle system is spawned in a frame, in the order the notifies fired. 0 for no limit."),
+	ECVF_Default);
+
+bool UAnimNotifyBatchSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	// Editor previews spawn straight away, so scrubbing plays what is under the cursor
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAnimNotifyBatchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UAnimNotifyBatchSubsystem::OnWorldPreActorTick);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UAnimNotifyBatchSubsystem::OnWorldPostActorTick);
+}
+
+void UAnimNotifyBatchSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	bInActorTick = false;
+
+	// The world is going away, nothing left to spawn into
+	SoundRequests.Empty();
+	ParticleSystemRequests.Empty();
+
+	Super::Deinitialize();
+}
+
+UAnimNotifyBatchSubsystem* UAnimNotifyBatchSubsystem::GetForComponent(const USkeletalMeshComponent* MeshComp)
+{
+	if (CVarAnimNotifyBatchSpawns.GetValueOnGameThread() == 0 || !MeshComp || !IsInGameThread())
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = MeshComp->GetWorld();
+	UAnimNotifyBatchSubsystem* Subsystem = World ? World->GetSubsystem<UAnimNotifyBatchSubsystem>() : nullptr;
+
+	// Only the post actor tick flushes, anything queued outside of the actor tick would wait for the world to tick actors again
+	return Subsystem && Subsystem->bInActorTick ? Subsystem : nullptr;
+}
+
+bool UAnimNotifyBatchSubsystem::QueueSound(UAnimNotify_PlaySound* Notify, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	UAnimNotifyBatchSubsystem* Subsystem = Notify && Notify->Sound ? GetForComponent(MeshComp) : nullptr;
+	if (!Subsystem)
+	{
+		return false;
+	}
+
+	FAnimNotifySpawnRequest Request;
+	Request.Notify = Notify;
+	Request.MeshComp = MeshComp;
+	Request.Animation = Animation;
+	Request.Asset = Notify->Sound;
+	Subsystem->AddSoundRequest(Request);
+	return true;
+}
+
+bool UAnimNotifyBatchSubsystem::QueueParticleSystem(UAnimNotify_PlayParticleEffect* Notify, USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	// Notifies without a template spawn straight away to log it
+	UAnimNotifyBatchSubsystem* Subsystem = Notify && Notify->PSTemplate ? GetForComponent(MeshComp) : nullptr;
+	if (!Subsystem)
+	{
+		return false;
+	}
+
+	FAnimNotifySpawnRequest Request;
+	Request.Notify = Notify;
+	Request.MeshComp = MeshComp;
+	Request.Animation = Animation;
+	Request.Asset = Notify->PSTemplate;
+	Subsystem->AddParticleSystemRequest(Request);
+	return true;
+}
+
+/**
+ * Spawns Requests one asset after the other, at most MaxSpawnsPerAsset of each if above 0, in the order they were queued within an
+ * asset. Requests whose component went away since are skipped. Returns the number spawned and leaves Requests empty.
+ */
+template<typename SpawnFunctionType>
+static int32 SpawnRequestsByAsset(TArray<FAnimNotifySpawnRequest>& Requests, const int32 MaxSpawnsPerAsset, int32& OutNumDropped, SpawnFunctionType&& SpawnFunction)
+{
+	Requests.StableSort([](const FAnimNotifySpawnRequest& A, const FAnimNotifySpawnRequest& B) { return A.Asset < B.Asset; });
+
+	int32 NumSpawned = 0;
+	int32 NumSpawnedForAsset = 0;
+	const UObject* CurrentAsset = nullptr;
+	for (const FAnimNotifySpawnRequest& Request : Requests)
+	{
+		if (Request.Asset != CurrentAsset)
+		{
+			CurrentAsset = Request.Asset;
+			NumSpawnedForAsset = 0;
+		}
+
+		if (!Request.Notify || !IsValid(Request.MeshComp) || !Request.MeshComp->IsRegistered())
+		{
+			continue;
+		}
+
+		if (MaxSpawnsPerAsset > 0 && NumSpawnedForAsset >= MaxSpawnsPerAsset)
+		{
+			++OutNumDropped;
+			continue;
+		}
+
+		SpawnFunction(Request);
+		++NumSpawnedForAsset;
+		++NumSpawned;
+	}
+
+	// Keep the allocation for the next frame
+	Requests.Reset();
+	return NumSpawned;
+}
+
+void UAnimNotifyBatchSubsystem::Flush()
+{
+	if (SoundRequests.Num() == 0 && ParticleSystemRequests.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AnimNotifyBatchFlush);
+
+	const int32 MaxSpawnsPerAsset = CVarAnimNotifyMaxSpawnsPerAsset.GetValueOnGameThread();
+	int32 NumDropped = 0;
+
+	// Requests added while spawning, when flushing during the actor tick for instance, go to the next flush
+	TArray<FAnimNotifySpawnRequest> Sounds = MoveTemp(SoundRequests);
+	TArray<FAnimNotifySpawnRequest> ParticleSystems = MoveTemp(ParticleSystemRequests);
+
+	const int32 NumSounds = SpawnRequestsByAsset(Sounds, MaxSpawnsPerAsset, NumDropped, [this](const FAnimNotifySpawnRequest& Request)
+	{
+		SpawnSound(Request);
+	});
+
+	const int32 NumParticleSystems = SpawnRequestsByAsset(ParticleSystems, MaxSpawnsPerAsset, NumDropped, [this](const FAnimNotifySpawnRequest& Request)
+	{
+		SpawnParticleSystem(Request);
+	});
+
+	// Hand the allocations back unless spawning queued more
+	if (SoundRequests.Num() == 0)
+	{
+		SoundRequests = MoveTemp(Sounds);
+	}
+	if (ParticleSystemRequests.Num() == 0)
+	{
+		ParticleSystemRequests = MoveTemp(ParticleSystems);
+	}
+
+	INC_DWORD_STAT_BY(STAT_AnimNotifyBatchSounds, NumSounds);
+	INC_DWORD_STAT_BY(STAT_AnimNotifyBatchParticleSystems, NumParticleSystems);
+	INC_DWORD_STAT_BY(STAT_AnimNotifyBatchDropped, NumDropped);
+}
+
+void UAnimNotifyBatchSubsystem::SpawnSound(const FAnimNotifySpawnRequest& Request)
+{
+	CastChecked<UAnimNotify_PlaySound>(Request.Notify)->SpawnSound(Request.MeshComp, Request.Animation);
+}
+
+void UAnimNotifyBatchSubsystem::SpawnParticleSystem(const FAnimNotifySpawnRequest& Request)
+{
+	CastChecked<UAnimNotify_PlayParticleEffect>(Request.Notify)->SpawnParticleSystem(Request.MeshComp, Request.Animation);
+}
+
+void UAnimNotifyBatchSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld == GetWorld())
+	{
+		bInActorTick = true;
+	}
+}
+
+void UAnimNotifyBatchSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld == GetWorld())
+	{
+		// Cleared first, so notifies fired by what the flush spawns spawn straight away
+		bInActorTick = false;
+		Flush();
+	}
+}
@@ -3,6 +3,7 @@
 #include "Animation/AnimNotifyQueue.h"
 #include "Animation/AnimInstanceProxy.h"
 #include "Animation/AnimTypes.h"
+#include "HAL/ThreadSingleton.h"
 
 bool operator==(const FAnimNotifyEventReference& Lhs, const FAnimNotifyEvent& Rhs)
 {
@@ -13,6 +14,39 @@ bool operator==(const FAnimNotifyEventReference& Lhs, const FAnimNotifyEvent& Rh
 	return false;
 }
 
+/** Scratch arrays of the calling thread, indexed by how deeply scopes are nested. Arrays are held by pointer so nesting deeper doesn't move them */
+struct FAnimNotifyScratchPool : public TThreadSingleton<FAnimNotifyScratchPool>
+{
+	TIndirectArray<TArray<FAnimNotifyEventReference>> Arrays;
+	int32 NumInUse = 0;
+};
+
+static TArray<FAnimNotifyEventReference>& BorrowAnimNotifyScratch()
+{
+	FAnimNotifyScratchPool& Pool = FAnimNotifyScratchPool::Get();
+	if (Pool.NumInUse == Pool.Arrays.Num())
+	{
+		Pool.Arrays.Add(new TArray<FAnimNotifyEventReference>());
+	}
+	return Pool.Arrays[Pool.NumInUse++];
+}
+
+FScopedAnimNotifyScratch::FScopedAnimNotifyScratch()
+	: Notifies(BorrowAnimNotifyScratch())
+{
+	check(Notifies.Num() == 0);
+}
+
+FScopedAnimNotifyScratch::~FScopedAnimNotifyScratch()
+{
+	FAnimNotifyScratchPool& Pool = FAnimNotifyScratchPool::Get();
+	check(Pool.NumInUse > 0 && &Pool.Arrays[Pool.NumInUse - 1] == &Notifies);
+
+	// Keep the capacity for the next tick, but don't hold on to the sources
+	Notifies.Reset();
+	--Pool.NumInUse;
+}
+
 bool FAnimNotifyQueue::PassesFiltering(const FAnimNotifyEvent* Notify) const
 {
 	switch (Notify->NotifyFilterType)
@@ -6,6 +6,7 @@
 #include "ParticleHelper.h"
 #include "Kismet/GameplayStatics.h"
 #include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimNotifyBatchSubsystem.h"
 
 #if WITH_EDITOR
 #include "Logging/MessageLog.h"
@@ -73,7 +74,10 @@ void UAnimNotify_PlayParticleEffect::ValidateAssociatedAssets()
 void UAnimNotify_PlayParticleEffect::Notify(class USkeletalMeshComponent* MeshComp, class UAnimSequenceBase* Animation)
 {
 	// Don't call super to avoid unnecessary call in to blueprints
-	SpawnParticleSystem(MeshComp, Animation);
+	if (!UAnimNotifyBatchSubsystem::QueueParticleSystem(this, MeshComp, Animation))
+	{
+		SpawnParticleSystem(MeshComp, Animation);
+	}
 }
 
 FString UAnimNotify_PlayParticleEffect::GetNotifyName_Implementation() const
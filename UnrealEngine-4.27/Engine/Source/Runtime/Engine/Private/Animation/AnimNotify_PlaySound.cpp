@@ -5,6 +5,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundBase.h"
 #include "Animation/AnimSequenceBase.h"
+#include "Animation/AnimNotifyBatchSubsystem.h"
 
 #if WITH_EDITOR
 #include "Logging/MessageLog.h"
@@ -29,6 +30,14 @@ UAnimNotify_PlaySound::UAnimNotify_PlaySound()
 void UAnimNotify_PlaySound::Notify(class USkeletalMeshComponent* MeshComp, class UAnimSequenceBase* Animation)
 {
 	// Don't call super to avoid call back in to blueprints
+	if (Sound && MeshComp && !UAnimNotifyBatchSubsystem::QueueSound(this, MeshComp, Animation))
+	{
+		SpawnSound(MeshComp, Animation);
+	}
+}
+
+void UAnimNotify_PlaySound::SpawnSound(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
 	if (Sound && MeshComp)
 	{
 		if (Sound->IsLooping())
@@ -1568,6 +1568,58 @@ void UAnimSequence::GetBonePose(FAnimationPoseData& OutAnimationPoseData, const
 	SCOPE_CYCLE_COUNTER(STAT_AnimSeq_GetBonePose);
 	CSV_SCOPED_TIMING_STAT(Animation, AnimSeq_GetBonePose);
 
+	if (PrepareBonePose(OutAnimationPoseData, ExtractionContext, bForceUseRawData))
+	{
+		DecompressPose(MakePoseDecompressionRequest(OutAnimationPoseData.GetPose(), ExtractionContext));
+
+		GetCustomAttributes(OutAnimationPoseData, ExtractionContext, false);
+	}
+}
+
+void UAnimSequence::GetAnimationPoses(TArrayView<const FAnimSequencePoseRequest> Requests)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AnimSeq_GetBonePose);
+	CSV_SCOPED_TIMING_STAT(Animation, AnimSeq_GetBonePose);
+
+	TArray<FAnimPoseDecompressionRequest, TInlineAllocator<8>> DecompressionRequests;
+	TArray<const FAnimSequencePoseRequest*, TInlineAllocator<8>> DecompressedRequests;
+
+	for (const FAnimSequencePoseRequest& Request : Requests)
+	{
+		const UAnimSequence* Sequence = Request.Sequence;
+		FAnimationPoseData& OutAnimationPoseData = *Request.OutAnimationPoseData;
+
+		// Additives extracted from raw data are built from two poses, leave them to GetAnimationPose
+		if (Sequence->UseRawDataForPoseExtraction(OutAnimationPoseData.GetPose().GetBoneContainer()) && Sequence->IsValidAdditive())
+		{
+			Sequence->GetAnimationPose(OutAnimationPoseData, Request.ExtractionContext);
+		}
+		else if (Sequence->PrepareBonePose(OutAnimationPoseData, Request.ExtractionContext, false))
+		{
+			DecompressionRequests.Add(Sequence->MakePoseDecompressionRequest(OutAnimationPoseData.GetPose(), Request.ExtractionContext));
+			DecompressedRequests.Add(&Request);
+		}
+	}
+
+	DecompressPoses(DecompressionRequests);
+
+	for (const FAnimSequencePoseRequest* Request : DecompressedRequests)
+	{
+		Request->Sequence->GetCustomAttributes(*Request->OutAnimationPoseData, Request->ExtractionContext, false);
+	}
+}
+
+FAnimPoseDecompressionRequest UAnimSequence::MakePoseDecompressionRequest(FCompactPose& OutPose, const FAnimExtractContext& ExtractionContext) const
+{
+	// Only compressed data gets here, which is additive whenever the sequence is
+	const bool bIsBakedAdditive = IsValidAdditive();
+	const FRootMotionReset RootMotionReset(bEnableRootMotion, RootMotionRootLock, bForceRootLock, ExtractRootTrackTransform(0.f, &OutPose.GetBoneContainer()), bIsBakedAdditive);
+
+	return FAnimPoseDecompressionRequest(OutPose, CompressedData, ExtractionContext, GetSkeleton(), SequenceLength, Interpolation, bIsBakedAdditive, GetRetargetTransforms(), GetRetargetTransformsSourceName(), RootMotionReset);
+}
+
+bool UAnimSequence::PrepareBonePose(FAnimationPoseData& OutAnimationPoseData, const FAnimExtractContext& ExtractionContext, bool bForceUseRawData) const
+{
 	FCompactPose& OutPose = OutAnimationPoseData.GetPose();
 
 	const FBoneContainer& RequiredBones = OutPose.GetBoneContainer();
@@ -1586,7 +1638,7 @@ void UAnimSequence::GetBonePose(FAnimationPoseData& OutAnimationPoseData, const
 		{
 			OutPose.ResetToRefPose();
 		}
-		return;
+		return false;
 	}
 
 	const bool bDisableRetargeting = RequiredBones.GetDisableRetargeting();
@@ -1627,17 +1679,17 @@ void UAnimSequence::GetBonePose(FAnimationPoseData& OutAnimationPoseData, const
 	const int32 NumTracks = bUseRawDataForPoseExtraction ? TrackToSkeletonMapTable.Num() : CompressedData.CompressedTrackToSkeletonMapTable.Num();
 	if (NumTracks == 0)
 	{
-		return;
+		return false;
 	}
 
-	const bool bTreatAnimAsAdditive = (IsValidAdditive() && !bUseRawDataForPoseExtraction); // Raw data is never additive
-	FRootMotionReset RootMotionReset(bEnableRootMotion, RootMotionRootLock, bForceRootLock, ExtractRootTrackTransform(0.f, &RequiredBones), bTreatAnimAsAdditive);
-
 #if WITH_EDITOR
 	// this happens only with editor data
 	// Slower path for disable retargeting, that's only used in editor and for debugging.
 	if (bUseRawDataForPoseExtraction)
 	{
+		const bool bTreatAnimAsAdditive = false; // Raw data is never additive
+		FRootMotionReset RootMotionReset(bEnableRootMotion, RootMotionRootLock, bForceRootLock, ExtractRootTrackTransform(0.f, &RequiredBones), bTreatAnimAsAdditive);
+
 		const bool bShouldUseSourceData = (RequiredBones.ShouldUseSourceData() && SourceRawAnimationData.Num() > 0);
 		const TArray<FRawAnimSequenceTrack>& AnimationData = bShouldUseSourceData ? SourceRawAnimationData : RawAnimationData;
 
@@ -1663,13 +1715,11 @@ void UAnimSequence::GetBonePose(FAnimationPoseData& OutAnimationPoseData, const
 
 		GetCustomAttributes(OutAnimationPoseData, ExtractionContext, true);
 
-		return;
+		return false;
 	}
 #endif // WITH_EDITOR
 
-	DecompressPose(OutPose, CompressedData, ExtractionContext, GetSkeleton(), SequenceLength, Interpolation, bIsBakedAdditive, GetRetargetTransforms(), GetRetargetTransformsSourceName(), RootMotionReset);
-
-	GetCustomAttributes(OutAnimationPoseData, ExtractionContext, false);
+	return true;
 }
 
 #if WITH_EDITORONLY_DATA
@@ -766,7 +766,8 @@ void UAnimSequenceBase::GetAnimationPose(struct FCompactPose& OutPose, FBlendedC
 void UAnimSequenceBase::HandleAssetPlayerTickedInternal(FAnimAssetTickContext &Context, const float PreviousTime, const float MoveDelta, const FAnimTickRecord &Instance, struct FAnimNotifyQueue& NotifyQueue) const
 {
 	// Harvest and record notifies
-	TArray<FAnimNotifyEventReference> AnimNotifies;
+	FScopedAnimNotifyScratch NotifyScratch;
+	TArray<FAnimNotifyEventReference>& AnimNotifies = NotifyScratch.Get();
 	GetAnimNotifies(PreviousTime, MoveDelta, Instance.bLooping, AnimNotifies);
 	NotifyQueue.AddAnimNotifies(Context.ShouldGenerateNotifies(),AnimNotifies, Instance.EffectiveBlendWeight);
 }
@@ -321,6 +321,16 @@ float UAnimSingleNodeInstance::GetCurrentTime() const
 	return GetProxyOnGameThread<FAnimSingleNodeInstanceProxy>().GetCurrentTime();
 }
 
+float UAnimSingleNodeInstance::GetCurrentTimeOnAnyThread() const
+{
+	return GetProxyOnAnyThread<FAnimSingleNodeInstanceProxy>().GetCurrentTime();
+}
+
+void UAnimSingleNodeInstance::SetCurrentTimeOnAnyThread(float InTime)
+{
+	GetProxyOnAnyThread<FAnimSingleNodeInstanceProxy>().SetCurrentTime(InTime);
+}
+
 void UAnimSingleNodeInstance::SetReverse(bool bInReverse)
 {
 	GetProxyOnGameThread<FAnimSingleNodeInstanceProxy>().SetReverse(bInReverse);
@@ -352,7 +362,8 @@ void UAnimSingleNodeInstance::SetPositionWithPreviousTime(float InPosition, floa
 		{
 			NotifyQueue.Reset(GetSkelMeshComponent());
 
-			TArray<FAnimNotifyEventReference> Notifies;
+			FScopedAnimNotifyScratch NotifyScratch;
+			TArray<FAnimNotifyEventReference>& Notifies = NotifyScratch.Get();
 			SequenceBase->GetAnimNotifiesFromDeltaPositions(InPreviousTime, Proxy.GetCurrentTime(), Notifies);
 			if ( Notifies.Num() > 0 )
 			{
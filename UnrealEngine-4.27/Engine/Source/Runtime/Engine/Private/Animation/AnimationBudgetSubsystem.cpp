@@ -0,0 +1,377 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/AnimationBudgetSubsystem.h"
+#include "Animation/AnimStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+DEFINE_STAT(STAT_AnimationBudgetUpdate);
+DEFINE_STAT(STAT_AnimationBudget);
+DEFINE_STAT(STAT_AnimationBudgetUsed);
+DEFINE_STAT(STAT_AnimationBudgetNumComponents);
+DEFINE_STAT(STAT_AnimationBudgetNumThrottled);
+DEFINE_STAT(STAT_AnimationBudgetNumInterpolated);
+DEFINE_STAT(STAT_AnimationBudgetAverageLatency);
+DEFINE_STAT(STAT_AnimationBudgetMaxLatency);
+
+static TAutoConsoleVariable<int32> CVarAnimationBudgetEnabled(
+	TEXT("a.Budget.Enabled"),
+	0,
+	TEXT("If 1, skeletal mesh components with update rate optimizations enabled are scheduled within a.Budget.BudgetMs instead. Components go back to their own update rate optimizations when it is set to 0."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimationBudgetMs(
+	TEXT("a.Budget.BudgetMs"),
+	1.0f,
+	TEXT("Time in ms the scheduled components can spend ticking and evaluating animation each frame, across all threads."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimationBudgetMaxTickRate(
+	TEXT("a.Budget.MaxTickRate"),
+	8,
+	TEXT("Components over budget update at most once every this many frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimationBudgetMaxInterpolationRate(
+	TEXT("a.Budget.MaxInterpolationRate"),
+	4,
+	TEXT("Visible components updating at most once every this many frames interpolate towards their last evaluated pose on the frames in between, slower ones skip them."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimationBudgetInitialCostMs(
+	TEXT("a.Budget.InitialCostMs"),
+	0.1f,
+	TEXT("Cost in ms assumed for a component's update until it has been measured."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimationBudgetCostSmoothing(
+	TEXT("a.Budget.CostSmoothing"),
+	0.1f,
+	TEXT("Weight given to the latest measured cost of a component when updating its estimate, between 0 and 1."),
+	ECVF_Default);
+
+bool UAnimationBudgetSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	// Editor previews always want every frame
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAnimationBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Decisions have to be made before components tick, which tickable objects can't do
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UAnimationBudgetSubsystem::OnWorldPreActorTick);
+}
+
+void UAnimationBudgetSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	for (const FAnimationBudgetComponentState& State : ComponentStates)
+	{
+		if (State.Component)
+		{
+			if (State.Component->bManagedByAnimationBudget)
+			{
+				StopManaging(State.Component);
+			}
+			State.Component->AnimationBudgetIndex = INDEX_NONE;
+		}
+	}
+	ComponentStates.Empty();
+	SortedIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+void UAnimationBudgetSubsystem::RegisterComponent(USkeletalMeshComponent* Component)
+{
+	if (Component && Component->AnimationBudgetIndex == INDEX_NONE)
+	{
+		Component->AnimationBudgetIndex = ComponentStates.Num();
+		ComponentStates.AddDefaulted_GetRef().Component = Component;
+	}
+}
+
+void UAnimationBudgetSubsystem::UnregisterComponent(USkeletalMeshComponent* Component)
+{
+	if (!Component || !ComponentStates.IsValidIndex(Component->AnimationBudgetIndex) || ComponentStates[Component->AnimationBudgetIndex].Component != Component)
+	{
+		return;
+	}
+
+	if (Component->bManagedByAnimationBudget)
+	{
+		StopManaging(Component);
+	}
+
+	RemoveComponentState(Component->AnimationBudgetIndex);
+	Component->AnimationBudgetIndex = INDEX_NONE;
+}
+
+int32 UAnimationBudgetSubsystem::GetNumManagedComponents() const
+{
+	int32 NumManaged = 0;
+	for (const FAnimationBudgetComponentState& State : ComponentStates)
+	{
+		NumManaged += State.Component && State.Component->bManagedByAnimationBudget ? 1 : 0;
+	}
+	return NumManaged;
+}
+
+void UAnimationBudgetSubsystem::RemoveComponentState(int32 Index)
+{
+	ComponentStates.RemoveAtSwap(Index, 1, false);
+
+	// The last state moved into the removed one's slot
+	if (ComponentStates.IsValidIndex(Index) && ComponentStates[Index].Component)
+	{
+		ComponentStates[Index].Component->AnimationBudgetIndex = Index;
+	}
+}
+
+void UAnimationBudgetSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AnimationBudgetUpdate);
+
+	const bool bEnabled = CVarAnimationBudgetEnabled.GetValueOnGameThread() != 0;
+	const float BudgetMs = FMath::Max(CVarAnimationBudgetMs.GetValueOnGameThread(), 0.0f);
+	const int32 MaxTickRate = FMath::Clamp(CVarAnimationBudgetMaxTickRate.GetValueOnGameThread(), 1, (int32)MAX_uint8);
+	const int32 MaxInterpolationRate = CVarAnimationBudgetMaxInterpolationRate.GetValueOnGameThread();
+
+	BudgetUsedMs = 0.0f;
+	SortedIndices.Reset();
+
+	// Removing moves the last state into the removed one's slot, so do it before any index is kept
+	for (int32 Index = ComponentStates.Num() - 1; Index >= 0; --Index)
+	{
+		if (!ComponentStates[Index].Component)
+		{
+			RemoveComponentState(Index);
+		}
+	}
+
+	for (int32 Index = 0; Index < ComponentStates.Num(); ++Index)
+	{
+		FAnimationBudgetComponentState& State = ComponentStates[Index];
+		if (!bEnabled)
+		{
+			if (State.Component->bManagedByAnimationBudget)
+			{
+				StopManaging(State.Component);
+			}
+			continue;
+		}
+
+		if (UpdateComponentState(State))
+		{
+			if (!State.Component->bManagedByAnimationBudget)
+			{
+				StartManaging(State, MaxTickRate);
+			}
+			SortedIndices.Add(Index);
+		}
+	}
+
+	SortedIndices.Sort([this](const int32 A, const int32 B)
+	{
+		const FAnimationBudgetComponentState& StateA = ComponentStates[A];
+		const FAnimationBudgetComponentState& StateB = ComponentStates[B];
+		if (StateA.bAlwaysUpdate != StateB.bAlwaysUpdate)
+		{
+			return StateA.bAlwaysUpdate;
+		}
+		return StateA.Significance > StateB.Significance;
+	});
+
+	AllocateBudget(BudgetMs, MaxTickRate);
+
+	NumThrottledComponents = 0;
+	int32 NumInterpolated = 0;
+	float TotalLatencyMs = 0.0f;
+	float MaxLatencyMs = 0.0f;
+	for (const int32 Index : SortedIndices)
+	{
+		FAnimationBudgetComponentState& State = ComponentStates[Index];
+		ApplyTickRate(State, InDeltaSeconds, MaxInterpolationRate);
+
+		if (State.TickRate > 1)
+		{
+			// A pose is at most this much older than it would be updating every frame
+			const float LatencyMs = (State.TickRate - 1) * InDeltaSeconds * 1000.0f;
+			TotalLatencyMs += LatencyMs;
+			MaxLatencyMs = FMath::Max(MaxLatencyMs, LatencyMs);
+			++NumThrottledComponents;
+			NumInterpolated += State.Component->IsUsingExternalInterpolation() ? 1 : 0;
+		}
+	}
+
+	SET_FLOAT_STAT(STAT_AnimationBudget, bEnabled ? BudgetMs : 0.0f);
+	SET_FLOAT_STAT(STAT_AnimationBudgetUsed, BudgetUsedMs);
+	SET_DWORD_STAT(STAT_AnimationBudgetNumComponents, SortedIndices.Num());
+	SET_DWORD_STAT(STAT_AnimationBudgetNumThrottled, NumThrottledComponents);
+	SET_DWORD_STAT(STAT_AnimationBudgetNumInterpolated, NumInterpolated);
+	SET_FLOAT_STAT(STAT_AnimationBudgetAverageLatency, NumThrottledComponents > 0 ? TotalLatencyMs / NumThrottledComponents : 0.0f);
+	SET_FLOAT_STAT(STAT_AnimationBudgetMaxLatency, MaxLatencyMs);
+}
+
+bool UAnimationBudgetSubsystem::UpdateComponentState(FAnimationBudgetComponentState& State)
+{
+	USkeletalMeshComponent* Component = State.Component;
+
+	// Components only opt in through update rate optimizations, which are turned off while managed
+	if (!Component->bEnableUpdateRateOptimizations && !Component->bManagedByAnimationBudget)
+	{
+		return false;
+	}
+
+	if (Component->bManagedByAnimationBudget)
+	{
+		// Both are done being written to, the game thread ticks and the evaluation tasks have completed by now
+		const uint32 CostCycles = Component->AnimationBudgetGameThreadCycles + Component->AnimationBudgetWorkerCycles;
+		Component->AnimationBudgetGameThreadCycles = 0;
+		Component->AnimationBudgetWorkerCycles = 0;
+
+		if (CostCycles > 0)
+		{
+			const float CostMs = FPlatformTime::ToMilliseconds(CostCycles);
+			const float Smoothing = FMath::Clamp(CVarAnimationBudgetCostSmoothing.GetValueOnGameThread(), 0.0f, 1.0f);
+			float& EstimatedCostMs = State.bUpdatedLastFrame ? State.UpdateCostMs : State.SkippedCostMs;
+			EstimatedCostMs = FMath::Lerp(EstimatedCostMs, CostMs, Smoothing);
+			BudgetUsedMs += CostMs;
+		}
+	}
+
+	// Nothing to schedule for components that don't tick, baked vertex animation turns it off for instance
+	if (!Component->IsComponentTickEnabled() || !Component->SkeletalMesh)
+	{
+		return false;
+	}
+
+	// Same rule as update rate optimizations, player controlled characters update every frame to keep up with gameplay
+	const AActor* Owner = Component->GetOwner();
+	State.bAlwaysUpdate = Owner && Owner->GetInstigatorController<APlayerController>() != nullptr;
+	State.Significance = Component->bRecentlyRendered ? FMath::Max(Component->MaxDistanceFactor, KINDA_SMALL_NUMBER) : 0.0f;
+
+	return true;
+}
+
+void UAnimationBudgetSubsystem::AllocateBudget(float BudgetMs, int32 MaxTickRate)
+{
+	// Every component pays for updating at the slowest rate, whether it fits or not
+	float RemainingMs = BudgetMs;
+	for (const int32 Index : SortedIndices)
+	{
+		FAnimationBudgetComponentState& State = ComponentStates[Index];
+		State.TickRate = State.bAlwaysUpdate ? 1 : MaxTickRate;
+		RemainingMs -= State.GetAmortizedCostMs(State.TickRate);
+	}
+
+	// What is left goes to the most significant components first, each taking the fastest rate that still fits
+	for (const int32 Index : SortedIndices)
+	{
+		FAnimationBudgetComponentState& State = ComponentStates[Index];
+		if (State.TickRate == 1)
+		{
+			continue;
+		}
+
+		if (RemainingMs <= 0.0f)
+		{
+			break;
+		}
+
+		const float SlowestCostMs = State.GetAmortizedCostMs(MaxTickRate);
+		for (int32 TickRate = 1; TickRate < MaxTickRate; ++TickRate)
+		{
+			const float ExtraCostMs = State.GetAmortizedCostMs(TickRate) - SlowestCostMs;
+			if (ExtraCostMs <= RemainingMs)
+			{
+				State.TickRate = TickRate;
+				RemainingMs -= ExtraCostMs;
+				break;
+			}
+		}
+	}
+}
+
+void UAnimationBudgetSubsystem::ApplyTickRate(FAnimationBudgetComponentState& State, float DeltaSeconds, int32 MaxInterpolationRate)
+{
+	USkeletalMeshComponent* Component = State.Component;
+
+	State.AccumulatedDeltaTime += DeltaSeconds;
+	++State.FramesSinceUpdate;
+
+	const bool bUpdate = State.FramesSinceUpdate >= State.TickRate;
+	if (bUpdate)
+	{
+		State.FramesSinceUpdate = 0;
+	}
+
+	// Interpolating something nobody sees is wasted work
+	const bool bInterpolate = State.TickRate > 1 && State.TickRate <= MaxInterpolationRate && Component->bRecentlyRendered;
+
+	Component->SetExternalTickRate((uint8)State.TickRate);
+	Component->EnableExternalEvaluationRateLimiting(State.TickRate > 1);
+	Component->EnableExternalInterpolation(bInterpolate);
+	Component->EnableExternalUpdate(bUpdate);
+
+	if (bUpdate)
+	{
+		Component->SetExternalDeltaTime(State.AccumulatedDeltaTime);
+		State.AccumulatedDeltaTime = 0.0f;
+	}
+
+	if (bInterpolate)
+	{
+		// Reaches the evaluated pose on the frame before the next update
+		Component->SetExternalInterpolationAlpha(1.0f / (State.TickRate - State.FramesSinceUpdate));
+	}
+
+	State.bUpdatedLastFrame = bUpdate;
+}
+
+void UAnimationBudgetSubsystem::StartManaging(FAnimationBudgetComponentState& State, int32 MaxTickRate)
+{
+	USkeletalMeshComponent* Component = State.Component;
+	check(!Component->bManagedByAnimationBudget);
+
+	Component->bManagedByAnimationBudget = true;
+	Component->bUpdateRateOptimizationsBeforeAnimationBudget = Component->bEnableUpdateRateOptimizations;
+	Component->bEnableUpdateRateOptimizations = false;
+	Component->AnimationBudgetGameThreadCycles = 0;
+	Component->AnimationBudgetWorkerCycles = 0;
+	Component->EnableExternalTickRateControl(true);
+
+	State.UpdateCostMs = FMath::Max(CVarAnimationBudgetInitialCostMs.GetValueOnGameThread(), 0.0f);
+	State.SkippedCostMs = 0.0f;
+	State.AccumulatedDeltaTime = 0.0f;
+	State.TickRate = 1;
+	State.bUpdatedLastFrame = false;
+
+	// Spread components over the frames so throttled ones don't all update on the same one
+	State.FramesSinceUpdate = FMath::RandHelper(MaxTickRate);
+}
+
+void UAnimationBudgetSubsystem::StopManaging(USkeletalMeshComponent* Component)
+{
+	check(Component->bManagedByAnimationBudget);
+
+	Component->bManagedByAnimationBudget = false;
+	Component->bEnableUpdateRateOptimizations = Component->bUpdateRateOptimizationsBeforeAnimationBudget;
+	Component->AnimationBudgetGameThreadCycles = 0;
+	Component->AnimationBudgetWorkerCycles = 0;
+	Component->EnableExternalTickRateControl(false);
+	Component->EnableExternalEvaluationRateLimiting(false);
+	Component->EnableExternalInterpolation(false);
+	Component->EnableExternalUpdate(false);
+	Component->SetExternalTickRate(1);
+}
@@ -13,6 +13,7 @@
 #include "Animation/CustomAttributesRuntime.h"
 #include "GenericPlatform/GenericPlatformCompilerPreSetup.h"
 #include "Animation/AnimationPoseData.h"
+#include "HAL/IConsoleManager.h"
 #if INTEL_ISPC
 #include "AnimationRuntime.ispc.generated.h"
 #endif
@@ -29,8 +30,56 @@ DECLARE_CYCLE_STAT(TEXT("BlendPosesPerBoneFilter"), STAT_BlendPosesPerBoneFilter
 
 #if INTEL_ISPC
 static_assert(sizeof(ispc::FTransform) == sizeof(FTransform), "sizeof(ispc::FTransform) != sizeof(FTransform)");
+
+static TAutoConsoleVariable<int32> CVarPoseBlendingISPC(
+	TEXT("a.PoseBlending.ISPC"),
+	1,
+	TEXT("If 1, blend space, per bone and additive pose blends run through the ISPC kernels that blend a vector of bones at a time. If 0, they blend one bone at a time."),
+	ECVF_Default);
 #endif
 
+/** Whether the pose blends below go through the ISPC kernels blending several bones at once */
+static FORCEINLINE bool UsePoseBlendingISPC()
+{
+#if INTEL_ISPC
+	return CVarPoseBlendingISPC.GetValueOnAnyThread() != 0;
+#else
+	return false;
+#endif
+}
+
+typedef TArray<const FTransform*, TInlineAllocator<16>> FSourceBonesArray;
+
+/**
+ * Weighted sum of the bones of several poses written to OutPose in a single pass over the bones, instead of a pass per source pose.
+ * SourceWeights holds a weight per pose, or NumBones weights per pose in turn if bPerBoneWeights is set.
+ */
+static void BlendPosesWeightedISPC(FCompactPose& OutPose, const FSourceBonesArray& SourceBones, const float* SourceWeights, const bool bPerBoneWeights, const bool bNormalizeRotations)
+{
+#if INTEL_ISPC
+	check(SourceBones.Num() > 0);
+	if (bPerBoneWeights)
+	{
+		ispc::BlendPosesWeightedPerBone(
+			(ispc::FTransform*)OutPose.GetMutableBones().GetData(),
+			(ispc::FTransform**)SourceBones.GetData(),
+			SourceWeights,
+			SourceBones.Num(),
+			OutPose.GetNumBones());
+	}
+	else
+	{
+		ispc::BlendPosesWeighted(
+			(ispc::FTransform*)OutPose.GetMutableBones().GetData(),
+			(ispc::FTransform**)SourceBones.GetData(),
+			SourceWeights,
+			SourceBones.Num(),
+			OutPose.GetNumBones(),
+			bNormalizeRotations);
+	}
+#endif
+}
+
 void FAnimationRuntime::NormalizeRotations(const FBoneContainer& RequiredBones, /*inout*/ FTransformArrayA2& Atoms)
 {
 	check( Atoms.Num() == RequiredBones.GetNumBones() );
@@ -279,17 +328,30 @@ void FAnimationRuntime::BlendPosesTogether(TArrayView<const FCompactPose> Source
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	FStackCustomAttributes& OutAttributes = OutAnimationPoseData.GetAttributes();
 
-	BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[0]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (UsePoseBlendingISPC())
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
-	}
+		FSourceBonesArray SourceBones;
+		for (const FCompactPose& SourcePose : SourcePoses)
+		{
+			SourceBones.Add(SourcePose.GetBones().GetData());
+		}
 
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+		BlendPosesWeightedISPC(OutPose, SourceBones, SourceWeights.GetData(), false, SourcePoses.Num() > 1);
+	}
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[0]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	// curve blending if exists
@@ -327,17 +389,32 @@ void FAnimationRuntime::BlendPosesTogether(TArrayView<const FCompactPose> Source
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	FStackCustomAttributes& OutAttributes = OutAnimationPoseData.GetAttributes();
 
-	BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[SourceWeightsIndices[0]]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (UsePoseBlendingISPC())
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[SourceWeightsIndices[PoseIndex]]);
-	}
+		FSourceBonesArray SourceBones;
+		TArray<float, TInlineAllocator<16>> PoseWeights;
+		for (int32 PoseIndex = 0; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			SourceBones.Add(SourcePoses[PoseIndex].GetBones().GetData());
+			PoseWeights.Add(SourceWeights[SourceWeightsIndices[PoseIndex]]);
+		}
 
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+		BlendPosesWeightedISPC(OutPose, SourceBones, PoseWeights.GetData(), false, SourcePoses.Num() > 1);
+	}
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(SourcePoses[0], OutPose, SourceWeights[SourceWeightsIndices[0]]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(SourcePoses[PoseIndex], OutPose, SourceWeights[SourceWeightsIndices[PoseIndex]]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	// curve blending if exists
@@ -373,17 +450,30 @@ void FAnimationRuntime::BlendPosesTogetherIndirect(TArrayView<const FCompactPose
 	FBlendedCurve& OutCurve = OutAnimationPoseData.GetCurve();
 	FStackCustomAttributes& OutAttributes = OutAnimationPoseData.GetAttributes();
 	
-	BlendPose<ETransformBlendMode::Overwrite>(*SourcePoses[0], OutPose, SourceWeights[0]);
-
-	for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+	if (UsePoseBlendingISPC())
 	{
-		BlendPose<ETransformBlendMode::Accumulate>(*SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
-	}
+		FSourceBonesArray SourceBones;
+		for (const FCompactPose* SourcePose : SourcePoses)
+		{
+			SourceBones.Add(SourcePose->GetBones().GetData());
+		}
 
-	// Ensure that all of the resulting rotations are normalized
-	if (SourcePoses.Num() > 1)
+		BlendPosesWeightedISPC(OutPose, SourceBones, SourceWeights.GetData(), false, SourcePoses.Num() > 1);
+	}
+	else
 	{
-		OutPose.NormalizeRotations();
+		BlendPose<ETransformBlendMode::Overwrite>(*SourcePoses[0], OutPose, SourceWeights[0]);
+
+		for (int32 PoseIndex = 1; PoseIndex < SourcePoses.Num(); ++PoseIndex)
+		{
+			BlendPose<ETransformBlendMode::Accumulate>(*SourcePoses[PoseIndex], OutPose, SourceWeights[PoseIndex]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		if (SourcePoses.Num() > 1)
+		{
+			OutPose.NormalizeRotations();
+		}
 	}
 
 	if (SourceCurves.Num() > 0)
@@ -461,27 +551,42 @@ void FAnimationRuntime::BlendTwoPosesTogetherPerBone(const FAnimationPoseData& S
 	const FCompactPose& SourcePoseOne = SourcePoseOneData.GetPose();
 	const FCompactPose& SourcePoseTwo = SourcePoseTwoData.GetPose();
 
-	for (FCompactPoseBoneIndex BoneIndex : OutPose.ForEachBoneIndex())
+	if (UsePoseBlendingISPC())
 	{
-		const float BlendWeight = WeightsOfSource2[BoneIndex.GetInt()];
-		if (FAnimationRuntime::IsFullWeight(BlendWeight))
-		{
-			OutPose[BoneIndex] = SourcePoseTwo[BoneIndex];
-		}
-		// if it doens't have weight, take source pose 1
-		else if (FAnimationRuntime::HasWeight(BlendWeight))
-		{
-			BlendTransform<ETransformBlendMode::Overwrite>(SourcePoseOne[BoneIndex], OutPose[BoneIndex], 1.f - BlendWeight);
-			BlendTransform<ETransformBlendMode::Accumulate>(SourcePoseTwo[BoneIndex], OutPose[BoneIndex], BlendWeight);
-		}
-		else
+#if INTEL_ISPC
+		check(WeightsOfSource2.Num() >= OutPose.GetNumBones());
+		ispc::BlendTwoPosesPerBone(
+			(ispc::FTransform*)OutPose.GetMutableBones().GetData(),
+			(ispc::FTransform*)SourcePoseOne.GetBones().GetData(),
+			(ispc::FTransform*)SourcePoseTwo.GetBones().GetData(),
+			WeightsOfSource2.GetData(),
+			OutPose.GetNumBones());
+#endif
+	}
+	else
+	{
+		for (FCompactPoseBoneIndex BoneIndex : OutPose.ForEachBoneIndex())
 		{
-			OutPose[BoneIndex] = SourcePoseOne[BoneIndex];
+			const float BlendWeight = WeightsOfSource2[BoneIndex.GetInt()];
+			if (FAnimationRuntime::IsFullWeight(BlendWeight))
+			{
+				OutPose[BoneIndex] = SourcePoseTwo[BoneIndex];
+			}
+			// if it doens't have weight, take source pose 1
+			else if (FAnimationRuntime::HasWeight(BlendWeight))
+			{
+				BlendTransform<ETransformBlendMode::Overwrite>(SourcePoseOne[BoneIndex], OutPose[BoneIndex], 1.f - BlendWeight);
+				BlendTransform<ETransformBlendMode::Accumulate>(SourcePoseTwo[BoneIndex], OutPose[BoneIndex], BlendWeight);
+			}
+			else
+			{
+				OutPose[BoneIndex] = SourcePoseOne[BoneIndex];
+			}
 		}
-	}
 
-	// Ensure that all of the resulting rotations are normalized
-	OutPose.NormalizeRotations();
+		// Ensure that all of the resulting rotations are normalized
+		OutPose.NormalizeRotations();
+	}
 
 	// @note : This isn't perfect as curve can link to joint, and it would be the best to use that information
 	// but that is very expensive option as we have to have another indirect look up table to search. 
@@ -533,6 +638,17 @@ void BlendPosePerBone(const TArray<int32>& PerBoneIndices, const FBlendSampleDat
 	}
 }
 
+/** Writes the weight each bone of a sample is blended with, PerBoneBlendData where the bone has an interpolation index and the sample weight otherwise */
+static void GetPerBoneBlendWeights(const TArray<int32>& PerBoneIndices, const FBlendSampleData& BlendSampleDataCache, float* OutWeights)
+{
+	const float BlendWeight = BlendSampleDataCache.GetWeight();
+	for (int32 BoneIndex = 0; BoneIndex < PerBoneIndices.Num(); ++BoneIndex)
+	{
+		const int32 PerBoneIndex = PerBoneIndices[BoneIndex];
+		OutWeights[BoneIndex] = (PerBoneIndex == INDEX_NONE || !BlendSampleDataCache.PerBoneBlendData.IsValidIndex(PerBoneIndex)) ? BlendWeight : BlendSampleDataCache.PerBoneBlendData[PerBoneIndex];
+	}
+}
+
 void FAnimationRuntime::BlendPosesTogetherPerBone(
 	const TArrayView<const FCompactPose> SourcePoses,
 	const TArrayView<const FBlendedCurve> SourceCurves,
@@ -565,15 +681,35 @@ void FAnimationRuntime::BlendPosesTogetherPerBone(TArrayView<const FCompactPose>
 		PerBoneIndices[BoneIndex] = InterpolationIndexProvider->GetPerBoneInterpolationIndex(RequiredBoneIndices[BoneIndex], OutPose.GetBoneContainer());
 	}
 
-	BlendPosePerBone<ETransformBlendMode::Overwrite>(PerBoneIndices, BlendSampleDataCache[0], OutPose, SourcePoses[0]);
-
-	for (int32 i = 1; i < SourcePoses.Num(); ++i)
+	if (UsePoseBlendingISPC())
 	{
-		BlendPosePerBone<ETransformBlendMode::Accumulate>(PerBoneIndices, BlendSampleDataCache[i], OutPose, SourcePoses[i]);
+		FMemMark Mark(FMemStack::Get());
+
+		const int32 NumBones = OutPose.GetNumBones();
+		TArray<float, TMemStackAllocator<>> BoneWeights;
+		BoneWeights.AddUninitialized(SourcePoses.Num() * NumBones);
+
+		FSourceBonesArray SourceBones;
+		for (int32 i = 0; i < SourcePoses.Num(); ++i)
+		{
+			SourceBones.Add(SourcePoses[i].GetBones().GetData());
+			GetPerBoneBlendWeights(PerBoneIndices, BlendSampleDataCache[i], BoneWeights.GetData() + i * NumBones);
+		}
+
+		BlendPosesWeightedISPC(OutPose, SourceBones, BoneWeights.GetData(), true, true);
 	}
+	else
+	{
+		BlendPosePerBone<ETransformBlendMode::Overwrite>(PerBoneIndices, BlendSampleDataCache[0], OutPose, SourcePoses[0]);
 
-	// Ensure that all of the resulting rotations are normalized
-	OutPose.NormalizeRotations();
+		for (int32 i = 1; i < SourcePoses.Num(); ++i)
+		{
+			BlendPosePerBone<ETransformBlendMode::Accumulate>(PerBoneIndices, BlendSampleDataCache[i], OutPose, SourcePoses[i]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		OutPose.NormalizeRotations();
+	}
 
 	if (SourceCurves.Num() > 0 || SourceAttributes.Num() > 0)
 	{
@@ -628,15 +764,35 @@ void FAnimationRuntime::BlendPosesTogetherPerBone(TArrayView<const FCompactPose>
 		PerBoneIndices[BoneIndex] = InterpolationIndexProvider->GetPerBoneInterpolationIndex(RequiredBoneIndices[BoneIndex], OutPose.GetBoneContainer());
 	}
 
-	BlendPosePerBone<ETransformBlendMode::Overwrite>(PerBoneIndices, BlendSampleDataCache[BlendSampleDataCacheIndices[0]], OutPose, SourcePoses[0]);
-
-	for (int32 i = 1; i < SourcePoses.Num(); ++i)
+	if (UsePoseBlendingISPC())
 	{
-		BlendPosePerBone<ETransformBlendMode::Accumulate>(PerBoneIndices, BlendSampleDataCache[BlendSampleDataCacheIndices[i]], OutPose, SourcePoses[i]);
+		FMemMark Mark(FMemStack::Get());
+
+		const int32 NumBones = OutPose.GetNumBones();
+		TArray<float, TMemStackAllocator<>> BoneWeights;
+		BoneWeights.AddUninitialized(SourcePoses.Num() * NumBones);
+
+		FSourceBonesArray SourceBones;
+		for (int32 i = 0; i < SourcePoses.Num(); ++i)
+		{
+			SourceBones.Add(SourcePoses[i].GetBones().GetData());
+			GetPerBoneBlendWeights(PerBoneIndices, BlendSampleDataCache[BlendSampleDataCacheIndices[i]], BoneWeights.GetData() + i * NumBones);
+		}
+
+		BlendPosesWeightedISPC(OutPose, SourceBones, BoneWeights.GetData(), true, true);
 	}
+	else
+	{
+		BlendPosePerBone<ETransformBlendMode::Overwrite>(PerBoneIndices, BlendSampleDataCache[BlendSampleDataCacheIndices[0]], OutPose, SourcePoses[0]);
 
-	// Ensure that all of the resulting rotations are normalized
-	OutPose.NormalizeRotations();
+		for (int32 i = 1; i < SourcePoses.Num(); ++i)
+		{
+			BlendPosePerBone<ETransformBlendMode::Accumulate>(PerBoneIndices, BlendSampleDataCache[BlendSampleDataCacheIndices[i]], OutPose, SourcePoses[i]);
+		}
+
+		// Ensure that all of the resulting rotations are normalized
+		OutPose.NormalizeRotations();
+	}
 
 	if (SourceCurves.Num() > 0 || SourceAttributes.Num() > 0)
 	{
@@ -1068,7 +1224,7 @@ void FAnimationRuntime::AccumulateLocalSpaceAdditivePoseInternal(FCompactPose& B
 		const ScalarRegister VBlendWeight(Weight);
 		if (FAnimWeight::IsFullWeight(Weight))
 		{
-			if (INTEL_ISPC)
+			if (UsePoseBlendingISPC())
 			{
 #if INTEL_ISPC
 				ispc::AccumulateWithAdditiveScale(
@@ -1087,6 +1243,16 @@ void FAnimationRuntime::AccumulateLocalSpaceAdditivePoseInternal(FCompactPose& B
 				}
 			}
 		}
+		else if (UsePoseBlendingISPC())
+		{
+#if INTEL_ISPC
+			ispc::BlendFromIdentityAndAccumulate(
+				(ispc::FTransform*)BasePose.GetMutableBones().GetData(),
+				(ispc::FTransform*)AdditivePose.GetBones().GetData(),
+				Weight,
+				BasePose.GetNumBones());
+#endif
+		}
 		else
 		{
 			// Slower path w/ weighting
@@ -2109,18 +2275,17 @@ void FAnimationRuntime::FillUpComponentSpaceTransformsRetargetBasePose(const USk
 }
 #endif // WITH_EDITOR
 
-/** See if an array of ActiveMorphTargets already contains the supplied anim */
-static int32 FindMorphTarget(const TArray<FActiveMorphTarget>& ActiveMorphTargets, UMorphTarget* InMorphTarget)
+/** Marks the weight index of every entry of ActiveMorphTargets, so a curve can tell whether its morph target is active without searching */
+static void GetActiveMorphTargetWeightIndices(const TArray<FActiveMorphTarget>& ActiveMorphTargets, const int32 NumMorphTargets, TBitArray<>& OutActiveWeightIndices)
 {
-	for(int32 i=0; i<ActiveMorphTargets.Num(); i++)
+	OutActiveWeightIndices.Init(false, NumMorphTargets);
+	for (const FActiveMorphTarget& ActiveMorphTarget : ActiveMorphTargets)
 	{
-		if(ActiveMorphTargets[i].MorphTarget == InMorphTarget)
+		if (ActiveMorphTarget.WeightIndex >= 0 && ActiveMorphTarget.WeightIndex < NumMorphTargets)
 		{
-			return i;
+			OutActiveWeightIndices[ActiveMorphTarget.WeightIndex] = true;
 		}
 	}
-
-	return INDEX_NONE;
 }
 
 void FAnimationRuntime::AppendActiveMorphTargets(const USkeletalMesh* InSkeletalMesh, const TMap<FName, float>& MorphCurveAnims, TArray<FActiveMorphTarget>& InOutActiveMorphTargets, TArray<float>& InOutMorphTargetWeights)
@@ -2149,6 +2314,10 @@ void FAnimationRuntime::AppendActiveMorphTargets(const USkeletalMesh* InSkeletal
 
 		if(NumMorphTargets > 0)
 		{
+			// Active entries are looked up by weight index once for all curves, rather than searched for every curve
+			TBitArray<> ActiveWeightIndices;
+			GetActiveMorphTargetWeightIndices(InOutActiveMorphTargets, NumMorphTargets, ActiveWeightIndices);
+
 			// Then go over the CurveKeys finding morph targets by name
 			for(const TPair<FName, float>& MorphCurveAnim : MorphCurveAnims)
 			{
@@ -2163,25 +2332,17 @@ void FAnimationRuntime::AppendActiveMorphTargets(const USkeletalMesh* InSkeletal
 					// If it has a valid weight
 					if (FMath::Abs(Weight) > MinMorphTargetBlendWeight)
 					{
-						// See if this morph target already has an entry
-						int32 MorphIndex = FindMorphTarget(InOutActiveMorphTargets, Target);
-						// If not, add it
-						if (MorphIndex == INDEX_NONE)
+						// See if this morph target already has an entry, if not, add it
+						if (!ActiveWeightIndices[SkeletalMorphIndex])
 						{
 							InOutActiveMorphTargets.Add(FActiveMorphTarget(Target, SkeletalMorphIndex));
-							InOutMorphTargetWeights[SkeletalMorphIndex] = Weight;
-						}
-						else
-						{
-							// If it does, use the max weight
-							check(SkeletalMorphIndex == InOutActiveMorphTargets[MorphIndex].WeightIndex);
-							InOutMorphTargetWeights[SkeletalMorphIndex] = Weight;
+							ActiveWeightIndices[SkeletalMorphIndex] = true;
 						}
+						InOutMorphTargetWeights[SkeletalMorphIndex] = Weight;
 					}
 					else
 					{
-						int32 MorphIndex = FindMorphTarget(InOutActiveMorphTargets, Target);
-						if (MorphIndex != INDEX_NONE)
+						if (ActiveWeightIndices[SkeletalMorphIndex])
 						{
 							// clear weight
 							InOutMorphTargetWeights[SkeletalMorphIndex] = 0.f;
@@ -0,0 +1,335 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/BakedVertexAnimation.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/CustomAttributesRuntime.h"
+#include "BonePose.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBakedVertexAnimation, Log, All);
+
+const FName UBakedVertexAnimation::PositionTextureParameterName(TEXT("VAT_PositionTexture"));
+const FName UBakedVertexAnimation::NormalTextureParameterName(TEXT("VAT_NormalTexture"));
+const FName UBakedVertexAnimation::NumFramesParameterName(TEXT("VAT_NumFrames"));
+const FName UBakedVertexAnimation::PlayLengthParameterName(TEXT("VAT_PlayLength"));
+
+namespace BakedVertexAnimation
+{
+	/** Creates a point sampled, uncompressed half float texture holding Texels */
+	static UTexture2D* CreateTexture(UObject* Outer, const TCHAR* Name, const int32 Width, const int32 Height, const TArray<FFloat16Color>& Texels)
+	{
+		check(Texels.Num() == Width * Height);
+
+#if WITH_EDITORONLY_DATA
+		UTexture2D* Texture = NewObject<UTexture2D>(Outer, Name, RF_Public);
+		Texture->Source.Init(Width, Height, 1, 1, TSF_RGBA16F, (const uint8*)Texels.GetData());
+		Texture->MipGenSettings = TMGS_NoMipmaps;
+#else
+		UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_FloatRGBA, Name);
+		if (!Texture)
+		{
+			return nullptr;
+		}
+
+		void* MipData = Texture->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(MipData, Texels.GetData(), Texels.Num() * sizeof(FFloat16Color));
+		Texture->PlatformData->Mips[0].BulkData.Unlock();
+#endif
+
+		Texture->CompressionSettings = TC_HDR;
+		Texture->Filter = TF_Nearest;
+		Texture->SRGB = false;
+		Texture->NeverStream = true;
+		Texture->AddressX = TA_Clamp;
+		Texture->AddressY = TA_Wrap;
+
+#if WITH_EDITORONLY_DATA
+		Texture->PostEditChange();
+#else
+		Texture->UpdateResource();
+#endif
+		return Texture;
+	}
+
+	/** Copies the baked LOD into a static mesh description, with each vertex's texel column in UV channel 1 */
+	static void BuildMeshDescription(const USkeletalMesh& SkeletalMesh, const FSkeletalMeshLODRenderData& LODData, const TArray<uint32>& Indices, FMeshDescription& OutMeshDescription, TArray<FName>& OutSlotNames)
+	{
+		FStaticMeshAttributes Attributes(OutMeshDescription);
+		Attributes.Register();
+
+		TVertexAttributesRef<FVector> Positions = Attributes.GetVertexPositions();
+		TVertexInstanceAttributesRef<FVector> Normals = Attributes.GetVertexInstanceNormals();
+		TVertexInstanceAttributesRef<FVector> Tangents = Attributes.GetVertexInstanceTangents();
+		TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+		TVertexInstanceAttributesRef<FVector2D> UVs = Attributes.GetVertexInstanceUVs();
+		TPolygonGroupAttributesRef<FName> SlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+
+		const FPositionVertexBuffer& PositionBuffer = LODData.StaticVertexBuffers.PositionVertexBuffer;
+		const FStaticMeshVertexBuffer& VertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+		const int32 NumVertices = PositionBuffer.GetNumVertices();
+
+		UVs.SetNumIndices(2);
+
+		OutMeshDescription.ReserveNewVertices(NumVertices);
+		OutMeshDescription.ReserveNewVertexInstances(NumVertices);
+		OutMeshDescription.ReserveNewPolygons(Indices.Num() / 3);
+
+		TArray<FVertexInstanceID> VertexInstances;
+		VertexInstances.Reserve(NumVertices);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			const FVertexID VertexID = OutMeshDescription.CreateVertex();
+			Positions[VertexID] = PositionBuffer.VertexPosition(VertexIndex);
+
+			const FVertexInstanceID VertexInstanceID = OutMeshDescription.CreateVertexInstance(VertexID);
+			const FVector TangentX = VertexBuffer.VertexTangentX(VertexIndex);
+			const FVector4 TangentZ = VertexBuffer.VertexTangentZ(VertexIndex);
+			Normals[VertexInstanceID] = TangentZ;
+			Tangents[VertexInstanceID] = TangentX;
+			BinormalSigns[VertexInstanceID] = TangentZ.W < 0.0f ? -1.0f : 1.0f;
+			UVs.Set(VertexInstanceID, 0, VertexBuffer.GetVertexUV(VertexIndex, 0));
+			UVs.Set(VertexInstanceID, 1, FVector2D((VertexIndex + 0.5f) / NumVertices, 0.0f));
+			VertexInstances.Add(VertexInstanceID);
+		}
+
+		const TArray<FSkeletalMaterial>& Materials = SkeletalMesh.GetMaterials();
+		for (const FSkelMeshRenderSection& Section : LODData.RenderSections)
+		{
+			const FPolygonGroupID PolygonGroupID = OutMeshDescription.CreatePolygonGroup();
+			const FName SlotName = Materials.IsValidIndex(Section.MaterialIndex) ? Materials[Section.MaterialIndex].MaterialSlotName : NAME_None;
+			SlotNames[PolygonGroupID] = SlotName;
+			OutSlotNames.Add(SlotName);
+
+			for (uint32 TriangleIndex = 0; TriangleIndex < Section.NumTriangles; ++TriangleIndex)
+			{
+				const uint32 FirstIndex = Section.BaseIndex + TriangleIndex * 3;
+				const FVertexInstanceID TriangleVertices[3] =
+				{
+					VertexInstances[Indices[FirstIndex + 0]],
+					VertexInstances[Indices[FirstIndex + 1]],
+					VertexInstances[Indices[FirstIndex + 2]],
+				};
+				OutMeshDescription.CreateTriangle(PolygonGroupID, TriangleVertices);
+			}
+		}
+	}
+}
+
+UBakedVertexAnimation::UBakedVertexAnimation(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, SourceMesh(nullptr)
+	, SourceSequence(nullptr)
+	, SourceLODIndex(0)
+	, SampleRate(30.0f)
+	, Material(nullptr)
+	, StaticMesh(nullptr)
+	, PositionTexture(nullptr)
+	, NormalTexture(nullptr)
+	, NumVertices(0)
+	, NumFrames(0)
+	, PlayLength(0.0f)
+{
+}
+
+bool UBakedVertexAnimation::IsBaked() const
+{
+	return StaticMesh && PositionTexture && NormalTexture && NumVertices > 0 && NumFrames > 0 && PlayLength > 0.0f;
+}
+
+bool UBakedVertexAnimation::Bake(FString& OutError)
+{
+	using namespace BakedVertexAnimation;
+
+	if (!SourceMesh || !SourceSequence)
+	{
+		OutError = TEXT("A source mesh and sequence are needed");
+		return false;
+	}
+
+	if (SourceSequence->GetSkeleton() != SourceMesh->GetSkeleton())
+	{
+		OutError = FString::Printf(TEXT("%s doesn't use the skeleton of %s"), *SourceSequence->GetName(), *SourceMesh->GetName());
+		return false;
+	}
+
+	const FSkeletalMeshRenderData* RenderData = SourceMesh->GetResourceForRendering();
+	if (!RenderData || !RenderData->LODRenderData.IsValidIndex(SourceLODIndex))
+	{
+		OutError = FString::Printf(TEXT("%s has no LOD %d"), *SourceMesh->GetName(), SourceLODIndex);
+		return false;
+	}
+
+	const FSkeletalMeshLODRenderData& LODData = RenderData->LODRenderData[SourceLODIndex];
+	const FPositionVertexBuffer& PositionBuffer = LODData.StaticVertexBuffers.PositionVertexBuffer;
+	const FStaticMeshVertexBuffer& VertexBuffer = LODData.StaticVertexBuffers.StaticMeshVertexBuffer;
+	if (!PositionBuffer.GetVertexData() || !VertexBuffer.GetTangentData() || !LODData.MultiSizeIndexContainer.IsIndexBufferValid())
+	{
+		OutError = FString::Printf(TEXT("LOD %d of %s needs CPU access to be baked"), SourceLODIndex, *SourceMesh->GetName());
+		return false;
+	}
+
+	const int32 MaxTextureDimension = (int32)GetMax2DTextureDimension();
+	const int32 NewNumVertices = PositionBuffer.GetNumVertices();
+	const float NewPlayLength = SourceSequence->SequenceLength;
+	const int32 NewNumFrames = FMath::Max(FMath::CeilToInt(NewPlayLength * SampleRate), 1);
+	if (NewNumVertices > MaxTextureDimension || NewNumFrames > MaxTextureDimension || NewPlayLength <= 0.0f)
+	{
+		OutError = FString::Printf(TEXT("%d vertices and %d frames don't fit in a %d texture, bake a smaller LOD or lower the sample rate"), NewNumVertices, NewNumFrames, MaxTextureDimension);
+		return false;
+	}
+
+	TArray<uint32> Indices;
+	LODData.MultiSizeIndexContainer.GetIndexBuffer(Indices);
+
+	// Evaluate every bone of the mesh, the LOD's sections only reference some of them
+	const FReferenceSkeleton& RefSkeleton = SourceMesh->GetRefSkeleton();
+	TArray<FBoneIndexType> RequiredBoneIndices;
+	RequiredBoneIndices.SetNumUninitialized(RefSkeleton.GetNum());
+	for (int32 BoneIndex = 0; BoneIndex < RequiredBoneIndices.Num(); ++BoneIndex)
+	{
+		RequiredBoneIndices[BoneIndex] = (FBoneIndexType)BoneIndex;
+	}
+	FBoneContainer BoneContainer(RequiredBoneIndices, FCurveEvaluationOption(false), *SourceMesh);
+
+	const TArray<FMatrix>& RefBasesInvMatrix = SourceMesh->GetRefBasesInvMatrix();
+	TArray<FMatrix> RefToLocals;
+	RefToLocals.SetNumUninitialized(RefBasesInvMatrix.Num());
+	TArray<FTransform> ComponentSpaceTransforms;
+
+	TArray<FFloat16Color> PositionTexels;
+	TArray<FFloat16Color> NormalTexels;
+	PositionTexels.SetNumZeroed(NewNumVertices * NewNumFrames);
+	NormalTexels.SetNumZeroed(NewNumVertices * NewNumFrames);
+
+	const FSkinWeightVertexBuffer& SkinWeights = LODData.SkinWeightVertexBuffer;
+	const int32 MaxBoneInfluences = SkinWeights.GetMaxBoneInfluences();
+	FVector MaxOffset = FVector::ZeroVector;
+
+	for (int32 FrameIndex = 0; FrameIndex < NewNumFrames; ++FrameIndex)
+	{
+		ComponentSpaceTransforms.Reset();
+		ComponentSpaceTransforms.SetNum(RefToLocals.Num());
+		EvaluateComponentSpacePose(FMath::Min(FrameIndex / SampleRate, NewPlayLength), BoneContainer, ComponentSpaceTransforms);
+		for (int32 MeshBoneIndex = 0; MeshBoneIndex < RefToLocals.Num(); ++MeshBoneIndex)
+		{
+			RefToLocals[MeshBoneIndex] = RefBasesInvMatrix[MeshBoneIndex] * ComponentSpaceTransforms[MeshBoneIndex].ToMatrixWithScale();
+		}
+
+		FFloat16Color* PositionRow = PositionTexels.GetData() + FrameIndex * NewNumVertices;
+		FFloat16Color* NormalRow = NormalTexels.GetData() + FrameIndex * NewNumVertices;
+
+		for (const FSkelMeshRenderSection& Section : LODData.RenderSections)
+		{
+			for (uint32 SectionVertexIndex = 0; SectionVertexIndex < Section.NumVertices; ++SectionVertexIndex)
+			{
+				const int32 VertexIndex = Section.BaseVertexIndex + SectionVertexIndex;
+				const FVector RefPosition = PositionBuffer.VertexPosition(VertexIndex);
+				const FVector RefNormal = VertexBuffer.VertexTangentZ(VertexIndex);
+
+				FVector Position = FVector::ZeroVector;
+				FVector Normal = FVector::ZeroVector;
+				for (int32 InfluenceIndex = 0; InfluenceIndex < MaxBoneInfluences; ++InfluenceIndex)
+				{
+					const uint8 Weight = SkinWeights.GetBoneWeight(VertexIndex, InfluenceIndex);
+					if (Weight == 0)
+					{
+						continue;
+					}
+
+					const FMatrix& RefToLocal = RefToLocals[Section.BoneMap[SkinWeights.GetBoneIndex(VertexIndex, InfluenceIndex)]];
+					Position += RefToLocal.TransformPosition(RefPosition) * (Weight / 255.0f);
+					Normal += RefToLocal.TransformVector(RefNormal) * (Weight / 255.0f);
+				}
+
+				const FVector Offset = Position - RefPosition;
+				MaxOffset = MaxOffset.ComponentMax(Offset.GetAbs());
+
+				PositionRow[VertexIndex] = FFloat16Color(FLinearColor(Offset.X, Offset.Y, Offset.Z, 1.0f));
+				Normal = Normal.GetSafeNormal(SMALL_NUMBER, RefNormal);
+				NormalRow[VertexIndex] = FFloat16Color(FLinearColor(Normal.X, Normal.Y, Normal.Z, 1.0f));
+			}
+		}
+	}
+
+	Modify();
+
+	FMeshDescription MeshDescription;
+	TArray<FName> SlotNames;
+	BuildMeshDescription(*SourceMesh, LODData, Indices, MeshDescription, SlotNames);
+
+	StaticMesh = NewObject<UStaticMesh>(this, TEXT("BakedStaticMesh"), RF_Public);
+	for (const FName SlotName : SlotNames)
+	{
+		StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material, SlotName, SlotName));
+	}
+
+	// The reference pose bounds don't cover the animation
+	StaticMesh->SetPositiveBoundsExtension(MaxOffset);
+	StaticMesh->SetNegativeBoundsExtension(MaxOffset);
+
+	// Half float UVs can't tell apart the columns of more than a couple thousand vertices
+	UStaticMesh::FBuildMeshDescriptionsParams BuildParams;
+	BuildParams.bMarkPackageDirty = false;
+	BuildParams.bUseFullPrecisionUVs = true;
+	StaticMesh->BuildFromMeshDescriptions({ &MeshDescription }, BuildParams);
+
+	PositionTexture = CreateTexture(this, TEXT("BakedPositionTexture"), NewNumVertices, NewNumFrames, PositionTexels);
+	NormalTexture = CreateTexture(this, TEXT("BakedNormalTexture"), NewNumVertices, NewNumFrames, NormalTexels);
+
+	NumVertices = NewNumVertices;
+	NumFrames = NewNumFrames;
+	PlayLength = NewPlayLength;
+
+	UE_LOG(LogBakedVertexAnimation, Log, TEXT("Baked %s on LOD %d of %s: %d vertices, %d frames"), *SourceSequence->GetName(), SourceLODIndex, *SourceMesh->GetName(), NumVertices, NumFrames);
+
+	MarkPackageDirty();
+	return IsBaked();
+}
+
+void UBakedVertexAnimation::EvaluateComponentSpacePose(const float Time, const FBoneContainer& BoneContainer, TArray<FTransform>& OutComponentSpaceTransforms) const
+{
+	FMemMark Mark(FMemStack::Get());
+
+	FCompactPose Pose;
+	Pose.SetBoneContainer(&BoneContainer);
+	FBlendedCurve Curve;
+	Curve.InitFrom(BoneContainer);
+	FStackCustomAttributes Attributes;
+	FAnimationPoseData PoseData(Pose, Curve, Attributes);
+	SourceSequence->GetBonePose(PoseData, FAnimExtractContext(Time));
+
+	FCSPose<FCompactPose> ComponentSpacePose;
+	ComponentSpacePose.InitPose(Pose);
+	for (const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+	{
+		const int32 MeshBoneIndex = BoneContainer.MakeMeshPoseIndex(BoneIndex).GetInt();
+		if (OutComponentSpaceTransforms.IsValidIndex(MeshBoneIndex))
+		{
+			OutComponentSpaceTransforms[MeshBoneIndex] = ComponentSpacePose.GetComponentSpaceTransform(BoneIndex);
+		}
+	}
+}
+
+UMaterialInstanceDynamic* UBakedVertexAnimation::CreateMaterialInstance(UObject* Outer) const
+{
+	if (!Material || !IsBaked())
+	{
+		return nullptr;
+	}
+
+	UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(Material, Outer);
+	MaterialInstance->SetTextureParameterValue(PositionTextureParameterName, PositionTexture);
+	MaterialInstance->SetTextureParameterValue(NormalTextureParameterName, NormalTexture);
+	MaterialInstance->SetScalarParameterValue(NumFramesParameterName, (float)NumFrames);
+	MaterialInstance->SetScalarParameterValue(PlayLengthParameterName, PlayLength);
+	return MaterialInstance;
+}
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/BakedVertexAnimationSubsystem.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "Animation/AnimStats.h"
+#include "Animation/BakedVertexAnimation.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+DEFINE_STAT(STAT_BakedVertexAnimationUpdate);
+DEFINE_STAT(STAT_NumBakedVertexAnimationInstances);
+
+static TAutoConsoleVariable<int32> CVarBakedVertexAnimation(
+	TEXT("a.BakedVertexAnimation"),
+	1,
+	TEXT("If 0, skeletal mesh components never switch to their baked vertex animation, and the ones using it switch back."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBakedVertexAnimationHysteresis(
+	TEXT("a.BakedVertexAnimation.Hysteresis"),
+	0.1f,
+	TEXT("Fraction of BakedVertexAnimationDistance a view has to come closer than it before a component switches back to skeletal animation, so components on the threshold don't switch every frame."),
+	ECVF_Default);
+
+bool UBakedVertexAnimationSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	// Editor worlds are never far enough from the camera to bother, and components don't tick there the same way
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBakedVertexAnimationSubsystem::Deinitialize()
+{
+	for (USkeletalMeshComponent* Component : Components)
+	{
+		if (Component && Component->bUsingBakedVertexAnimation)
+		{
+			SwitchToSkeletal(Component);
+		}
+	}
+	Components.Empty();
+
+	for (TPair<UBakedVertexAnimation*, FBakedVertexAnimationBatch>& Pair : Batches)
+	{
+		if (Pair.Value.Instances)
+		{
+			Pair.Value.Instances->DestroyComponent();
+		}
+	}
+	Batches.Empty();
+
+	Super::Deinitialize();
+}
+
+void UBakedVertexAnimationSubsystem::RegisterComponent(USkeletalMeshComponent* Component)
+{
+	if (Component)
+	{
+		Components.AddUnique(Component);
+	}
+}
+
+void UBakedVertexAnimationSubsystem::UnregisterComponent(USkeletalMeshComponent* Component)
+{
+	if (Component && Components.RemoveSwap(Component) > 0 && Component->bUsingBakedVertexAnimation)
+	{
+		SwitchToSkeletal(Component);
+	}
+}
+
+int32 UBakedVertexAnimationSubsystem::GetNumBakedComponents() const
+{
+	int32 NumBaked = 0;
+	for (const TPair<UBakedVertexAnimation*, FBakedVertexAnimationBatch>& Pair : Batches)
+	{
+		NumBaked += Pair.Value.Owners.Num();
+	}
+	return NumBaked;
+}
+
+void UBakedVertexAnimationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BakedVertexAnimationUpdate);
+
+	Super::Tick(DeltaTime);
+
+	const UWorld* World = GetWorld();
+	const TArray<FVector>& ViewLocations = World->ViewLocationsRenderedLastFrame;
+	const bool bEnabled = CVarBakedVertexAnimation.GetValueOnGameThread() != 0;
+	const float Hysteresis = FMath::Clamp(CVarBakedVertexAnimationHysteresis.GetValueOnGameThread(), 0.0f, 1.0f);
+
+	for (int32 ComponentIndex = Components.Num() - 1; ComponentIndex >= 0; --ComponentIndex)
+	{
+		USkeletalMeshComponent* Component = Components[ComponentIndex];
+		if (!Component)
+		{
+			Components.RemoveAtSwap(ComponentIndex);
+			continue;
+		}
+
+		const bool bCanUseBaked = bEnabled && Component->BakedVertexAnimation && Component->BakedVertexAnimation->IsBaked() && Component->BakedVertexAnimationDistance > 0.0f;
+		if (!bCanUseBaked)
+		{
+			if (Component->bUsingBakedVertexAnimation)
+			{
+				SwitchToSkeletal(Component);
+			}
+			continue;
+		}
+
+		// Nothing was rendered, keep things as they are rather than switching everything on a frame without views
+		if (ViewLocations.Num() == 0)
+		{
+			continue;
+		}
+
+		const FVector Location = Component->Bounds.Origin;
+		float MinDistanceSquared = MAX_flt;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+		}
+
+		const float Distance = Component->BakedVertexAnimationDistance * (Component->bUsingBakedVertexAnimation ? 1.0f - Hysteresis : 1.0f);
+		const bool bWantsBaked = MinDistanceSquared > FMath::Square(Distance);
+
+		if (bWantsBaked != Component->bUsingBakedVertexAnimation)
+		{
+			if (bWantsBaked)
+			{
+				SwitchToBaked(Component);
+			}
+			else
+			{
+				SwitchToSkeletal(Component);
+			}
+		}
+		else if (bWantsBaked)
+		{
+			// Only moving components need their instance updated, the animation plays on its own
+			const FBakedVertexAnimationBatch* Batch = Batches.Find(Component->BakedVertexAnimation);
+
+			FTransform InstanceTransform;
+			if (Batch && Batch->Instances->GetInstanceTransform(Component->BakedVertexAnimationInstanceIndex, InstanceTransform, true) && !InstanceTransform.Equals(Component->GetComponentTransform()))
+			{
+				Batch->Instances->UpdateInstanceTransform(Component->BakedVertexAnimationInstanceIndex, Component->GetComponentTransform(), true, true);
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_NumBakedVertexAnimationInstances, GetNumBakedComponents());
+}
+
+void UBakedVertexAnimationSubsystem::SwitchToBaked(USkeletalMeshComponent* Component)
+{
+	check(!Component->bUsingBakedVertexAnimation);
+
+	UBakedVertexAnimation* BakedVertexAnimation = Component->BakedVertexAnimation;
+
+	FBakedVertexAnimationBatch& Batch = Batches.FindOrAdd(BakedVertexAnimation);
+	if (!Batch.Instances)
+	{
+		Batch.Instances = NewObject<UInstancedStaticMeshComponent>(this);
+		Batch.Instances->SetStaticMesh(BakedVertexAnimation->StaticMesh);
+		Batch.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Batch.Instances->SetCanEverAffectNavigation(false);
+		Batch.Instances->NumCustomDataFloats = 2;
+
+		UMaterialInstanceDynamic* MaterialInstance = BakedVertexAnimation->CreateMaterialInstance(Batch.Instances);
+		for (int32 MaterialIndex = 0; MaterialIndex < Batch.Instances->GetNumMaterials(); ++MaterialIndex)
+		{
+			Batch.Instances->SetMaterial(MaterialIndex, MaterialInstance);
+		}
+
+		Batch.Instances->RegisterComponentWithWorld(GetWorld());
+	}
+
+	// Start the baked animation where the skeletal one is, so the switch doesn't pop
+	float CurrentTime = 0.0f;
+	float PlayRate = 1.0f;
+	UAnimSingleNodeInstance* SingleNodeInstance = Component->GetSingleNodeInstance();
+	if (SingleNodeInstance && SingleNodeInstance->GetAnimationAsset() == BakedVertexAnimation->SourceSequence)
+	{
+		CurrentTime = SingleNodeInstance->GetCurrentTime();
+		PlayRate = SingleNodeInstance->GetPlayRate();
+	}
+	else
+	{
+		// Playing something else, spread components over the loop so crowds don't march in step
+		CurrentTime = FMath::FRand() * BakedVertexAnimation->PlayLength;
+	}
+
+	const float StartTime = GetWorld()->GetTimeSeconds() - CurrentTime / FMath::Max(PlayRate, KINDA_SMALL_NUMBER);
+
+	const int32 InstanceIndex = Batch.Instances->AddInstanceWorldSpace(Component->GetComponentTransform());
+	Batch.Instances->SetCustomDataValue(InstanceIndex, 0, StartTime);
+	Batch.Instances->SetCustomDataValue(InstanceIndex, 1, PlayRate, true);
+	check(InstanceIndex == Batch.Owners.Num());
+	Batch.Owners.Add(Component);
+
+	Component->BakedVertexAnimationInstanceIndex = InstanceIndex;
+	Component->bUsingBakedVertexAnimation = true;
+	Component->bTickEnabledBeforeBakedVertexAnimation = Component->IsComponentTickEnabled();
+	Component->SetComponentTickEnabled(false);
+	Component->MarkRenderStateDirty();
+}
+
+void UBakedVertexAnimationSubsystem::SwitchToSkeletal(USkeletalMeshComponent* Component)
+{
+	check(Component->bUsingBakedVertexAnimation);
+
+	FBakedVertexAnimationBatch* Batch = Batches.Find(Component->BakedVertexAnimation);
+	const int32 InstanceIndex = Component->BakedVertexAnimationInstanceIndex;
+	if (Batch && Batch->Owners.IsValidIndex(InstanceIndex) && Batch->Owners[InstanceIndex] == Component)
+	{
+		// Pick the skeletal animation up where the baked one is
+		UAnimSingleNodeInstance* SingleNodeInstance = Component->GetSingleNodeInstance();
+		if (SingleNodeInstance && SingleNodeInstance->GetAnimationAsset() == Component->BakedVertexAnimation->SourceSequence)
+		{
+			const int32 CustomDataIndex = InstanceIndex * Batch->Instances->NumCustomDataFloats;
+			const float StartTime = Batch->Instances->PerInstanceSMCustomData[CustomDataIndex];
+			const float PlayRate = Batch->Instances->PerInstanceSMCustomData[CustomDataIndex + 1];
+			const float PlayLength = Component->BakedVertexAnimation->PlayLength;
+			SingleNodeInstance->SetPosition(FMath::Fmod((GetWorld()->GetTimeSeconds() - StartTime) * PlayRate, PlayLength), false);
+		}
+
+		// Instances after the removed one move down a slot
+		Batch->Instances->RemoveInstance(InstanceIndex);
+		Batch->Owners.RemoveAt(InstanceIndex, 1, false);
+		for (int32 OwnerIndex = InstanceIndex; OwnerIndex < Batch->Owners.Num(); ++OwnerIndex)
+		{
+			Batch->Owners[OwnerIndex]->BakedVertexAnimationInstanceIndex = OwnerIndex;
+		}
+	}
+
+	Component->BakedVertexAnimationInstanceIndex = INDEX_NONE;
+	Component->bUsingBakedVertexAnimation = false;
+	Component->SetComponentTickEnabled(Component->bTickEnabledBeforeBakedVertexAnimation);
+	Component->MarkRenderStateDirty();
+}
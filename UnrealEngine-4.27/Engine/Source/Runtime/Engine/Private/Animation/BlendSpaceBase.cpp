@@ -12,6 +12,7 @@
 #include "UObject/UObjectIterator.h"
 #include "Logging/TokenizedMessage.h"
 #include "Logging/MessageLog.h"
+#include "Animation/AnimSequence.h"
 #include "Animation/AnimationPoseData.h"
 #include "Animation/CustomAttributesRuntime.h"
 
@@ -373,7 +374,8 @@ void UBlendSpaceBase::TickAssetPlayer(FAnimTickRecord& Instance, struct FAnimNot
 
 			// generate notifies and sets time
 			{
-				TArray<FAnimNotifyEventReference> Notifies;
+				FScopedAnimNotifyScratch NotifyScratch;
+				TArray<FAnimNotifyEventReference>& Notifies = NotifyScratch.Get();
 
 				const float ClampedNormalizedPreviousTime = FMath::Clamp<float>(NormalizedPreviousTime, 0.f, 1.f);
 				const float ClampedNormalizedCurrentTime = FMath::Clamp<float>(NormalizedCurrentTime, 0.f, 1.f);
@@ -608,6 +610,12 @@ void UBlendSpaceBase::GetAnimationPose(TArray<FBlendSampleData>& BlendSampleData
 		ChildrenCurves[ChildrenIdx].InitFrom(OutCurve);
 	}
 
+	TArray<FAnimationPoseData, TInlineAllocator<8>> ChildrenPoseData;
+	ChildrenPoseData.Reserve(NumPoses);
+
+	TArray<FAnimSequencePoseRequest, TInlineAllocator<8>> PoseRequests;
+	PoseRequests.Reserve(NumPoses);
+
 	// get all child atoms we interested in
 	for(int32 I = 0; I < BlendSampleDataCache.Num(); ++I)
 	{
@@ -627,9 +635,9 @@ void UBlendSpaceBase::GetAnimationPose(TArray<FBlendSampleData>& BlendSampleData
 			{
 				const float Time = FMath::Clamp<float>(BlendSampleDataCache[I].Time, 0.f, Sample.Animation->SequenceLength);
 
-				FAnimationPoseData ChildAnimationPoseData = { Pose, ChildrenCurves[I], ChildrenAttributes[I] };
-				// first one always fills up the source one
-				Sample.Animation->GetAnimationPose(ChildAnimationPoseData, FAnimExtractContext(Time, true));
+				// Extracted together below, so samples sharing a sequence decode its keys once
+				FAnimationPoseData& ChildAnimationPoseData = ChildrenPoseData.Emplace_GetRef(Pose, ChildrenCurves[I], ChildrenAttributes[I]);
+				PoseRequests.Emplace(Sample.Animation, ChildAnimationPoseData, FAnimExtractContext(Time, true));
 			}
 			else
 			{
@@ -642,6 +650,8 @@ void UBlendSpaceBase::GetAnimationPose(TArray<FBlendSampleData>& BlendSampleData
 		}
 	}
 
+	UAnimSequence::GetAnimationPoses(PoseRequests);
+
 	TArrayView<FCompactPose> ChildrenPosesView(ChildrenPoses);
 
 	if (PerBoneBlend.Num() > 0)
@@ -0,0 +1,202 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Animation/SharedPoseEvaluationCache.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "Animation/AnimStats.h"
+#include "Engine/SkeletalMesh.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_SharedPoseEvaluationCopy);
+DEFINE_STAT(STAT_SharedPoseEvaluationHits);
+DEFINE_STAT(STAT_SharedPoseEvaluationMisses);
+DEFINE_STAT(STAT_SharedPoseEvaluationSavedTime);
+
+static TAutoConsoleVariable<int32> CVarSharedPoseEvaluation(
+	TEXT("a.SharedPoseEvaluation"),
+	0,
+	TEXT("If 1, skeletal mesh components playing the same sequence through a single node instance, on the same mesh and LOD, at times within the same step, evaluate the pose once per frame and share it."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSharedPoseEvaluationTimeStep(
+	TEXT("a.SharedPoseEvaluation.TimeStep"),
+	1.0f / 30.0f,
+	TEXT("Step, in seconds, a.SharedPoseEvaluation quantizes playback times to. Components within the same step share a pose evaluated at its middle, so a longer step shares more and animates in coarser steps."),
+	ECVF_Default);
+
+/** Entries unused for this many frames are freed */
+static const uint64 SharedPoseEvaluationMaxEntryAge = 2;
+
+FSharedPoseEvaluationCache& FSharedPoseEvaluationCache::Get()
+{
+	static FSharedPoseEvaluationCache Cache;
+	return Cache;
+}
+
+bool FSharedPoseEvaluationCache::IsEnabled()
+{
+	return CVarSharedPoseEvaluation.GetValueOnAnyThread() != 0;
+}
+
+bool FSharedPoseEvaluationCache::GetKey(const USkeletalMesh* InSkeletalMesh, const UAnimInstance* InAnimInstance, FSharedPoseEvaluationKey& OutKey)
+{
+	const UAnimSingleNodeInstance* SingleNodeInstance = Cast<UAnimSingleNodeInstance>(InAnimInstance);
+	if (!InSkeletalMesh || !SingleNodeInstance || SingleNodeInstance->MontageInstances.Num() > 0)
+	{
+		return false;
+	}
+
+	// Blend spaces depend on their input and montages on their slots, only plain sequences give the same pose for the same time
+	const UAnimSequence* Sequence = Cast<UAnimSequence>(SingleNodeInstance->CurrentAsset);
+	if (!Sequence || Sequence->SequenceLength <= 0.0f || !SingleNodeInstance->ParallelCanEvaluate(InSkeletalMesh))
+	{
+		return false;
+	}
+
+	// A fixed step rather than a fraction of the length, so long sequences don't animate in coarser steps than short ones
+	const float TimeStep = FMath::Max(CVarSharedPoseEvaluationTimeStep.GetValueOnAnyThread(), KINDA_SMALL_NUMBER);
+	const int32 NumSteps = FMath::Max(FMath::CeilToInt(Sequence->SequenceLength / TimeStep), 1);
+	const float Time = SingleNodeInstance->GetCurrentTimeOnAnyThread();
+
+	const FBoneContainer& RequiredBones = SingleNodeInstance->GetRequiredBonesOnAnyThread();
+
+	OutKey.Sequence = Sequence;
+	OutKey.SkeletalMesh = InSkeletalMesh;
+	OutKey.LODIndex = RequiredBones.GetCalculatedForLOD();
+	OutKey.NumRequiredBones = RequiredBones.GetBoneIndicesArray().Num();
+	OutKey.TimeStepIndex = FMath::Clamp(FMath::FloorToInt(Time / TimeStep), 0, NumSteps - 1);
+	OutKey.RootMotionMode = (uint8)SingleNodeInstance->RootMotionMode;
+	OutKey.EvaluationTime = FMath::Min((OutKey.TimeStepIndex + 0.5f) * TimeStep, Sequence->SequenceLength);
+	return true;
+}
+
+FSharedPoseEvaluationCache::EAcquireResult FSharedPoseEvaluationCache::Acquire(const FSharedPoseEvaluationKey& Key, const UAnimInstance* InAnimInstance, TArray<FTransform>& OutSpaceBases, TArray<FTransform>& OutBoneSpaceTransforms, FVector& OutRootBoneTranslation, FBlendedHeapCurve& OutCurve, FHeapCustomAttributes& OutAttributes)
+{
+	const uint64 Frame = GFrameCounter;
+
+	for (;;)
+	{
+		{
+			FReadScopeLock ReadLock(Lock);
+
+			const TUniquePtr<FEntry>* FoundEntry = Entries.Find(Key);
+			if (FoundEntry && (*FoundEntry)->Frame == Frame)
+			{
+				const FEntry& Entry = **FoundEntry;
+				if (!Entry.bReady)
+				{
+					// Being evaluated on another thread, evaluating it here is cheaper than holding up an animation worker
+					INC_DWORD_STAT(STAT_SharedPoseEvaluationMisses);
+					return EAcquireResult::Evaluate;
+				}
+				else if (Entry.SpaceBases.Num() == OutSpaceBases.Num() && Entry.BoneSpaceTransforms.Num() == OutBoneSpaceTransforms.Num())
+				{
+					const uint32 StartCycles = FPlatformTime::Cycles();
+					{
+						SCOPE_CYCLE_COUNTER(STAT_SharedPoseEvaluationCopy);
+
+						FMemory::Memcpy(OutSpaceBases.GetData(), Entry.SpaceBases.GetData(), Entry.SpaceBases.Num() * sizeof(FTransform));
+						FMemory::Memcpy(OutBoneSpaceTransforms.GetData(), Entry.BoneSpaceTransforms.GetData(), Entry.BoneSpaceTransforms.Num() * sizeof(FTransform));
+						OutRootBoneTranslation = Entry.RootBoneTranslation;
+						OutAttributes = Entry.Attributes;
+
+						// Same mesh and LOD means the same curve layout, but keep pointing at this instance's lookup table
+						OutCurve.CopyFrom(Entry.Curve);
+						OutCurve.UIDToArrayIndexLUT = &InAnimInstance->GetRequiredBonesOnAnyThread().GetUIDToArrayLookupTable();
+					}
+					const uint32 CopyCycles = FPlatformTime::Cycles() - StartCycles;
+
+					INC_DWORD_STAT(STAT_SharedPoseEvaluationHits);
+					INC_FLOAT_STAT_BY(STAT_SharedPoseEvaluationSavedTime, Entry.EvaluationCycles > CopyCycles ? FPlatformTime::ToMilliseconds(Entry.EvaluationCycles - CopyCycles) : 0.0f);
+					return EAcquireResult::Copied;
+				}
+				else
+				{
+					return EAcquireResult::Evaluate;
+				}
+			}
+		}
+
+		FWriteScopeLock WriteLock(Lock);
+
+		EvictStaleEntries(Frame);
+
+		TUniquePtr<FEntry>& Entry = Entries.FindOrAdd(Key);
+		if (!Entry.IsValid())
+		{
+			Entry = MakeUnique<FEntry>();
+		}
+		else if (Entry->Frame == Frame)
+		{
+			// Claimed by another thread since we looked
+			continue;
+		}
+
+		Entry->Frame = Frame;
+		Entry->bReady = false;
+
+		INC_DWORD_STAT(STAT_SharedPoseEvaluationMisses);
+		return EAcquireResult::Claimed;
+	}
+}
+
+void FSharedPoseEvaluationCache::Store(const FSharedPoseEvaluationKey& Key, const TArray<FTransform>& SpaceBases, const TArray<FTransform>& BoneSpaceTransforms, const FVector& RootBoneTranslation, const FBlendedHeapCurve& Curve, const FHeapCustomAttributes& Attributes, const uint32 EvaluationCycles)
+{
+	if (!Curve.IsValid())
+	{
+		Abandon(Key);
+		return;
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	TUniquePtr<FEntry>* FoundEntry = Entries.Find(Key);
+	if (FoundEntry && !(*FoundEntry)->bReady)
+	{
+		FEntry& Entry = **FoundEntry;
+		Entry.SpaceBases = SpaceBases;
+		Entry.BoneSpaceTransforms = BoneSpaceTransforms;
+		Entry.RootBoneTranslation = RootBoneTranslation;
+		Entry.Curve.CopyFrom(Curve);
+		Entry.Attributes = Attributes;
+		Entry.EvaluationCycles = EvaluationCycles;
+		Entry.bReady = true;
+	}
+}
+
+void FSharedPoseEvaluationCache::Abandon(const FSharedPoseEvaluationKey& Key)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	TUniquePtr<FEntry>* FoundEntry = Entries.Find(Key);
+	if (FoundEntry && !(*FoundEntry)->bReady)
+	{
+		Entries.Remove(Key);
+	}
+}
+
+void FSharedPoseEvaluationCache::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Entries.Empty();
+	LastEvictionFrame = 0;
+}
+
+void FSharedPoseEvaluationCache::EvictStaleEntries(const uint64 Frame)
+{
+	if (Frame == LastEvictionFrame)
+	{
+		return;
+	}
+	LastEvictionFrame = Frame;
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Value()->Frame + SharedPoseEvaluationMaxEntryAge < Frame)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
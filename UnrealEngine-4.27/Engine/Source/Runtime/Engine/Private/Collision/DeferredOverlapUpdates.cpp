@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	DeferredOverlapUpdates.cpp: Batched end of frame UpdateOverlaps queries
+=============================================================================*/
+
+#include "DeferredOverlapUpdates.h"
+#include "Stats/Stats.h"
+#include "Async/ParallelFor.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("DeferredOverlaps Flush"), STAT_DeferredOverlapsFlush, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("DeferredOverlaps Query"), STAT_DeferredOverlapsQuery, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("DeferredOverlaps Dispatch"), STAT_DeferredOverlapsDispatch, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DeferredOverlaps Queries"), STAT_DeferredOverlapsNumQueries, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DeferredOverlaps Requeried"), STAT_DeferredOverlapsNumRequeried, STATGROUP_Game);
+
+namespace DeferredOverlapUpdatesCVars
+{
+	static int32 EnableDeferredOverlapUpdates = 0;
+	static FAutoConsoleVariableRef CVarEnableDeferredOverlapUpdates(
+		TEXT("p.DeferredOverlapUpdates"),
+		EnableDeferredOverlapUpdates,
+		TEXT("Whether components with bDeferOverlapUpdates set gather their UpdateOverlaps queries into one batch run at the end of the frame.\n")
+		TEXT("0: Always update overlaps immediately, 1: Defer flagged components"),
+		ECVF_Default);
+
+	static int32 ParallelDeferredOverlapQueries = 1;
+	static FAutoConsoleVariableRef CVarParallelDeferredOverlapQueries(
+		TEXT("p.DeferredOverlapUpdates.Parallel"),
+		ParallelDeferredOverlapQueries,
+		TEXT("Whether the batched deferred overlap queries run on worker threads.\n")
+		TEXT("0: Run queries on the game thread, 1: Run queries in parallel"),
+		ECVF_Default);
+}
+
+FDeferredOverlapUpdates::FDeferredOverlapUpdates()
+	: DispatchingComponent(nullptr)
+	, DispatchingOverlaps(nullptr)
+	, bIsFlushing(false)
+{
+}
+
+FDeferredOverlapUpdates::~FDeferredOverlapUpdates()
+{
+}
+
+bool FDeferredOverlapUpdates::IsEnabled()
+{
+	return DeferredOverlapUpdatesCVars::EnableDeferredOverlapUpdates != 0;
+}
+
+bool FDeferredOverlapUpdates::Enqueue(UPrimitiveComponent* Component, bool bDoNotifies)
+{
+	check(IsInGameThread());
+
+	if (bIsFlushing || Component == nullptr)
+	{
+		return false;
+	}
+
+	if (const int32* PendingIndex = PendingComponents.Find(Component))
+	{
+		// Keep the first request's position in the queue, but make sure notifies are sent if any request wanted them.
+		PendingUpdates[*PendingIndex].bDoNotifies |= bDoNotifies;
+		return true;
+	}
+
+	PendingComponents.Add(Component, PendingUpdates.Num());
+	FPendingUpdate& Update = PendingUpdates.AddDefaulted_GetRef();
+	Update.Component = Component;
+	Update.bDoNotifies = bDoNotifies;
+	return true;
+}
+
+void FDeferredOverlapUpdates::Reset()
+{
+	PendingUpdates.Reset();
+	PendingComponents.Reset();
+}
+
+const TArray<FOverlapResult>* FDeferredOverlapUpdates::ConsumeBatchedOverlaps(const UPrimitiveComponent* Component)
+{
+	if (Component != nullptr && Component == DispatchingComponent)
+	{
+		const TArray<FOverlapResult>* Result = DispatchingOverlaps;
+		DispatchingComponent = nullptr;
+		DispatchingOverlaps = nullptr;
+		return Result;
+	}
+	return nullptr;
+}
+
+void FDeferredOverlapUpdates::Flush(UWorld* World)
+{
+	check(IsInGameThread());
+
+	if (PendingUpdates.Num() == 0 || bIsFlushing)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_DeferredOverlapsFlush);
+
+	TArray<FPendingUpdate> Updates = MoveTemp(PendingUpdates);
+	Reset();
+
+	// Gather query inputs on the game thread. Components are sorted by UniqueID so the dispatch order
+	// does not depend on the order in which (possibly parallel) ticks happened to move them.
+	TArray<FBatchedQuery> Queries;
+	Queries.Reserve(Updates.Num());
+	for (const FPendingUpdate& Update : Updates)
+	{
+		UPrimitiveComponent* Component = Update.Component.Get();
+		if (Component == nullptr || Component->IsPendingKill() || Component->GetWorld() != World)
+		{
+			continue;
+		}
+
+		const AActor* Owner = Component->GetOwner();
+		const bool bIgnoreChildren = Owner && (Owner->GetRootComponent() == Component);
+
+		FComponentQueryParams Params(SCENE_QUERY_STAT(DeferredUpdateOverlaps), bIgnoreChildren ? Owner : nullptr);
+		Params.bIgnoreBlocks = true;
+		FCollisionResponseParams ResponseParam;
+		Component->InitSweepCollisionParams(Params, ResponseParam);
+
+		Queries.Emplace(Component, Component->GetComponentLocation(), Component->GetComponentQuat(), Component->GetCollisionObjectType(), Params, Update.bDoNotifies);
+	}
+
+	Queries.Sort([](const FBatchedQuery& A, const FBatchedQuery& B)
+	{
+		return A.Component->GetUniqueID() < B.Component->GetUniqueID();
+	});
+
+	INC_DWORD_STAT_BY(STAT_DeferredOverlapsNumQueries, Queries.Num());
+
+	TArray<TArray<FOverlapResult>> Results;
+	Results.SetNum(Queries.Num());
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DeferredOverlapsQuery);
+
+		// Scene queries only read from the physics scene, so they are safe to run concurrently while the game thread waits.
+		const bool bForceSingleThreaded = (DeferredOverlapUpdatesCVars::ParallelDeferredOverlapQueries == 0);
+		ParallelFor(Queries.Num(), [&Queries, &Results, World](int32 Index)
+		{
+			const FBatchedQuery& Query = Queries[Index];
+			if (Query.Component->GetGenerateOverlapEvents() && Query.Component->IsQueryCollisionEnabled())
+			{
+				Query.Component->ComponentOverlapMulti(Results[Index], World, Query.Location, Query.Rotation, Query.Channel, Query.Params);
+			}
+		}, bForceSingleThreaded);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DeferredOverlapsDispatch);
+
+		TGuardValue<bool> FlushGuard(bIsFlushing, true);
+		for (int32 Index = 0; Index < Queries.Num(); ++Index)
+		{
+			const FBatchedQuery& Query = Queries[Index];
+			UPrimitiveComponent* Component = Query.Component;
+
+			// Events dispatched for earlier components may have destroyed or moved this one.
+			if (Component->IsPendingKill() || Component->GetWorld() != World)
+			{
+				continue;
+			}
+
+			const bool bUnmoved = Component->GetComponentLocation().Equals(Query.Location) && Component->GetComponentQuat().Equals(Query.Rotation);
+			if (!bUnmoved)
+			{
+				INC_DWORD_STAT(STAT_DeferredOverlapsNumRequeried);
+			}
+
+			DispatchingComponent = bUnmoved ? Component : nullptr;
+			DispatchingOverlaps = bUnmoved ? &Results[Index] : nullptr;
+			Component->UpdateOverlaps(nullptr, Query.bDoNotifies, nullptr);
+			DispatchingComponent = nullptr;
+			DispatchingOverlaps = nullptr;
+		}
+	}
+}
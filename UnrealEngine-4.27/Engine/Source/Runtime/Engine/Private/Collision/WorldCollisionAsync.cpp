@@ -7,6 +7,7 @@
 #include "CoreMinimal.h"
 #include "Stats/Stats.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "Async/ParallelFor.h"
 #include "EngineDefines.h"
 #include "Engine/EngineTypes.h"
 #include "CollisionQueryParams.h"
@@ -19,6 +20,10 @@
 
 CSV_DEFINE_CATEGORY(WorldCollision, true);
 
+DECLARE_CYCLE_STAT(TEXT("BatchTrace"), STAT_BatchTrace, STATGROUP_Collision);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("BatchTrace Requests"), STAT_BatchTraceNumRequests, STATGROUP_Collision);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("BatchTrace Collapsed"), STAT_BatchTraceNumCollapsed, STATGROUP_Collision);
+
 /**
  * Async trace functions
  * Pretty much same parameter set except you can optional set delegate to be called when execution is completed and you can set UserData if you'd like
@@ -49,6 +54,22 @@ namespace AsyncTraceCVars
 	{
 		return RunAsyncTraceOnWorkerThread != 0 && (FApp::ShouldUseThreadingForPerformance() || FForkProcessHelper::IsForkedMultithreadInstance());
 	}
+
+	static int32 BatchTraceMinTracesPerTask = 32;
+	static FAutoConsoleVariableRef CVarBatchTraceMinTracesPerTask(
+		TEXT("p.BatchTrace.MinTracesPerTask"),
+		BatchTraceMinTracesPerTask,
+		TEXT("Minimum number of unique traces each worker task of UWorld::BatchTraceByChannel runs. Batches smaller than this run on the calling thread.\n")
+		TEXT("<= 0: Always run batched traces on the calling thread"),
+		ECVF_Default);
+
+	static int32 BatchTraceCollapseDuplicates = 1;
+	static FAutoConsoleVariableRef CVarBatchTraceCollapseDuplicates(
+		TEXT("p.BatchTrace.CollapseDuplicates"),
+		BatchTraceCollapseDuplicates,
+		TEXT("Whether UWorld::BatchTraceByChannel only traces once for requests of the same batch with the same start, end, channel and trace type.\n")
+		TEXT("0: Trace every request, 1: Collapse duplicates"),
+		ECVF_Default);
 }
 
 namespace
@@ -532,3 +553,137 @@ void UWorld::FinishAsyncTrace()
 
 }
 
+
+int32 UWorld::BatchTraceByChannel(TArrayView<const FBatchTraceRequest> Requests, TArray<FHitResult>& OutHits, const FCollisionShape& CollisionShape /* = FCollisionShape::LineShape */, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */, TArray<TArray<FHitResult>>* OutMultiHits /* = nullptr */) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_BatchTrace);
+	INC_DWORD_STAT_BY(STAT_BatchTraceNumRequests, Requests.Num());
+
+	OutHits.Reset(Requests.Num());
+	if (OutMultiHits)
+	{
+		OutMultiHits->Reset(Requests.Num());
+	}
+	if (Requests.Num() == 0)
+	{
+		return 0;
+	}
+
+	const bool bAnyMulti = Requests.ContainsByPredicate([](const FBatchTraceRequest& Request) { return Request.TraceType == EAsyncTraceType::Multi; });
+	ensureMsgf(!bAnyMulti || OutMultiHits, TEXT("UWorld::BatchTraceByChannel was given Multi requests without OutMultiHits, only their blocking hits are returned"));
+
+	// Map every request of this batch to the first request with the same inputs, only those get traced.
+	TArray<int32> UniqueRequests;
+	TArray<int32> RequestToUnique;
+	RequestToUnique.SetNumUninitialized(Requests.Num());
+	if (AsyncTraceCVars::BatchTraceCollapseDuplicates)
+	{
+		TMap<FBatchTraceRequest, int32> UniqueIndices;
+		UniqueIndices.Reserve(Requests.Num());
+		for (int32 Idx = 0; Idx < Requests.Num(); ++Idx)
+		{
+			const int32* ExistingIndex = UniqueIndices.Find(Requests[Idx]);
+			if (ExistingIndex)
+			{
+				RequestToUnique[Idx] = *ExistingIndex;
+			}
+			else
+			{
+				RequestToUnique[Idx] = UniqueRequests.Add(Idx);
+				UniqueIndices.Add(Requests[Idx], RequestToUnique[Idx]);
+			}
+		}
+	}
+	else
+	{
+		UniqueRequests.SetNumUninitialized(Requests.Num());
+		for (int32 Idx = 0; Idx < Requests.Num(); ++Idx)
+		{
+			UniqueRequests[Idx] = Idx;
+			RequestToUnique[Idx] = Idx;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BatchTraceNumCollapsed, Requests.Num() - UniqueRequests.Num());
+
+	TArray<FHitResult> UniqueHits;
+	UniqueHits.SetNum(UniqueRequests.Num());
+
+	TArray<TArray<FHitResult>> UniqueMultiHits;
+	if (bAnyMulti)
+	{
+		UniqueMultiHits.SetNum(UniqueRequests.Num());
+	}
+
+	// Split the unique traces into one contiguous range per task rather than one task per trace,
+	// so each worker pays the scheduling cost once no matter how large the batch is.
+	const bool bLineTrace = (CollisionShape.ShapeType == ECollisionShape::Line) || CollisionShape.IsNearlyZero();
+	const int32 MinTracesPerTask = AsyncTraceCVars::BatchTraceMinTracesPerTask;
+	const bool bRunOnWorkers = MinTracesPerTask > 0 && UniqueRequests.Num() > MinTracesPerTask && AsyncTraceCVars::IsAsyncTraceOnWorkerThreads();
+	const int32 NumTasks = bRunOnWorkers ? FMath::Min(FMath::DivideAndRoundUp(UniqueRequests.Num(), MinTracesPerTask), FTaskGraphInterface::Get().GetNumWorkerThreads() + 1) : 1;
+	const int32 TracesPerTask = FMath::DivideAndRoundUp(UniqueRequests.Num(), NumTasks);
+
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+	{
+		const int32 First = TaskIndex * TracesPerTask;
+		const int32 Last = FMath::Min(First + TracesPerTask, UniqueRequests.Num());
+		for (int32 UniqueIdx = First; UniqueIdx < Last; ++UniqueIdx)
+		{
+			const FBatchTraceRequest& Request = Requests[UniqueRequests[UniqueIdx]];
+			FHitResult& Hit = UniqueHits[UniqueIdx];
+			Hit = FHitResult(Request.Start, Request.End);
+
+			if (Request.TraceType == EAsyncTraceType::Test)
+			{
+				Hit.bBlockingHit = bLineTrace
+					? FPhysicsInterface::RaycastTest(this, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam)
+					: FPhysicsInterface::GeomSweepTest(this, CollisionShape, FQuat::Identity, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam);
+			}
+			else if (Request.TraceType == EAsyncTraceType::Multi)
+			{
+				TArray<FHitResult>& MultiHits = UniqueMultiHits[UniqueIdx];
+				if (bLineTrace)
+				{
+					FPhysicsInterface::RaycastMulti(this, MultiHits, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam);
+				}
+				else
+				{
+					FPhysicsInterface::GeomSweepMulti(this, CollisionShape, FQuat::Identity, MultiHits, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam);
+				}
+
+				// The blocking hit, if any, comes last
+				if (MultiHits.Num() > 0 && MultiHits.Last().bBlockingHit)
+				{
+					Hit = MultiHits.Last();
+				}
+			}
+			else if (bLineTrace)
+			{
+				FPhysicsInterface::RaycastSingle(this, Hit, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam);
+			}
+			else
+			{
+				FPhysicsInterface::GeomSweepSingle(this, CollisionShape, FQuat::Identity, Hit, Request.Start, Request.End, Request.TraceChannel, Params, ResponseParam);
+			}
+		}
+	}, NumTasks == 1);
+
+	int32 NumBlockingHits = 0;
+	for (int32 Idx = 0; Idx < Requests.Num(); ++Idx)
+	{
+		const FHitResult& Hit = UniqueHits[RequestToUnique[Idx]];
+		NumBlockingHits += Hit.bBlockingHit ? 1 : 0;
+		OutHits.Add(Hit);
+
+		if (OutMultiHits)
+		{
+			TArray<FHitResult>& MultiHits = OutMultiHits->AddDefaulted_GetRef();
+			if (Requests[Idx].TraceType == EAsyncTraceType::Multi)
+			{
+				MultiHits = UniqueMultiHits[RequestToUnique[Idx]];
+			}
+		}
+	}
+
+	return NumBlockingHits;
+}
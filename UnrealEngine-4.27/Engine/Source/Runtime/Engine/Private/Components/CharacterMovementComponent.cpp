@@ -60,6 +60,15 @@ DECLARE_CYCLE_STAT(TEXT("Char SmoothClientPosition_Visual"), STAT_CharacterMovem
 DECLARE_CYCLE_STAT(TEXT("Char Physics Interation"), STAT_CharPhysicsInteraction, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char FindFloor"), STAT_CharFindFloor, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Batched Floor Queries"), STAT_CharBatchedFloorQueries, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Batched Floor Query Hits"), STAT_CharBatchedFloorQueryHits, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Batched Floor Query Stale"), STAT_CharBatchedFloorQueryStale, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Proxy Floor Reuses"), STAT_CharProxyFloorReuses, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Movement LOD 0"), STAT_CharMovementLOD0, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Movement LOD 1"), STAT_CharMovementLOD1, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Movement LOD 2+"), STAT_CharMovementLOD2Plus, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Movement LOD Skipped Updates"), STAT_CharMovementLODSkipped, STATGROUP_Character);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Char Movement LOD Time Saved (ms)"), STAT_CharMovementLODTimeSaved, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char AdjustFloorHeight"), STAT_CharAdjustFloorHeight, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char Update Acceleration"), STAT_CharUpdateAcceleration, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char MoveUpdateDelegate"), STAT_CharMoveUpdateDelegate, STATGROUP_Character);
@@ -95,6 +104,8 @@ static const FString PerfCounter_NumServerMoveCorrections = TEXT("NumServerMoveC
 #endif
 
 
+FCharacterMovementLODSignificanceDelegate UCharacterMovementComponent::OnCalculateMovementLODSignificance;
+
 // CVars
 namespace CharacterMovementCVars
 {
@@ -132,6 +143,37 @@ namespace CharacterMovementCVars
 		TEXT("0: Disable, 1: Enable"),
 		ECVF_Default);
 
+	static int32 BatchedFloorQueries = 1;
+	FAutoConsoleVariableRef CVarBatchedFloorQueries(
+		TEXT("p.BatchedFloorQueries"),
+		BatchedFloorQueries,
+		TEXT("Whether characters with bUseBatchedFloorQueries submit async floor sweeps for their next update, run in parallel at the end of the frame.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 SimulatedProxyFloorReuse = 1;
+	FAutoConsoleVariableRef CVarSimulatedProxyFloorReuse(
+		TEXT("p.SimulatedProxyFloorReuse"),
+		SimulatedProxyFloorReuse,
+		TEXT("Whether simulated proxies may reuse a recent nearby floor result instead of finding the floor, if SimulatedProxyFloorReuseDistance is non-zero on the movement component.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 CharacterMovementLOD = 1;
+	FAutoConsoleVariableRef CVarCharacterMovementLOD(
+		TEXT("p.CharacterMovementLOD"),
+		CharacterMovementLOD,
+		TEXT("Whether characters with bEnableMovementLOD may run movement at a reduced rate when far from viewers or not rendered.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static float CharacterMovementLODCheckInterval = 0.25f;
+	FAutoConsoleVariableRef CVarCharacterMovementLODCheckInterval(
+		TEXT("p.CharacterMovementLOD.CheckInterval"),
+		CharacterMovementLODCheckInterval,
+		TEXT("Time in seconds between recalculations of a character's movement LOD level."),
+		ECVF_Default);
+
 	// Logging when character is stuck. Off by default in shipping.
 #if UE_BUILD_SHIPPING
 	static float StuckWarningPeriod = -1.f;
@@ -528,6 +570,28 @@ UCharacterMovementComponent::UCharacterMovementComponent(const FObjectInitialize
 	bIgnoreClientMovementErrorChecksAndCorrection = false;
 	bServerAcceptClientAuthoritativePosition = false;
 	bAlwaysCheckFloor = true;
+	bUseBatchedFloorQueries = false;
+	BatchedFloorQueryTolerance = 5.0f;
+	SimulatedProxyFloorReuseDistance = 0.0f;
+	SimulatedProxyFloorReuseMaxAge = 0.25f;
+	SimulatedProxyFloorLocation = FVector::ZeroVector;
+	SimulatedProxyFloorTime = -1.0f;
+	SimulatedProxyFloorDist = 0.0f;
+	BatchedFloorTraceStart = FVector::ZeroVector;
+	BatchedFloorTraceEnd = FVector::ZeroVector;
+	BatchedFloorTraceInflation = 0.0f;
+	BatchedFloorHitFrame = 0;
+
+	bEnableMovementLOD = false;
+	bMovementLODLightweightProxies = true;
+	MovementLODLevels.Add(FCharacterMovementLODLevel(3000.0f, 1.0f / 15.0f));
+	MovementLODLevels.Add(FCharacterMovementLODLevel(6000.0f, 0.25f));
+	MovementLODNotRenderedTime = 1.0f;
+	MovementLODLevel = 0;
+	MovementLODAccumulatedTime = 0.0f;
+	MovementLODNextCheckTime = 0.0f;
+	MovementLODMeshOffset = FVector::ZeroVector;
+	MovementLODAverageUpdateTime = 0.0f;
 
 	// default character can jump, walk, and swim
 	NavAgentProps.bCanJump = true;
@@ -1328,7 +1392,29 @@ void UCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick
 		return;
 	}
 
-	AvoidanceLockTimer -= DeltaTime;
+	// Characters at a reduced movement LOD skip whole updates and simulate the accumulated time later. Skipped frames only interpolate visuals.
+	float MovementDeltaTime = DeltaTime;
+	const bool bMovementLODAllowed = IsMovementLODAllowed();
+	if (bMovementLODAllowed)
+	{
+		if (!TickMovementLOD(DeltaTime, MovementDeltaTime))
+		{
+			InterpolateMovementLOD(DeltaTime);
+			return;
+		}
+	}
+	else if (MovementLODLevel != 0)
+	{
+		MovementLODLevel = 0;
+		MovementLODAccumulatedTime = 0.f;
+		MovementLODMeshOffset = FVector::ZeroVector;
+		ApplyMovementLODMeshOffset();
+	}
+	const FVector MovementLODOldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat MovementLODOldRotation = UpdatedComponent->GetComponentQuat();
+	const uint32 MovementLODStartCycles = bMovementLODAllowed ? FPlatformTime::Cycles() : 0;
+
+	AvoidanceLockTimer -= MovementDeltaTime;
 
 	if (CharacterOwner->GetLocalRole() > ROLE_SimulatedProxy)
 	{
@@ -1348,7 +1434,7 @@ void UCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick
 		// Allow root motion to move characters that have no controller.
 		if (CharacterOwner->IsLocallyControlled() || (!CharacterOwner->Controller && bRunPhysicsWithNoController) || (!CharacterOwner->Controller && CharacterOwner->IsPlayingRootMotion()))
 		{
-			ControlledCharacterMove(InputVector, DeltaTime);
+			ControlledCharacterMove(InputVector, MovementDeltaTime);
 		}
 		else if (CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy)
 		{
@@ -1371,7 +1457,7 @@ void UCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick
 		{
 			AdjustProxyCapsuleSize();
 		}
-		SimulatedTick(DeltaTime);
+		SimulatedTick(MovementDeltaTime);
 	}
 
 	if (bUseRVOAvoidance)
@@ -1382,8 +1468,13 @@ void UCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick
 	if (bEnablePhysicsInteraction)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_CharPhysicsInteraction);
-		ApplyDownwardForce(DeltaTime);
-		ApplyRepulsionForce(DeltaTime);
+		ApplyDownwardForce(MovementDeltaTime);
+		ApplyRepulsionForce(MovementDeltaTime);
+	}
+
+	if (bMovementLODAllowed && HasValidData())
+	{
+		FinishMovementLODUpdate(MovementLODOldLocation, MovementLODOldRotation, MovementLODStartCycles);
 	}
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -1489,8 +1580,37 @@ void UCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
 		return;
 	}
 
+	// Lightweight proxies at a reduced movement LOD don't simulate root motion, they follow the replicated root motion moves with smoothing.
+	if (CharacterOwner->IsPlayingNetworkedRootMotionMontage() && IsUsingLightweightProxySimulation())
+	{
+		bWasSimulatingRootMotion = true;
+
+		// Keep the montage playing, but discard the root motion it extracts.
+		if (CharacterOwner->GetMesh())
+		{
+			TickCharacterPose(DeltaSeconds);
+
+			// Make sure animation didn't trigger an event that destroyed us
+			if (!HasValidData())
+			{
+				return;
+			}
+		}
+		RootMotionParams.Clear();
+
+		if (CharacterOwner->RootMotionRepMoves.Num() > 0)
+		{
+			const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+			const FQuat OldRotation = UpdatedComponent->GetComponentQuat();
+			if (CharacterOwner->RestoreReplicatedMove(CharacterOwner->RootMotionRepMoves.Last()))
+			{
+				SmoothCorrection(OldLocation, OldRotation, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentQuat());
+			}
+			CharacterOwner->RootMotionRepMoves.Reset();
+		}
+	}
 	// If we are playing a RootMotion AnimMontage.
-	if (CharacterOwner->IsPlayingNetworkedRootMotionMontage())
+	else if (CharacterOwner->IsPlayingNetworkedRootMotionMontage())
 	{
 		bWasSimulatingRootMotion = true;
 		UE_LOG(LogRootMotion, Verbose, TEXT("UCharacterMovementComponent::SimulatedTick"));
@@ -1754,6 +1874,8 @@ void UCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 		return;
 	}
 
+	ResolveBatchedFloorQuery();
+
 	FVector OldVelocity;
 	FVector OldLocation;
 
@@ -1836,7 +1958,31 @@ void UCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 				}
 				else if (Velocity.Z <= 0.f)
 				{
-					FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, Velocity.IsZero(), NULL);
+					const FVector ProxyLocation = UpdatedComponent->GetComponentLocation();
+					const float ReusedFloorDist = SimulatedProxyFloorDist + (ProxyLocation.Z - SimulatedProxyFloorLocation.Z);
+					if (bIsSimulatedProxy && CanReuseSimulatedProxyFloor(ProxyLocation) && ReusedFloorDist >= -MAX_FLOOR_DIST && ReusedFloorDist <= FMath::Max(MAX_FLOOR_DIST, MaxStepHeight))
+					{
+						// Proxies only need a plausible floor; keep the recent nearby flat one, moved under our new location.
+						INC_DWORD_STAT(STAT_CharProxyFloorReuses);
+						const FVector ProxyOffset = ProxyLocation - SimulatedProxyFloorLocation;
+						FHitResult ReusedHit = SimulatedProxyFloorHit;
+						ReusedHit.TraceStart += ProxyOffset;
+						ReusedHit.TraceEnd += ProxyOffset;
+						ReusedHit.Location += FVector(ProxyOffset.X, ProxyOffset.Y, 0.f);
+						ReusedHit.ImpactPoint += FVector(ProxyOffset.X, ProxyOffset.Y, 0.f);
+						ReusedHit.Distance = (ReusedHit.TraceStart.Z - ReusedHit.Location.Z);
+						ReusedHit.Time = ReusedHit.Distance / FMath::Max(ReusedHit.TraceStart.Z - ReusedHit.TraceEnd.Z, KINDA_SMALL_NUMBER);
+						CurrentFloor.SetFromSweep(ReusedHit, ReusedFloorDist, true);
+					}
+					else
+					{
+						FindFloor(ProxyLocation, CurrentFloor, Velocity.IsZero(), NULL);
+						SimulatedProxyFloorLocation = ProxyLocation;
+						SimulatedProxyFloorTime = GetWorld()->GetTimeSeconds();
+						SimulatedProxyFloorDist = CurrentFloor.FloorDist;
+						// Line trace floors don't have a capsule location to move with us, only reuse swept ones.
+						SimulatedProxyFloorHit = CurrentFloor.bLineTrace ? FHitResult() : CurrentFloor.HitResult;
+					}
 				}
 				else
 				{
@@ -1903,6 +2049,8 @@ void UCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 	UpdateComponentVelocity();
 	bJustTeleported = false;
 
+	SubmitBatchedFloorQuery(DeltaSeconds);
+
 	LastUpdateLocation = UpdatedComponent ? UpdatedComponent->GetComponentLocation() : FVector::ZeroVector;
 	LastUpdateRotation = UpdatedComponent ? UpdatedComponent->GetComponentQuat() : FQuat::Identity;
 	LastUpdateVelocity = Velocity;
@@ -2193,6 +2341,8 @@ void UCharacterMovementComponent::PerformMovement(float DeltaSeconds)
 	// Force floor update if we've moved outside of CharacterMovement since last update.
 	bForceNextFloorCheck |= (IsMovingOnGround() && UpdatedComponent->GetComponentLocation() != LastUpdateLocation);
 
+	ResolveBatchedFloorQuery();
+
 	// Update saved LastPreAdditiveVelocity with any external changes to character Velocity that happened since last update.
 	if( CurrentRootMotion.HasAdditiveVelocity() )
 	{
@@ -2478,6 +2628,7 @@ void UCharacterMovementComponent::PerformMovement(float DeltaSeconds)
 
 	SaveBaseLocation();
 	UpdateComponentVelocity();
+	SubmitBatchedFloorQuery(DeltaSeconds);
 
 	const bool bHasAuthority = CharacterOwner && CharacterOwner->HasAuthority();
 
@@ -6254,6 +6405,13 @@ void UCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFin
 	float FloorSweepTraceDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + HeightCheckAdjust);
 	float FloorLineTraceDist = FloorSweepTraceDist;
 	bool bNeedToValidateFloor = true;
+
+	// Use the floor sweep batched at the end of the last update if it was predicted for this location.
+	FHitResult BatchedDownwardSweepResult;
+	if (DownwardSweepResult == NULL && GetBatchedFloorHit(CapsuleLocation, FloorSweepTraceDist, BatchedDownwardSweepResult))
+	{
+		DownwardSweepResult = &BatchedDownwardSweepResult;
+	}
 	
 	// Sweep floor
 	if (FloorLineTraceDist > 0.f || FloorSweepTraceDist > 0.f)
@@ -6336,6 +6494,365 @@ void UCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFin
 }
 
 
+void UCharacterMovementComponent::SubmitBatchedFloorQuery(float DeltaSeconds)
+{
+	// The resolved hit only applies to the update that resolved it
+	BatchedFloorHitFrame = 0;
+
+	if (!bUseBatchedFloorQueries || CharacterMovementCVars::BatchedFloorQueries == 0 || bUseFlatBaseForFloorChecks)
+	{
+		BatchedFloorQueryHandle = FTraceHandle();
+		return;
+	}
+
+	if (!HasValidData() || !IsMovingOnGround() || !UpdatedComponent->IsQueryCollisionEnabled())
+	{
+		BatchedFloorQueryHandle = FTraceHandle();
+		return;
+	}
+
+	UWorld* MyWorld = GetWorld();
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	// Predict where the next floor check will happen, assuming we keep moving with the same horizontal velocity.
+	const FVector PredictedLocation = UpdatedComponent->GetComponentLocation() + FVector(Velocity.X, Velocity.Y, 0.f) * DeltaSeconds;
+
+	// Start above our current height so stepping up slopes and stairs is covered, and sweep as far down as FindFloor() would while walking.
+	const float StepUpAllowance = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight);
+	const float FloorSweepTraceDist = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + MAX_FLOOR_DIST + KINDA_SMALL_NUMBER);
+	const FVector Start = PredictedLocation + FVector(0.f, 0.f, StepUpAllowance);
+	const FVector End = PredictedLocation - FVector(0.f, 0.f, FloorSweepTraceDist);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BatchedFloorQuery), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	// Grow the capsule by the tolerance so anything a capsule within the tolerance of the prediction would land on is hit as well.
+	BatchedFloorTraceInflation = FMath::Max(BatchedFloorQueryTolerance, 0.f);
+	const FCollisionShape SweepShape = FCollisionShape::MakeCapsule(PawnRadius + BatchedFloorTraceInflation, PawnHalfHeight + BatchedFloorTraceInflation);
+
+	INC_DWORD_STAT(STAT_CharBatchedFloorQueries);
+	BatchedFloorQueryHandle = MyWorld->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, UpdatedComponent->GetCollisionObjectType(), SweepShape, QueryParams, ResponseParam);
+}
+
+
+void UCharacterMovementComponent::ResolveBatchedFloorQuery()
+{
+	BatchedFloorHitFrame = 0;
+	if (!BatchedFloorQueryHandle.IsValid())
+	{
+		return;
+	}
+
+	const FTraceHandle Handle = BatchedFloorQueryHandle;
+	BatchedFloorQueryHandle = FTraceHandle();
+
+	// Results are only available the frame after the query was submitted.
+	FTraceDatum TraceData;
+	UWorld* MyWorld = GetWorld();
+	if (MyWorld == nullptr || !MyWorld->QueryTraceData(Handle, TraceData) || TraceData.OutHits.Num() == 0)
+	{
+		return;
+	}
+
+	const FHitResult& Hit = TraceData.OutHits[0];
+	if (!Hit.IsValidBlockingHit() || Hit.bStartPenetrating)
+	{
+		return;
+	}
+
+	// A dynamic base may have moved since the sweep ran last frame, FindFloor() sweeps it again.
+	if (MovementBaseUtility::IsDynamicBase(Hit.GetComponent()))
+	{
+		INC_DWORD_STAT(STAT_CharBatchedFloorQueryStale);
+		return;
+	}
+
+	BatchedFloorHit = Hit;
+	BatchedFloorTraceStart = TraceData.Start;
+	BatchedFloorTraceEnd = TraceData.End;
+	BatchedFloorHitFrame = GFrameCounter;
+}
+
+
+bool UCharacterMovementComponent::GetBatchedFloorHit(const FVector& CapsuleLocation, float SweepDistance, FHitResult& OutHit) const
+{
+	if (BatchedFloorHitFrame != GFrameCounter)
+	{
+		return false;
+	}
+
+	const FHitResult& Hit = BatchedFloorHit;
+	const FVector Offset2D(CapsuleLocation.X - BatchedFloorTraceStart.X, CapsuleLocation.Y - BatchedFloorTraceStart.Y, 0.f);
+	if (Offset2D.SizeSquared() > FMath::Square(FMath::Min(BatchedFloorQueryTolerance, BatchedFloorTraceInflation)))
+	{
+		return false;
+	}
+
+	// The hit only carries over to another location on a flat floor, slopes, ledges and step edges need the real sweep from CapsuleLocation.
+	if (Hit.Normal.Z < 1.f - KINDA_SMALL_NUMBER || Hit.ImpactNormal.Z < 1.f - KINDA_SMALL_NUMBER || !IsWalkable(Hit))
+	{
+		return false;
+	}
+
+	// The inflated sweep touched the floor with the bottom of its capsule, so the pawn's capsule rests its half height above the impact.
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+	const FVector FloorLocation(CapsuleLocation.X, CapsuleLocation.Y, Hit.ImpactPoint.Z + PawnHalfHeight);
+
+	// Same distance limits as the regular sweep in ComputeFloorDist(), except a penetrating capsule, which the real sweep has to resolve.
+	const float FloorDist = CapsuleLocation.Z - FloorLocation.Z;
+	if (FloorDist < 0.f || FloorDist > SweepDistance || SweepDistance <= 0.f)
+	{
+		return false;
+	}
+
+	// The impact is a real point of the floor, it has to be under the pawn's capsule and not on the cusp of its radius.
+	if (!IsWithinEdgeTolerance(FloorLocation, Hit.ImpactPoint, PawnRadius))
+	{
+		return false;
+	}
+
+	// Present the hit as the vertical downward sweep ComputeFloorDist() would have done from CapsuleLocation.
+	OutHit = Hit;
+	OutHit.TraceStart = CapsuleLocation;
+	OutHit.TraceEnd = CapsuleLocation - FVector(0.f, 0.f, SweepDistance);
+	OutHit.Location = FloorLocation;
+	OutHit.Distance = FloorDist;
+	OutHit.Time = FloorDist / SweepDistance;
+
+	INC_DWORD_STAT(STAT_CharBatchedFloorQueryHits);
+	return true;
+}
+
+
+bool UCharacterMovementComponent::CanReuseSimulatedProxyFloor(const FVector& CapsuleLocation) const
+{
+	if (SimulatedProxyFloorReuseDistance <= 0.f || CharacterMovementCVars::SimulatedProxyFloorReuse == 0 || SimulatedProxyFloorTime < 0.f)
+	{
+		return false;
+	}
+
+	if (bForceNextFloorCheck || !IsMovingOnGround() || !CurrentFloor.IsWalkableFloor())
+	{
+		return false;
+	}
+
+	// The reused hit is moved horizontally, which only keeps it valid on a flat floor.
+	const FHitResult& FloorHit = SimulatedProxyFloorHit;
+	if (!CurrentFloor.bBlockingHit || !FloorHit.IsValidBlockingHit() || FloorHit.Normal.Z < 1.f - KINDA_SMALL_NUMBER || FloorHit.ImpactNormal.Z < 1.f - KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	// Dynamic bases can move out from under us at any time.
+	UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	if (MovementBase == nullptr || MovementBaseUtility::IsDynamicBase(MovementBase))
+	{
+		return false;
+	}
+
+	if ((CapsuleLocation - SimulatedProxyFloorLocation).SizeSquared2D() > FMath::Square(SimulatedProxyFloorReuseDistance))
+	{
+		return false;
+	}
+
+	const UWorld* MyWorld = GetWorld();
+	return MyWorld && (MyWorld->GetTimeSeconds() - SimulatedProxyFloorTime) <= SimulatedProxyFloorReuseMaxAge;
+}
+
+
+bool UCharacterMovementComponent::IsMovementLODAllowed() const
+{
+	if (!bEnableMovementLOD || CharacterMovementCVars::CharacterMovementLOD == 0 || MovementLODLevels.Num() == 0 || !HasValidData())
+	{
+		return false;
+	}
+
+	const ENetRole LocalRole = CharacterOwner->GetLocalRole();
+	if (LocalRole == ROLE_SimulatedProxy)
+	{
+		// Replays interpolate between recorded samples and need every frame.
+		if (NetworkSmoothingMode == ENetworkSmoothingMode::Replay)
+		{
+			return false;
+		}
+		return bMovementLODLightweightProxies || !CharacterOwner->IsPlayingNetworkedRootMotionMontage();
+	}
+
+	// Players are never throttled, and root motion needs the pose to tick with movement every frame.
+	return LocalRole == ROLE_Authority
+		&& CharacterOwner->GetRemoteRole() != ROLE_AutonomousProxy
+		&& !CharacterOwner->IsPlayerControlled()
+		&& !CharacterOwner->IsPlayingRootMotion()
+		&& !CurrentRootMotion.HasActiveRootMotionSources();
+}
+
+
+int32 UCharacterMovementComponent::CalculateMovementLODLevel() const
+{
+	const UWorld* MyWorld = GetWorld();
+	if (MyWorld == nullptr)
+	{
+		return 0;
+	}
+
+	const FVector CharacterLocation = UpdatedComponent->GetComponentLocation();
+
+	// Distance to the nearest viewer. On servers this includes the view points of all connected players.
+	float MinDistSq = MAX_FLT;
+	for (FConstPlayerControllerIterator Iterator = MyWorld->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController)
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			MinDistSq = FMath::Min(MinDistSq, FVector::DistSquared(ViewLocation, CharacterLocation));
+		}
+	}
+
+	float Distance = (MinDistSq < MAX_FLT) ? FMath::Sqrt(MinDistSq) : MAX_FLT;
+	if (OnCalculateMovementLODSignificance.IsBound())
+	{
+		const float Significance = OnCalculateMovementLODSignificance.Execute(this);
+		Distance = (Significance > KINDA_SMALL_NUMBER) ? Distance / Significance : MAX_FLT;
+	}
+
+	int32 NewLODLevel = 0;
+	for (int32 LevelIndex = 0; LevelIndex < MovementLODLevels.Num(); ++LevelIndex)
+	{
+		if (Distance >= MovementLODLevels[LevelIndex].MinDistance)
+		{
+			NewLODLevel = LevelIndex + 1;
+		}
+	}
+
+	// Nothing is rendered on dedicated servers, so only distance and significance apply there.
+	if (NewLODLevel == 0 && MovementLODNotRenderedTime > 0.f && !IsNetMode(NM_DedicatedServer) && !CharacterOwner->WasRecentlyRendered(MovementLODNotRenderedTime))
+	{
+		NewLODLevel = 1;
+	}
+
+	return NewLODLevel;
+}
+
+
+bool UCharacterMovementComponent::TickMovementLOD(float DeltaTime, float& OutMovementDeltaTime)
+{
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	if (WorldTime >= MovementLODNextCheckTime)
+	{
+		MovementLODLevel = CalculateMovementLODLevel();
+
+		// Spread recalculations of characters spawned on the same frame over the check interval.
+		const float CheckInterval = FMath::Max(0.f, CharacterMovementCVars::CharacterMovementLODCheckInterval);
+		MovementLODNextCheckTime = WorldTime + CheckInterval * FMath::FRandRange(0.9f, 1.1f);
+	}
+
+	if (MovementLODLevel == 0)
+	{
+		INC_DWORD_STAT(STAT_CharMovementLOD0);
+	}
+	else if (MovementLODLevel == 1)
+	{
+		INC_DWORD_STAT(STAT_CharMovementLOD1);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_CharMovementLOD2Plus);
+	}
+
+	MovementLODAccumulatedTime += DeltaTime;
+	const float UpdateInterval = (MovementLODLevel > 0) ? MovementLODLevels[MovementLODLevel - 1].UpdateInterval : 0.f;
+	if (MovementLODAccumulatedTime < UpdateInterval)
+	{
+		INC_DWORD_STAT(STAT_CharMovementLODSkipped);
+		INC_FLOAT_STAT_BY(STAT_CharMovementLODTimeSaved, MovementLODAverageUpdateTime * 1000.f);
+		return false;
+	}
+
+	OutMovementDeltaTime = MovementLODAccumulatedTime;
+	MovementLODAccumulatedTime = 0.f;
+	return true;
+}
+
+
+void UCharacterMovementComponent::InterpolateMovementLOD(float DeltaTime)
+{
+	if (CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		// Network smoothing already blends the mesh towards the capsule.
+		if (!bNetworkSmoothingComplete)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_CharacterMovementSmoothClientPosition);
+			SmoothClientPosition(DeltaTime);
+		}
+		return;
+	}
+
+	if (MovementLODMeshOffset.IsZero() || MovementLODLevel == 0)
+	{
+		return;
+	}
+
+	// Blend the offset out linearly so it reaches zero when the next update is due.
+	const float UpdateInterval = MovementLODLevels[MovementLODLevel - 1].UpdateInterval;
+	const float RemainingTime = FMath::Max(0.f, UpdateInterval - MovementLODAccumulatedTime);
+	MovementLODMeshOffset *= (RemainingTime > KINDA_SMALL_NUMBER) ? RemainingTime / (RemainingTime + DeltaTime) : 0.f;
+	ApplyMovementLODMeshOffset();
+}
+
+
+void UCharacterMovementComponent::FinishMovementLODUpdate(const FVector& OldLocation, const FQuat& OldRotation, uint32 StartCycles)
+{
+	const float UpdateTime = FPlatformTime::ToSeconds(FPlatformTime::Cycles() - StartCycles);
+	MovementLODAverageUpdateTime = (MovementLODAverageUpdateTime > 0.f) ? FMath::Lerp(MovementLODAverageUpdateTime, UpdateTime, 0.1f) : UpdateTime;
+
+	// Proxies use network smoothing, and nothing needs to look smooth on a dedicated server.
+	if (CharacterOwner->GetLocalRole() != ROLE_Authority || IsNetMode(NM_DedicatedServer))
+	{
+		return;
+	}
+
+	const FVector WorldDelta = OldLocation - UpdatedComponent->GetComponentLocation();
+	if (MovementLODLevel == 0 || WorldDelta.SizeSquared() > FMath::Square(NetworkNoSmoothUpdateDistance))
+	{
+		if (!MovementLODMeshOffset.IsZero())
+		{
+			MovementLODMeshOffset = FVector::ZeroVector;
+			ApplyMovementLODMeshOffset();
+		}
+		return;
+	}
+
+	// Keep the mesh where it was, and blend it to the new capsule location until the next update.
+	// The offset is relative to the capsule, so the part left from the last update is carried over from the capsule's old rotation.
+	const FQuat NewRotation = UpdatedComponent->GetComponentQuat();
+	const FVector OldWorldOffset = OldRotation.RotateVector(MovementLODMeshOffset);
+	MovementLODMeshOffset = NewRotation.UnrotateVector(OldWorldOffset + WorldDelta);
+	ApplyMovementLODMeshOffset();
+}
+
+
+void UCharacterMovementComponent::ApplyMovementLODMeshOffset()
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (Mesh && Mesh->GetAttachParent() == UpdatedComponent)
+	{
+		Mesh->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset() + MovementLODMeshOffset);
+	}
+}
+
+
+bool UCharacterMovementComponent::IsUsingLightweightProxySimulation() const
+{
+	return bMovementLODLightweightProxies && MovementLODLevel > 0 && IsMovementLODAllowed();
+}
+
+
 void UCharacterMovementComponent::K2_FindFloor(FVector CapsuleLocation, FFindFloorResult& FloorResult) const
 {
 	const bool SavedForceNextFloorCheck(bForceNextFloorCheck);
@@ -308,6 +308,71 @@ void UMeshComponent::SetScalarParameterValueOnMaterials(const FName ParameterNam
 	}
 }
 
+void UMeshComponent::SetScalarParameterValuesOnMaterials(const TMap<FName, float>& Parameters)
+{
+	typedef TArray<TPair<FName, float>, TInlineAllocator<16>> FMaterialScalarParameters;
+
+	// Parameters to set, grouped by material index
+	TArray<FMaterialScalarParameters, TInlineAllocator<8>> MaterialParameters;
+	MaterialParameters.SetNum(GetNumMaterials());
+
+	if (!bEnableMaterialParameterCaching)
+	{
+		for (FMaterialScalarParameters& Material : MaterialParameters)
+		{
+			Material.Reserve(Parameters.Num());
+			for (const TPair<FName, float>& Parameter : Parameters)
+			{
+				Material.Add(Parameter);
+			}
+		}
+	}
+	else
+	{
+		if (bCachedMaterialParameterIndicesAreDirty)
+		{
+			CacheMaterialParameterNameIndices();
+		}
+
+		for (const TPair<FName, float>& Parameter : Parameters)
+		{
+			if (FMaterialParameterCache* ParameterCache = MaterialParameterCache.Find(Parameter.Key))
+			{
+				for (int32 MaterialIndex : ParameterCache->ScalarParameterMaterialIndices)
+				{
+					if (MaterialParameters.IsValidIndex(MaterialIndex))
+					{
+						MaterialParameters[MaterialIndex].Add(Parameter);
+					}
+				}
+			}
+			else
+			{
+				UE_LOG(LogMaterialParameter, Log, TEXT("%s material parameter hasn't found on the component %s"), *Parameter.Key.ToString(), *GetPathName());
+			}
+		}
+	}
+
+	for (int32 MaterialIndex = 0; MaterialIndex < MaterialParameters.Num(); ++MaterialIndex)
+	{
+		if (MaterialParameters[MaterialIndex].Num() == 0)
+		{
+			continue;
+		}
+
+		UMaterialInterface* MaterialInterface = GetMaterial(MaterialIndex);
+		if (MaterialInterface)
+		{
+			UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(MaterialInterface);
+			if (!DynamicMaterial)
+			{
+				DynamicMaterial = CreateAndSetMaterialInstanceDynamic(MaterialIndex);
+			}
+			DynamicMaterial->SetScalarParameterValues(MaterialParameters[MaterialIndex]);
+		}
+	}
+}
+
 void UMeshComponent::SetVectorParameterValueOnMaterials(const FName ParameterName, const FVector ParameterValue)
 {
 	if (!bEnableMaterialParameterCaching)
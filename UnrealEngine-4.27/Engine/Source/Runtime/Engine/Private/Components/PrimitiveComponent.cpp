@@ -9,6 +9,7 @@
 #include "GameFramework/DamageType.h"
 #include "GameFramework/Pawn.h"
 #include "WorldCollision.h"
+#include "DeferredOverlapUpdates.h"
 #include "AI/NavigationSystemBase.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PhysicsVolume.h"
@@ -362,6 +363,7 @@ UPrimitiveComponent::UPrimitiveComponent(const FObjectInitializer& ObjectInitial
 
 	SetGenerateOverlapEvents(true);
 	bMultiBodyOverlap = false;
+	bDeferOverlapUpdates = false;
 	bReturnMaterialOnMove = false;
 	bCanEverAffectNavigation = false;
 	bNavigationRelevant = false;
@@ -3181,7 +3183,20 @@ bool UPrimitiveComponent::UpdateOverlapsImpl(const TOverlapArrayView* NewPending
 	if (GetGenerateOverlapEvents() && IsQueryCollisionEnabled())	//TODO: should modifying query collision remove from mayoverlapevents?
 	{
 		bCanSkipUpdateOverlaps = false;
-		if (MyActor)
+
+		// Large numbers of moving overlap volumes can gather their queries into one batch at the end of the frame.
+		// Only plain updates are deferred; pending sweep overlaps and known end overlaps are cheaper to handle now.
+		bool bDeferred = false;
+		if (bDeferOverlapUpdates && MyActor && FDeferredOverlapUpdates::IsEnabled() && OverlapsAtEndLocation == nullptr && (NewPendingOverlaps == nullptr || NewPendingOverlaps->Num() == 0))
+		{
+			UWorld* const MyWorld = GetWorld();
+			if (MyWorld && MyWorld->IsGameWorld())
+			{
+				bDeferred = MyWorld->GetDeferredOverlapUpdates().Enqueue(this, bDoNotifies);
+			}
+		}
+
+		if (MyActor && !bDeferred)
 		{
 			const FTransform PrevTransform = GetComponentTransform();
 			// If we are the root component we ignore child components. Those children will update their overlaps when we descend into the child tree.
@@ -3226,12 +3241,20 @@ bool UPrimitiveComponent::UpdateOverlapsImpl(const TOverlapArrayView* NewPending
 					UE_LOG(LogPrimitiveComponent, VeryVerbose, TEXT("%s->%s Performing overlaps!"), *GetNameSafe(GetOwner()), *GetName());
 					UWorld* const MyWorld = GetWorld();
 					TArray<FOverlapResult> Overlaps;
-					// note this will optionally include overlaps with components in the same actor (depending on bIgnoreChildren). 
-					FComponentQueryParams Params(SCENE_QUERY_STAT(UpdateOverlaps), bIgnoreChildren ? MyActor : nullptr);
-					Params.bIgnoreBlocks = true;	//We don't care about blockers since we only route overlap events to real overlaps
-					FCollisionResponseParams ResponseParam;
-					InitSweepCollisionParams(Params, ResponseParam);
-					ComponentOverlapMulti(Overlaps, MyWorld, GetComponentLocation(), GetComponentQuat(), GetCollisionObjectType(), Params);
+					if (const TArray<FOverlapResult>* BatchedOverlaps = MyWorld->GetDeferredOverlapUpdates().ConsumeBatchedOverlaps(this))
+					{
+						// Query already ran as part of the deferred overlap batch at this transform.
+						Overlaps = *BatchedOverlaps;
+					}
+					else
+					{
+						// note this will optionally include overlaps with components in the same actor (depending on bIgnoreChildren). 
+						FComponentQueryParams Params(SCENE_QUERY_STAT(UpdateOverlaps), bIgnoreChildren ? MyActor : nullptr);
+						Params.bIgnoreBlocks = true;	//We don't care about blockers since we only route overlap events to real overlaps
+						FCollisionResponseParams ResponseParam;
+						InitSweepCollisionParams(Params, ResponseParam);
+						ComponentOverlapMulti(Overlaps, MyWorld, GetComponentLocation(), GetComponentQuat(), GetCollisionObjectType(), Params);
+					}
 
 					for (int32 ResultIdx=0; ResultIdx < Overlaps.Num(); ResultIdx++)
 					{
@@ -40,6 +40,9 @@
 #include "SkeletalRenderPublic.h"
 #include "ContentStreaming.h"
 #include "Animation/AnimTrace.h"
+#include "Animation/SharedPoseEvaluationCache.h"
+#include "Animation/BakedVertexAnimationSubsystem.h"
+#include "Animation/AnimationBudgetSubsystem.h"
 #if INTEL_ISPC
 #include "SkeletalMeshComponent.ispc.generated.h"
 #endif
@@ -120,7 +123,12 @@ public:
 				GInitRunaway();
 			}
 
+			const uint32 StartCycles = FPlatformTime::Cycles();
 			Comp->ParallelAnimationEvaluation();
+			if (Comp->bManagedByAnimationBudget)
+			{
+				Comp->AnimationBudgetWorkerCycles += FPlatformTime::Cycles() - StartCycles;
+			}
 		}
 	}
 };
@@ -254,6 +262,18 @@ USkeletalMeshComponent::USkeletalMeshComponent(const FObjectInitializer& ObjectI
 	bSkipBoundsUpdateWhenInterpolating = false;
 
 	DeferredKinematicUpdateIndex = INDEX_NONE;
+
+	BakedVertexAnimation = nullptr;
+	BakedVertexAnimationDistance = 0.0f;
+	bUsingBakedVertexAnimation = false;
+	bTickEnabledBeforeBakedVertexAnimation = false;
+	BakedVertexAnimationInstanceIndex = INDEX_NONE;
+
+	bManagedByAnimationBudget = false;
+	bUpdateRateOptimizationsBeforeAnimationBudget = false;
+	AnimationBudgetIndex = INDEX_NONE;
+	AnimationBudgetGameThreadCycles = 0;
+	AnimationBudgetWorkerCycles = 0;
 }
 
 void USkeletalMeshComponent::Serialize(FArchive& Ar)
@@ -620,10 +640,33 @@ void USkeletalMeshComponent::OnRegister()
 			*GetNameSafe(SkeletalMesh));
 	}
 #endif  // #if WITH_CHAOS_CLOTHING
+
+	if (BakedVertexAnimation)
+	{
+		if (UBakedVertexAnimationSubsystem* BakedVertexAnimationSubsystem = UWorld::GetSubsystem<UBakedVertexAnimationSubsystem>(GetWorld()))
+		{
+			BakedVertexAnimationSubsystem->RegisterComponent(this);
+		}
+	}
+
+	if (UAnimationBudgetSubsystem* AnimationBudgetSubsystem = UWorld::GetSubsystem<UAnimationBudgetSubsystem>(GetWorld()))
+	{
+		AnimationBudgetSubsystem->RegisterComponent(this);
+	}
 }
 
 void USkeletalMeshComponent::OnUnregister()
 {
+	if (UBakedVertexAnimationSubsystem* BakedVertexAnimationSubsystem = UWorld::GetSubsystem<UBakedVertexAnimationSubsystem>(GetWorld()))
+	{
+		BakedVertexAnimationSubsystem->UnregisterComponent(this);
+	}
+
+	if (UAnimationBudgetSubsystem* AnimationBudgetSubsystem = UWorld::GetSubsystem<UAnimationBudgetSubsystem>(GetWorld()))
+	{
+		AnimationBudgetSubsystem->UnregisterComponent(this);
+	}
+
 	const bool bBlockOnTask = true; // wait on evaluation task so we complete any work before this component goes away
 	const bool bPerformPostAnimEvaluation = false; // Skip post evaluation, it would be wasted work
 
@@ -680,6 +723,34 @@ void USkeletalMeshComponent::OnUnregister()
 	Super::OnUnregister();
 }
 
+void USkeletalMeshComponent::SetBakedVertexAnimation(UBakedVertexAnimation* InBakedVertexAnimation)
+{
+	if (InBakedVertexAnimation == BakedVertexAnimation)
+	{
+		return;
+	}
+
+	// OnRegister only registers components that have one, and a baked component's instance belongs to the previous asset's batch
+	UBakedVertexAnimationSubsystem* BakedVertexAnimationSubsystem = IsRegistered() ? UWorld::GetSubsystem<UBakedVertexAnimationSubsystem>(GetWorld()) : nullptr;
+	if (BakedVertexAnimationSubsystem)
+	{
+		BakedVertexAnimationSubsystem->UnregisterComponent(this);
+	}
+
+	BakedVertexAnimation = InBakedVertexAnimation;
+
+	if (BakedVertexAnimationSubsystem && BakedVertexAnimation)
+	{
+		BakedVertexAnimationSubsystem->RegisterComponent(this);
+	}
+}
+
+bool USkeletalMeshComponent::ShouldCreateRenderState() const
+{
+	// Drawn as an instance of the baked static mesh instead
+	return Super::ShouldCreateRenderState() && !bUsingBakedVertexAnimation;
+}
+
 void USkeletalMeshComponent::InitAnim(bool bForceReinit)
 {
 	CSV_SCOPED_TIMING_STAT(Animation, InitAnim);
@@ -1368,7 +1439,15 @@ void USkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevelTick Tick
 		ClothingSimulation->GetSimulationData(CurrentSimulationData, this, Cast<USkeletalMeshComponent>(MasterPoseComponent.Get()));
 	}
 
+	// Evaluation running on a worker is measured by its task
+	const uint32 AnimationBudgetStartCycles = FPlatformTime::Cycles();
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (bManagedByAnimationBudget)
+	{
+		AnimationBudgetGameThreadCycles += FPlatformTime::Cycles() - AnimationBudgetStartCycles;
+	}
 	
 	PendingRadialForces.Reset();
 
@@ -1956,11 +2035,39 @@ void USkeletalMeshComponent::PerformAnimationProcessing(const USkeletalMesh* InS
 	// Do nothing more if no bones in skeleton.
 	if(bInDoEvaluation && OutSpaceBases.Num() > 0)
 	{
+		// With a.SharedPoseEvaluation, crowds playing the same sequence copy the pose the first of them evaluated this frame
+		FSharedPoseEvaluationKey SharedPoseKey;
+		FSharedPoseEvaluationCache::EAcquireResult SharedPoseResult = FSharedPoseEvaluationCache::EAcquireResult::Evaluate;
+		if (FSharedPoseEvaluationCache::IsEnabled() && !bForceRefpose && !ShouldEvaluatePostProcessInstance() && FSharedPoseEvaluationCache::GetKey(InSkeletalMesh, InAnimInstance, SharedPoseKey))
+		{
+			SharedPoseResult = FSharedPoseEvaluationCache::Get().Acquire(SharedPoseKey, InAnimInstance, OutSpaceBases, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve, OutAttributes);
+			if (SharedPoseResult == FSharedPoseEvaluationCache::EAcquireResult::Copied)
+			{
+				return;
+			}
+		}
+
+		const uint32 EvaluationStartCycles = FPlatformTime::Cycles();
+
 		FMemMark Mark(FMemStack::Get());
 		FCompactPose EvaluatedPose;
 
+		// A shared pose is evaluated at the middle of its time step, so the components copying it get the same pose whichever of them claimed it
+		UAnimSingleNodeInstance* SharedPoseInstance = SharedPoseResult == FSharedPoseEvaluationCache::EAcquireResult::Claimed ? CastChecked<UAnimSingleNodeInstance>(InAnimInstance) : nullptr;
+		const float ComponentTime = SharedPoseInstance ? SharedPoseInstance->GetCurrentTimeOnAnyThread() : 0.0f;
+		if (SharedPoseInstance)
+		{
+			SharedPoseInstance->SetCurrentTimeOnAnyThread(SharedPoseKey.EvaluationTime);
+		}
+
 		// evaluate pure animations, and fill up BoneSpaceTransforms
 		EvaluateAnimation(InSkeletalMesh, InAnimInstance, OutRootBoneTranslation, OutCurve, EvaluatedPose, OutAttributes);
+
+		if (SharedPoseInstance)
+		{
+			SharedPoseInstance->SetCurrentTimeOnAnyThread(ComponentTime);
+		}
+
 		EvaluatePostProcessMeshInstance(OutBoneSpaceTransforms, EvaluatedPose, OutCurve, InSkeletalMesh, OutRootBoneTranslation, OutAttributes);
 
 		// Finalize the transforms from the evaluation
@@ -1968,6 +2075,11 @@ void USkeletalMeshComponent::PerformAnimationProcessing(const USkeletalMesh* InS
 
 		// Fill SpaceBases from LocalAtoms
 		FillComponentSpaceTransforms(InSkeletalMesh, OutBoneSpaceTransforms, OutSpaceBases);
+
+		if (SharedPoseResult == FSharedPoseEvaluationCache::EAcquireResult::Claimed)
+		{
+			FSharedPoseEvaluationCache::Get().Store(SharedPoseKey, OutSpaceBases, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve, OutAttributes, FPlatformTime::Cycles() - EvaluationStartCycles);
+		}
 	}
 }
 
@@ -2665,12 +2777,7 @@ void USkeletalMeshComponent::ApplyAnimationCurvesToComponent(const TMap<FName, f
 	if (bContainsMaterialCurves)
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_FAnimInstanceProxy_UpdateComponentsMaterialParameters);
-		for (auto Iter = InMaterialParameterCurves->CreateConstIterator(); Iter; ++Iter)
-		{
-			FName ParameterName = Iter.Key();
-			float ParameterValue = Iter.Value();
-			SetScalarParameterValueOnMaterials(ParameterName, ParameterValue);
-		}
+		SetScalarParameterValuesOnMaterials(*InMaterialParameterCurves);
 	}
 
 	const bool bContainsMorphCurves = InAnimationMorphCurves && InAnimationMorphCurves->Num() > 0;
@@ -8,6 +8,8 @@
 #include "Engine/NetConnection.h"
 #include "Engine/ControlChannel.h"
 #include "Net/Core/Trace/NetTrace.h"
+#include "EngineStats.h"
+#include "HAL/IConsoleManager.h"
 
 const int32 MAX_BUNCH_SIZE = 1024 * 1024; 
 
@@ -46,6 +48,36 @@ FInBunch::FInBunch( UNetConnection* InConnection, uint8* Src, int64 CountBits )
 
 /** Copy constructor but with optional parameter to not copy buffer */
 FInBunch::FInBunch( FInBunch &InBunch, bool CopyBuffer )
+{
+	CopyHeaderFrom(InBunch);
+
+	if (CopyBuffer)
+	{
+		FBitReader::operator=(InBunch);
+	}
+
+	Pos = 0;
+}
+
+void FInBunch::ResetFrom( FInBunch &InBunch, bool CopyBuffer )
+{
+	CopyHeaderFrom(InBunch);
+	SetByteSwapping(InBunch.IsByteSwapping());
+
+	// Reset rather than Empty, keeping the allocation is the point of reusing this bunch
+	Buffer.Reset();
+	Num = 0;
+
+	if (CopyBuffer)
+	{
+		Buffer.Append(InBunch.GetData(), InBunch.GetNumBytes());
+		Num = InBunch.GetNumBits();
+	}
+
+	Pos = 0;
+}
+
+void FInBunch::CopyHeaderFrom( const FInBunch &InBunch )
 {
 	PacketId =	InBunch.PacketId;
 	Next =	InBunch.Next;
@@ -70,13 +102,6 @@ FInBunch::FInBunch( FInBunch &InBunch, bool CopyBuffer )
 	this->SetGameNetVer(InBunch.GameNetVer());
 
 	PackageMap = InBunch.PackageMap;
-
-	if (CopyBuffer)
-	{
-		FBitReader::operator=(InBunch);
-	}
-
-	Pos = 0;
 }
 
 void FInBunch::CountMemory(FArchive& Ar) const
@@ -89,6 +114,166 @@ void FInBunch::CountMemory(FArchive& Ar) const
 	}
 }
 
+/*-----------------------------------------------------------------------------
+	FInBunchArena implementation.
+-----------------------------------------------------------------------------*/
+
+static int32 GNetPoolInBunches = 1;
+static FAutoConsoleVariableRef CVarNetPoolInBunches(
+	TEXT("net.PoolInBunches"),
+	GNetPoolInBunches,
+	TEXT("When enabled, queued reliable, partial and guid dependent incoming bunches are reused from a per connection pool instead of reallocated."));
+
+static int32 GNetInBunchPoolMaxPerSizeClass = 16;
+static FAutoConsoleVariableRef CVarNetInBunchPoolMaxPerSizeClass(
+	TEXT("net.InBunchPoolMaxPerSizeClass"),
+	GNetInBunchPoolMaxPerSizeClass,
+	TEXT("Maximum number of released incoming bunches each connection keeps per buffer size class."));
+
+static int32 GNetInBunchPoolMaxBytes = 64 * 1024;
+static FAutoConsoleVariableRef CVarNetInBunchPoolMaxBytes(
+	TEXT("net.InBunchPoolMaxBytes"),
+	GNetInBunchPoolMaxBytes,
+	TEXT("Maximum number of buffer bytes each connection keeps in its pool of released incoming bunches."));
+
+FInBunchArena::~FInBunchArena()
+{
+	Empty();
+}
+
+int32 FInBunchArena::GetSizeClass(int64 NumBytes)
+{
+	// Small property updates, a typical MTU sized bunch, merged partial bunches, and anything larger
+	static const int64 SizeClassMaxBytes[NumSizeClasses - 1] = { 256, 1536, 16 * 1024 };
+
+	for (int32 SizeClass = 0; SizeClass < NumSizeClasses - 1; ++SizeClass)
+	{
+		if (NumBytes <= SizeClassMaxBytes[SizeClass])
+		{
+			return SizeClass;
+		}
+	}
+
+	return NumSizeClasses - 1;
+}
+
+FInBunch* FInBunchArena::Acquire(FInBunch& Source, bool bCopyBuffer)
+{
+	++Stats.NumAcquired;
+
+	FInBunch* Bunch = nullptr;
+	if (GNetPoolInBunches)
+	{
+		if (bCopyBuffer)
+		{
+			for (int32 SizeClass = GetSizeClass(Source.GetNumBytes()); SizeClass < NumSizeClasses && !Bunch; ++SizeClass)
+			{
+				Bunch = FreeBunches[SizeClass].Num() > 0 ? FreeBunches[SizeClass].Pop(false) : nullptr;
+			}
+		}
+		else
+		{
+			// Bunches started without a buffer are partial bunches that will be appended to, so hand out the largest one we have
+			for (int32 SizeClass = NumSizeClasses - 1; SizeClass >= 0 && !Bunch; --SizeClass)
+			{
+				Bunch = FreeBunches[SizeClass].Num() > 0 ? FreeBunches[SizeClass].Pop(false) : nullptr;
+			}
+		}
+	}
+
+	if (Bunch)
+	{
+		const int64 PreviousCapacity = Bunch->GetBufferCapacity();
+		PooledBytes -= PreviousCapacity;
+		DEC_MEMORY_STAT_BY(STAT_InBunchPoolMemory, PreviousCapacity);
+		INC_DWORD_STAT(STAT_InBunchPoolReuses);
+
+		Bunch->ResetFrom(Source, bCopyBuffer);
+		NoteBufferGrowth(*Bunch, PreviousCapacity);
+	}
+	else
+	{
+		Bunch = new FInBunch(Source, bCopyBuffer);
+		++Stats.NumBunchAllocations;
+		INC_DWORD_STAT(STAT_InBunchAllocations);
+
+		NoteBufferGrowth(*Bunch, 0);
+	}
+
+	return Bunch;
+}
+
+void FInBunchArena::Release(FInBunch* Bunch)
+{
+	if (Bunch == nullptr)
+	{
+		return;
+	}
+
+	const int64 Capacity = Bunch->GetBufferCapacity();
+	const int32 SizeClass = GetSizeClass(Capacity);
+
+	if (GNetPoolInBunches && !Bunch->IsError() && FreeBunches[SizeClass].Num() < GNetInBunchPoolMaxPerSizeClass && PooledBytes + Capacity <= GNetInBunchPoolMaxBytes)
+	{
+		Bunch->Next = nullptr;
+		FreeBunches[SizeClass].Add(Bunch);
+
+		PooledBytes += Capacity;
+		INC_MEMORY_STAT_BY(STAT_InBunchPoolMemory, Capacity);
+		++Stats.NumPooled;
+	}
+	else
+	{
+		delete Bunch;
+	}
+}
+
+void FInBunchArena::NoteBufferGrowth(const FInBunch& Bunch, int64 PreviousCapacity)
+{
+	if (Bunch.GetBufferCapacity() > PreviousCapacity)
+	{
+		++Stats.NumBufferAllocations;
+		INC_DWORD_STAT(STAT_InBunchBufferAllocations);
+	}
+}
+
+void FInBunchArena::Empty()
+{
+	for (TArray<FInBunch*>& SizeClassBunches : FreeBunches)
+	{
+		for (FInBunch* Bunch : SizeClassBunches)
+		{
+			delete Bunch;
+		}
+		SizeClassBunches.Empty();
+	}
+
+	DEC_MEMORY_STAT_BY(STAT_InBunchPoolMemory, PooledBytes);
+	PooledBytes = 0;
+}
+
+int32 FInBunchArena::GetNumPooledBunches() const
+{
+	int32 NumPooledBunches = 0;
+	for (const TArray<FInBunch*>& SizeClassBunches : FreeBunches)
+	{
+		NumPooledBunches += SizeClassBunches.Num();
+	}
+	return NumPooledBunches;
+}
+
+void FInBunchArena::CountMemory(FArchive& Ar) const
+{
+	for (const TArray<FInBunch*>& SizeClassBunches : FreeBunches)
+	{
+		SizeClassBunches.CountBytes(Ar);
+		for (const FInBunch* Bunch : SizeClassBunches)
+		{
+			Bunch->CountMemory(Ar);
+		}
+	}
+}
+
 /*-----------------------------------------------------------------------------
 	FOutBunch implementation.
 -----------------------------------------------------------------------------*/
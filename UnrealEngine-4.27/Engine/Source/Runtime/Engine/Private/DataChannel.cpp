@@ -226,12 +226,12 @@ bool UChannel::CleanUp(const bool bForDestroy, EChannelCloseReason CloseReason)
 	for (FInBunch* In = InRec, *NextIn; In != NULL; In = NextIn)
 	{
 		NextIn = In->Next;
-		delete In;
+		Connection->InBunchArena.Release(In);
 	}
 	InRec = nullptr;
 	if (InPartialBunch != NULL)
 	{
-		delete InPartialBunch;
+		Connection->InBunchArena.Release(InPartialBunch);
 		InPartialBunch = NULL;
 	}
 
@@ -488,7 +488,7 @@ void UChannel::ReceivedRawBunch( FInBunch & Bunch, bool & bOutSkipAck )
 			}
 		}
 
-		FInBunch* New = new FInBunch(Bunch);
+		FInBunch* New = Connection->InBunchArena.Acquire(Bunch, true);
 		New->Next     = *InPtr;
 		*InPtr        = New;
 		NumInRec++;
@@ -548,7 +548,8 @@ void UChannel::ReceivedRawBunch( FInBunch & Bunch, bool & bOutSkipAck )
 				return;
 			}
 
-			delete Release;
+			// Go through the bunch's connection, ReceivedNextBunch may have cleaned up this channel
+			Release->Connection->InBunchArena.Release(Release);
 			if (bDeleted)
 			{
 				return;
@@ -613,11 +614,11 @@ bool UChannel::ReceivedNextBunch( FInBunch & Bunch, bool & bOutSkipAck )
 					UE_LOG(LogNetPartialBunch, Verbose, TEXT("Incomplete partial bunch. Channel: %d ChSequence: %d"), InPartialBunch->ChIndex, InPartialBunch->ChSequence);
 				}
 				
-				delete InPartialBunch;
+				Connection->InBunchArena.Release(InPartialBunch);
 				InPartialBunch = NULL;
 			}
 
-			InPartialBunch = new FInBunch(Bunch, false);
+			InPartialBunch = Connection->InBunchArena.Acquire(Bunch, false);
 			if ( !Bunch.bHasPackageMapExports && Bunch.GetBitsLeft() > 0 )
 			{
 				if ( Bunch.GetBitsLeft() % 8 != 0 )
@@ -627,7 +628,9 @@ bool UChannel::ReceivedNextBunch( FInBunch & Bunch, bool & bOutSkipAck )
 					return false;
 				}
 
+				const int64 PreviousCapacity = InPartialBunch->GetBufferCapacity();
 				InPartialBunch->AppendDataFromChecked( Bunch.GetDataPosChecked(), Bunch.GetBitsLeft() );
+				Connection->InBunchArena.NoteBufferGrowth(*InPartialBunch, PreviousCapacity);
 
 				LogPartialBunch(TEXT("Received new partial bunch."), Bunch, *InPartialBunch);
 			}
@@ -663,7 +666,9 @@ bool UChannel::ReceivedNextBunch( FInBunch & Bunch, bool & bOutSkipAck )
 
 				if ( !Bunch.bHasPackageMapExports && Bunch.GetBitsLeft() > 0 )
 				{
+					const int64 PreviousCapacity = InPartialBunch->GetBufferCapacity();
 					InPartialBunch->AppendDataFromChecked( Bunch.GetDataPosChecked(), Bunch.GetBitsLeft() );
+					Connection->InBunchArena.NoteBufferGrowth(*InPartialBunch, PreviousCapacity);
 				}
 
 				// Only the final partial bunch should ever be non byte aligned. This is enforced during partial bunch creation
@@ -740,7 +745,7 @@ bool UChannel::ReceivedNextBunch( FInBunch & Bunch, bool & bOutSkipAck )
 
 				if (InPartialBunch)
 				{
-					delete InPartialBunch;
+					Connection->InBunchArena.Release(InPartialBunch);
 					InPartialBunch = NULL;
 				}
 
@@ -2199,7 +2204,7 @@ bool UActorChannel::CleanUp(const bool bForDestroy, EChannelCloseReason CloseRea
 		// Free any queued bunches
 		for (FInBunch* QueuedInBunch : QueuedBunches)
 		{
-			delete QueuedInBunch;
+			Connection->InBunchArena.Release(QueuedInBunch);
 		}
 
 		QueuedBunches.Empty();
@@ -2481,7 +2486,7 @@ bool UActorChannel::ProcessQueuedBunches()
 			for (FInBunch* QueuedInBunch : QueuedBunches)
 			{
 				ProcessBunch(*QueuedInBunch);
-				delete QueuedInBunch;
+				QueuedInBunch->Connection->InBunchArena.Release(QueuedInBunch);
 			}
 
 			UE_LOG(LogNet, VeryVerbose, TEXT("UActorChannel::ProcessQueuedBunches: Flushing queued bunches. ChIndex: %i, Actor: %s, Queued: %i"), ChIndex, Actor != NULL ? *Actor->GetPathName() : TEXT("NULL"), QueuedBunches.Num());
@@ -2661,7 +2666,7 @@ void UActorChannel::ReceivedBunch( FInBunch & Bunch )
 				bSuppressQueuedBunchWarningsDueToHitches = false;
 			}
 
-			QueuedBunches.Add(new FInBunch(Bunch));
+			QueuedBunches.Add(Connection->InBunchArena.Acquire(Bunch, true));
 			
 			// Start ticking this channel so we can process the queued bunches when possible
 			Connection->StartTickingChannel(this);
@@ -40,6 +40,7 @@
 #include "Engine/ChildConnection.h"
 #include "Net/ReplayPlaylistTracker.h"
 #include "Net/NetworkGranularMemoryLogging.h"
+#include "Containers/Ticker.h"
 
 DEFINE_LOG_CATEGORY( LogDemo );
 
@@ -72,6 +73,8 @@ static TAutoConsoleVariable<float> CVarDemoCullDistanceOverride( TEXT( "demo.Cul
 static TAutoConsoleVariable<float> CVarDemoRecordHzWhenNotRelevant( TEXT( "demo.RecordHzWhenNotRelevant" ), 2.0f, TEXT( "Record at this frequency when actor is not relevant." ) );
 static TAutoConsoleVariable<int32> CVarLoopDemo(TEXT("demo.Loop"), 0, TEXT("<1> : play replay from beginning once it reaches the end / <0> : stop replay at the end"));
 static TAutoConsoleVariable<int32> CVarDemoFastForwardIgnoreRPCs( TEXT( "demo.FastForwardIgnoreRPCs" ), 1, TEXT( "If true, RPCs will be discarded during playback fast forward." ) );
+static TAutoConsoleVariable<int32> CVarDemoFastForwardSkipDestroyedActors( TEXT( "demo.FastForwardSkipDestroyedActors" ), 0, TEXT( "If true, actors that are spawned and destroyed before the end of a fast forward are never spawned during playback fast forward." ) );
+static TAutoConsoleVariable<int32> CVarDemoFastForwardParallelIndexMinPackets( TEXT( "demo.FastForwardParallelIndexMinPackets" ), 64, TEXT( "Minimum number of packets in a fast forward before demo.FastForwardSkipDestroyedActors decodes them on worker threads." ) );
 static TAutoConsoleVariable<int32> CVarDemoLateActorDormancyCheck(TEXT("demo.LateActorDormancyCheck"), 1, TEXT("If true, check if an actor should become dormant as late as possible- when serializing it to the demo archive."));
 
 static TAutoConsoleVariable<int32> CVarDemoJumpToEndOfLiveReplay(TEXT("demo.JumpToEndOfLiveReplay"), 1, TEXT("If true, fast forward to a few seconds before the end when starting playback, if the replay is still being recorded."));
@@ -86,6 +89,7 @@ static FAutoConsoleVariableRef CVarDemoSaveRollbackActorState( TEXT( "demo.SaveR
 TAutoConsoleVariable<int32> CVarWithLevelStreamingFixes(TEXT("demo.WithLevelStreamingFixes"), 0, TEXT("If 1, provides fixes for level streaming (but breaks backwards compatibility)."));
 TAutoConsoleVariable<int32> CVarWithDemoTimeBurnIn(TEXT("demo.WithTimeBurnIn"), 0, TEXT("If true, adds an on screen message with the current DemoTime and Changelist."));
 TAutoConsoleVariable<int32> CVarWithDeltaCheckpoints(TEXT("demo.WithDeltaCheckpoints"), 0, TEXT("If true, record checkpoints as a delta from the previous checkpoint."));
+TAutoConsoleVariable<int32> CVarAsyncCheckpointGuidCache(TEXT("demo.AsyncCheckpointGuidCache"), 0, TEXT("If true, the guid cache of a checkpoint is copied on the game thread and serialized on a worker thread."));
 TAutoConsoleVariable<int32> CVarWithGameSpecificFrameData(TEXT("demo.WithGameSpecificFrameData"), 0, TEXT("If true, allow game specific data to be recorded with each demo frame."));
 
 static TAutoConsoleVariable<float> CVarDemoIncreaseRepPrioritizeThreshold(TEXT("demo.IncreaseRepPrioritizeThreshold"), 0.9, TEXT("The % of Replicated to Prioritized actors at which prioritize time will be decreased."));
@@ -2686,6 +2690,8 @@ void UDemoNetDriver::TickDemoPlayback(float DeltaSeconds)
 	{
 	}
 
+	const bool bIgnoringDestroyedActors = bIsFastForwarding && IgnoreActorsDestroyedDuringFastForward();
+
 	{
 		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("TickDemoPlayback_ProcessPackets"), TickDemoPlayback_ProcessPackets, STATGROUP_Net);
 
@@ -2698,6 +2704,11 @@ void UDemoNetDriver::TickDemoPlayback(float DeltaSeconds)
 			ReplayHelper.DemoFrameNum++;
 		}
 
+		if (bIgnoringDestroyedActors && ServerConnection != nullptr)
+		{
+			ServerConnection->SetIgnoreActorBunches(false, TSet<FNetworkGUID>());
+		}
+
 		if (PlaybackPacketIndex > 0)
 		{
 			// Remove all packets that were processed
@@ -2731,6 +2742,78 @@ void UDemoNetDriver::TickDemoPlayback(float DeltaSeconds)
 	}
 }
 
+bool UDemoNetDriver::IgnoreActorsDestroyedDuringFastForward()
+{
+	if (CVarDemoFastForwardSkipDestroyedActors.GetValueOnGameThread() == 0 || ServerConnection == nullptr)
+	{
+		return false;
+	}
+
+	// Leave the connection alone if the game is already ignoring bunches, or if the packets need a handler or an old header layout
+	if (ServerConnection->IsIgnoringActorBunches() || ServerConnection->Handler.IsValid() || !FReplayChannelLifetimeIndex::SupportsEngineNetVersion(ServerConnection->EngineNetworkProtocolVersion))
+	{
+		return false;
+	}
+
+	// Only the packets ConditionallyProcessPlaybackPackets will get through this tick
+	int32 NumPackets = 0;
+	for (int32 Index = PlaybackPacketIndex; Index < PlaybackPackets.Num(); ++Index)
+	{
+		const FPlaybackPacket& Packet = PlaybackPackets[Index];
+		if (Packet.TimeSeconds > GetDemoCurrentTime() || Packet.LevelIndex != GetCurrentLevelIndex())
+		{
+			break;
+		}
+
+		++NumPackets;
+	}
+
+	if (NumPackets == 0)
+	{
+		return false;
+	}
+
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Demo_IndexFastForwardChannels"), Demo_IndexFastForwardChannels, STATGROUP_Net);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bParallel = NumPackets >= CVarDemoFastForwardParallelIndexMinPackets.GetValueOnGameThread();
+
+	// Actors from the checkpoint or still on an open channel may reopen their channel, dormant ones waking up for instance
+	TSet<FNetworkGUID> LiveChannelActors;
+	for (const UChannel* Channel : ServerConnection->OpenChannels)
+	{
+		if (const UActorChannel* ActorChannel = Cast<UActorChannel>(Channel))
+		{
+			LiveChannelActors.Add(ActorChannel->ActorNetGUID);
+		}
+	}
+
+	auto IsKnownActor = [this, &LiveChannelActors](const FNetworkGUID& ActorGUID)
+	{
+		return LiveChannelActors.Contains(ActorGUID) || (GuidCache.IsValid() && GuidCache->IsGUIDRegistered(ActorGUID));
+	};
+
+	FReplayChannelLifetimeIndex LifetimeIndex;
+	if (!LifetimeIndex.Build(MakeArrayView(PlaybackPackets.GetData() + PlaybackPacketIndex, NumPackets), ServerConnection->EngineNetworkProtocolVersion, ServerConnection->GameNetworkProtocolVersion, ServerConnection->MaxPacket, bParallel, IsKnownActor))
+	{
+		UE_LOG(LogDemo, Warning, TEXT("IgnoreActorsDestroyedDuringFastForward: Failed to index %d packets, fast forwarding without skipping actors."), NumPackets);
+		return false;
+	}
+
+	UE_LOG(LogDemo, Log, TEXT("IgnoreActorsDestroyedDuringFastForward: %d packets, %d bunches, skipping %d destroyed actors. Took %.2f ms (Parallel: %d)"),
+		NumPackets, LifetimeIndex.GetNumBunches(), LifetimeIndex.GetDestroyedActors().Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0, bParallel ? 1 : 0);
+
+	if (LifetimeIndex.GetDestroyedActors().Num() == 0)
+	{
+		return false;
+	}
+
+	TSet<FNetworkGUID> IgnoredGuids = LifetimeIndex.GetDestroyedActors();
+	ServerConnection->SetIgnoreActorBunches(true, MoveTemp(IgnoredGuids));
+
+	return true;
+}
+
 void UDemoNetDriver::FinalizeFastForward(const double StartTime)
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Demo_FinalizeFastForward"), Demo_FinalizeFastForward, STATGROUP_Net);
@@ -4802,6 +4885,151 @@ void UDemoNetDriver::PendingNetGameLoadMapCompleted()
 {
 }
 
+#if !UE_BUILD_SHIPPING
+namespace DemoNetDriverScrubBenchmarkPrivate
+{
+	/** Seeks through the replay being played one GotoTimeInSeconds at a time and logs how long each one took to finish */
+	class FScrubBenchmark : public TSharedFromThis<FScrubBenchmark>
+	{
+	public:
+		FScrubBenchmark(UDemoNetDriver* InDriver, const int32 NumSeeks) : Driver(InDriver)
+		{
+			// Alternate between both halves of the replay so every seek has to load a different checkpoint
+			const float TotalTime = InDriver->GetDemoTotalTime();
+			for (int32 Index = 0; Index < NumSeeks; ++Index)
+			{
+				const float Alpha = (float)(Index / 2 + 1) / (float)(NumSeeks / 2 + 1);
+				SeekTimes.Add((Index % 2) == 0 ? TotalTime * Alpha * 0.5f : TotalTime * (0.5f + Alpha * 0.5f));
+			}
+		}
+
+		bool Tick(float DeltaTime)
+		{
+			UDemoNetDriver* DemoDriver = Driver.Get();
+			if (DemoDriver == nullptr || !DemoDriver->IsPlaying())
+			{
+				UE_LOG(LogDemo, Warning, TEXT("demo.BenchmarkScrub: Replay stopped after %d seeks."), NextSeek);
+				return Finish();
+			}
+
+			if (bSeekPending)
+			{
+				return true;
+			}
+
+			if (NextSeek == SeekTimes.Num())
+			{
+				Report();
+				return Finish();
+			}
+
+			bSeekPending = true;
+			SeekStartTime = FPlatformTime::Seconds();
+			DemoDriver->GotoTimeInSeconds(SeekTimes[NextSeek], FOnGotoTimeDelegate::CreateSP(this, &FScrubBenchmark::OnGotoTimeFinished));
+
+			return true;
+		}
+
+		static TSharedPtr<FScrubBenchmark> Active;
+
+	private:
+		void OnGotoTimeFinished(const bool bWasSuccessful)
+		{
+			const double Milliseconds = (FPlatformTime::Seconds() - SeekStartTime) * 1000.0;
+
+			UE_LOG(LogDemo, Log, TEXT("demo.BenchmarkScrub: Seek %d to %.2f s %s in %.2f ms"), NextSeek, SeekTimes[NextSeek], bWasSuccessful ? TEXT("finished") : TEXT("failed"), Milliseconds);
+
+			if (bWasSuccessful)
+			{
+				SeekMilliseconds.Add(Milliseconds);
+
+				// The streamer keeps the checkpoint the seek loaded until the next one
+				UDemoNetDriver* DemoDriver = Driver.Get();
+				FArchive* CheckpointArchive = DemoDriver && DemoDriver->GetReplayStreamer().IsValid() ? DemoDriver->GetReplayStreamer()->GetCheckpointArchive() : nullptr;
+				CheckpointBytes.Add(CheckpointArchive ? FMath::Max<int64>(CheckpointArchive->TotalSize(), 0) : 0);
+			}
+
+			++NextSeek;
+			bSeekPending = false;
+		}
+
+		void Report() const
+		{
+			if (SeekMilliseconds.Num() == 0)
+			{
+				UE_LOG(LogDemo, Warning, TEXT("demo.BenchmarkScrub: No seek succeeded."));
+				return;
+			}
+
+			double Total = 0.0;
+			double Max = 0.0;
+			for (const double Milliseconds : SeekMilliseconds)
+			{
+				Total += Milliseconds;
+				Max = FMath::Max(Max, Milliseconds);
+			}
+
+			TArray<double> Sorted = SeekMilliseconds;
+			Sorted.Sort();
+
+			int64 TotalCheckpointBytes = 0;
+			int64 MaxCheckpointBytes = 0;
+			for (const int64 Bytes : CheckpointBytes)
+			{
+				TotalCheckpointBytes += Bytes;
+				MaxCheckpointBytes = FMath::Max(MaxCheckpointBytes, Bytes);
+			}
+
+			UE_LOG(LogDemo, Display, TEXT("demo.BenchmarkScrub: %d/%d seeks, avg %.2f ms, median %.2f ms, max %.2f ms, checkpoint read avg %.1f KB, max %.1f KB (DeltaCheckpoints: %d)"),
+				SeekMilliseconds.Num(), SeekTimes.Num(), Total / SeekMilliseconds.Num(), Sorted[Sorted.Num() / 2], Max,
+				(TotalCheckpointBytes / 1024.0) / CheckpointBytes.Num(), MaxCheckpointBytes / 1024.0, Driver.IsValid() && Driver->HasDeltaCheckpoints() ? 1 : 0);
+		}
+
+		bool Finish()
+		{
+			// The ticker drops us when we return false, and this was the last reference keeping us alive
+			Active.Reset();
+			return false;
+		}
+
+		TWeakObjectPtr<UDemoNetDriver> Driver;
+		TArray<float> SeekTimes;
+		TArray<double> SeekMilliseconds;
+		TArray<int64> CheckpointBytes;
+		int32 NextSeek = 0;
+		double SeekStartTime = 0.0;
+		bool bSeekPending = false;
+	};
+
+	TSharedPtr<FScrubBenchmark> FScrubBenchmark::Active;
+
+	static FAutoConsoleCommandWithWorldAndArgs CVarDemoBenchmarkScrub(
+		TEXT("demo.BenchmarkScrub"),
+		TEXT("Seeks through the replay that's playing back and logs how long each seek took. Optional parameter: number of seeks (default 10)."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(
+			[](const TArray<FString>& Args, UWorld* InWorld)
+	{
+		UDemoNetDriver* DemoDriver = InWorld ? InWorld->GetDemoNetDriver() : nullptr;
+		if (DemoDriver == nullptr || !DemoDriver->IsPlaying())
+		{
+			UE_LOG(LogDemo, Warning, TEXT("demo.BenchmarkScrub: No replay is playing."));
+			return;
+		}
+
+		if (FScrubBenchmark::Active.IsValid())
+		{
+			UE_LOG(LogDemo, Warning, TEXT("demo.BenchmarkScrub: Already running."));
+			return;
+		}
+
+		const int32 NumSeeks = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+		FScrubBenchmark::Active = MakeShared<FScrubBenchmark>(DemoDriver, NumSeeks);
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(FScrubBenchmark::Active.ToSharedRef(), &FScrubBenchmark::Tick));
+	}));
+}
+#endif // !UE_BUILD_SHIPPING
+
 void UDemoNetDriver::OnSeamlessTravelStartDuringRecording(const FString& LevelName)
 {
 	if (ClientConnections.Num() > 0)
@@ -4949,8 +5177,8 @@ void UDemoNetDriver::CleanupOutstandingRewindActors()
 					World->DestroyActor(Actor);
 
 					ensureMsgf(GuidCache->NetGUIDLookup.Remove(CacheObject->Object) > 0, TEXT("CleanupOutstandingRewindActors: No entry found for %d in NetGUIDLookup"), NetGUID.Value);
-					GuidCache->ObjectLookup.Remove(NetGUID);
 					CacheObject->bNoLoad = false;
+					GuidCache->ObjectLookup.Remove(NetGUID);
 				}
 				else
 				{
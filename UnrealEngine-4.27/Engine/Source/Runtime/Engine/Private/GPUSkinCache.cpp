@@ -26,6 +26,9 @@ DEFINE_STAT(STAT_GPUSkinCache_NumTrianglesForRecomputeTangents);
 DEFINE_STAT(STAT_GPUSkinCache_NumSectionsProcessed);
 DEFINE_STAT(STAT_GPUSkinCache_NumSetVertexStreams);
 DEFINE_STAT(STAT_GPUSkinCache_NumPreGDME);
+DEFINE_STAT(STAT_GPUSkinCache_NumEvictions);
+DEFINE_STAT(STAT_GPUSkinCache_NumRebuilds);
+DEFINE_STAT(STAT_GPUSkinCache_NumSectionsShared);
 DEFINE_LOG_CATEGORY_STATIC(LogSkinCache, Log, All);
 
 static int32 GEnableGPUSkinCacheShaders = 0;
@@ -107,6 +110,27 @@ static TAutoConsoleVariable<float> CVarGPUSkinCacheSceneMemoryLimitInMB(
 	ECVF_RenderThreadSafe
 );
 
+static int32 GSkinCacheEviction = 1;
+FAutoConsoleVariableRef CVarGPUSkinCacheEviction(
+	TEXT("r.SkinCache.Eviction"),
+	GSkinCacheEviction,
+	TEXT("What to do when an entry doesn't fit in r.SkinCache.SceneMemoryLimitInMB, ignored with ray tracing\n")
+	TEXT("0: off, the new entry falls back to vertex shader skinning\n")
+	TEXT("1: evict the entries drawn or skinned longest ago, coarsest LOD first, that weren't drawn or skinned this frame (default)\n"),
+	ECVF_RenderThreadSafe
+);
+
+static int32 GSkinCacheShareIdenticalPoses = 0;
+FAutoConsoleVariableRef CVarGPUSkinCacheShareIdenticalPoses(
+	TEXT("r.SkinCache.ShareIdenticalPoses"),
+	GSkinCacheShareIdenticalPoses,
+	TEXT("Whether components skinning the same mesh LOD into the same pose this frame, like animation instanced crowds, draw a single skinned output, ignored with ray tracing\n")
+	TEXT("Sections with morph targets, cloth or vertex offsets are always skinned on their own\n")
+	TEXT("0: off (default)\n")
+	TEXT("1: on, costs hashing the bone matrices of every skin cached mesh update\n"),
+	ECVF_RenderThreadSafe
+);
+
 ////temporary disable until resource lifetimes are safe for all cases
 static int32 GAllowDupedVertsForRecomputeTangents = 0;
 FAutoConsoleVariableRef CVarGPUSkinCacheAllowDupedVertesForRecomputeTangents(
@@ -364,6 +388,40 @@ public:
 		return GPUSkin == InSkin && GPUSkin->GetLOD() == LOD;
 	}
 
+	/** True when the entry has skinned output to draw, either its own or the one it shares */
+	bool HasOutput() const
+	{
+		return PositionAllocation || SharedSource;
+	}
+
+	void SetSharedSource(FGPUSkinCacheEntry* InSharedSource)
+	{
+		check(!PositionAllocation && !SharedSource);
+		SharedSource = InSharedSource;
+		SharedSource->SharingEntries.Add(this);
+	}
+
+	void InvalidateSection(int32 Section)
+	{
+		FSectionDispatchData& Data = DispatchData[Section];
+		Data.SectionIndex = -1;
+		Data.PositionTracker = FGPUSkinCache::FRWBufferTracker();
+		Data.PositionBuffer = nullptr;
+		Data.PreviousPositionBuffer = nullptr;
+		Data.TangentBuffer = nullptr;
+		Data.IntermediateTangentBuffer = nullptr;
+	}
+
+	/** Sends every section back to vertex shader skinning, the owner re-creates the entry on its next update as IsValid fails */
+	void Invalidate()
+	{
+		LOD = -1;
+		for (int32 Section = 0; Section < DispatchData.Num(); ++Section)
+		{
+			InvalidateSection(Section);
+		}
+	}
+
 	void UpdateSkinWeightBuffer()
 	{
 		FSkinWeightVertexBuffer* WeightBuffer = GPUSkin->GetSkinWeightVertexBuffer(LOD);
@@ -494,6 +552,14 @@ protected:
 	FShaderResourceViewRHIRef ClothBuffer;
 	int32 LOD;
 
+	/** Last frame the entry was skinned, and last frame it was skinned or drawn, which orders evictions */
+	uint32 LastSkinnedFrame = 0;
+	uint32 LastUsedFrame = 0;
+
+	/** Entry whose output this one draws instead of owning an allocation, and the entries drawing this one's output */
+	FGPUSkinCacheEntry* SharedSource = nullptr;
+	TArray<FGPUSkinCacheEntry*> SharingEntries;
+
 	bool bMultipleClothSkinInfluences;
 
 	friend class FGPUSkinCache;
@@ -1194,7 +1260,8 @@ FGPUSkinCache::FRWBuffersAllocation* FGPUSkinCache::TryAllocBuffer(uint32 NumVer
 {
 	uint64 MaxSizeInBytes = (uint64)(GSkinCacheSceneMemoryLimitInMB * 1024.0f * 1024.0f);
 	uint64 RequiredMemInBytes = FRWBuffersAllocation::CalculateRequiredMemory(NumVertices, WithTangnents);
-	if (bRequiresMemoryLimit && UsedMemoryInBytes + RequiredMemInBytes >= MaxSizeInBytes)
+	if (bRequiresMemoryLimit && UsedMemoryInBytes + RequiredMemInBytes >= MaxSizeInBytes
+		&& !(GSkinCacheEviction && !IsRayTracingEnabled() && EvictEntries(UsedMemoryInBytes + RequiredMemInBytes - MaxSizeInBytes + 1)))
 	{
 		ExtraRequiredMemory += RequiredMemInBytes;
 
@@ -1211,6 +1278,50 @@ FGPUSkinCache::FRWBuffersAllocation* FGPUSkinCache::TryAllocBuffer(uint32 NumVer
 	return NewAllocation;
 }
 
+bool FGPUSkinCache::EvictEntries(uint64 BytesToFree)
+{
+	const uint32 FrameNumber = GFrameNumberRenderThread;
+
+	// Entries drawn or skinned this frame may have draws or dispatches pending
+	TArray<FGPUSkinCacheEntry*, TInlineAllocator<64>> Candidates;
+	uint64 CandidateBytes = 0;
+	for (FGPUSkinCacheEntry* Entry : Entries)
+	{
+		if (Entry->PositionAllocation && Entry->LastUsedFrame != FrameNumber)
+		{
+			Candidates.Add(Entry);
+			CandidateBytes += Entry->PositionAllocation->GetNumBytes();
+		}
+	}
+
+	// Evicting entries that wouldn't make room would only cost rebuilding them
+	if (CandidateBytes < BytesToFree)
+	{
+		return false;
+	}
+
+	// Offscreen the longest first, then the least detailed LOD
+	Algo::Sort(Candidates, [](const FGPUSkinCacheEntry* A, const FGPUSkinCacheEntry* B)
+	{
+		return A->LastUsedFrame != B->LastUsedFrame ? A->LastUsedFrame < B->LastUsedFrame : A->LOD > B->LOD;
+	});
+
+	uint64 FreedBytes = 0;
+	for (int32 Index = 0; Index < Candidates.Num() && FreedBytes < BytesToFree; ++Index)
+	{
+		FGPUSkinCacheEntry* Entry = Candidates[Index];
+		FreedBytes += Entry->PositionAllocation->GetNumBytes();
+
+		ReleaseAllocation(Entry);
+		InvalidateSharingEntries(Entry);
+		Entry->Invalidate();
+
+		INC_DWORD_STAT(STAT_GPUSkinCache_NumEvictions);
+	}
+
+	return true;
+}
+
 void FGPUSkinCache::DoDispatch(FRHICommandListImmediate& RHICmdList)
 {
 	int32 BatchCount = BatchDispatches.Num();
@@ -1233,7 +1344,10 @@ void FGPUSkinCache::DoDispatch(FRHICommandListImmediate& RHICmdList)
 	for (int32 i = 0; i < BatchCount; ++i)
 	{
 		FDispatchEntry& DispatchItem = BatchDispatches[i];
-		DispatchUpdateSkinning(RHICmdList, DispatchItem.SkinCacheEntry, DispatchItem.Section, DispatchItem.RevisionNumber);
+		if (DispatchItem.SkinCacheEntry->PositionAllocation)
+		{
+			DispatchUpdateSkinning(RHICmdList, DispatchItem.SkinCacheEntry, DispatchItem.Section, DispatchItem.RevisionNumber);
+		}
 	}
 	RHICmdList.EndUAVOverlap(OverlappedUAVBuffers);
 
@@ -1242,7 +1356,7 @@ void FGPUSkinCache::DoDispatch(FRHICommandListImmediate& RHICmdList)
 		FDispatchEntry& DispatchItem = BatchDispatches[i];
 		DispatchItem.SkinCacheEntry->UpdateVertexFactoryDeclaration(DispatchItem.Section);
 
-		if (DispatchItem.SkinCacheEntry->DispatchData[DispatchItem.Section].IndexBuffer)
+		if (DispatchItem.SkinCacheEntry->DispatchData[DispatchItem.Section].IndexBuffer && DispatchItem.SkinCacheEntry->PositionAllocation)
 		{
 			DispatchUpdateSkinTangents(RHICmdList, DispatchItem.SkinCacheEntry, DispatchItem.Section);
 		}
@@ -1255,11 +1369,14 @@ void FGPUSkinCache::DoDispatch(FRHICommandListImmediate& RHICmdList, FGPUSkinCac
 {
 	INC_DWORD_STAT(STAT_GPUSkinCache_TotalNumChunks);
 	PrepareUpdateSkinning(SkinCacheEntry, Section, RevisionNumber, nullptr);
-	DispatchUpdateSkinning(RHICmdList, SkinCacheEntry, Section, RevisionNumber);
+	if (SkinCacheEntry->PositionAllocation)
+	{
+		DispatchUpdateSkinning(RHICmdList, SkinCacheEntry, Section, RevisionNumber);
+	}
 	//RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, DispatchData.GetRWBuffer());
 	SkinCacheEntry->UpdateVertexFactoryDeclaration(Section);
 
-	if (SkinCacheEntry->DispatchData[Section].IndexBuffer)
+	if (SkinCacheEntry->DispatchData[Section].IndexBuffer && SkinCacheEntry->PositionAllocation)
 	{
 		DispatchUpdateSkinTangents(RHICmdList, SkinCacheEntry, Section);
 	}
@@ -1298,14 +1415,53 @@ void FGPUSkinCache::ProcessEntry(
 		InvalidateAllEntries();
 	}
 
+	const uint32 FrameNumber = GFrameNumberRenderThread;
+	const bool bMorph = MorphVertexBuffer && MorphVertexBuffer->SectionIds.Contains(Section);
+
+	// Look for an entry skinned this frame into the same output
+	FSharedSectionKey SharedKey;
+	FGPUSkinCacheEntry* SharedSource = nullptr;
+	const bool bCanShare = IsPoseSharingEnabled() && Skin->GetPoseHash() != 0 && !bMorph && !ClothVertexBuffer && VertexOffsetBuffers->GetUsage() == 0;
+	if (bCanShare)
+	{
+		if (SharedSectionsFrameNumber != FrameNumber)
+		{
+			SharedSections.Reset();
+			SharedSectionsFrameNumber = FrameNumber;
+		}
+
+		SharedKey.LODData = &LodData;
+		SharedKey.WeightBuffer = Skin->GetSkinWeightVertexBuffer(LODIndex);
+		SharedKey.PoseHash = Skin->GetPoseHash();
+		SharedKey.PreviousPoseHash = Skin->GetPreviousPoseHash();
+		SharedKey.Section = Section;
+		SharedSource = SharedSections.FindRef(SharedKey);
+	}
+
+	const bool bRebuild = InOutEntry && !InOutEntry->IsValid(Skin);
 	if (InOutEntry)
 	{
 		// If the LOD changed, the entry has to be invalidated
-		if (!InOutEntry->IsValid(Skin))
+		if (bRebuild)
 		{
 			Release(InOutEntry);
 			InOutEntry = nullptr;
 		}
+		else if (!InOutEntry->PositionAllocation && InOutEntry->SharedSource != SharedSource)
+		{
+			// The pose no longer matches the output this entry shares
+			if (InOutEntry->LastSkinnedFrame != FrameNumber)
+			{
+				Release(InOutEntry);
+				InOutEntry = nullptr;
+			}
+			else
+			{
+				// Its other sections are already queued this frame, leave this one to vertex shader skinning until the next update
+				InOutEntry->InvalidateSection(Section);
+				return;
+			}
+		}
 		else
 		{
 			if (!InOutEntry->IsSectionValid(Section) || !InOutEntry->IsSourceFactoryValid(Section, VertexFactory))
@@ -1320,27 +1476,51 @@ void FGPUSkinCache::ProcessEntry(
 	// Try to allocate a new entry
 	if (!InOutEntry)
 	{
-		bool WithTangents = RecomputeTangentsMode > 0;
-		int32 TotalNumVertices = VertexFactory->GetNumVertices();
-		FRWBuffersAllocation* NewPositionAllocation = TryAllocBuffer(TotalNumVertices, WithTangents);
-		if (!NewPositionAllocation)
+		FRWBuffersAllocation* NewPositionAllocation = nullptr;
+		if (!SharedSource)
 		{
-			// Couldn't fit; caller will notify OOM
-			return;
+			bool WithTangents = RecomputeTangentsMode > 0;
+			int32 TotalNumVertices = VertexFactory->GetNumVertices();
+			NewPositionAllocation = TryAllocBuffer(TotalNumVertices, WithTangents);
+			if (!NewPositionAllocation)
+			{
+				// Couldn't fit; caller will notify OOM
+				return;
+			}
 		}
 
 		InOutEntry = new FGPUSkinCacheEntry(this, Skin, NewPositionAllocation);
 		InOutEntry->GPUSkin = Skin;
+		if (SharedSource)
+		{
+			InOutEntry->SetSharedSource(SharedSource);
+		}
 
 		InOutEntry->SetupSection(Section, NewPositionAllocation, &LodData.RenderSections[Section], MorphVertexBuffer, ClothVertexBuffer, NumVertices, InputStreamStart, VertexFactory, TargetVertexFactory);
 		Entries.Add(InOutEntry);
+
+		if (bRebuild)
+		{
+			INC_DWORD_STAT(STAT_GPUSkinCache_NumRebuilds);
+		}
+	}
+
+	InOutEntry->LastSkinnedFrame = FrameNumber;
+	InOutEntry->LastUsedFrame = FrameNumber;
+	if (InOutEntry->SharedSource)
+	{
+		INC_DWORD_STAT(STAT_GPUSkinCache_NumSectionsShared);
+	}
+	else if (bCanShare && !SharedSource)
+	{
+		// Entries with their own allocation never start sharing, so the first one skinned into this output serves the others
+		SharedSections.Add(SharedKey, InOutEntry);
 	}
 
 	InOutEntry->VertexOffsetUsage = VertexOffsetBuffers->GetUsage();
 	InOutEntry->PreSkinningVertexOffsetSRV = VertexOffsetBuffers->PreSkinningOffsetsVertexBuffer.GetSRV();
 	InOutEntry->PostSkinningVertexOffsetSRV = VertexOffsetBuffers->PostSkinningOffsetsVertexBuffer.GetSRV();
 
-	const bool bMorph = MorphVertexBuffer && MorphVertexBuffer->SectionIds.Contains(Section);
 	if (bMorph)
 	{
 		InOutEntry->MorphBuffer = MorphVertexBuffer->GetSRV();
@@ -1644,6 +1824,20 @@ void FGPUSkinCache::GetShaderBindings(
 void FGPUSkinCache::PrepareUpdateSkinning(FGPUSkinCacheEntry* Entry, int32 Section, uint32 RevisionNumber, TArray<FRHIUnorderedAccessView*>* OverlappedUAVs)
 {
 	FGPUSkinCacheEntry::FSectionDispatchData& DispatchData = Entry->DispatchData[Section];
+
+	if (!Entry->PositionAllocation)
+	{
+		// Draws the output of an entry skinned earlier this frame, which was prepared first
+		check(Entry->SharedSource && Entry->SharedSource->IsSectionValid(Section));
+		const FGPUSkinCacheEntry::FSectionDispatchData& SourceDispatchData = Entry->SharedSource->DispatchData[Section];
+		DispatchData.DispatchFlags = 0;
+		DispatchData.PositionBuffer = SourceDispatchData.PositionBuffer;
+		DispatchData.PreviousPositionBuffer = SourceDispatchData.PreviousPositionBuffer;
+		DispatchData.TangentBuffer = SourceDispatchData.TangentBuffer;
+		DispatchData.IntermediateTangentBuffer = SourceDispatchData.IntermediateTangentBuffer;
+		return;
+	}
+
 	FGPUBaseSkinVertexFactory::FShaderDataType& ShaderData = DispatchData.SourceVertexFactory->GetShaderData();
 
 	const FVertexBufferAndSRV& BoneBuffer = ShaderData.GetBoneBufferForReading(false);
@@ -1917,6 +2111,29 @@ void FGPUSkinCache::ReleaseSkinCacheEntry(FGPUSkinCacheEntry* SkinCacheEntry)
 #if RHI_RAYTRACING
 	SkinCache->RemoveRayTracingGeometryUpdate(&SkinCacheEntry->GPUSkin->RayTracingGeometry);
 #endif // RHI_RAYTRACING
+	ReleaseAllocation(SkinCacheEntry);
+
+	if (SkinCacheEntry->SharedSource)
+	{
+		SkinCacheEntry->SharedSource->SharingEntries.RemoveSingleSwap(SkinCacheEntry, false);
+	}
+	InvalidateSharingEntries(SkinCacheEntry);
+
+	for (auto It = SkinCache->SharedSections.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == SkinCacheEntry)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	SkinCache->Entries.RemoveSingleSwap(SkinCacheEntry, false);
+	delete SkinCacheEntry;
+}
+
+void FGPUSkinCache::ReleaseAllocation(FGPUSkinCacheEntry* SkinCacheEntry)
+{
+	FGPUSkinCache* SkinCache = SkinCacheEntry->SkinCache;
 	FRWBuffersAllocation* PositionAllocation = SkinCacheEntry->PositionAllocation;
 	if (PositionAllocation)
 	{
@@ -1931,9 +2148,16 @@ void FGPUSkinCache::ReleaseSkinCacheEntry(FGPUSkinCacheEntry* SkinCacheEntry)
 
 		SkinCacheEntry->PositionAllocation = nullptr;
 	}
+}
 
-	SkinCache->Entries.RemoveSingleSwap(SkinCacheEntry, false);
-	delete SkinCacheEntry;
+void FGPUSkinCache::InvalidateSharingEntries(FGPUSkinCacheEntry* SkinCacheEntry)
+{
+	for (FGPUSkinCacheEntry* SharingEntry : SkinCacheEntry->SharingEntries)
+	{
+		SharingEntry->SharedSource = nullptr;
+		SharingEntry->Invalidate();
+	}
+	SkinCacheEntry->SharingEntries.Reset();
 }
 
 #if RHI_RAYTRACING
@@ -1945,7 +2169,25 @@ void FGPUSkinCache::GetRayTracingSegmentVertexBuffers(const FGPUSkinCacheEntry&
 
 bool FGPUSkinCache::IsEntryValid(FGPUSkinCacheEntry* SkinCacheEntry, int32 Section)
 {
-	return SkinCacheEntry->IsSectionValid(Section);
+	// A shared output only holds this entry's pose until its source is skinned again without it
+	return SkinCacheEntry->IsSectionValid(Section)
+		&& (!SkinCacheEntry->SharedSource || SkinCacheEntry->SharedSource->LastSkinnedFrame == SkinCacheEntry->LastSkinnedFrame);
+}
+
+void FGPUSkinCache::MarkEntryDrawn(FGPUSkinCacheEntry* SkinCacheEntry)
+{
+	const uint32 FrameNumber = GFrameNumberRenderThread;
+	SkinCacheEntry->LastUsedFrame = FrameNumber;
+	if (SkinCacheEntry->SharedSource)
+	{
+		SkinCacheEntry->SharedSource->LastUsedFrame = FrameNumber;
+	}
+}
+
+bool FGPUSkinCache::IsPoseSharingEnabled()
+{
+	// Ray tracing geometry keeps pointing at the buffers of the entry it was built from
+	return GSkinCacheShareIdenticalPoses != 0 && !IsRayTracingEnabled();
 }
 
 bool FGPUSkinCache::UseIntermediateTangents()
@@ -1979,7 +2221,7 @@ FCachedGeometry FGPUSkinCache::GetCachedGeometry(uint32 ComponentId) const
 	FCachedGeometry Out;
 	for (FGPUSkinCacheEntry* Entry : Entries)
 	{
-		if (Entry && Entry->GPUSkin && Entry->GPUSkin->GetComponentId() == ComponentId)
+		if (Entry && Entry->GPUSkin && Entry->GPUSkin->GetComponentId() == ComponentId && Entry->HasOutput())
 		{
 			const uint32 LODIndex = Entry->GPUSkin->GetLOD();
 			const FSkeletalMeshRenderData& RenderData = Entry->GPUSkin->GetSkeletalMeshRenderData();
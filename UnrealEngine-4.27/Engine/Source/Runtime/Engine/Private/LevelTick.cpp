@@ -1616,6 +1616,9 @@ void UWorld::Tick( ELevelTick TickType, float DeltaSeconds )
 				RunTickGroup(TG_LastDemotable);
 			}
 
+			// All movement for this frame is done, run the batched overlap queries and dispatch their events.
+			DeferredOverlapUpdates.Flush(this);
+
 			FTickTaskManagerInterface::Get().EndFrame();
 		}
 	}
@@ -3731,6 +3731,50 @@ void UMaterialInstance::SetScalarParameterValueInternal(const FMaterialParameter
 	}
 }
 
+void UMaterialInstance::SetScalarParameterValuesInternal(TArrayView<const TPair<FName, float>> Parameters)
+{
+	LLM_SCOPE(ELLMTag::MaterialInstance);
+
+	TArray<TPair<FMaterialParameterInfo, float>> ChangedParameters;
+	ChangedParameters.Reserve(Parameters.Num());
+
+	for (const TPair<FName, float>& Parameter : Parameters)
+	{
+		const FMaterialParameterInfo ParameterInfo(Parameter.Key);
+		FScalarParameterValue* ParameterValue = GameThread_FindParameterByName(ScalarParameterValues, ParameterInfo);
+
+		bool bForceUpdate = false;
+		if (!ParameterValue)
+		{
+			ParameterValue = new(ScalarParameterValues) FScalarParameterValue;
+			ParameterValue->ParameterInfo = ParameterInfo;
+			ParameterValue->ExpressionGUID.Invalidate();
+			bForceUpdate = true;
+		}
+
+		if (bForceUpdate || ParameterValue->ParameterValue != Parameter.Value)
+		{
+			ParameterValue->ParameterValue = Parameter.Value;
+			ChangedParameters.Emplace(ParameterInfo, Parameter.Value);
+		}
+	}
+
+	// One render command and one uniform expression cache update for the lot, rather than one per parameter
+	if (ChangedParameters.Num() > 0 && FApp::CanEverRender())
+	{
+		FMaterialInstanceResource* InResource = Resource;
+		ENQUEUE_RENDER_COMMAND(SetMIScalarParameterValues)(
+			[InResource, ChangedParameters = MoveTemp(ChangedParameters)](FRHICommandListImmediate& RHICmdList)
+			{
+				for (const TPair<FMaterialParameterInfo, float>& Parameter : ChangedParameters)
+				{
+					InResource->RenderThread_UpdateParameter(Parameter.Key, Parameter.Value);
+				}
+				InResource->CacheUniformExpressions(false);
+			});
+	}
+}
+
 #if WITH_EDITOR
 void UMaterialInstance::SetScalarParameterAtlasInternal(const FMaterialParameterInfo& ParameterInfo, FScalarParameterAtlasInstanceData AtlasData)
 {
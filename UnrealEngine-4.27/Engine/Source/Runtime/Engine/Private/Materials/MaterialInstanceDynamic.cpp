@@ -112,6 +112,11 @@ void UMaterialInstanceDynamic::SetScalarParameterValueByInfo(const FMaterialPara
 	SetScalarParameterValueInternal(ParameterInfo, Value);
 }
 
+void UMaterialInstanceDynamic::SetScalarParameterValues(TArrayView<const TPair<FName, float>> Parameters)
+{
+	SetScalarParameterValuesInternal(Parameters);
+}
+
 bool UMaterialInstanceDynamic::InitializeScalarParameterAndGetIndex(const FName& ParameterName, float Value, int32& OutParameterIndex)
 {
 	OutParameterIndex = INDEX_NONE;
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/NetPacketSendQueue.h"
+
+void FNetPacketSendQueue::Enqueue(const uint8* Data, int32 CountBits, const FOutPacketTraits& Traits)
+{
+	const int32 NumBytes = (CountBits + 7) >> 3;
+	const int32 Offset = Storage.AddUninitialized(NumBytes);
+	if (NumBytes > 0)
+	{
+		FMemory::Memcpy(Storage.GetData() + Offset, Data, NumBytes);
+	}
+
+	Entries.Add({ Offset, CountBits, Traits });
+}
+
+void FNetPacketSendQueue::Flush(TFunctionRef<void(TArrayView<FQueuedOutPacket>)> SendBatch)
+{
+	if (Entries.Num() == 0 || bIsFlushing)
+	{
+		return;
+	}
+
+	TGuardValue<bool> FlushingGuard(bIsFlushing, true);
+
+	// Take the packets out of the queue first, sending can flush the connection again and queue more
+	Exchange(Storage, FlushStorage);
+
+	FlushPackets.Reset(Entries.Num());
+	for (const FEntry& Entry : Entries)
+	{
+		FlushPackets.Add({ FlushStorage.GetData() + Entry.Offset, Entry.CountBits, Entry.Traits });
+	}
+	Entries.Reset();
+
+	SendBatch(FlushPackets);
+
+	FlushPackets.Reset();
+	FlushStorage.Reset();
+}
+
+void FNetPacketSendQueue::Reset()
+{
+	Storage.Reset();
+	Entries.Reset();
+}
+
+void FNetPacketSendQueue::CountBytes(FArchive& Ar) const
+{
+	Storage.CountBytes(Ar);
+	Entries.CountBytes(Ar);
+	FlushPackets.CountBytes(Ar);
+	FlushStorage.CountBytes(Ar);
+}
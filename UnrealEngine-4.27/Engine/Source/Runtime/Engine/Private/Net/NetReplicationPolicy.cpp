@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/NetReplicationPolicy.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetworkObjectList.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/WorldSettings.h"
+#include "EngineStats.h"
+
+FNetReplicationPolicy::FNetReplicationPolicy(UNetDriver* InNetDriver)
+	: NetDriver(InNetDriver)
+	, Frame(0)
+{
+	check(NetDriver);
+	NetDriver->GetNetworkObjectList().SetUpdateScheduleEnabled(true);
+	NetDriver->GetNetworkObjectList().GetRelevancyGrid().SetTrackChanges(true);
+}
+
+FNetReplicationPolicy::~FNetReplicationPolicy()
+{
+}
+
+void FNetReplicationPolicy::GatherDueActors(TArray<FNetworkObjectInfo*>& OutActors)
+{
+	// Zero means never gathered
+	Frame = (Frame == MAX_uint32) ? 1 : Frame + 1;
+
+	FNetworkObjectList& NetworkObjectList = NetDriver->GetNetworkObjectList();
+
+	for (const TWeakObjectPtr<AActor>& WeakActor : RequestedActors)
+	{
+		if (FNetworkObjectInfo* ActorInfo = NetDriver->FindNetworkObjectInfo(WeakActor.Get()))
+		{
+			if (ActorInfo->UpdateScheduleGatherFrame != Frame)
+			{
+				ActorInfo->UpdateScheduleGatherFrame = Frame;
+				OutActors.Add(ActorInfo);
+			}
+		}
+	}
+	RequestedActors.Reset();
+
+	NetworkObjectList.GetUpdateSchedule().GatherDueObjects(Frame, OutActors);
+
+	// Actors dormant on every connection stay in their bucket, but there is nothing to do for them until they wake up
+	const FNetworkObjectList::FNetworkObjectSet& ActiveObjects = NetworkObjectList.GetActiveObjects();
+	if (ActiveObjects.Num() < NetworkObjectList.GetAllObjects().Num())
+	{
+		OutActors.RemoveAll([&ActiveObjects](const FNetworkObjectInfo* ActorInfo)
+		{
+			return !ActiveObjects.Contains(ActorInfo->Actor);
+		});
+	}
+
+	SET_DWORD_STAT(STAT_NumReplicationPolicyDueActors, OutActors.Num());
+	SET_DWORD_STAT(STAT_NumReplicationPolicyBuckets, NetworkObjectList.GetUpdateSchedule().GetNumBuckets());
+}
+
+void FNetReplicationPolicy::RescheduleActor(FNetworkObjectInfo& ActorInfo, const float ServerTickTime)
+{
+	NetDriver->GetNetworkObjectList().GetUpdateSchedule().Update(ActorInfo, GetUpdateIntervalFrames(ActorInfo, ServerTickTime));
+}
+
+void FNetReplicationPolicy::RequestUpdate(FNetworkObjectInfo& ActorInfo)
+{
+	RequestedActors.Add(ActorInfo.WeakActor);
+}
+
+int32 FNetReplicationPolicy::GetUpdateIntervalFrames(const FNetworkObjectInfo& ActorInfo, const float ServerTickTime) const
+{
+	const AActor* Actor = ActorInfo.Actor;
+	if (Actor->NetUpdateFrequency <= 0.0f)
+	{
+		return FNetworkUpdateSchedule::MaxIntervalFrames;
+	}
+
+	// With adaptive net update frequency, actors that haven't sent anything in a while are visited less often
+	float UpdateDelta = 1.0f / Actor->NetUpdateFrequency;
+	if (UNetDriver::IsAdaptiveNetUpdateFrequencyEnabled() && ActorInfo.OptimalNetUpdateDelta > UpdateDelta)
+	{
+		UpdateDelta = ActorInfo.OptimalNetUpdateDelta;
+	}
+
+	if (ServerTickTime <= 0.0f)
+	{
+		return 1;
+	}
+
+	return FMath::Clamp(FMath::RoundToInt(UpdateDelta / ServerTickTime), 1, FNetworkUpdateSchedule::MaxIntervalFrames);
+}
+
+bool FNetReplicationPolicy::FConnectionState::IsNearby(const ENetRelevancyGridList List, const FIntPoint& Cell) const
+{
+	switch (List)
+	{
+		case ENetRelevancyGridList::Cell:
+			return NearbyCells.Contains(Cell);
+
+		case ENetRelevancyGridList::AlwaysRelevant:
+		case ENetRelevancyGridList::OwnerRelevant:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+const TSet<const FNetworkObjectInfo*>& FNetReplicationPolicy::GetNearbyActors(UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const FNetworkRelevancyGrid& RelevancyGrid)
+{
+	FConnectionState& State = ConnectionStates.FindOrAdd(Connection);
+
+	TArray<FIntPoint, TInlineAllocator<2>> ViewerCells;
+	for (const FNetViewer& Viewer : ConnectionViewers)
+	{
+		ViewerCells.Add(RelevancyGrid.GetCell(Viewer.ViewLocation));
+	}
+
+	if (ViewerCells != State.ViewerCells || State.CellSize != RelevancyGrid.GetCellSize() || State.QueryRadius != RelevancyGrid.GetQueryRadius())
+	{
+		State.ViewerCells = ViewerCells;
+		State.CellSize = RelevancyGrid.GetCellSize();
+		State.QueryRadius = RelevancyGrid.GetQueryRadius();
+
+		State.NearbyCells.Reset();
+		RelevancyGrid.GatherNearbyCells(ConnectionViewers, State.NearbyCells);
+		State.bNearbyActorsValid = false;
+	}
+
+	if (!State.bNearbyActorsValid)
+	{
+		State.NearbyActors.Reset();
+		RelevancyGrid.GatherObjectsInCells(State.NearbyCells, State.NearbyActors);
+		State.bNearbyActorsValid = true;
+
+		INC_DWORD_STAT(STAT_NumReplicationPolicyCellRebuilds);
+	}
+
+	return State.NearbyActors;
+}
+
+void FNetReplicationPolicy::ApplyRelevancyGridChanges(FNetworkRelevancyGrid& RelevancyGrid)
+{
+	if (RelevancyGrid.WasResetSinceChangesCleared())
+	{
+		for (TPair<UNetConnection*, FConnectionState>& Pair : ConnectionStates)
+		{
+			Pair.Value.NearbyActors.Reset();
+			Pair.Value.bNearbyActorsValid = false;
+		}
+	}
+	else
+	{
+		const TArray<FNetRelevancyGridChange>& Changes = RelevancyGrid.GetChanges();
+		for (TPair<UNetConnection*, FConnectionState>& Pair : ConnectionStates)
+		{
+			FConnectionState& State = Pair.Value;
+			if (!State.bNearbyActorsValid)
+			{
+				continue;
+			}
+
+			// Applied in order, an object can leave the grid and another be added at the same address
+			for (const FNetRelevancyGridChange& Change : Changes)
+			{
+				const bool bWasNearby = State.IsNearby(Change.OldList, Change.OldCell);
+				const bool bIsNearby = State.IsNearby(Change.NewList, Change.NewCell);
+				if (bIsNearby && !bWasNearby)
+				{
+					State.NearbyActors.Add(Change.ObjectInfo);
+				}
+				else if (bWasNearby && !bIsNearby)
+				{
+					State.NearbyActors.Remove(Change.ObjectInfo);
+				}
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_NumReplicationPolicyGridChanges, Changes.Num());
+	}
+
+	RelevancyGrid.ClearChanges();
+}
+
+void FNetReplicationPolicy::RemoveConnection(UNetConnection* Connection)
+{
+	ConnectionStates.Remove(Connection);
+}
+
+void FNetReplicationPolicy::CountBytes(FArchive& Ar) const
+{
+	ConnectionStates.CountBytes(Ar);
+	for (const TPair<UNetConnection*, FConnectionState>& Pair : ConnectionStates)
+	{
+		Pair.Value.ViewerCells.CountBytes(Ar);
+		Pair.Value.NearbyCells.CountBytes(Ar);
+		Pair.Value.NearbyActors.CountBytes(Ar);
+	}
+
+	RequestedActors.CountBytes(Ar);
+}
@@ -83,6 +83,11 @@ namespace GranularNetworkMemoryTrackingPrivate
 			TotalBytes += Bytes;
 		}
 
+		void AddCountToField(const FString& FieldName, const uint64 Count)
+		{
+			Fields.FindOrAdd(FieldName) += Count;
+		}
+
 		uint64 GetTotalBytes() const
 		{
 			return TotalBytes;
@@ -157,6 +162,14 @@ namespace GranularNetworkMemoryTrackingPrivate
 			GetCorrectScope().AddBytesToField(WorkName, WorkBytes);
 		}
 
+		void TrackCount(const FString& CountName, const uint64 Count)
+		{
+			if (CurrentScope)
+			{
+				CurrentScope->AddCountToField(CountName, Count);
+			}
+		}
+
 	private:
 
 		FNetworkMemoryTrackingScopeStack() :
@@ -246,6 +259,14 @@ namespace GranularNetworkMemoryTrackingPrivate
 			ScopeStack->TrackWork(WorkName, Bytes);
 		}
 	}
+
+	void FScopeMarker::LogCustomCount(const FString& CountName, const uint64 Count) const
+	{
+		if (ScopeStack)
+		{
+			ScopeStack->TrackCount(CountName, Count);
+		}
+	}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/NetConnection.h"
+
+#include "BatchedSendTestNetConnection.generated.h"
+
+class FInternetAddr;
+class FSocket;
+
+/**
+ * Connection the batched send tests drive through FlushNet. LowLevelSend records the size of every packet in the order
+ * it reached the socket, and sends it to TestSocket when one is set. Hidden from Blueprints and class pickers, it only exists for the tests.
+ */
+UCLASS(transient, NotBlueprintable, HideDropdown)
+class UBatchedSendTestNetConnection : public UNetConnection
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Socket and address LowLevelSend writes packets to, packets are only recorded when null */
+	FSocket* TestSocket = nullptr;
+	TSharedPtr<FInternetAddr> TestRemoteAddr;
+
+	/** Size in bits of every packet LowLevelSend was given, in order */
+	TArray<int32> SentPacketBits;
+
+	/** Called by LowLevelSend before it records the packet */
+	TFunction<void()> OnLowLevelSend;
+
+	//~UNetConnection interface
+	virtual void LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits) override;
+	virtual FString LowLevelGetRemoteAddress(bool bAppendPort = false) override { return FString(); }
+	virtual FString LowLevelDescribe() override { return TEXT("Batched Send Test"); }
+	virtual void InitRemoteConnection(UNetDriver* InDriver, class FSocket* InSocket, const FURL& InURL, const class FInternetAddr& InRemoteAddr, EConnectionState InState, int32 InMaxPacket = 0, int32 InPacketOverhead = 0) override {}
+	virtual void InitLocalConnection(UNetDriver* InDriver, class FSocket* InSocket, const FURL& InURL, EConnectionState InState, int32 InMaxPacket = 0, int32 InPacketOverhead = 0) override {}
+	//~End of UNetConnection interface
+};
@@ -0,0 +1,370 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/Tests/BatchedSendTestNetConnection.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "IPAddress.h"
+#include "UObject/Package.h"
+#include "Engine/DemoNetDriver.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+void UBatchedSendTestNetConnection::LowLevelSend(void* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	if (OnLowLevelSend)
+	{
+		OnLowLevelSend();
+	}
+
+	if (TestSocket && TestRemoteAddr.IsValid())
+	{
+		int32 BytesSent = 0;
+		TestSocket->SendTo((const uint8*)Data, (CountBits + 7) >> 3, BytesSent, *TestRemoteAddr);
+	}
+
+	SentPacketBits.Add(CountBits);
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#if PLATFORM_LINUX
+THIRD_PARTY_INCLUDES_START
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+THIRD_PARTY_INCLUDES_END
+#endif
+
+/**
+ * Sends packets through FlushNet with net.BatchSends on, and checks they reach LowLevelSend in the order they were built: when the
+ * driver flushes, when net.BatchSendsMaxPackets is reached, before an unbatched send, and when a packet is sent while flushing.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNetBatchedSendOrderTest, "Net.BatchedSend Order", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Sends server sized packets over loopback through FlushNet the way a tick of a connection would, with net.BatchSends off and on,
+ * plus raw sendmmsg and UDP segmentation offload where the platform has them to show what a LowLevelSendBatch override could gain.
+ * Reports packets per second and sending thread time per packet.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNetBatchedSendLoopbackBenchmark, "Net.BatchedSend Loopback Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace BatchedSendTest
+{
+	static const int32 NumTicks = 1500;
+	static const int32 PacketsPerTick = 64;
+	static const int32 PacketBytes = 900;
+
+	struct FSendResult
+	{
+		int32 NumSent = 0;
+		double SendSeconds = 0.0;
+	};
+
+	/** A client connection on a driver that doesn't own a socket, so FlushNet sends through the connection's LowLevelSend */
+	struct FScopedTestConnection
+	{
+		FScopedTestConnection()
+		{
+			Driver = NewObject<UDemoNetDriver>(GetTransientPackage());
+			Connection = NewObject<UBatchedSendTestNetConnection>(GetTransientPackage());
+			Connection->InitConnection(Driver, USOCK_Open, FURL(), 1000000);
+			Connection->InitSendBuffer();
+
+			// Servers hold packets back until the client's handshake, clients don't
+			Driver->ServerConnection = Connection;
+		}
+
+		~FScopedTestConnection()
+		{
+			Connection->BatchedSends.Reset();
+			Driver->ServerConnection = nullptr;
+			Connection->MarkPendingKill();
+			Driver->MarkPendingKill();
+		}
+
+		UDemoNetDriver* Driver;
+		UBatchedSendTestNetConnection* Connection;
+	};
+
+	/** Builds one packet with NumBytes of payload and hands it to SendOrQueuePacket */
+	static void SendPacket(UNetConnection* Connection, const TArray<uint8>& Payload, int32 NumBytes)
+	{
+		Connection->WriteBitsToSendBuffer(Payload.GetData(), NumBytes * 8);
+		Connection->FlushNet(true);
+	}
+
+	static bool IsAscending(const TArray<int32>& Values)
+	{
+		for (int32 Index = 1; Index < Values.Num(); ++Index)
+		{
+			if (Values[Index] <= Values[Index - 1])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Empties the receiving socket between ticks so loopback doesn't start dropping, not counted in the send time */
+	static void Drain(FSocket* Receiver, TArray<uint8>& Scratch)
+	{
+		uint32 PendingDataSize = 0;
+		int32 BytesRead = 0;
+		while (Receiver->HasPendingData(PendingDataSize) && Receiver->Recv(Scratch.GetData(), Scratch.Num(), BytesRead))
+		{
+		}
+	}
+
+	/** Sends NumTicks ticks of PacketsPerTick packets through FlushNet, then the driver's flush */
+	static FSendResult SendTicks(UBatchedSendTestNetConnection* Connection, const TArray<uint8>& Payload, FSocket* Receiver, TArray<uint8>& Scratch)
+	{
+		FSendResult Result;
+		Connection->SentPacketBits.Reset();
+
+		for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+		{
+			Result.SendSeconds += AutomationBenchmark::TimeIterations(1, [Connection, &Payload](int32)
+			{
+				for (int32 Index = 0; Index < PacketsPerTick; ++Index)
+				{
+					SendPacket(Connection, Payload, PacketBytes);
+				}
+				Connection->FlushBatchedSends();
+			});
+
+			Drain(Receiver, Scratch);
+		}
+
+		Result.NumSent = Connection->SentPacketBits.Num();
+		return Result;
+	}
+
+	static void ReportResult(FAutomationTestBase& Test, const TCHAR* Name, const FSendResult& Result)
+	{
+		const double PacketsPerSecond = Result.SendSeconds > 0.0 ? double(Result.NumSent) / Result.SendSeconds : 0.0;
+
+		Test.AddInfo(FString::Printf(TEXT("%s: %d packets, %.0f packets/s, %s per packet"), Name, Result.NumSent, PacketsPerSecond, *AutomationBenchmark::FormatMicroseconds(Result.SendSeconds, Result.NumSent)));
+	}
+
+#if PLATFORM_LINUX
+	static int32 OpenNativeSender(const FInternetAddr& ReceiverAddr, sockaddr_in& OutDestination)
+	{
+		FMemory::Memzero(OutDestination);
+		OutDestination.sin_family = AF_INET;
+		OutDestination.sin_port = htons((uint16)ReceiverAddr.GetPort());
+		OutDestination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		return socket(AF_INET, SOCK_DGRAM, 0);
+	}
+#endif
+}
+
+bool FNetBatchedSendOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace BatchedSendTest;
+
+	AutomationBenchmark::FScopedCVarValue BatchSends(TEXT("net.BatchSends"), 1);
+	AutomationBenchmark::FScopedCVarValue BatchSendsMaxPackets(TEXT("net.BatchSendsMaxPackets"), 64);
+	if (!TestNotNull(TEXT("net.BatchSends exists"), BatchSends.CVar) || !TestNotNull(TEXT("net.BatchSendsMaxPackets exists"), BatchSendsMaxPackets.CVar))
+	{
+		return false;
+	}
+
+	FScopedTestConnection TestConnection;
+	UBatchedSendTestNetConnection* Connection = TestConnection.Connection;
+
+	// Payloads grow by more than the packet header can vary, so the packet sizes tell the order they were built in
+	TArray<uint8> Payload;
+	Payload.SetNumZeroed(PacketBytes);
+	const int32 PayloadStep = 32;
+
+	// Queued until the driver flushes, then sent in order
+	for (int32 Index = 1; Index <= 4; ++Index)
+	{
+		SendPacket(Connection, Payload, Index * PayloadStep);
+	}
+	TestEqual(TEXT("Packets wait for the driver's flush"), Connection->SentPacketBits.Num(), 0);
+	TestEqual(TEXT("Every packet is queued"), Connection->BatchedSends.Num(), 4);
+
+	// The connection closes as the first packet of the batch goes out, and sends one last packet
+	bool bSentWhileFlushing = false;
+	Connection->OnLowLevelSend = [Connection, &Payload, &bSentWhileFlushing, PayloadStep]()
+	{
+		if (!bSentWhileFlushing)
+		{
+			bSentWhileFlushing = true;
+			Connection->State = USOCK_Closed;
+			SendPacket(Connection, Payload, 5 * PayloadStep);
+		}
+	};
+	Connection->FlushBatchedSends();
+	Connection->OnLowLevelSend = nullptr;
+	Connection->State = USOCK_Open;
+
+	TestEqual(TEXT("The flush sends the batch and the packet sent while flushing"), Connection->SentPacketBits.Num(), 5);
+	TestTrue(TEXT("The packet sent while flushing goes after the batch"), IsAscending(Connection->SentPacketBits));
+	TestTrue(TEXT("Nothing is left queued after the flush"), Connection->BatchedSends.IsEmpty());
+
+	// Sent early at net.BatchSendsMaxPackets, and whatever is queued goes ahead of an unbatched send
+	Connection->SentPacketBits.Reset();
+	BatchSendsMaxPackets.Set(2);
+	for (int32 Index = 1; Index <= 3; ++Index)
+	{
+		SendPacket(Connection, Payload, Index * PayloadStep);
+	}
+	TestEqual(TEXT("Reaching net.BatchSendsMaxPackets sends the queue"), Connection->SentPacketBits.Num(), 2);
+	TestEqual(TEXT("Packets after the early flush are queued"), Connection->BatchedSends.Num(), 1);
+
+	BatchSends.Set(0);
+	SendPacket(Connection, Payload, 4 * PayloadStep);
+	TestEqual(TEXT("An unbatched send sends the queue first"), Connection->SentPacketBits.Num(), 4);
+	TestTrue(TEXT("Queued packets go ahead of the unbatched send"), IsAscending(Connection->SentPacketBits));
+
+	return true;
+}
+
+bool FNetBatchedSendLoopbackBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace BatchedSendTest;
+
+	AutomationBenchmark::FScopedCVarValue BatchSends(TEXT("net.BatchSends"), 0);
+	AutomationBenchmark::FScopedCVarValue BatchSendsMaxPackets(TEXT("net.BatchSendsMaxPackets"), PacketsPerTick);
+	if (!TestNotNull(TEXT("net.BatchSends exists"), BatchSends.CVar))
+	{
+		return false;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!TestNotNull(TEXT("Socket subsystem exists"), SocketSubsystem))
+	{
+		return false;
+	}
+
+	FSocket* Receiver = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("BatchedSendTest Receiver"), FNetworkProtocolTypes::IPv4);
+	FSocket* Sender = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("BatchedSendTest Sender"), FNetworkProtocolTypes::IPv4);
+	if (!TestNotNull(TEXT("Created receiving socket"), Receiver) || !TestNotNull(TEXT("Created sending socket"), Sender))
+	{
+		SocketSubsystem->DestroySocket(Receiver);
+		SocketSubsystem->DestroySocket(Sender);
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> ReceiverAddr = SocketSubsystem->CreateInternetAddr(FNetworkProtocolTypes::IPv4);
+	ReceiverAddr->SetLoopbackAddress();
+	ReceiverAddr->SetPort(0);
+
+	int32 NewSize = 0;
+	Receiver->SetReceiveBufferSize(4 * 1024 * 1024, NewSize);
+	Receiver->SetNonBlocking(true);
+	if (!TestTrue(TEXT("Bound receiving socket to loopback"), Receiver->Bind(*ReceiverAddr)))
+	{
+		SocketSubsystem->DestroySocket(Receiver);
+		SocketSubsystem->DestroySocket(Sender);
+		return false;
+	}
+	Receiver->GetAddress(*ReceiverAddr);
+
+	TArray<uint8> Packet;
+	Packet.SetNumUninitialized(PacketBytes * PacketsPerTick);
+	for (int32 Index = 0; Index < Packet.Num(); ++Index)
+	{
+		Packet[Index] = (uint8)Index;
+	}
+
+	TArray<uint8> Scratch;
+	Scratch.SetNumUninitialized(65536);
+
+	{
+		FScopedTestConnection TestConnection;
+		UBatchedSendTestNetConnection* Connection = TestConnection.Connection;
+		Connection->TestSocket = Sender;
+		Connection->TestRemoteAddr = ReceiverAddr;
+
+		// One socket call per packet from FlushNet
+		BatchSends.Set(0);
+		const FSendResult PerPacket = SendTicks(Connection, Packet, Receiver, Scratch);
+		ReportResult(*this, TEXT("FlushNet, per packet sends"), PerPacket);
+
+		// Queued by FlushNet and sent by the driver's flush with the default LowLevelSendBatch
+		BatchSends.Set(1);
+		const FSendResult Batched = SendTicks(Connection, Packet, Receiver, Scratch);
+		ReportResult(*this, TEXT("FlushNet, batched with the per packet fallback"), Batched);
+
+		TestEqual(TEXT("Batching sends as many packets"), Batched.NumSent, PerPacket.NumSent);
+		TestTrue(TEXT("Nothing is left queued"), Connection->BatchedSends.IsEmpty());
+	}
+
+#if PLATFORM_LINUX
+	sockaddr_in Destination;
+	const int32 NativeSender = OpenNativeSender(*ReceiverAddr, Destination);
+	if (TestTrue(TEXT("Opened native sending socket"), NativeSender >= 0))
+	{
+		// sendmmsg, one call per tick
+		{
+			mmsghdr Messages[PacketsPerTick];
+			iovec Vectors[PacketsPerTick];
+			FMemory::Memzero(Messages);
+			for (int32 Index = 0; Index < PacketsPerTick; ++Index)
+			{
+				Vectors[Index].iov_base = Packet.GetData() + Index * PacketBytes;
+				Vectors[Index].iov_len = PacketBytes;
+				Messages[Index].msg_hdr.msg_name = &Destination;
+				Messages[Index].msg_hdr.msg_namelen = sizeof(Destination);
+				Messages[Index].msg_hdr.msg_iov = &Vectors[Index];
+				Messages[Index].msg_hdr.msg_iovlen = 1;
+			}
+
+			FSendResult Result;
+			for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+			{
+				Result.SendSeconds += AutomationBenchmark::TimeIterations(1, [&Result, NativeSender, &Messages](int32)
+				{
+					Result.NumSent += FMath::Max(sendmmsg(NativeSender, Messages, PacketsPerTick, 0), 0);
+				});
+
+				Drain(Receiver, Scratch);
+			}
+			ReportResult(*this, TEXT("sendmmsg"), Result);
+		}
+
+#if defined(UDP_SEGMENT)
+		// UDP segmentation offload, one datagram per tick that the kernel splits into PacketBytes sized packets
+		{
+			const int SegmentSize = PacketBytes;
+			if (setsockopt(NativeSender, SOL_UDP, UDP_SEGMENT, &SegmentSize, sizeof(SegmentSize)) == 0)
+			{
+				FSendResult Result;
+				for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+				{
+					Result.SendSeconds += AutomationBenchmark::TimeIterations(1, [&Result, NativeSender, &Packet, &Destination](int32)
+					{
+						const ssize_t BytesSent = sendto(NativeSender, Packet.GetData(), Packet.Num(), 0, (const sockaddr*)&Destination, sizeof(Destination));
+						Result.NumSent += BytesSent > 0 ? int32(BytesSent / PacketBytes) : 0;
+					});
+
+					Drain(Receiver, Scratch);
+				}
+				ReportResult(*this, TEXT("UDP segmentation offload"), Result);
+			}
+			else
+			{
+				AddInfo(TEXT("UDP segmentation offload is not supported by this kernel"));
+			}
+		}
+#endif
+
+		close(NativeSender);
+	}
+#endif
+
+	SocketSubsystem->DestroySocket(Receiver);
+	SocketSubsystem->DestroySocket(Sender);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
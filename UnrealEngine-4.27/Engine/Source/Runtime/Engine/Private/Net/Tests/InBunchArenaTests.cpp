@@ -0,0 +1,211 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#include "Net/DataBunch.h"
+#include "Engine/DemoNetConnection.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Simulates the bunches a connection has to hold on to under packet loss: reliable bunches queued behind a lost
+ * sequence until it is resent, and partial bunches being merged. Runs the same stream with net.PoolInBunches off
+ * and on, checks the queued data survives reuse, and reports heap allocations per simulated second.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInBunchArenaPacketLossBenchmark, "Net.InBunchArena PacketLoss Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace InBunchArenaTest
+{
+	static const int32 FramesPerSecond = 30;
+	static const int32 NumFrames = FramesPerSecond * 60;
+	static const int32 NumChannels = 64;
+	static const int32 BunchesPerFrame = 24;
+	static const int32 ResendDelayFrames = 6;
+	static const int32 NumPartialsPerMessage = 3;
+	static const float PartialMessageChance = 0.04f;
+
+	struct FQueuedBunch
+	{
+		FInBunch* Bunch;
+		int32 NumBytes;
+		uint8 Pattern;
+	};
+
+	struct FSimChannel
+	{
+		TArray<FQueuedBunch> Queued;
+		int32 BlockedUntilFrame = INDEX_NONE;
+	};
+
+	struct FSimResult
+	{
+		FInBunchArena::FStats Stats;
+		int32 NumQueued = 0;
+		int32 NumCorrupt = 0;
+		double Seconds = 0.0;
+	};
+
+	static void MakeSource(TArray<uint8>& Scratch, int32 NumBytes, uint8 Pattern)
+	{
+		Scratch.SetNumUninitialized(NumBytes, false);
+		FMemory::Memset(Scratch.GetData(), Pattern, NumBytes);
+	}
+
+	static bool IsIntact(FInBunch* Bunch, int32 NumBytes, uint8 Pattern)
+	{
+		if (Bunch->GetNumBytes() != NumBytes)
+		{
+			return false;
+		}
+
+		const uint8* Data = Bunch->GetData();
+		for (int32 Index = 0; Index < NumBytes; ++Index)
+		{
+			if (Data[Index] != Pattern)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static void FlushQueued(FInBunchArena& Arena, FSimChannel& Channel, FSimResult& Result)
+	{
+		for (const FQueuedBunch& Queued : Channel.Queued)
+		{
+			Result.NumCorrupt += IsIntact(Queued.Bunch, Queued.NumBytes, Queued.Pattern) ? 0 : 1;
+			Arena.Release(Queued.Bunch);
+		}
+		Channel.Queued.Reset();
+	}
+
+	static FSimResult Simulate(UNetConnection* Connection, float LossRate)
+	{
+		FRandomStream Random(0x1B0C4);
+		FInBunchArena Arena;
+		FSimResult Result;
+
+		TArray<FSimChannel> Channels;
+		Channels.SetNum(NumChannels);
+		for (FSimChannel& Channel : Channels)
+		{
+			Channel.Queued.Reserve(BunchesPerFrame * ResendDelayFrames);
+		}
+
+		TArray<uint8> Scratch;
+		Scratch.Reserve(4096);
+
+		Result.Seconds = AutomationBenchmark::TimeIterations(NumFrames, [&](const int32 Frame)
+		{
+			for (FSimChannel& Channel : Channels)
+			{
+				if (Channel.BlockedUntilFrame != INDEX_NONE && Channel.BlockedUntilFrame <= Frame)
+				{
+					// The lost bunch was resent, everything queued behind it is dispatched
+					FlushQueued(Arena, Channel, Result);
+					Channel.BlockedUntilFrame = INDEX_NONE;
+				}
+			}
+
+			for (int32 BunchIndex = 0; BunchIndex < BunchesPerFrame; ++BunchIndex)
+			{
+				FSimChannel& Channel = Channels[Random.RandHelper(NumChannels)];
+				const uint8 Pattern = (uint8)Random.RandHelper(256);
+
+				if (Random.FRand() < PartialMessageChance)
+				{
+					// A large update split over a few partial bunches, merged into a bunch started without a buffer
+					MakeSource(Scratch, Random.RandRange(900, 1200), Pattern);
+					FInBunch Initial(Connection, Scratch.GetData(), Scratch.Num() * 8);
+					FInBunch* Partial = Arena.Acquire(Initial, false);
+
+					int32 NumPartialBytes = 0;
+					for (int32 PartIndex = 0; PartIndex < NumPartialsPerMessage; ++PartIndex)
+					{
+						const int64 PreviousCapacity = Partial->GetBufferCapacity();
+						Partial->AppendDataFromChecked(Scratch.GetData(), Scratch.Num() * 8);
+						Arena.NoteBufferGrowth(*Partial, PreviousCapacity);
+						NumPartialBytes += Scratch.Num();
+					}
+
+					Result.NumCorrupt += IsIntact(Partial, NumPartialBytes, Pattern) ? 0 : 1;
+					Arena.Release(Partial);
+					continue;
+				}
+
+				MakeSource(Scratch, Random.RandRange(16, 600), Pattern);
+				FInBunch Bunch(Connection, Scratch.GetData(), Scratch.Num() * 8);
+
+				if (Channel.BlockedUntilFrame != INDEX_NONE)
+				{
+					Channel.Queued.Add({ Arena.Acquire(Bunch, true), Scratch.Num(), Pattern });
+					++Result.NumQueued;
+				}
+				else if (Random.FRand() < LossRate)
+				{
+					Channel.BlockedUntilFrame = Frame + ResendDelayFrames;
+				}
+			}
+		});
+
+		for (FSimChannel& Channel : Channels)
+		{
+			FlushQueued(Arena, Channel, Result);
+		}
+		Result.Stats = Arena.GetStats();
+
+		return Result;
+	}
+
+	static double AllocationsPerSecond(const FSimResult& Result)
+	{
+		const double SimulatedSeconds = double(NumFrames) / double(FramesPerSecond);
+		return double(Result.Stats.NumBunchAllocations + Result.Stats.NumBufferAllocations) / SimulatedSeconds;
+	}
+}
+
+bool FInBunchArenaPacketLossBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace InBunchArenaTest;
+
+	IConsoleVariable* PoolInBunchesCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.PoolInBunches"));
+	if (!TestNotNull(TEXT("net.PoolInBunches exists"), PoolInBunchesCVar))
+	{
+		return false;
+	}
+	const int32 OldPoolInBunches = PoolInBunchesCVar->GetInt();
+
+	UDemoNetConnection* Connection = NewObject<UDemoNetConnection>(GetTransientPackage());
+
+	const float LossRates[] = { 0.01f, 0.05f, 0.2f };
+	for (const float LossRate : LossRates)
+	{
+		PoolInBunchesCVar->Set(0, ECVF_SetByCode);
+		const FSimResult Unpooled = Simulate(Connection, LossRate);
+		PoolInBunchesCVar->Set(1, ECVF_SetByCode);
+		const FSimResult Pooled = Simulate(Connection, LossRate);
+
+		const int32 LossPercent = FMath::RoundToInt(LossRate * 100.0f);
+		TestEqual(FString::Printf(TEXT("%d%% loss: both runs queue the same bunches"), LossPercent), Pooled.NumQueued, Unpooled.NumQueued);
+		TestEqual(FString::Printf(TEXT("%d%% loss: unpooled bunches are intact"), LossPercent), Unpooled.NumCorrupt, 0);
+		TestEqual(FString::Printf(TEXT("%d%% loss: reused bunches are intact"), LossPercent), Pooled.NumCorrupt, 0);
+		TestTrue(FString::Printf(TEXT("%d%% loss: pooling does not allocate more than the heap path"), LossPercent), AllocationsPerSecond(Pooled) <= AllocationsPerSecond(Unpooled));
+
+		AddInfo(FString::Printf(TEXT("%d%% loss, %d queued bunches: unpooled %.1f allocs/s (%s), pooled %.1f allocs/s (%s, %llu bunch and %llu buffer allocations for %llu acquires)"),
+			LossPercent, Pooled.NumQueued,
+			AllocationsPerSecond(Unpooled), *AutomationBenchmark::FormatMilliseconds(Unpooled.Seconds),
+			AllocationsPerSecond(Pooled), *AutomationBenchmark::FormatMilliseconds(Pooled.Seconds),
+			Pooled.Stats.NumBunchAllocations, Pooled.Stats.NumBufferAllocations, Pooled.Stats.NumAcquired));
+	}
+
+	PoolInBunchesCVar->Set(OldPoolInBunches, ECVF_SetByCode);
+	Connection->MarkPendingKill();
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
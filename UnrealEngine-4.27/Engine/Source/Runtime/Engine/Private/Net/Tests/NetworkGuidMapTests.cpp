@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Net/NetworkGuidMap.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Runs the same mix of adds, removes, iterator removes and lookups on TNetworkGUIDMap and TMap and checks they agree. Also checks the
+ * table keeps every guid through growth, that removing entries leaves the others where they are, and that Reset leaves it usable.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNetworkGUIDMapTest, "Net.NetworkGUIDMap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace NetworkGUIDMapTest
+{
+	static const int32 NumOperations = 200000;
+	static const int32 NumGrowthGuids = 20000;
+
+	// Static guids are odd and dynamic guids are even, both handed out sequentially
+	static FNetworkGUID MakeGuid(FRandomStream& Random, int32 MaxIndex)
+	{
+		const uint32 Index = (uint32)Random.RandHelper(MaxIndex);
+		return FNetworkGUID((Index << 1) | (Random.RandHelper(2) ? 1u : 0u));
+	}
+}
+
+bool FNetworkGUIDMapTest::RunTest(const FString& Parameters)
+{
+	using namespace NetworkGUIDMapTest;
+
+	// Random operations, both maps have to hold the same pairs afterwards
+	{
+		FRandomStream Random(0x6A1D);
+		TNetworkGUIDMap<int32> FlatMap;
+		TMap<FNetworkGUID, int32> ReferenceMap;
+
+		int32 NumMismatches = 0;
+		for (int32 Index = 0; Index < NumOperations; ++Index)
+		{
+			const FNetworkGUID Guid = MakeGuid(Random, 4096);
+			const int32 Operation = Random.RandHelper(10);
+			if (Operation < 5)
+			{
+				FlatMap.Add(Guid, Index);
+				ReferenceMap.Add(Guid, Index);
+			}
+			else if (Operation < 8)
+			{
+				NumMismatches += (FlatMap.Remove(Guid) != ReferenceMap.Remove(Guid)) ? 1 : 0;
+			}
+			else
+			{
+				const int32* FlatValue = FlatMap.Find(Guid);
+				const int32* ReferenceValue = ReferenceMap.Find(Guid);
+				NumMismatches += ((FlatValue == nullptr) != (ReferenceValue == nullptr) || (FlatValue && *FlatValue != *ReferenceValue)) ? 1 : 0;
+			}
+
+			// Time out a slice of the table through the iterator, like FNetGUIDCache::CleanReferences
+			if (Index % 20000 == 0)
+			{
+				for (auto It = FlatMap.CreateIterator(); It; ++It)
+				{
+					if (It.Value() % 7 == 0)
+					{
+						ReferenceMap.Remove(It.Key());
+						It.RemoveCurrent();
+					}
+				}
+			}
+		}
+
+		TestEqual(TEXT("Operations agree with TMap"), NumMismatches, 0);
+		TestEqual(TEXT("Same number of elements as TMap"), FlatMap.Num(), ReferenceMap.Num());
+
+		int32 NumMissing = 0;
+		for (const TPair<FNetworkGUID, int32>& Pair : ReferenceMap)
+		{
+			const int32* FlatValue = FlatMap.Find(Pair.Key);
+			NumMissing += (FlatValue == nullptr || *FlatValue != Pair.Value) ? 1 : 0;
+		}
+		TestEqual(TEXT("Every TMap pair is found"), NumMissing, 0);
+	}
+
+	// The slot table is rebuilt as it grows, a late joining client is sent thousands of guids in a row
+	{
+		TNetworkGUIDMap<int32> FlatMap;
+		for (int32 Index = 0; Index < NumGrowthGuids; ++Index)
+		{
+			FlatMap.Add(FNetworkGUID((uint32)Index * 2 + (Index & 1)), Index);
+		}
+
+		int32 NumMissing = 0;
+		for (int32 Index = 0; Index < NumGrowthGuids; ++Index)
+		{
+			const int32* Value = FlatMap.Find(FNetworkGUID((uint32)Index * 2 + (Index & 1)));
+			NumMissing += (Value == nullptr || *Value != Index) ? 1 : 0;
+		}
+		TestEqual(TEXT("Every guid is found after growing"), NumMissing, 0);
+		TestFalse(TEXT("Guids that were never added are not found"), FlatMap.Contains(FNetworkGUID((uint32)NumGrowthGuids * 2 + 1)));
+	}
+
+	// Entries stay where they are when others are removed, the guid cache holds on to them while it cleans up
+	{
+		TNetworkGUIDMap<int32> FlatMap;
+		for (int32 Index = 0; Index < 1000; ++Index)
+		{
+			FlatMap.Add(FNetworkGUID((uint32)Index * 2), Index);
+		}
+
+		const int32* KeptValue = FlatMap.Find(FNetworkGUID(500 * 2));
+		for (int32 Index = 0; Index < 1000; ++Index)
+		{
+			if (Index != 500)
+			{
+				FlatMap.Remove(FNetworkGUID((uint32)Index * 2));
+			}
+		}
+
+		TestEqual(TEXT("Only the kept entry is left"), FlatMap.Num(), 1);
+		TestTrue(TEXT("The kept entry did not move"), FlatMap.Find(FNetworkGUID(500 * 2)) == KeptValue);
+		TestEqual(TEXT("The kept entry keeps its value"), KeptValue ? *KeptValue : INDEX_NONE, 500);
+		TestEqual(TEXT("Removing a removed guid removes nothing"), FlatMap.Remove(FNetworkGUID(2)), 0);
+	}
+
+	// Reset keeps the allocations, the table has to behave like a new one afterwards
+	{
+		TNetworkGUIDMap<int32> FlatMap;
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			FlatMap.Add(FNetworkGUID((uint32)Index * 2 + 1), Index);
+		}
+
+		FlatMap.Reset();
+		TestEqual(TEXT("Reset removes every entry"), FlatMap.Num(), 0);
+		TestFalse(TEXT("Reset guids are not found"), FlatMap.Contains(FNetworkGUID(3)));
+
+		FlatMap.FindOrAdd(FNetworkGUID(3)) = 7;
+		TestEqual(TEXT("Guids can be added after a reset"), FlatMap.FindRef(FNetworkGUID(3)), 7);
+		TestEqual(TEXT("Adding after a reset adds one entry"), FlatMap.Num(), 1);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
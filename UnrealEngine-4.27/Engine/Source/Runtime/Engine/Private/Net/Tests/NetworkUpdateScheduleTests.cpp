@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Engine/NetworkObjectList.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Schedules objects with the update intervals of a busy server, some of them moving between buckets and being removed
+ * as they go, and checks every object is gathered exactly once per interval. Also checks intervals are clamped, and that
+ * objects already gathered on a frame, like the actors FNetReplicationPolicy::RequestUpdate adds first, aren't added again.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNetworkUpdateScheduleTest, "Net.NetworkUpdateSchedule", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace NetworkUpdateScheduleTest
+{
+	static const int32 NumObjects = 2000;
+	static const int32 NumFrames = 600;
+	static const int32 Intervals[] = { 1, 3, 6, 15, 30, 60 };
+
+	struct FSimObject
+	{
+		FNetworkObjectInfo Info;
+		int32 IntervalFrames = 1;
+		int32 NumGathered = 0;
+		int32 LastGatheredFrame = INDEX_NONE;
+		bool bRemoved = false;
+	};
+}
+
+bool FNetworkUpdateScheduleTest::RunTest(const FString& Parameters)
+{
+	using namespace NetworkUpdateScheduleTest;
+
+	FRandomStream RandomStream(0x5CED);
+
+	TArray<FSimObject> Objects;
+	Objects.SetNum(NumObjects);
+
+	FNetworkUpdateSchedule Schedule;
+	for (FSimObject& Object : Objects)
+	{
+		Object.IntervalFrames = Intervals[RandomStream.RandHelper(UE_ARRAY_COUNT(Intervals))];
+		Schedule.Update(Object.Info, Object.IntervalFrames);
+	}
+
+	TestEqual(TEXT("Every object is scheduled"), Schedule.GetNumObjects(), NumObjects);
+	TestEqual(TEXT("One bucket per interval"), Schedule.GetNumBuckets(), (int32)UE_ARRAY_COUNT(Intervals));
+
+	int32 NumEarly = 0;
+	int32 NumLate = 0;
+	int32 NumGatheredRemoved = 0;
+
+	TArray<FNetworkObjectInfo*> DueObjects;
+	for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+	{
+		DueObjects.Reset();
+
+		Schedule.GatherDueObjects(Frame, DueObjects);
+
+		for (FNetworkObjectInfo* Info : DueObjects)
+		{
+			FSimObject& Object = *(FSimObject*)((uint8*)Info - STRUCT_OFFSET(FSimObject, Info));
+			if (Object.bRemoved)
+			{
+				NumGatheredRemoved++;
+				continue;
+			}
+
+			if (Object.LastGatheredFrame != INDEX_NONE)
+			{
+				const int32 Gap = Frame - Object.LastGatheredFrame;
+				NumEarly += Gap < Object.IntervalFrames ? 1 : 0;
+				NumLate += Gap > Object.IntervalFrames ? 1 : 0;
+			}
+
+			Object.LastGatheredFrame = Frame;
+			Object.NumGathered++;
+		}
+
+		// A few objects change rate or go away every frame
+		for (int32 Index = 0; Index < 20; ++Index)
+		{
+			FSimObject& Object = Objects[RandomStream.RandHelper(NumObjects)];
+			if (Object.bRemoved)
+			{
+				continue;
+			}
+
+			if (Index == 0)
+			{
+				Schedule.Remove(Object.Info);
+				Object.bRemoved = true;
+			}
+			else
+			{
+				Object.IntervalFrames = Intervals[RandomStream.RandHelper(UE_ARRAY_COUNT(Intervals))];
+				Object.LastGatheredFrame = INDEX_NONE;
+				Schedule.Update(Object.Info, Object.IntervalFrames);
+			}
+		}
+	}
+
+	int32 NumRemoved = 0;
+	for (const FSimObject& Object : Objects)
+	{
+		NumRemoved += Object.bRemoved ? 1 : 0;
+	}
+
+	TestEqual(TEXT("Removed objects are not gathered"), NumGatheredRemoved, 0);
+	TestEqual(TEXT("No object is gathered before its interval"), NumEarly, 0);
+	TestEqual(TEXT("No object is gathered after its interval"), NumLate, 0);
+	TestEqual(TEXT("Removed objects leave the schedule"), Schedule.GetNumObjects(), NumObjects - NumRemoved);
+
+	// Intervals past the longest one are clamped to it
+	{
+		FNetworkUpdateSchedule ClampedSchedule;
+		FNetworkObjectInfo LongInterval;
+		FNetworkObjectInfo ZeroInterval;
+		ClampedSchedule.Update(LongInterval, FNetworkUpdateSchedule::MaxIntervalFrames * 4);
+		ClampedSchedule.Update(ZeroInterval, 0);
+
+		TestEqual(TEXT("Long intervals are clamped"), LongInterval.UpdateScheduleInterval, FNetworkUpdateSchedule::MaxIntervalFrames);
+		TestEqual(TEXT("Intervals below one frame are clamped"), ZeroInterval.UpdateScheduleInterval, 1);
+		ClampedSchedule.Reset();
+	}
+
+	// An object gathered on a frame already, requested by the replication policy for instance, is only added once
+	{
+		FNetworkUpdateSchedule RequestSchedule;
+		FNetworkObjectInfo Requested;
+		RequestSchedule.Update(Requested, 1);
+
+		const uint32 Frame = 7;
+		Requested.UpdateScheduleGatherFrame = Frame;
+
+		TArray<FNetworkObjectInfo*> RequestedObjects;
+		RequestedObjects.Add(&Requested);
+		RequestSchedule.GatherDueObjects(Frame, RequestedObjects);
+		TestEqual(TEXT("Objects gathered earlier on the frame are not added again"), RequestedObjects.Num(), 1);
+
+		RequestSchedule.GatherDueObjects(Frame + 1, RequestedObjects);
+		TestEqual(TEXT("They are gathered again on the next frame"), RequestedObjects.Num(), 2);
+		RequestSchedule.Reset();
+	}
+
+	Schedule.Reset();
+	TestEqual(TEXT("Reset empties the schedule"), Schedule.GetNumObjects(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,199 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Net/RepLayout.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/GameStateBase.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Times FRepLayout::CompareProperties on a few common actor classes with net.ComparePodSpans off and on,
+ * and checks both produce the same changelists while replicated numeric properties are changing.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRepLayoutComparePodSpansBenchmark, "Net.RepLayout.ComparePodSpans Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace RepLayoutCompareTest
+{
+	static const int32 NumTimedCompares = 20000;
+	static const int32 NumChangingCompares = 200;
+
+	struct FCompareState
+	{
+		TSharedPtr<FReplicationChangelistMgr> ChangelistMgr;
+		TSharedPtr<FRepChangedPropertyTracker> PropertyTracker;
+		TUniquePtr<FRepState> RepState;
+	};
+}
+
+struct FRepLayoutTestUtil
+{
+	static void InitCompareState(const FRepLayout& RepLayout, const UObject* Object, RepLayoutCompareTest::FCompareState& OutState)
+	{
+		OutState.ChangelistMgr = RepLayout.CreateReplicationChangelistMgr(Object, ECreateReplicationChangelistMgrFlags::SkipDeltaCustomState);
+		OutState.PropertyTracker = MakeShared<FRepChangedPropertyTracker>(/*bIsReplay=*/false, /*bIsClientReplayRecording=*/false);
+		RepLayout.InitChangedTracker(OutState.PropertyTracker.Get());
+		OutState.RepState = RepLayout.CreateRepState(Object, OutState.PropertyTracker, ECreateRepStateFlags::SkipCreateReceivingState);
+	}
+
+	static ERepLayoutResult CompareProperties(const FRepLayout& RepLayout, RepLayoutCompareTest::FCompareState& State, const UObject* Object, const FReplicationFlags& RepFlags)
+	{
+		return RepLayout.CompareProperties(State.RepState->GetSendingRepState(), State.ChangelistMgr->GetRepChangelistState(), Object, RepFlags);
+	}
+
+	static const TArray<uint16>& GetLatestChangelist(const RepLayoutCompareTest::FCompareState& State)
+	{
+		const FRepChangelistState* ChangelistState = State.ChangelistMgr->GetRepChangelistState();
+		const int32 HistoryIndex = (ChangelistState->HistoryEnd - 1 + FRepChangelistState::MAX_CHANGE_HISTORY) % FRepChangelistState::MAX_CHANGE_HISTORY;
+		return ChangelistState->ChangeHistory[HistoryIndex].Changed;
+	}
+
+	static int32 GetNumPodParents(const FRepLayout& RepLayout)
+	{
+		int32 NumPodParents = 0;
+		for (const FRepLayoutPodSpanRange& Range : RepLayout.ParentPodSpans)
+		{
+			NumPodParents += (Range.Num > 0) ? 1 : 0;
+		}
+		return NumPodParents;
+	}
+};
+
+namespace RepLayoutCompareTest
+{
+	// Replicated ints and floats we can change without upsetting the actor, Role and RemoteRole are handled separately by CompareProperties
+	static void GatherNumericProperties(UClass* Class, TArray<FNumericProperty*>& OutProperties)
+	{
+		static const FName RoleName(TEXT("Role"));
+		static const FName RemoteRoleName(TEXT("RemoteRole"));
+
+		for (const FRepRecord& RepRecord : Class->ClassReps)
+		{
+			FNumericProperty* NumericProperty = CastField<FNumericProperty>(RepRecord.Property);
+			if (NumericProperty && RepRecord.Index == 0 && NumericProperty->GetFName() != RoleName && NumericProperty->GetFName() != RemoteRoleName)
+			{
+				OutProperties.Add(NumericProperty);
+			}
+		}
+	}
+
+	static void ChangeNumericProperty(FNumericProperty* Property, UObject* Object)
+	{
+		void* Value = Property->ContainerPtrToValuePtr<void>(Object);
+		if (Property->IsFloatingPoint())
+		{
+			Property->SetFloatingPointPropertyValue(Value, Property->GetFloatingPointPropertyValue(Value) + 1.0);
+		}
+		else
+		{
+			Property->SetIntPropertyValue(Value, Property->GetSignedIntPropertyValue(Value) + 1);
+		}
+	}
+
+	static double TimeUnchangedCompares(const FRepLayout& RepLayout, FCompareState& State, const UObject* Object)
+	{
+		FReplicationFlags RepFlags;
+
+		return AutomationBenchmark::TimeIterations(NumTimedCompares, [&RepLayout, &State, Object, &RepFlags](int32)
+		{
+			FRepLayoutTestUtil::CompareProperties(RepLayout, State, Object, RepFlags);
+		});
+	}
+}
+
+bool FRepLayoutComparePodSpansBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RepLayoutCompareTest;
+
+	IConsoleVariable* ComparePodSpansCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.ComparePodSpans"));
+	if (!TestNotNull(TEXT("net.ComparePodSpans exists"), ComparePodSpansCVar))
+	{
+		return false;
+	}
+	const int32 OldComparePodSpans = ComparePodSpansCVar->GetInt();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	UClass* const ActorClasses[] = { AActor::StaticClass(), APawn::StaticClass(), ACharacter::StaticClass(), APlayerState::StaticClass(), AGameStateBase::StaticClass() };
+
+	for (UClass* ActorClass : ActorClasses)
+	{
+		AActor* Actor = World->SpawnActor(ActorClass);
+		if (!TestNotNull(FString::Printf(TEXT("Spawned %s"), *ActorClass->GetName()), Actor))
+		{
+			continue;
+		}
+
+		TSharedPtr<FRepLayout> RepLayout = FRepLayout::CreateFromClass(ActorClass);
+
+		FCompareState PerCommandState;
+		FCompareState PodSpanState;
+		FRepLayoutTestUtil::InitCompareState(*RepLayout, Actor, PerCommandState);
+		FRepLayoutTestUtil::InitCompareState(*RepLayout, Actor, PodSpanState);
+
+		FReplicationFlags InitialRepFlags;
+		InitialRepFlags.bNetInitial = true;
+		ComparePodSpansCVar->Set(0, ECVF_SetByCode);
+		FRepLayoutTestUtil::CompareProperties(*RepLayout, PerCommandState, Actor, InitialRepFlags);
+		ComparePodSpansCVar->Set(1, ECVF_SetByCode);
+		FRepLayoutTestUtil::CompareProperties(*RepLayout, PodSpanState, Actor, InitialRepFlags);
+
+		// Both paths have to find the same changes
+		TArray<FNumericProperty*> NumericProperties;
+		GatherNumericProperties(ActorClass, NumericProperties);
+
+		int32 NumMismatches = 0;
+		FReplicationFlags RepFlags;
+		for (int32 Index = 0; Index < NumChangingCompares; ++Index)
+		{
+			if (NumericProperties.Num() > 0 && (Index % 2) == 0)
+			{
+				ChangeNumericProperty(NumericProperties[(Index / 2) % NumericProperties.Num()], Actor);
+			}
+
+			ComparePodSpansCVar->Set(0, ECVF_SetByCode);
+			const ERepLayoutResult PerCommandResult = FRepLayoutTestUtil::CompareProperties(*RepLayout, PerCommandState, Actor, RepFlags);
+			ComparePodSpansCVar->Set(1, ECVF_SetByCode);
+			const ERepLayoutResult PodSpanResult = FRepLayoutTestUtil::CompareProperties(*RepLayout, PodSpanState, Actor, RepFlags);
+
+			if (PerCommandResult != PodSpanResult ||
+				(PerCommandResult == ERepLayoutResult::Success && FRepLayoutTestUtil::GetLatestChangelist(PerCommandState) != FRepLayoutTestUtil::GetLatestChangelist(PodSpanState)))
+			{
+				++NumMismatches;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("%s: changelists match with and without POD spans"), *ActorClass->GetName()), NumMismatches, 0);
+
+		ComparePodSpansCVar->Set(0, ECVF_SetByCode);
+		const double PerCommandSeconds = TimeUnchangedCompares(*RepLayout, PerCommandState, Actor);
+		ComparePodSpansCVar->Set(1, ECVF_SetByCode);
+		const double PodSpanSeconds = TimeUnchangedCompares(*RepLayout, PodSpanState, Actor);
+
+		AddInfo(FString::Printf(TEXT("%s: %d parents (%d POD), %d unchanged compares: per command %s, POD spans %s"),
+			*ActorClass->GetName(), RepLayout->GetNumParents(), FRepLayoutTestUtil::GetNumPodParents(*RepLayout), NumTimedCompares,
+			*AutomationBenchmark::FormatMilliseconds(PerCommandSeconds), *AutomationBenchmark::FormatMilliseconds(PodSpanSeconds)));
+	}
+
+	ComparePodSpansCVar->Set(OldComparePodSpans, ECVF_SetByCode);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,355 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Misc/NetworkVersion.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/CoreNet.h"
+#include "ReplayTypes.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Builds a synthetic replay stream with long lived, short lived, dormant and temporary actor channels, then seeks
+ * through it from the previous checkpoint. Each seek indexes its fast forward packets serially and in parallel,
+ * checks the destroyed actors against the ones the stream was generated with, and reports latency percentiles.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplayChannelLifetimeIndexBenchmark, "Net.Replay.ChannelLifetimeIndex Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+/**
+ * An actor that already exists when the fast forward starts, a dormant one waking up, reopens its channel and is destroyed within the
+ * indexed packets. Checks it is only reported as destroyed when the caller doesn't know about it, so existing actors see their close.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplayChannelLifetimeIndexKnownActorsTest, "Net.Replay.ChannelLifetimeIndex KnownActors", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace ReplayChannelIndexTest
+{
+	static const int32 NumFrames = 3000;
+	static const float FrameSeconds = 1.0f / 30.0f;
+	static const int32 CheckpointIntervalFrames = 900;
+	static const int32 NumLongLivedActors = 200;
+	static const int32 NumSeeks = 200;
+	static const int32 MaxPacketSize = 1024;
+
+	struct FSyntheticActor
+	{
+		FNetworkGUID ActorGUID;
+		int32 OpenFrame = 0;
+		int32 CloseFrame = MAX_int32;
+		EChannelCloseReason CloseReason = EChannelCloseReason::Destroyed;
+		bool bTemporary = false;
+	};
+
+	struct FSyntheticReplay
+	{
+		TArray<FPlaybackPacket> Packets;
+		TArray<FSyntheticActor> Actors;
+	};
+
+	// Same header layout UNetConnection::SendRawBunch writes for an InternalAck connection
+	static void WriteBunch(FBitWriter& Packet, bool bOpen, bool bClose, EChannelCloseReason CloseReason, bool bReliable, uint32 ChIndex, FBitWriter& Payload)
+	{
+		const bool bIsOpenOrClose = bOpen || bClose;
+
+		Packet.WriteBit(bIsOpenOrClose);
+		if (bIsOpenOrClose)
+		{
+			Packet.WriteBit(bOpen);
+			Packet.WriteBit(bClose);
+			if (bClose)
+			{
+				uint32 Value = (uint32)CloseReason;
+				Packet.SerializeInt(Value, (uint32)EChannelCloseReason::MAX);
+			}
+		}
+
+		Packet.WriteBit(0); // bIsReplicationPaused
+		Packet.WriteBit(bReliable);
+		Packet.SerializeIntPacked(ChIndex);
+		Packet.WriteBit(0); // bHasPackageMapExports
+		Packet.WriteBit(0); // bHasMustBeMappedGUIDs
+		Packet.WriteBit(0); // bPartial
+
+		if (bOpen || bReliable)
+		{
+			FName ChName = NAME_Actor;
+			UPackageMap::StaticSerializeName(Packet, ChName);
+		}
+
+		Packet.WriteIntWrapped((uint32)Payload.GetNumBits(), MaxPacketSize * 8);
+		Packet.SerializeBits(Payload.GetData(), Payload.GetNumBits());
+	}
+
+	static void WriteOpenBunch(FBitWriter& Packet, const FSyntheticActor& Actor, uint32 ChIndex, FRandomStream& Random)
+	{
+		FBitWriter Payload(MaxPacketSize * 8, true);
+		FNetworkGUID ActorGUID = Actor.ActorGUID;
+		NET_CHECKSUM(Payload);
+		Payload << ActorGUID;
+
+		// Stand in for the spawn info and initial properties
+		for (int32 Index = Random.RandRange(8, 32); Index > 0; --Index)
+		{
+			uint8 Byte = (uint8)Random.RandHelper(256);
+			Payload << Byte;
+		}
+
+		const bool bCloseNow = Actor.bTemporary;
+		WriteBunch(Packet, true, bCloseNow, Actor.CloseReason, !Actor.bTemporary, ChIndex, Payload);
+	}
+
+	static void WriteUpdateBunch(FBitWriter& Packet, uint32 ChIndex, FRandomStream& Random)
+	{
+		FBitWriter Payload(MaxPacketSize * 8, true);
+		for (int32 Index = Random.RandRange(4, 24); Index > 0; --Index)
+		{
+			uint8 Byte = (uint8)Random.RandHelper(256);
+			Payload << Byte;
+		}
+
+		WriteBunch(Packet, false, false, EChannelCloseReason::Destroyed, false, ChIndex, Payload);
+	}
+
+	static void WriteCloseBunch(FBitWriter& Packet, const FSyntheticActor& Actor, uint32 ChIndex)
+	{
+		FBitWriter Payload(0, true);
+		WriteBunch(Packet, false, true, Actor.CloseReason, true, ChIndex, Payload);
+	}
+
+	static FPlaybackPacket FinishPacket(FBitWriter& Packet, int32 Frame)
+	{
+		// Termination bit, ReceivedRawPacket trims everything after it
+		Packet.WriteBit(1);
+
+		FPlaybackPacket PlaybackPacket;
+		PlaybackPacket.Data.Append(Packet.GetData(), Packet.GetNumBytes());
+		PlaybackPacket.TimeSeconds = Frame * FrameSeconds;
+		PlaybackPacket.LevelIndex = 0;
+		PlaybackPacket.SeenLevelIndex = 0;
+		return PlaybackPacket;
+	}
+
+	static FSyntheticReplay MakeReplay()
+	{
+		FRandomStream Random(0x5C2B);
+		FSyntheticReplay Replay;
+
+		uint32 NextGUID = 2;
+		TArray<uint32> FreeChannels;
+		uint32 NextChannel = 1;
+
+		auto AllocChannel = [&FreeChannels, &NextChannel]()
+		{
+			return FreeChannels.Num() > 0 ? FreeChannels.Pop() : NextChannel++;
+		};
+
+		// Actor index -> channel, for the actors that are currently open
+		TMap<int32, uint32> OpenChannels;
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FBitWriter Packet(0, true);
+
+			auto OpenActor = [&](FSyntheticActor&& Actor)
+			{
+				Actor.ActorGUID = FNetworkGUID(NextGUID);
+				NextGUID += 2;
+
+				const int32 ActorIndex = Replay.Actors.Add(MoveTemp(Actor));
+				const uint32 ChIndex = AllocChannel();
+				WriteOpenBunch(Packet, Replay.Actors[ActorIndex], ChIndex, Random);
+
+				if (Replay.Actors[ActorIndex].bTemporary)
+				{
+					FreeChannels.Push(ChIndex);
+				}
+				else
+				{
+					OpenChannels.Add(ActorIndex, ChIndex);
+				}
+			};
+
+			if (Frame == 0)
+			{
+				for (int32 Index = 0; Index < NumLongLivedActors; ++Index)
+				{
+					OpenActor(FSyntheticActor());
+				}
+			}
+
+			// Projectiles, pickups and the like
+			for (int32 Index = Random.RandRange(1, 4); Index > 0; --Index)
+			{
+				FSyntheticActor Actor;
+				Actor.OpenFrame = Frame;
+
+				const int32 Kind = Random.RandHelper(10);
+				if (Kind == 0)
+				{
+					Actor.bTemporary = true;
+					Actor.CloseFrame = Frame;
+				}
+				else
+				{
+					Actor.CloseFrame = Frame + Random.RandRange(5, 400);
+					Actor.CloseReason = (Kind == 1) ? EChannelCloseReason::Dormancy : (Kind == 2) ? EChannelCloseReason::TearOff : EChannelCloseReason::Destroyed;
+				}
+
+				OpenActor(MoveTemp(Actor));
+			}
+
+			for (auto It = OpenChannels.CreateIterator(); It; ++It)
+			{
+				const FSyntheticActor& Actor = Replay.Actors[It.Key()];
+				if (Actor.CloseFrame == Frame)
+				{
+					WriteCloseBunch(Packet, Actor, It.Value());
+					FreeChannels.Push(It.Value());
+					It.RemoveCurrent();
+				}
+				else if (Actor.OpenFrame != Frame && Random.FRand() < 0.25f)
+				{
+					WriteUpdateBunch(Packet, It.Value(), Random);
+				}
+			}
+
+			Replay.Packets.Add(FinishPacket(Packet, Frame));
+		}
+
+		return Replay;
+	}
+
+	static TSet<FNetworkGUID> GetExpectedDestroyedActors(const FSyntheticReplay& Replay, int32 StartFrame, int32 EndFrame)
+	{
+		TSet<FNetworkGUID> Expected;
+		for (const FSyntheticActor& Actor : Replay.Actors)
+		{
+			if (!Actor.bTemporary && Actor.CloseReason == EChannelCloseReason::Destroyed && Actor.OpenFrame >= StartFrame && Actor.CloseFrame <= EndFrame)
+			{
+				Expected.Add(Actor.ActorGUID);
+			}
+		}
+		return Expected;
+	}
+
+	static double GetPercentile(TArray<double>& Values, float Percentile)
+	{
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::FloorToInt(Values.Num() * Percentile), 0, Values.Num() - 1)];
+	}
+}
+
+bool FReplayChannelLifetimeIndexBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ReplayChannelIndexTest;
+
+	const uint32 EngineNetVer = FNetworkVersion::GetEngineNetworkProtocolVersion();
+	const uint32 GameNetVer = FNetworkVersion::GetGameNetworkProtocolVersion();
+
+	if (!TestTrue(TEXT("Current engine network version can be indexed"), FReplayChannelLifetimeIndex::SupportsEngineNetVersion(EngineNetVer)))
+	{
+		return false;
+	}
+
+	const FSyntheticReplay Replay = MakeReplay();
+
+	FRandomStream Random(0x5C2C);
+
+	TArray<double> SerialMilliseconds;
+	TArray<double> ParallelMilliseconds;
+	int32 NumMismatches = 0;
+	int64 TotalBunches = 0;
+	int64 TotalSkippedActors = 0;
+
+	for (int32 Seek = 0; Seek < NumSeeks; ++Seek)
+	{
+		// Seeks load the previous checkpoint and fast forward to the target
+		const int32 TargetFrame = Random.RandRange(1, NumFrames - 1);
+		const int32 CheckpointFrame = (TargetFrame / CheckpointIntervalFrames) * CheckpointIntervalFrames;
+		const TArrayView<const FPlaybackPacket> Packets = MakeArrayView(Replay.Packets.GetData() + CheckpointFrame, TargetFrame - CheckpointFrame + 1);
+
+		FReplayChannelLifetimeIndex SerialIndex;
+		bool bSerialBuilt = false;
+		SerialMilliseconds.Add(AutomationBenchmark::TimeIterations(1, [&](int32)
+		{
+			bSerialBuilt = SerialIndex.Build(Packets, EngineNetVer, GameNetVer, MaxPacketSize, false);
+		}) * 1000.0);
+
+		FReplayChannelLifetimeIndex ParallelIndex;
+		bool bParallelBuilt = false;
+		ParallelMilliseconds.Add(AutomationBenchmark::TimeIterations(1, [&](int32)
+		{
+			bParallelBuilt = ParallelIndex.Build(Packets, EngineNetVer, GameNetVer, MaxPacketSize, true);
+		}) * 1000.0);
+
+		const TSet<FNetworkGUID> Expected = GetExpectedDestroyedActors(Replay, CheckpointFrame, TargetFrame);
+
+		const bool bSerialMatches = bSerialBuilt && SerialIndex.GetDestroyedActors().Num() == Expected.Num() && SerialIndex.GetDestroyedActors().Includes(Expected);
+		const bool bParallelMatches = bParallelBuilt && ParallelIndex.GetDestroyedActors().Num() == Expected.Num() && ParallelIndex.GetDestroyedActors().Includes(Expected);
+
+		if (!bSerialMatches || !bParallelMatches)
+		{
+			++NumMismatches;
+		}
+
+		TotalBunches += SerialIndex.GetNumBunches();
+		TotalSkippedActors += Expected.Num();
+	}
+
+	TestEqual(TEXT("Serial and parallel indices find exactly the actors destroyed within each seek"), NumMismatches, 0);
+
+	AddInfo(FString::Printf(TEXT("%d seeks over %d frames (%d actors), avg %.1f bunches and %.1f skippable actors per seek"),
+		NumSeeks, NumFrames, Replay.Actors.Num(), (double)TotalBunches / NumSeeks, (double)TotalSkippedActors / NumSeeks));
+
+	AddInfo(FString::Printf(TEXT("Index latency serial: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms | parallel: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms"),
+		GetPercentile(SerialMilliseconds, 0.5f), GetPercentile(SerialMilliseconds, 0.9f), GetPercentile(SerialMilliseconds, 0.99f),
+		GetPercentile(ParallelMilliseconds, 0.5f), GetPercentile(ParallelMilliseconds, 0.9f), GetPercentile(ParallelMilliseconds, 0.99f)));
+
+	return true;
+}
+
+bool FReplayChannelLifetimeIndexKnownActorsTest::RunTest(const FString& Parameters)
+{
+	using namespace ReplayChannelIndexTest;
+
+	const uint32 EngineNetVer = FNetworkVersion::GetEngineNetworkProtocolVersion();
+	const uint32 GameNetVer = FNetworkVersion::GetGameNetworkProtocolVersion();
+
+	FRandomStream Random(0x5C2D);
+
+	FSyntheticActor WakingActor;
+	WakingActor.ActorGUID = FNetworkGUID(2);
+
+	FSyntheticActor NewActor;
+	NewActor.ActorGUID = FNetworkGUID(4);
+
+	TArray<FPlaybackPacket> Packets;
+	{
+		FBitWriter Packet(0, true);
+		WriteOpenBunch(Packet, WakingActor, 1, Random);
+		WriteOpenBunch(Packet, NewActor, 2, Random);
+		Packets.Add(FinishPacket(Packet, 0));
+	}
+	{
+		FBitWriter Packet(0, true);
+		WriteCloseBunch(Packet, WakingActor, 1);
+		WriteCloseBunch(Packet, NewActor, 2);
+		Packets.Add(FinishPacket(Packet, 1));
+	}
+
+	FReplayChannelLifetimeIndex Index;
+	TestTrue(TEXT("Index built without a filter"), Index.Build(Packets, EngineNetVer, GameNetVer, MaxPacketSize, false));
+	TestEqual(TEXT("Both actors are destroyed without a filter"), Index.GetDestroyedActors().Num(), 2);
+
+	const FNetworkGUID KnownGUID = WakingActor.ActorGUID;
+	TestTrue(TEXT("Index built with a filter"), Index.Build(Packets, EngineNetVer, GameNetVer, MaxPacketSize, false, [KnownGUID](const FNetworkGUID& ActorGUID) { return ActorGUID == KnownGUID; }));
+	TestEqual(TEXT("Only the new actor is destroyed with a filter"), Index.GetDestroyedActors().Num(), 1);
+	TestTrue(TEXT("The new actor is skipped"), Index.GetDestroyedActors().Contains(NewActor.ActorGUID));
+	TestFalse(TEXT("The known actor sees its close"), Index.GetDestroyedActors().Contains(KnownGUID));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
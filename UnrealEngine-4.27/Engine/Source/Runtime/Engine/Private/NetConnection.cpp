@@ -84,6 +84,12 @@ static TAutoConsoleVariable<int32> CVarDisableBandwithThrottling(TEXT("net.Disab
 	TEXT("Forces IsNetReady to always return true. Not available in shipping builds."));
 #endif
 
+static TAutoConsoleVariable<int32> CVarNetBatchSends(TEXT("net.BatchSends"), 0,
+	TEXT("If nonzero, packets built by FlushNet are queued and sent together once all connections have ticked, so connections that support it can write them with one batched socket call."));
+
+static TAutoConsoleVariable<int32> CVarNetBatchSendsMaxPackets(TEXT("net.BatchSendsMaxPackets"), 64,
+	TEXT("The maximum number of packets a connection queues with net.BatchSends before it sends them early."));
+
 TAutoConsoleVariable<int32> CVarNetEnableCongestionControl(TEXT("net.EnableCongestionControl"), 0,
 	TEXT("Enables congestion control module."));
 
@@ -677,6 +683,12 @@ void UNetConnection::Serialize( FArchive& Ar )
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("OutReliable", OutReliable.CountBytes(Ar));
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("InReliable", InReliable.CountBytes(Ar));
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("PendingOutRec", PendingOutRec.CountBytes(Ar));
+		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("InBunchArena", InBunchArena.CountMemory(Ar));
+		GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT("InBunchArena.NumPooledBunches", InBunchArena.GetNumPooledBunches());
+		GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT("InBunchArena.NumBunchAllocations", InBunchArena.GetStats().NumBunchAllocations);
+		GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT("InBunchArena.NumBufferAllocations", InBunchArena.GetStats().NumBufferAllocations);
+		GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT("InBunchArena.NumAcquired", InBunchArena.GetStats().NumAcquired);
+		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("BatchedSends", BatchedSends.CountBytes(Ar));
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("ActorChannels", ActorChannels.CountBytes(Ar));
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("DestroyedStartupOrDormantActorGUIDs", DestroyedStartupOrDormantActorGUIDs.CountBytes(Ar));
 
@@ -766,6 +778,8 @@ void UNetConnection::Close()
 			FlushNet();
 		}
 
+		FlushBatchedSends();
+
 		if (NetAnalyticsData.IsValid())
 		{
 			NetAnalyticsData->CommitAnalytics(AnalyticsVars);
@@ -1515,7 +1529,7 @@ void UNetConnection::FlushNet(bool bIgnoreSimulation)
 			// Checked in FlushNet() so each child class doesn't have to implement this
 			if (Driver->IsNetResourceValid())
 			{
-				LowLevelSend(SendBuffer.GetData(), SendBuffer.GetNumBits(), Traits);
+				SendOrQueuePacket(SendBuffer.GetData(), SendBuffer.GetNumBits(), Traits);
 			}
 #if DO_ENABLE_NET_TEST
 			if (PacketSimulationSettings.PktDup && FMath::FRand() * 100.f < PacketSimulationSettings.PktDup)
@@ -1523,7 +1537,7 @@ void UNetConnection::FlushNet(bool bIgnoreSimulation)
 				// Checked in FlushNet() so each child class doesn't have to implement this
 				if (Driver->IsNetResourceValid())
 				{
-					LowLevelSend((char*) SendBuffer.GetData(), SendBuffer.GetNumBits(), Traits);
+					SendOrQueuePacket(SendBuffer.GetData(), SendBuffer.GetNumBits(), Traits);
 				}
 			}
 		}
@@ -1587,6 +1601,68 @@ void UNetConnection::FlushNet(bool bIgnoreSimulation)
 	}
 }
 
+void UNetConnection::SendOrQueuePacket(uint8* Data, int32 CountBits, FOutPacketTraits& Traits)
+{
+	// Closing connections send right away, they may not be around for the driver's flush
+	const bool bBatchSend = CVarNetBatchSends.GetValueOnAnyThread() != 0 && State != USOCK_Closed && !IsGarbageCollecting() && !IsInternalAck();
+
+	if (BatchedSends.IsFlushing())
+	{
+		// Sent from within LowLevelSendBatch, a connection closing mid flush for instance. Going straight to the socket would
+		// put this packet ahead of the rest of the batch, so it goes after them, FlushBatchedSends sends it before returning.
+		BatchedSends.Enqueue(Data, CountBits, Traits);
+	}
+	else if (bBatchSend)
+	{
+		BatchedSends.Enqueue(Data, CountBits, Traits);
+
+		if (BatchedSends.Num() >= CVarNetBatchSendsMaxPackets.GetValueOnAnyThread())
+		{
+			FlushBatchedSends();
+		}
+	}
+	else
+	{
+		// Anything still queued has to go out first to keep packets in order
+		FlushBatchedSends();
+
+		LowLevelSend(Data, CountBits, Traits);
+	}
+}
+
+void UNetConnection::FlushBatchedSends()
+{
+	// Nested calls from within LowLevelSendBatch leave their packets to the outer flush
+	if (BatchedSends.IsFlushing())
+	{
+		return;
+	}
+
+	// Packets sent while flushing were queued behind the batch, keep going until they're out too
+	while (!BatchedSends.IsEmpty())
+	{
+		BatchedSends.Flush([this](TArrayView<FQueuedOutPacket> Packets)
+		{
+			INC_DWORD_STAT(STAT_NetBatchedSendCalls);
+			INC_DWORD_STAT_BY(STAT_NetBatchedSendPackets, Packets.Num());
+
+			// Checked here as well as in FlushNet, the socket may have gone away since the packets were queued
+			if (Driver != nullptr && Driver->IsNetResourceValid())
+			{
+				LowLevelSendBatch(Packets);
+			}
+		});
+	}
+}
+
+void UNetConnection::LowLevelSendBatch(TArrayView<FQueuedOutPacket> Packets)
+{
+	for (FQueuedOutPacket& Packet : Packets)
+	{
+		LowLevelSend(Packet.Data, Packet.CountBits, Packet.Traits);
+	}
+}
+
 #if DO_ENABLE_NET_TEST
 bool UNetConnection::CheckOutgoingPacketEmulation(FOutPacketTraits& Traits)
 {
@@ -2926,7 +3002,7 @@ void UNetConnection::SetIgnoreActorBunches(bool bInIgnoreActorBunches, TSet<FNet
 	bIgnoreActorBunches = bInIgnoreActorBunches;
 
 	IgnoredBunchChannels.Empty();
-	InIgnoredBunchGuids.Empty();
+	IgnoredBunchGuids.Empty();
 
 	if (bIgnoreActorBunches)
 	{
@@ -4505,6 +4581,89 @@ FAutoConsoleCommandWithWorldAndArgs AddimulatedConnectionsCmd(TEXT("net.Simulate
 
 FAutoConsoleCommandWithWorldAndArgs RemoveSimulatedConnectionsCmd(TEXT("net.DisconnectSimulatedConnections"), TEXT("Disconnects some simulated connections (0 = all)"), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(RemoveSimulatedNetConnections));
 
+/**
+ * Headless benchmark for UNetDriver::ServerReplicateActors, meant to be run on a dedicated server (-nullrhi) with a loaded map.
+ * Adds simulated connections that absorb all traffic, forces every actor to be considered each tick, and reports the
+ * average replication time per tick with net.ParallelPrioritizeActors off and on.
+ */
+static void	BenchmarkServerReplicateActors(const TArray<FString>& Args, UWorld* World)
+{
+	int32 NumConnections = 63;
+	int32 NumTicks = 100;
+	if (Args.Num() > 0)
+	{
+		LexFromString(NumConnections, *Args[0]);
+	}
+	if (Args.Num() > 1)
+	{
+		LexFromString(NumTicks, *Args[1]);
+	}
+
+	// Search for server game net driver. Do it this way so we can cheat in PIE
+	UNetDriver* BestNetDriver = nullptr;
+	for (TObjectIterator<UNetDriver> NetDriverIt; NetDriverIt; ++NetDriverIt)
+	{
+		if (NetDriverIt->NetDriverName == NAME_GameNetDriver && NetDriverIt->IsServer())
+		{
+			BestNetDriver = *NetDriverIt;
+			break;
+		}
+	}
+
+	IConsoleVariable* ParallelPrioritizeCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.ParallelPrioritizeActors"));
+	if (!BestNetDriver || !ParallelPrioritizeCVar || NumTicks <= 0)
+	{
+		UE_LOG(LogNet, Warning, TEXT("net.BenchmarkServerReplicateActors requires a server game net driver. Usage: net.BenchmarkServerReplicateActors [NumConnections] [NumTicks]"));
+		return;
+	}
+
+	if (NumConnections > 0)
+	{
+		AddSimulatedNetConnections({ LexToString(NumConnections) }, World);
+	}
+
+	const int32 PreviousParallelPrioritize = ParallelPrioritizeCVar->GetInt();
+	const float DeltaSeconds = 1.0f / 30.0f;
+
+	for (int32 ParallelPrioritize = 0; ParallelPrioritize < 2; ++ParallelPrioritize)
+	{
+		ParallelPrioritizeCVar->Set(ParallelPrioritize, ECVF_SetByConsole);
+
+		double TotalSeconds = 0.0;
+		double MaxSeconds = 0.0;
+		int32 NumReplicated = 0;
+		for (int32 TickIndex = 0; TickIndex < NumTicks; ++TickIndex)
+		{
+			BestNetDriver->ForceAllActorsNetUpdateTime(0.0f, [](const AActor* const) { return true; });
+
+			const double StartTime = FPlatformTime::Seconds();
+			NumReplicated += BestNetDriver->ServerReplicateActors(DeltaSeconds);
+			const double TickSeconds = FPlatformTime::Seconds() - StartTime;
+
+			TotalSeconds += TickSeconds;
+			MaxSeconds = FMath::Max(MaxSeconds, TickSeconds);
+
+			// Let the connections flush and refill their bandwidth budget as they would between server frames
+			for (UNetConnection* Connection : BestNetDriver->ClientConnections)
+			{
+				Connection->Tick(DeltaSeconds);
+			}
+		}
+
+		UE_LOG(LogNet, Display, TEXT("ServerReplicateActors, %d connections, net.ParallelPrioritizeActors=%d: %.3f ms/tick avg, %.3f ms max, %.1f actors replicated/tick"),
+			BestNetDriver->ClientConnections.Num(), ParallelPrioritize, TotalSeconds * 1000.0 / NumTicks, MaxSeconds * 1000.0, (float)NumReplicated / NumTicks);
+	}
+
+	ParallelPrioritizeCVar->Set(PreviousParallelPrioritize, ECVF_SetByConsole);
+
+	if (NumConnections > 0)
+	{
+		RemoveSimulatedNetConnections({ LexToString(NumConnections) }, World);
+	}
+}
+
+FAutoConsoleCommandWithWorldAndArgs BenchmarkServerReplicateActorsCmd(TEXT("net.BenchmarkServerReplicateActors"), TEXT("Adds simulated connections and reports ServerReplicateActors time per tick with and without parallel prioritization. Args: [NumConnections=63] [NumTicks=100]"), FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkServerReplicateActors));
+
 // ----------------------------------------------------------------
 
 
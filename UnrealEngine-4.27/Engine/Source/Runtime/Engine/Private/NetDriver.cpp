@@ -12,6 +12,7 @@
 #include "Stats/Stats.h"
 #include "Misc/App.h"
 #include "Misc/MemStack.h"
+#include "Async/ParallelFor.h"
 #include "HAL/IConsoleManager.h"
 #include "HAL/LowLevelMemTracker.h"
 #include "UObject/ObjectMacros.h"
@@ -64,6 +65,7 @@
 #include "Net/PerfCountersHelpers.h"
 #include "Stats/StatsMisc.h"
 #include "Engine/ReplicationDriver.h"
+#include "Net/NetReplicationPolicy.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/NetworkSettings.h"
@@ -114,6 +116,15 @@ DEFINE_STAT(STAT_NumActors);
 DEFINE_STAT(STAT_NumNetActors);
 DEFINE_STAT(STAT_NumDormantActors);
 DEFINE_STAT(STAT_NumInitiallyDormantActors);
+DEFINE_STAT(STAT_NumRelevancyGridCellActors);
+DEFINE_STAT(STAT_NumRelevancyGridCells);
+DEFINE_STAT(STAT_NumRelevancyGridAlwaysRelevantActors);
+DEFINE_STAT(STAT_NumRelevancyGridOwnerRelevantActors);
+DEFINE_STAT(STAT_NumRelevancyGridCulledActors);
+DEFINE_STAT(STAT_NumReplicationPolicyDueActors);
+DEFINE_STAT(STAT_NumReplicationPolicyBuckets);
+DEFINE_STAT(STAT_NumReplicationPolicyCellRebuilds);
+DEFINE_STAT(STAT_NumReplicationPolicyGridChanges);
 DEFINE_STAT(STAT_NumNetGUIDsAckd);
 DEFINE_STAT(STAT_NumNetGUIDsPending);
 DEFINE_STAT(STAT_NumNetGUIDsUnAckd);
@@ -124,6 +135,12 @@ DEFINE_STAT(STAT_NetSaturated);
 DEFINE_STAT(STAT_ImportedNetGuids);
 DEFINE_STAT(STAT_PendingOuterNetGuids);
 DEFINE_STAT(STAT_UnmappedReplicators);
+DEFINE_STAT(STAT_InBunchAllocations);
+DEFINE_STAT(STAT_InBunchBufferAllocations);
+DEFINE_STAT(STAT_InBunchPoolReuses);
+DEFINE_STAT(STAT_InBunchPoolMemory);
+DEFINE_STAT(STAT_NetBatchedSendCalls);
+DEFINE_STAT(STAT_NetBatchedSendPackets);
 
 // Voice specific stats
 DEFINE_STAT(STAT_VoiceBytesSent);
@@ -146,6 +163,7 @@ DEFINE_STAT(STAT_PacketReservedHandshake);
 DECLARE_CYCLE_STAT(TEXT("NetDriver AddClientConnection"), Stat_NetDriverAddClientConnection, STATGROUP_Net);
 DECLARE_CYCLE_STAT(TEXT("NetDriver ProcessRemoteFunction"), STAT_NetProcessRemoteFunc, STATGROUP_Net);
 DECLARE_CYCLE_STAT(TEXT("Process Prioritized Actors Time"), STAT_NetProcessPrioritizedActorsTime, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Parallel Prioritize Actors Time"), STAT_NetParallelPrioritizeActorsTime, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush"), STAT_NetTickFlush, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush GatherStats"), STAT_NetTickFlushGatherStats, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush GatherStatsPerfCounters"), STAT_NetTickFlushGatherStatsPerfCounters, STATGROUP_Game);
@@ -155,6 +173,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogNetSyncLoads, Log, All);
 int32 GNumSaturatedConnections; // Counter for how many connections are skipped/early out due to bandwidth saturation
 int32 GNumSharedSerializationHit;
 int32 GNumSharedSerializationMiss;
+int32 GNumSharedChangelistHit;
 
 extern int32 GNetRPCDebug;
 
@@ -291,6 +310,65 @@ static FAutoConsoleVariableRef CVarNetReuseReplicatorsForDormantObjects(
 	TEXT("When true, Server's will persist and attempt to reuse replicators for Dormant Actors and Objects. This can cut down on bandwidth by preventing redundant information from being sent when waking objects from Dormancy."),
 	ECVF_Default);
 
+int32 GNetParallelPrioritizeActors = 0;
+static FAutoConsoleVariableRef CVarNetParallelPrioritizeActors(
+	TEXT("net.ParallelPrioritizeActors"),
+	GNetParallelPrioritizeActors,
+	TEXT("When enabled, ServerReplicateActors prioritizes the actors of every connection on worker threads before replicating them.\n")
+	TEXT("All connections see the actor state from the start of replication, channel closes and dormancy changes are applied on the game thread afterwards, and actors are still replicated serially.\n")
+	TEXT("Only actors with bParallelNetPrioritization set are prioritized on worker threads, the others are prioritized on the game thread. Frames where the server is behind its tick rate prioritize on the game thread.\n")
+	TEXT("0: Prioritize on the game thread, 1: Prioritize on worker threads"),
+	ECVF_Default);
+
+int32 GNetParallelPrioritizeActorsMinConnections = 4;
+static FAutoConsoleVariableRef CVarNetParallelPrioritizeActorsMinConnections(
+	TEXT("net.ParallelPrioritizeActors.MinConnections"),
+	GNetParallelPrioritizeActorsMinConnections,
+	TEXT("Minimum number of connections ticked in a frame for net.ParallelPrioritizeActors to use worker threads."),
+	ECVF_Default);
+
+int32 GNetRelevancyGrid = 0;
+static FAutoConsoleVariableRef CVarNetRelevancyGrid(
+	TEXT("net.RelevancyGrid"),
+	GNetRelevancyGrid,
+	TEXT("When enabled, considered actors are kept in a spatial grid, and actors without a channel are only checked with IsNetRelevantFor if they are near one of the connection's viewers.\n")
+	TEXT("Always relevant actors, actors with an owner, instigator or attach parent, and actors with a cull distance beyond net.RelevancyGrid.QueryRadius are always checked.\n")
+	TEXT("Requires game overrides of IsNetRelevantFor to only make actors relevant beyond their cull distance through one of those.\n")
+	TEXT("0: Check every considered actor, 1: Use the relevancy grid"),
+	ECVF_Default);
+
+float GNetRelevancyGridCellSize = 10000.0f;
+static FAutoConsoleVariableRef CVarNetRelevancyGridCellSize(
+	TEXT("net.RelevancyGrid.CellSize"),
+	GNetRelevancyGridCellSize,
+	TEXT("Size of the net.RelevancyGrid cells, in world units. Changing it rebuilds the grid."),
+	ECVF_Default);
+
+float GNetRelevancyGridQueryRadius = 15000.0f;
+static FAutoConsoleVariableRef CVarNetRelevancyGridQueryRadius(
+	TEXT("net.RelevancyGrid.QueryRadius"),
+	GNetRelevancyGridQueryRadius,
+	TEXT("Distance around each viewer net.RelevancyGrid gathers actors from. Actors with a larger NetCullDistance are always checked. Changing it rebuilds the grid."),
+	ECVF_Default);
+
+int32 GNetRelevancyGridRebinFrames = 30;
+static FAutoConsoleVariableRef CVarNetRelevancyGridRebinFrames(
+	TEXT("net.RelevancyGrid.RebinFrames"),
+	GNetRelevancyGridRebinFrames,
+	TEXT("Number of frames over which every active actor is moved to its current relevancy grid cell, whether or not it is considered for replication. ")
+	TEXT("Considered actors are also moved when they are considered."),
+	ECVF_Default);
+
+int32 GNetReplicationPolicy = 0;
+static FAutoConsoleVariableRef CVarNetReplicationPolicy(
+	TEXT("net.ReplicationPolicy"),
+	GNetReplicationPolicy,
+	TEXT("When enabled, ServerReplicateActors uses FNetReplicationPolicy: actors are kept in buckets by update interval and only the buckets due each frame are considered, ")
+	TEXT("the actors near each connection's viewers are kept between frames and updated as actors move, and only the considered actors are sorted by priority.\n")
+	TEXT("Ignored when a ReplicationDriver is set.\n")
+	TEXT("0: Consider every active actor each frame, 1: Use the replication policy"),
+	ECVF_Default);
+
 static TAutoConsoleVariable<int32> CVarNetDebugDraw(
 	TEXT("net.DebugDraw"),
 	0,
@@ -1106,6 +1184,20 @@ void UNetDriver::TickFlush(float DeltaSeconds)
 			Connection->Tick(DeltaSeconds);
 		}
 	}
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_NetDriver_FlushBatchedSends)
+
+		// Send the packets the connections queued while ticking, when net.BatchSends is enabled
+		if (ServerConnection)
+		{
+			ServerConnection->FlushBatchedSends();
+		}
+
+		for (UNetConnection* Connection : ClientConnections)
+		{
+			Connection->FlushBatchedSends();
+		}
+	}
 
 	if (ConnectionlessHandler.IsValid())
 	{
@@ -2598,6 +2690,13 @@ void UNetDriver::Serialize( FArchive& Ar )
 
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("RenamedStartupActors", RenamedStartupActors.CountBytes(Ar));
 
+		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("ReplicationPolicy",
+			if (ReplicationPolicy.IsValid())
+			{
+				ReplicationPolicy->CountBytes(Ar);
+			}
+		);
+
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("RepChangedPropertyTrackerMap",
 			RepChangedPropertyTrackerMap.CountBytes(Ar);
 
@@ -3380,6 +3479,11 @@ void UNetDriver::NotifyActorTearOff(AActor* Actor)
 	}
 }
 
+TSharedPtr<FNetReplicationPolicy> UNetDriver::CreateReplicationPolicy()
+{
+	return MakeShared<FNetReplicationPolicy>(this);
+}
+
 void UNetDriver::ForceNetUpdate(AActor* Actor)
 {
 	// Let Replication Driver handle it if its exists
@@ -3393,6 +3497,11 @@ void UNetDriver::ForceNetUpdate(AActor* Actor)
 	if ( FNetworkObjectInfo* NetActor = FindNetworkObjectInfo(Actor) )
 	{
 		NetActor->NextUpdateTime = World->TimeSeconds - 0.01f;
+
+		if ( ReplicationPolicy.IsValid() )
+		{
+			ReplicationPolicy->RequestUpdate( *NetActor );
+		}
 	}
 }
 
@@ -3470,6 +3579,15 @@ void UNetDriver::FlushActorDormancyInternal(AActor *Actor)
 			NetConnection->FlushDormancy(Actor);
 		}
 	}
+
+	// The actor is awake again, consider it next frame instead of waiting for its bucket to come around
+	if ( ReplicationPolicy.IsValid() )
+	{
+		if ( FNetworkObjectInfo* NetActor = FindNetworkObjectInfo(Actor) )
+		{
+			ReplicationPolicy->RequestUpdate( *NetActor );
+		}
+	}
 }
 
 void UNetDriver::ForcePropertyCompare( AActor* Actor )
@@ -4045,141 +4163,226 @@ int32 UNetDriver::ServerReplicateActors_PrepConnections( const float DeltaSecond
 	return bFoundReadyConnection ? NumClientsToTick : 0;
 }
 
-void UNetDriver::ServerReplicateActors_BuildConsiderList( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime )
+// The relevancy grid can only cull by distance if relevancy is distance based
+static FORCEINLINE_DEBUGGABLE bool ShouldUseRelevancyGrid()
 {
-	SCOPE_CYCLE_COUNTER( STAT_NetConsiderActorsTime );
+	return GNetRelevancyGrid != 0 && GetDefault<AGameNetworkManager>()->bUseDistanceBasedRelevancy;
+}
 
-	UE_LOG( LogNetTraffic, Log, TEXT( "ServerReplicateActors_BuildConsiderList, Building ConsiderList %4.2f" ), World->GetTimeSeconds() );
+void UNetDriver::ServerReplicateActors_ConsiderActor( FNetworkObjectInfo* ActorInfo, const float ServerTickTime, const bool bUseRelevancyGrid, TArray<FNetworkObjectInfo*>& OutConsiderList, TArray<AActor*>& OutActorsToRemove, int32& OutNumInitiallyDormant )
+{
+	if ( !ActorInfo->bPendingNetUpdate && World->TimeSeconds <= ActorInfo->NextUpdateTime )
+	{
+		return;		// It's not time for this actor to perform an update, skip it
+	}
 
-	int32 NumInitiallyDormant = 0;
+	AActor* Actor = ActorInfo->Actor;
 
-	const bool bUseAdapativeNetFrequency = IsAdaptiveNetUpdateFrequencyEnabled();
+	if ( Actor->IsPendingKillPending() )
+	{
+		// Actors aren't allowed to be placed in the NetworkObjectList if they are PendingKillPending.
+		// Actors should also be unconditionally removed from the NetworkObjectList when UWorld::DestroyActor is called.
+		// If this is happening, it means code is not destructing Actors properly, and that's not OK.
+		UE_LOG( LogNet, Warning, TEXT( "Actor %s was found in the NetworkObjectList, but is PendingKillPending" ), *Actor->GetName() );
+		OutActorsToRemove.Add( Actor );
+		return;
+	}
 
-	TArray<AActor*> ActorsToRemove;
+	if ( Actor->GetRemoteRole() == ROLE_None )
+	{
+		OutActorsToRemove.Add( Actor );
+		return;
+	}
 
-	for ( const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : GetNetworkObjectList().GetActiveObjects() )
+	// This actor may belong to a different net driver, make sure this is the correct one
+	// (this can happen when using beacon net drivers for example)
+	if (Actor->GetNetDriverName() != NetDriverName)
 	{
-		FNetworkObjectInfo* ActorInfo = ObjectInfo.Get();
+		UE_LOG(LogNetTraffic, Error, TEXT("Actor %s in wrong network actors list! (Has net driver '%s', expected '%s')"),
+				*Actor->GetName(), *Actor->GetNetDriverName().ToString(), *NetDriverName.ToString());
 
-		if ( !ActorInfo->bPendingNetUpdate && World->TimeSeconds <= ActorInfo->NextUpdateTime )
-		{
-			continue;		// It's not time for this actor to perform an update, skip it
-		}
+		return;
+	}
 
-		AActor* Actor = ActorInfo->Actor;
+	// Verify the actor is actually initialized (it might have been intentionally spawn deferred until a later frame)
+	if ( !Actor->IsActorInitialized() )
+	{
+		return;
+	}
 
-		if ( Actor->IsPendingKillPending() )
-		{
-			// Actors aren't allowed to be placed in the NetworkObjectList if they are PendingKillPending.
-			// Actors should also be unconditionally removed from the NetworkObjectList when UWorld::DestroyActor is called.
-			// If this is happening, it means code is not destructing Actors properly, and that's not OK.
-			UE_LOG( LogNet, Warning, TEXT( "Actor %s was found in the NetworkObjectList, but is PendingKillPending" ), *Actor->GetName() );
-			ActorsToRemove.Add( Actor );
-			continue;
-		}
+	// Don't send actors that may still be streaming in or out
+	ULevel* Level = Actor->GetLevel();
+	if ( Level->HasVisibilityChangeRequestPending() || Level->bIsAssociatingLevel )
+	{
+		return;
+	}
 
-		if ( Actor->GetRemoteRole() == ROLE_None )
-		{
-			ActorsToRemove.Add( Actor );
-			continue;
-		}
+	if ( IsDormInitialStartupActor(Actor) )
+	{
+		// This stat isn't that useful in its current form when using NetworkActors list
+		// We'll want to track initially dormant actors some other way to track them with stats
+		SCOPE_CYCLE_COUNTER( STAT_NetInitialDormantCheckTime );
+		OutNumInitiallyDormant++;
+		OutActorsToRemove.Add( Actor );
+		//UE_LOG(LogNetTraffic, Log, TEXT("Skipping Actor %s - its initially dormant!"), *Actor->GetName() );
+		return;
+	}
 
-		// This actor may belong to a different net driver, make sure this is the correct one
-		// (this can happen when using beacon net drivers for example)
-		if (Actor->GetNetDriverName() != NetDriverName)
-		{
-			UE_LOG(LogNetTraffic, Error, TEXT("Actor %s in wrong network actors list! (Has net driver '%s', expected '%s')"),
-					*Actor->GetName(), *Actor->GetNetDriverName().ToString(), *NetDriverName.ToString());
+	checkSlow( Actor->NeedsLoadForClient() ); // We have no business sending this unless the client can load
+	checkSlow( World == Actor->GetWorld() );
 
-			continue;
-		}
+	// Set defaults if this actor is replicating for first time
+	if ( ActorInfo->LastNetReplicateTime == 0 )
+	{
+		ActorInfo->LastNetReplicateTime = World->TimeSeconds;
+		ActorInfo->OptimalNetUpdateDelta = 1.0f / Actor->NetUpdateFrequency;
+	}
 
-		// Verify the actor is actually initialized (it might have been intentionally spawn deferred until a later frame)
-		if ( !Actor->IsActorInitialized() )
-		{
-			continue;
-		}
+	const float ScaleDownStartTime = 2.0f;
+	const float ScaleDownTimeRange = 5.0f;
 
-		// Don't send actors that may still be streaming in or out
-		ULevel* Level = Actor->GetLevel();
-		if ( Level->HasVisibilityChangeRequestPending() || Level->bIsAssociatingLevel )
-		{
-			continue;
-		}
+	const float LastReplicateDelta = World->TimeSeconds - ActorInfo->LastNetReplicateTime;
 
-		if ( IsDormInitialStartupActor(Actor) )
+	if ( LastReplicateDelta > ScaleDownStartTime )
+	{
+		if ( Actor->MinNetUpdateFrequency == 0.0f )
 		{
-			// This stat isn't that useful in its current form when using NetworkActors list
-			// We'll want to track initially dormant actors some other way to track them with stats
-			SCOPE_CYCLE_COUNTER( STAT_NetInitialDormantCheckTime );
-			NumInitiallyDormant++;
-			ActorsToRemove.Add( Actor );
-			//UE_LOG(LogNetTraffic, Log, TEXT("Skipping Actor %s - its initially dormant!"), *Actor->GetName() );
-			continue;
+			Actor->MinNetUpdateFrequency = 2.0f;
 		}
 
-		checkSlow( Actor->NeedsLoadForClient() ); // We have no business sending this unless the client can load
-		checkSlow( World == Actor->GetWorld() );
+		// Calculate min delta (max rate actor will update), and max delta (slowest rate actor will update)
+		const float MinOptimalDelta = 1.0f / Actor->NetUpdateFrequency;									  // Don't go faster than NetUpdateFrequency
+		const float MaxOptimalDelta = FMath::Max( 1.0f / Actor->MinNetUpdateFrequency, MinOptimalDelta ); // Don't go slower than MinNetUpdateFrequency (or NetUpdateFrequency if it's slower)
 
-		// Set defaults if this actor is replicating for first time
-		if ( ActorInfo->LastNetReplicateTime == 0 )
-		{
-			ActorInfo->LastNetReplicateTime = World->TimeSeconds;
-			ActorInfo->OptimalNetUpdateDelta = 1.0f / Actor->NetUpdateFrequency;
-		}
+		// Interpolate between MinOptimalDelta/MaxOptimalDelta based on how long it's been since this actor actually sent anything
+		const float Alpha = FMath::Clamp( ( LastReplicateDelta - ScaleDownStartTime ) / ScaleDownTimeRange, 0.0f, 1.0f );
+		ActorInfo->OptimalNetUpdateDelta = FMath::Lerp( MinOptimalDelta, MaxOptimalDelta, Alpha );
+	}
 
-		const float ScaleDownStartTime = 2.0f;
-		const float ScaleDownTimeRange = 5.0f;
+	// Setup ActorInfo->NextUpdateTime, which will be the next time this actor will replicate properties to connections
+	// NOTE - We don't do this if bPendingNetUpdate is true, since this means we're forcing an update due to at least one connection
+	//	that wasn't to replicate previously (due to saturation, etc)
+	// NOTE - This also means all other connections will force an update (even if they just updated, we should look into this)
+	if ( !ActorInfo->bPendingNetUpdate )
+	{
+		UE_LOG( LogNetTraffic, Log, TEXT( "actor %s requesting new net update, time: %2.3f" ), *Actor->GetName(), World->TimeSeconds );
 
-		const float LastReplicateDelta = World->TimeSeconds - ActorInfo->LastNetReplicateTime;
+		const float NextUpdateDelta = IsAdaptiveNetUpdateFrequencyEnabled() ? ActorInfo->OptimalNetUpdateDelta : 1.0f / Actor->NetUpdateFrequency;
 
-		if ( LastReplicateDelta > ScaleDownStartTime )
-		{
-			if ( Actor->MinNetUpdateFrequency == 0.0f )
-			{
-				Actor->MinNetUpdateFrequency = 2.0f;
-			}
+		// then set the next update time
+		ActorInfo->NextUpdateTime = World->TimeSeconds + UpdateDelayRandomStream.FRand() * ServerTickTime + NextUpdateDelta;
 
-			// Calculate min delta (max rate actor will update), and max delta (slowest rate actor will update)
-			const float MinOptimalDelta = 1.0f / Actor->NetUpdateFrequency;									  // Don't go faster than NetUpdateFrequency
-			const float MaxOptimalDelta = FMath::Max( 1.0f / Actor->MinNetUpdateFrequency, MinOptimalDelta ); // Don't go slower than MinNetUpdateFrequency (or NetUpdateFrequency if it's slower)
+		// and mark when the actor first requested an update
+		//@note: using Time because it's compared against UActorChannel.LastUpdateTime which also uses that value
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		ActorInfo->LastNetUpdateTime = ElapsedTime;
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+		ActorInfo->LastNetUpdateTimestamp = ElapsedTime;
+	}
 
-			// Interpolate between MinOptimalDelta/MaxOptimalDelta based on how long it's been since this actor actually sent anything
-			const float Alpha = FMath::Clamp( ( LastReplicateDelta - ScaleDownStartTime ) / ScaleDownTimeRange, 0.0f, 1.0f );
-			ActorInfo->OptimalNetUpdateDelta = FMath::Lerp( MinOptimalDelta, MaxOptimalDelta, Alpha );
-		}
+	// and clear the pending update flag assuming all clients will be able to consider it
+	ActorInfo->bPendingNetUpdate = false;
 
-		// Setup ActorInfo->NextUpdateTime, which will be the next time this actor will replicate properties to connections
-		// NOTE - We don't do this if bPendingNetUpdate is true, since this means we're forcing an update due to at least one connection
-		//	that wasn't to replicate previously (due to saturation, etc)
-		// NOTE - This also means all other connections will force an update (even if they just updated, we should look into this)
-		if ( !ActorInfo->bPendingNetUpdate )
-		{
-			UE_LOG( LogNetTraffic, Log, TEXT( "actor %s requesting new net update, time: %2.3f" ), *Actor->GetName(), World->TimeSeconds );
+	// add it to the list to consider below
+	// For performance reasons, make sure we don't resize the array. It should already be appropriately sized above!
+	ensure( OutConsiderList.Num() < OutConsiderList.Max() );
+	OutConsiderList.Add( ActorInfo );
+	ActorInfo->ConsiderListFrame = ReplicationFrame;
 
-			const float NextUpdateDelta = bUseAdapativeNetFrequency ? ActorInfo->OptimalNetUpdateDelta : 1.0f / Actor->NetUpdateFrequency;
+	// Call PreReplication on all actors that will be considered
+	Actor->CallPreReplication( this );
 
-			// then set the next update time
-			ActorInfo->NextUpdateTime = World->TimeSeconds + UpdateDelayRandomStream.FRand() * ServerTickTime + NextUpdateDelta;
+	if ( bUseRelevancyGrid )
+	{
+		GetNetworkObjectList().GetRelevancyGrid().Update( *ActorInfo );
+	}
+}
 
-			// and mark when the actor first requested an update
-			//@note: using Time because it's compared against UActorChannel.LastUpdateTime which also uses that value
-			PRAGMA_DISABLE_DEPRECATION_WARNINGS
-			ActorInfo->LastNetUpdateTime = ElapsedTime;
-			PRAGMA_ENABLE_DEPRECATION_WARNINGS
-			ActorInfo->LastNetUpdateTimestamp = ElapsedTime;
-		}
+void UNetDriver::ServerReplicateActors_BuildConsiderList( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime )
+{
+	SCOPE_CYCLE_COUNTER( STAT_NetConsiderActorsTime );
 
-		// and clear the pending update flag assuming all clients will be able to consider it
-		ActorInfo->bPendingNetUpdate = false;
+	UE_LOG( LogNetTraffic, Log, TEXT( "ServerReplicateActors_BuildConsiderList, Building ConsiderList %4.2f" ), World->GetTimeSeconds() );
 
-		// add it to the list to consider below
-		// For performance reasons, make sure we don't resize the array. It should already be appropriately sized above!
-		ensure( OutConsiderList.Num() < OutConsiderList.Max() );
-		OutConsiderList.Add( ActorInfo );
+	int32 NumInitiallyDormant = 0;
 
-		// Call PreReplication on all actors that will be considered
-		Actor->CallPreReplication( this );
+	// Considered actors are moved to their current grid cell, the others a slice at a time so those that moved while skipped don't stay culled
+	FNetworkRelevancyGrid& RelevancyGrid = GetNetworkObjectList().GetRelevancyGrid();
+	const bool bUseRelevancyGrid = ShouldUseRelevancyGrid();
+	if ( bUseRelevancyGrid )
+	{
+		RelevancyGrid.SetCellSizeAndQueryRadius( GNetRelevancyGridCellSize, GNetRelevancyGridQueryRadius );
+		GetNetworkObjectList().UpdateRelevancyGridSlice( GNetRelevancyGridRebinFrames );
+	}
+	else if ( RelevancyGrid.GetNumObjects() > 0 )
+	{
+		RelevancyGrid.Reset();
+	}
+
+	TArray<AActor*> ActorsToRemove;
+
+	for ( const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : GetNetworkObjectList().GetActiveObjects() )
+	{
+		ServerReplicateActors_ConsiderActor( ObjectInfo.Get(), ServerTickTime, bUseRelevancyGrid, OutConsiderList, ActorsToRemove, NumInitiallyDormant );
+	}
+
+	for ( AActor* Actor : ActorsToRemove )
+	{
+		RemoveNetworkActor( Actor );
+	}
+
+	// Update stats
+	SET_DWORD_STAT( STAT_NumInitiallyDormantActors, NumInitiallyDormant );
+	SET_DWORD_STAT( STAT_NumConsideredActors, OutConsiderList.Num() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCellActors, RelevancyGrid.GetNumCellObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCells, RelevancyGrid.GetNumCells() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridAlwaysRelevantActors, RelevancyGrid.GetNumAlwaysRelevantObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridOwnerRelevantActors, RelevancyGrid.GetNumOwnerRelevantObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCulledActors, 0 );
+}
+
+void UNetDriver::ServerReplicateActors_BuildConsiderListFromPolicy( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime )
+{
+	SCOPE_CYCLE_COUNTER( STAT_NetConsiderActorsTime );
+
+	UE_LOG( LogNetTraffic, Log, TEXT( "ServerReplicateActors_BuildConsiderListFromPolicy, Building ConsiderList %4.2f" ), World->GetTimeSeconds() );
+
+	int32 NumInitiallyDormant = 0;
+
+	// The policy culls with cached grid cells, so the grid is kept whenever relevancy is distance based, whatever net.RelevancyGrid says
+	FNetworkRelevancyGrid& RelevancyGrid = GetNetworkObjectList().GetRelevancyGrid();
+	const bool bUseRelevancyGrid = GetDefault<AGameNetworkManager>()->bUseDistanceBasedRelevancy;
+	if ( bUseRelevancyGrid )
+	{
+		RelevancyGrid.SetCellSizeAndQueryRadius( GNetRelevancyGridCellSize, GNetRelevancyGridQueryRadius );
+		GetNetworkObjectList().UpdateRelevancyGridSlice( GNetRelevancyGridRebinFrames );
+	}
+	else if ( RelevancyGrid.GetNumObjects() > 0 )
+	{
+		RelevancyGrid.Reset();
+	}
+
+	TArray<FNetworkObjectInfo*> DueActors;
+	ReplicationPolicy->GatherDueActors( DueActors );
+
+	TArray<AActor*> ActorsToRemove;
+
+	for ( FNetworkObjectInfo* ActorInfo : DueActors )
+	{
+		// Bucket slots only approximate the actor's update rate, one visited before its next update time is retried on the next frame
+		if ( !ActorInfo->bPendingNetUpdate && World->TimeSeconds <= ActorInfo->NextUpdateTime )
+		{
+			ReplicationPolicy->RequestUpdate( *ActorInfo );
+			continue;
+		}
+
+		ServerReplicateActors_ConsiderActor( ActorInfo, ServerTickTime, bUseRelevancyGrid, OutConsiderList, ActorsToRemove, NumInitiallyDormant );
+	}
+
+	// Move considered actors to the bucket for their current rate, before any of them can be removed from the network object list
+	for ( FNetworkObjectInfo* ActorInfo : OutConsiderList )
+	{
+		ReplicationPolicy->RescheduleActor( *ActorInfo, ServerTickTime );
 	}
 
 	for ( AActor* Actor : ActorsToRemove )
@@ -4187,9 +4390,17 @@ void UNetDriver::ServerReplicateActors_BuildConsiderList( TArray<FNetworkObjectI
 		RemoveNetworkActor( Actor );
 	}
 
+	// Bring the nearby actors of every connection up to date with the actors that were added, moved or removed since the last frame
+	ReplicationPolicy->ApplyRelevancyGridChanges( RelevancyGrid );
+
 	// Update stats
 	SET_DWORD_STAT( STAT_NumInitiallyDormantActors, NumInitiallyDormant );
 	SET_DWORD_STAT( STAT_NumConsideredActors, OutConsiderList.Num() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCellActors, RelevancyGrid.GetNumCellObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCells, RelevancyGrid.GetNumCells() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridAlwaysRelevantActors, RelevancyGrid.GetNumAlwaysRelevantObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridOwnerRelevantActors, RelevancyGrid.GetNumOwnerRelevantObjects() );
+	SET_DWORD_STAT( STAT_NumRelevancyGridCulledActors, 0 );
 }
 
 // Returns true if this actor should replicate to *any* of the passed in connections
@@ -4206,6 +4417,71 @@ static FORCEINLINE_DEBUGGABLE bool IsActorRelevantToConnection( const AActor* Ac
 	return false;
 }
 
+// With net.RelevancyGrid, gathers the actors of this frame's consider list that a connection has to look at: those in the grid cells around
+// its viewers or in the grid's side lists, plus those further away that it has a channel for or views from. The rest are too far to be relevant.
+static void GatherRelevancyGridConsiderList( const FNetworkObjectList& NetworkObjectList, const UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const uint32 ReplicationFrame, TArray<FNetworkObjectInfo*>& OutConsiderList )
+{
+	const FNetworkRelevancyGrid& RelevancyGrid = NetworkObjectList.GetRelevancyGrid();
+	RelevancyGrid.GatherCandidateObjects( ConnectionViewers, OutConsiderList );
+
+	const int32 NumNearby = OutConsiderList.Num();
+	auto AddFarActor = [&NetworkObjectList, &RelevancyGrid, &ConnectionViewers, &OutConsiderList, NumNearby]( const AActor* Actor )
+	{
+		// Only the actor's info is needed, don't copy the shared pointer as this can run on several threads at once
+		const TSharedPtr<FNetworkObjectInfo>* ActorInfo = Actor ? NetworkObjectList.GetAllObjects().Find( Actor ) : nullptr;
+		if ( ActorInfo && FNetworkRelevancyGrid::IsInCell( **ActorInfo ) && !RelevancyGrid.IsInNearbyCell( **ActorInfo, ConnectionViewers ) )
+		{
+			// Actors outside the nearby cells can only have been added by this, and there are few of them
+			for ( int32 Index = NumNearby; Index < OutConsiderList.Num(); Index++ )
+			{
+				if ( OutConsiderList[Index] == ActorInfo->Get() )
+				{
+					return;
+				}
+			}
+			OutConsiderList.Add( ActorInfo->Get() );
+		}
+	};
+
+	// A view target is relevant to its viewer however far the camera is
+	for ( const FNetViewer& Viewer : ConnectionViewers )
+	{
+		AddFarActor( Viewer.ViewTarget );
+		AddFarActor( Viewer.InViewer );
+	}
+
+	// Actors with a channel are always visited, to keep them updated or close the channel once they stop being relevant
+	for ( FActorChannelMap::TConstIterator It = Connection->ActorChannelConstIterator(); It; ++It )
+	{
+		if ( const UActorChannel* Channel = It.Value() )
+		{
+			AddFarActor( Channel->Actor );
+		}
+	}
+
+	// Only keep the actors considered for replication this frame
+	OutConsiderList.RemoveAll( [ReplicationFrame]( const FNetworkObjectInfo* ActorInfo ) { return ActorInfo->ConsiderListFrame != ReplicationFrame; } );
+}
+
+// Returns true if the actor is in a grid cell but not in the nearby actors FNetReplicationPolicy keeps for the connection, and so too far to be relevant
+static FORCEINLINE_DEBUGGABLE bool IsActorCulledByNearbyActors( const FNetworkObjectInfo* ActorInfo, const TSet<const FNetworkObjectInfo*>& NearbyActors, const TArray<FNetViewer>& ConnectionViewers )
+{
+	if ( !FNetworkRelevancyGrid::IsInCell( *ActorInfo ) || NearbyActors.Contains( ActorInfo ) )
+	{
+		return false;
+	}
+
+	for ( const FNetViewer& Viewer : ConnectionViewers )
+	{
+		if ( ActorInfo->Actor == Viewer.ViewTarget || ActorInfo->Actor == Viewer.InViewer )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 // Returns true if this actor is owned by, and should replicate to *any* of the passed in connections
 static FORCEINLINE_DEBUGGABLE UNetConnection* IsActorOwnedByAndRelevantToConnection( const AActor* Actor, const TArray<FNetViewer>& ConnectionViewers, bool& bOutHasNullViewTarget )
 {
@@ -4282,6 +4558,7 @@ int32 UNetDriver::ServerReplicateActors_PrioritizeActors( UNetConnection* Connec
 
 	int32 FinalSortedCount = 0;
 	int32 DeletedCount = 0;
+	int32 RelevancyGridCulledCount = 0;
 
 	// Make weak ptr once for IsActorDormant call
 	TWeakObjectPtr<UNetConnection> WeakConnection(Connection);
@@ -4297,7 +4574,16 @@ int32 UNetDriver::ServerReplicateActors_PrioritizeActors( UNetConnection* Connec
 		AGameNetworkManager* const NetworkManager = World->NetworkManager;
 		const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
 
-		for ( FNetworkObjectInfo* ActorInfo : ConsiderList )
+		// With net.RelevancyGrid, only visit the considered actors near this connection's viewers instead of distance checking every actor
+		const bool bUseRelevancyGrid = ShouldUseRelevancyGrid();
+		TArray<FNetworkObjectInfo*> NearbyConsiderList;
+		if ( bUseRelevancyGrid )
+		{
+			GatherRelevancyGridConsiderList( GetNetworkObjectList(), Connection, ConnectionViewers, ReplicationFrame, NearbyConsiderList );
+			RelevancyGridCulledCount = ConsiderList.Num() - NearbyConsiderList.Num();
+		}
+
+		for ( FNetworkObjectInfo* ActorInfo : bUseRelevancyGrid ? NearbyConsiderList : ConsiderList )
 		{
 			AActor* Actor = ActorInfo->Actor;
 
@@ -4400,10 +4686,326 @@ int32 UNetDriver::ServerReplicateActors_PrioritizeActors( UNetConnection* Connec
 	// Setup stats
 	SET_DWORD_STAT( STAT_PrioritizedActors, FinalSortedCount );
 	SET_DWORD_STAT( STAT_NumRelevantDeletedActors, DeletedCount );
+	INC_DWORD_STAT_BY( STAT_NumRelevancyGridCulledActors, RelevancyGridCulledCount );
 
 	return FinalSortedCount;
 }
 
+int32 UNetDriver::ServerReplicateActors_PrioritizeActorsFromPolicy( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*>& ConsiderList, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors )
+{
+	SCOPE_CYCLE_COUNTER( STAT_NetPrioritizeActorsTime );
+
+	// Mirrors ServerReplicateActors_PrioritizeActors, but culls with the nearby actors the policy keeps for the connection.
+	// The consider list only holds the actors due this frame, so sorting it stays cheap.
+	NetTag++;
+
+	for ( int32 j = 0; j < Connection->SentTemporaries.Num(); j++ )
+	{
+		Connection->SentTemporaries[j]->NetTag = NetTag;
+	}
+
+	check( World == Connection->OwningActor->GetWorld() );
+
+	int32 FinalSortedCount = 0;
+	int32 DeletedCount = 0;
+	int32 RelevancyGridCulledCount = 0;
+
+	TWeakObjectPtr<UNetConnection> WeakConnection(Connection);
+
+	const int32 MaxSortedActors = ConsiderList.Num() + DestroyedStartupOrDormantActors.Num();
+	if ( MaxSortedActors > 0 )
+	{
+		OutPriorityList = new ( FMemStack::Get(), MaxSortedActors ) FActorPriority;
+		OutPriorityActors = new ( FMemStack::Get(), MaxSortedActors ) FActorPriority*;
+
+		check( World == Connection->ViewTarget->GetWorld() );
+
+		AGameNetworkManager* const NetworkManager = World->NetworkManager;
+		const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
+
+		const FNetworkRelevancyGrid& RelevancyGrid = GetNetworkObjectList().GetRelevancyGrid();
+		const bool bUseRelevancyGrid = RelevancyGrid.GetNumObjects() > 0;
+		const TSet<const FNetworkObjectInfo*>* NearbyActors = bUseRelevancyGrid ? &ReplicationPolicy->GetNearbyActors( Connection, ConnectionViewers, RelevancyGrid ) : nullptr;
+
+		for ( FNetworkObjectInfo* ActorInfo : ConsiderList )
+		{
+			AActor* Actor = ActorInfo->Actor;
+
+			UActorChannel* Channel = Connection->FindActorChannelRef( ActorInfo->WeakActor );
+
+			if ( !Channel )
+			{
+				if ( !IsLevelInitializedForActor( Actor, Connection ) )
+				{
+					continue;
+				}
+
+				if ( NearbyActors && IsActorCulledByNearbyActors( ActorInfo, *NearbyActors, ConnectionViewers ) )
+				{
+					RelevancyGridCulledCount++;
+					continue;
+				}
+
+				if ( !IsActorRelevantToConnection( Actor, ConnectionViewers ) )
+				{
+					continue;
+				}
+			}
+
+			UNetConnection* PriorityConnection = Connection;
+
+			if ( Actor->bOnlyRelevantToOwner )
+			{
+				bool bHasNullViewTarget = false;
+
+				PriorityConnection = IsActorOwnedByAndRelevantToConnection( Actor, ConnectionViewers, bHasNullViewTarget );
+
+				if ( PriorityConnection == nullptr )
+				{
+					if ( !bHasNullViewTarget && Channel != NULL && ElapsedTime - Channel->RelevantTime >= RelevantTimeout )
+					{
+						Channel->Close(EChannelCloseReason::Relevancy);
+					}
+
+					continue;
+				}
+			}
+			else if ( GSetNetDormancyEnabled != 0 )
+			{
+				if ( IsActorDormant( ActorInfo, WeakConnection ) )
+				{
+					continue;
+				}
+
+				if ( ShouldActorGoDormant( Actor, ConnectionViewers, Channel, ElapsedTime, bLowNetBandwidth ) )
+				{
+					Channel->StartBecomingDormant();
+				}
+			}
+
+			if ( Actor->NetTag != NetTag )
+			{
+				Actor->NetTag = NetTag;
+
+				OutPriorityList[FinalSortedCount] = FActorPriority( PriorityConnection, Channel, ActorInfo, ConnectionViewers, bLowNetBandwidth );
+				OutPriorityActors[FinalSortedCount] = OutPriorityList + FinalSortedCount;
+
+				FinalSortedCount++;
+
+				if ( DebugRelevantActors )
+				{
+					LastPrioritizedActors.Add( Actor );
+				}
+			}
+		}
+
+		for ( auto It = Connection->GetDestroyedStartupOrDormantActorGUIDs().CreateConstIterator(); It; ++It )
+		{
+			FActorDestructionInfo& DInfo = *DestroyedStartupOrDormantActors.FindChecked( *It );
+			OutPriorityList[FinalSortedCount] = FActorPriority( Connection, &DInfo, ConnectionViewers );
+			OutPriorityActors[FinalSortedCount] = OutPriorityList + FinalSortedCount;
+			FinalSortedCount++;
+			DeletedCount++;
+		}
+
+		// Sort by priority, actors left out when the connection saturates ask for an update on the next frame
+		Sort( OutPriorityActors, FinalSortedCount, FCompareFActorPriority() );
+	}
+
+	UE_LOG( LogNetTraffic, Log, TEXT( "ServerReplicateActors_PrioritizeActorsFromPolicy: Potential %04i ConsiderList %03i FinalSortedCount %03i" ), MaxSortedActors, ConsiderList.Num(), FinalSortedCount );
+
+	SET_DWORD_STAT( STAT_PrioritizedActors, FinalSortedCount );
+	SET_DWORD_STAT( STAT_NumRelevantDeletedActors, DeletedCount );
+	INC_DWORD_STAT_BY( STAT_NumRelevancyGridCulledActors, RelevancyGridCulledCount );
+
+	return FinalSortedCount;
+}
+
+void UNetDriver::UpdateReplicationPolicy()
+{
+	if ( GNetReplicationPolicy != 0 )
+	{
+		if ( !ReplicationPolicy.IsValid() )
+		{
+			ReplicationPolicy = CreateReplicationPolicy();
+		}
+	}
+	else if ( ReplicationPolicy.IsValid() )
+	{
+		ReplicationPolicy.Reset();
+		GetNetworkObjectList().SetUpdateScheduleEnabled( false );
+		GetNetworkObjectList().GetRelevancyGrid().SetTrackChanges( false );
+	}
+}
+
+bool UNetDriver::ShouldPrioritizeActorsInParallel( const int32 NumClientsToTick, const bool bCPUSaturated ) const
+{
+	// Debug relevancy output is gathered while prioritizing and isn't thread safe, and the replication policy keeps per-connection state.
+	// When the server is already behind, the worker threads are busy with the rest of the frame too, so don't add a wait on them.
+	return GNetParallelPrioritizeActors != 0 && !bCPUSaturated && !DebugRelevantActors && !ReplicationPolicy.IsValid() && NumClientsToTick >= FMath::Max(GNetParallelPrioritizeActorsMinConnections, 2) && FApp::ShouldUseThreadingForPerformance();
+}
+
+// Adds the viewers a connection replicates to, the connection itself and its children with a view target
+static void GatherConnectionViewers( UNetConnection* Connection, const float DeltaSeconds, TArray<FNetViewer>& OutConnectionViewers )
+{
+	new( OutConnectionViewers )FNetViewer( Connection, DeltaSeconds );
+	for ( int32 ViewerIndex = 0; ViewerIndex < Connection->Children.Num(); ViewerIndex++ )
+	{
+		if ( Connection->Children[ViewerIndex]->ViewTarget != NULL )
+		{
+			new( OutConnectionViewers )FNetViewer( Connection->Children[ViewerIndex], DeltaSeconds );
+		}
+	}
+}
+
+void UNetDriver::ServerReplicateActors_PrioritizeActorsParallel( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*>& ConsiderList, FConnectionPrioritizedActors& OutResult ) const
+{
+	// Mirrors ServerReplicateActors_PrioritizeActors, but uses a local set instead of Actor->NetTag to skip temporaries
+	// and records channel changes instead of making them, so several connections can be prioritized at once.
+	OutResult.Reset();
+
+	const int32 MaxSortedActors = ConsiderList.Num() + Connection->GetDestroyedStartupOrDormantActorGUIDs().Num();
+	if ( MaxSortedActors == 0 )
+	{
+		return;
+	}
+
+	OutResult.SentTemporaries.Reserve( Connection->SentTemporaries.Num() );
+	for ( const AActor* SentTemporary : Connection->SentTemporaries )
+	{
+		OutResult.SentTemporaries.Add( SentTemporary );
+	}
+
+	// Reserve up front, PriorityActors points into PriorityList
+	OutResult.PriorityList.Reserve( MaxSortedActors );
+	OutResult.PriorityActors.Reserve( MaxSortedActors );
+
+	TWeakObjectPtr<UNetConnection> WeakConnection(Connection);
+
+	AGameNetworkManager* const NetworkManager = World->NetworkManager;
+	const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
+
+	// The grid isn't modified while prioritizing, so it can be read from several connections at once
+	const bool bUseRelevancyGrid = ShouldUseRelevancyGrid();
+	TArray<FNetworkObjectInfo*> NearbyConsiderList;
+	if ( bUseRelevancyGrid )
+	{
+		GatherRelevancyGridConsiderList( GetNetworkObjectList(), Connection, ConnectionViewers, ReplicationFrame, NearbyConsiderList );
+		OutResult.NumRelevancyGridCulledActors = ConsiderList.Num() - NearbyConsiderList.Num();
+	}
+
+	for ( FNetworkObjectInfo* ActorInfo : bUseRelevancyGrid ? NearbyConsiderList : ConsiderList )
+	{
+		const AActor* Actor = ActorInfo->Actor;
+
+		// Overrides of the relevancy and priority virtuals aren't thread safe unless the actor says so, and owner relevancy calls into other actors
+		if ( !Actor->bParallelNetPrioritization || Actor->bOnlyRelevantToOwner || Actor->bNetUseOwnerRelevancy )
+		{
+			OutResult.GameThreadActors.Add( ActorInfo );
+			continue;
+		}
+
+		PrioritizeActorParallel( Connection, WeakConnection, ConnectionViewers, ActorInfo, bLowNetBandwidth, OutResult );
+	}
+
+	// Add in deleted actors
+	for ( auto It = Connection->GetDestroyedStartupOrDormantActorGUIDs().CreateConstIterator(); It; ++It )
+	{
+		FActorDestructionInfo& DInfo = *DestroyedStartupOrDormantActors.FindChecked( *It );
+		const int32 PriorityIndex = OutResult.PriorityList.Emplace( Connection, &DInfo, ConnectionViewers );
+		OutResult.PriorityActors.Add( &OutResult.PriorityList[PriorityIndex] );
+		OutResult.NumDeletedActors++;
+	}
+
+	// Sort by priority, unless the game thread still has actors to add
+	if ( OutResult.GameThreadActors.Num() == 0 )
+	{
+		Sort( OutResult.PriorityActors.GetData(), OutResult.PriorityActors.Num(), FCompareFActorPriority() );
+	}
+}
+
+void UNetDriver::ServerReplicateActors_FinishPrioritizeActorsParallel( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FConnectionPrioritizedActors& InOutResult ) const
+{
+	check( IsInGameThread() );
+
+	if ( InOutResult.GameThreadActors.Num() == 0 )
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UNetConnection> WeakConnection(Connection);
+
+	AGameNetworkManager* const NetworkManager = World->NetworkManager;
+	const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
+
+	for ( FNetworkObjectInfo* ActorInfo : InOutResult.GameThreadActors )
+	{
+		PrioritizeActorParallel( Connection, WeakConnection, ConnectionViewers, ActorInfo, bLowNetBandwidth, InOutResult );
+	}
+	InOutResult.GameThreadActors.Reset();
+
+	// Sort by priority
+	Sort( InOutResult.PriorityActors.GetData(), InOutResult.PriorityActors.Num(), FCompareFActorPriority() );
+}
+
+void UNetDriver::PrioritizeActorParallel( UNetConnection* Connection, const TWeakObjectPtr<UNetConnection>& WeakConnection, const TArray<FNetViewer>& ConnectionViewers, FNetworkObjectInfo* ActorInfo, const bool bLowNetBandwidth, FConnectionPrioritizedActors& Result ) const
+{
+	AActor* Actor = ActorInfo->Actor;
+
+	UActorChannel* Channel = Connection->FindActorChannelRef( ActorInfo->WeakActor );
+
+	if ( !Channel )
+	{
+		if ( !IsLevelInitializedForActor( Actor, Connection ) )
+		{
+			return;
+		}
+
+		if ( !IsActorRelevantToConnection( Actor, ConnectionViewers ) )
+		{
+			return;
+		}
+	}
+
+	UNetConnection* PriorityConnection = Connection;
+
+	if ( Actor->bOnlyRelevantToOwner )
+	{
+		bool bHasNullViewTarget = false;
+
+		PriorityConnection = IsActorOwnedByAndRelevantToConnection( Actor, ConnectionViewers, bHasNullViewTarget );
+
+		if ( PriorityConnection == nullptr )
+		{
+			if ( !bHasNullViewTarget && Channel != NULL && ElapsedTime - Channel->RelevantTime >= RelevantTimeout )
+			{
+				Result.ChannelsToClose.Add( Channel );
+			}
+
+			return;
+		}
+	}
+	else if ( GSetNetDormancyEnabled != 0 )
+	{
+		if ( IsActorDormant( ActorInfo, WeakConnection ) )
+		{
+			return;
+		}
+
+		if ( ShouldActorGoDormant( Actor, ConnectionViewers, Channel, ElapsedTime, bLowNetBandwidth ) )
+		{
+			Result.ChannelsToStartDormancy.Add( Channel );
+		}
+	}
+
+	if ( !Result.SentTemporaries.Contains( Actor ) )
+	{
+		check( Result.PriorityList.Num() < Result.PriorityList.Max() );
+		const int32 PriorityIndex = Result.PriorityList.Emplace( PriorityConnection, Channel, ActorInfo, ConnectionViewers, bLowNetBandwidth );
+		Result.PriorityActors.Add( &Result.PriorityList[PriorityIndex] );
+	}
+}
+
 int32 UNetDriver::ServerReplicateActors_ProcessPrioritizedActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FActorPriority** PriorityActors, const int32 FinalSortedCount, int32& OutUpdated )
 {
 	SCOPE_CYCLE_COUNTER(STAT_NetProcessPrioritizedActorsTime);
@@ -4698,6 +5300,7 @@ DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization RPC Hit"), STAT_SharedSeria
 DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization RPC Miss"), STAT_SharedSerializationRPCMiss, STATGROUP_Net);
 
 DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Property Hit"), STAT_SharedSerializationPropertyHit, STATGROUP_Net);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Changelist Hit"), STAT_SharedSerializationChangelistHit, STATGROUP_Net);
 DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Property Miss"), STAT_SharedSerializationPropertyMiss, STATGROUP_Net);
 
 struct FReplicationAutoCapture
@@ -4806,10 +5409,12 @@ struct FScopedNetDriverStats
 
 			SET_DWORD_STAT(STAT_SharedSerializationPropertyHit, GNumSharedSerializationHit);
 			SET_DWORD_STAT(STAT_SharedSerializationPropertyMiss, GNumSharedSerializationMiss);
+			SET_DWORD_STAT(STAT_SharedSerializationChangelistHit, GNumSharedChangelistHit);
 
 			// Note: we want to reset this at the end of the frame since the RPC stats are incremented at the top (recv)
 			GNumSharedSerializationHit = 0;
 			GNumSharedSerializationMiss = 0;
+			GNumSharedChangelistHit = 0;
 			GNumClientUpdateLevelVisibility = 0;
 		}
 	}
@@ -4851,6 +5456,8 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 	check( World );
 
+	UpdateReplicationPolicy();
+
 	// Bump the ReplicationFrame value to invalidate any properties marked as "unchanged" for this frame.
 	ReplicationFrame++;
 
@@ -4882,12 +5489,53 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 	ConsiderList.Reserve( GetNetworkObjectList().GetActiveObjects().Num() );
 
 	// Build the consider list (actors that are ready to replicate)
-	ServerReplicateActors_BuildConsiderList( ConsiderList, ServerTickTime );
+	if ( ReplicationPolicy.IsValid() )
+	{
+		ServerReplicateActors_BuildConsiderListFromPolicy( ConsiderList, ServerTickTime );
+	}
+	else
+	{
+		ServerReplicateActors_BuildConsiderList( ConsiderList, ServerTickTime );
+	}
 
 	TSet<UNetConnection*> ConnectionsToClose;
 
 	FMemMark Mark( FMemStack::Get() );
 
+	// With net.ParallelPrioritizeActors, build the sorted actor list of every connection that will be ticked this frame up front on worker threads.
+	// Replicating the actors, and any changes prioritization wants to make to channels, still happens one connection at a time below.
+	const bool bParallelPrioritize = ShouldPrioritizeActorsInParallel( NumClientsToTick, bCPUSaturated );
+	TArray<TArray<FNetViewer>> ParallelConnectionViewers;
+	TArray<FConnectionPrioritizedActors> ParallelPrioritizedActors;
+	if ( bParallelPrioritize )
+	{
+		SCOPE_CYCLE_COUNTER( STAT_NetParallelPrioritizeActorsTime );
+
+		ParallelConnectionViewers.SetNum( NumClientsToTick );
+		ParallelPrioritizedActors.SetNum( NumClientsToTick );
+
+		// Viewers call into the player controllers, so gather them on the game thread
+		for ( int32 i = 0; i < NumClientsToTick; i++ )
+		{
+			UNetConnection* Connection = ClientConnections[i];
+			if ( Connection->ViewTarget )
+			{
+				check( World == Connection->OwningActor->GetWorld() );
+				check( World == Connection->ViewTarget->GetWorld() );
+
+				GatherConnectionViewers( Connection, DeltaSeconds, ParallelConnectionViewers[i] );
+			}
+		}
+
+		ParallelFor( NumClientsToTick, [this, &ConsiderList, &ParallelConnectionViewers, &ParallelPrioritizedActors]( int32 ConnectionIndex )
+		{
+			if ( ParallelConnectionViewers[ConnectionIndex].Num() > 0 )
+			{
+				ServerReplicateActors_PrioritizeActorsParallel( ClientConnections[ConnectionIndex], ParallelConnectionViewers[ConnectionIndex], ConsiderList, ParallelPrioritizedActors[ConnectionIndex] );
+			}
+		});
+	}
+
 	for ( int32 i=0; i < ClientConnections.Num(); i++ )
 	{
 		UNetConnection* Connection = ClientConnections[i];
@@ -4929,6 +5577,11 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 						//UE_LOG(LogNet, Log, TEXT("flagging %s for a future update"),*Actor->GetName());
 						// flag it for a pending update
 						ConsiderList[ConsiderIdx]->bPendingNetUpdate = true;
+
+						if ( ReplicationPolicy.IsValid() )
+						{
+							ReplicationPolicy->RequestUpdate( *ConsiderList[ConsiderIdx] );
+						}
 					}
 				}
 			}
@@ -4940,17 +5593,21 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 			const int32 LocalNumSaturated = GNumSaturatedConnections;
 
+			// Use the result from the worker threads if this connection was prioritized up front
+			const bool bUseParallelPriorities = bParallelPrioritize && ParallelConnectionViewers[i].Num() > 0;
+
 			// Make a list of viewers this connection should consider (this connection and children of this connection)
 			TArray<FNetViewer>& ConnectionViewers = WorldSettings->ReplicationViewers;
 
+			// Viewers are only gathered once a frame, prioritizing on worker threads already did it for this connection
 			ConnectionViewers.Reset();
-			new( ConnectionViewers )FNetViewer( Connection, DeltaSeconds );
-			for ( int32 ViewerIndex = 0; ViewerIndex < Connection->Children.Num(); ViewerIndex++ )
+			if ( bUseParallelPriorities )
 			{
-				if ( Connection->Children[ViewerIndex]->ViewTarget != NULL )
-				{
-					new( ConnectionViewers )FNetViewer( Connection->Children[ViewerIndex], DeltaSeconds );
-				}
+				ConnectionViewers = MoveTemp( ParallelConnectionViewers[i] );
+			}
+			else
+			{
+				GatherConnectionViewers( Connection, DeltaSeconds, ConnectionViewers );
 			}
 
 			// send ClientAdjustment if necessary
@@ -4973,8 +5630,42 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 			FActorPriority* PriorityList	= NULL;
 			FActorPriority** PriorityActors = NULL;
 
-			// Get a sorted list of actors for this connection
-			const int32 FinalSortedCount = ServerReplicateActors_PrioritizeActors( Connection, ConnectionViewers, ConsiderList, bCPUSaturated, PriorityList, PriorityActors );
+			int32 FinalSortedCount = 0;
+			if ( bUseParallelPriorities )
+			{
+				FConnectionPrioritizedActors& PrioritizedActors = ParallelPrioritizedActors[i];
+
+				// Actors that didn't opt into bParallelNetPrioritization are prioritized here, where calling into game code is safe
+				ServerReplicateActors_FinishPrioritizeActorsParallel( Connection, ConnectionViewers, PrioritizedActors );
+
+				// Apply the channel changes prioritization deferred
+				for ( UActorChannel* Channel : PrioritizedActors.ChannelsToClose )
+				{
+					Channel->Close( EChannelCloseReason::Relevancy );
+				}
+
+				for ( UActorChannel* Channel : PrioritizedActors.ChannelsToStartDormancy )
+				{
+					Channel->StartBecomingDormant();
+				}
+
+				PriorityActors = PrioritizedActors.PriorityActors.GetData();
+				FinalSortedCount = PrioritizedActors.PriorityActors.Num();
+
+				SET_DWORD_STAT( STAT_PrioritizedActors, FinalSortedCount );
+				SET_DWORD_STAT( STAT_NumRelevantDeletedActors, PrioritizedActors.NumDeletedActors );
+				INC_DWORD_STAT_BY( STAT_NumRelevancyGridCulledActors, PrioritizedActors.NumRelevancyGridCulledActors );
+			}
+			else if ( ReplicationPolicy.IsValid() )
+			{
+				// Get the relevant actors for this connection, in the order the policy considered them
+				FinalSortedCount = ServerReplicateActors_PrioritizeActorsFromPolicy( Connection, ConnectionViewers, ConsiderList, PriorityList, PriorityActors );
+			}
+			else
+			{
+				// Get a sorted list of actors for this connection
+				FinalSortedCount = ServerReplicateActors_PrioritizeActors( Connection, ConnectionViewers, ConsiderList, bCPUSaturated, PriorityList, PriorityActors );
+			}
 
 			// Process the sorted list of actors for this connection
 			const int32 LastProcessedActor = ServerReplicateActors_ProcessPrioritizedActors( Connection, ConnectionViewers, PriorityActors, FinalSortedCount, Updated );
@@ -4997,12 +5688,22 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				{
 					UE_LOG(LogNetTraffic, Log, TEXT(" Saturated. Mark %s NetUpdateTime to be checked for next tick"), *Actor->GetName());
 					PriorityActors[k]->ActorInfo->bPendingNetUpdate = true;
+
+					if ( ReplicationPolicy.IsValid() )
+					{
+						ReplicationPolicy->RequestUpdate( *PriorityActors[k]->ActorInfo );
+					}
 				}
 				else if ( IsActorRelevantToConnection( Actor, ConnectionViewers ) )
 				{
 					// If this actor was relevant but didn't get processed, force another update for next frame
 					UE_LOG( LogNetTraffic, Log, TEXT( " Saturated. Mark %s NetUpdateTime to be checked for next tick" ), *Actor->GetName() );
 					PriorityActors[k]->ActorInfo->bPendingNetUpdate = true;
+
+					if ( ReplicationPolicy.IsValid() )
+					{
+						ReplicationPolicy->RequestUpdate( *PriorityActors[k]->ActorInfo );
+					}
 					if ( Channel != NULL )
 					{
 						Channel->RelevantTime = ElapsedTime + 0.5 * UpdateDelayRandomStream.FRand();
@@ -5478,6 +6179,11 @@ void UNetDriver::RemoveClientConnection(UNetConnection* ClientConnectionToRemove
 		ReplicationDriver->RemoveClientConnection(ClientConnectionToRemove);
 	}
 
+	if (ReplicationPolicy.IsValid())
+	{
+		ReplicationPolicy->RemoveConnection(ClientConnectionToRemove);
+	}
+
 	bHasReplayConnection = false;
 
 	for (UNetConnection* ClientConn : ClientConnections)
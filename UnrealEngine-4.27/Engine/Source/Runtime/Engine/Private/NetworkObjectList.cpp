@@ -4,7 +4,9 @@
 #include "Engine/Engine.h"
 #include "Engine/Level.h"
 #include "EngineUtils.h"
+#include "GameFramework/WorldSettings.h"
 #include "Serialization/Archive.h"
+#include "Algo/BinarySearch.h"
 
 void FNetworkObjectList::AddInitialObjects(UWorld* const World, const FName NetDriverName)
 {
@@ -76,6 +78,12 @@ TSharedPtr<FNetworkObjectInfo>* FNetworkObjectList::FindOrAdd(AActor* const Acto
 			NetworkObjectInfo = &AllNetworkObjects[AllNetworkObjects.Emplace(new FNetworkObjectInfo(Actor))];
 			ActiveNetworkObjects.Add(*NetworkObjectInfo);
 
+			if (bUpdateScheduleEnabled)
+			{
+				// Visited every frame until it is considered and moved to the bucket for its update frequency
+				UpdateSchedule.Update(*NetworkObjectInfo->Get(), 1);
+			}
+
 			UE_LOG(LogNetDormancy, VeryVerbose, TEXT("FNetworkObjectList::Add: Adding actor. Actor: %s, Total: %i, Active: %i, NetDriverName: %s"), *Actor->GetName(), AllNetworkObjects.Num(), ActiveNetworkObjects.Num(), *NetDriver->NetDriverName.ToString());
 
 			if (OutWasAdded)
@@ -134,6 +142,9 @@ void FNetworkObjectList::Remove(AActor* const Actor)
 		NumDormantObjectsPerConnectionRef--;
 	}
 
+	RelevancyGrid.Remove(*NetworkObjectInfo);
+	UpdateSchedule.Remove(*NetworkObjectInfo);
+
 	// Remove this object from all lists
 	AllNetworkObjects.Remove(Actor);
 	ActiveNetworkObjects.Remove(Actor);
@@ -345,9 +356,56 @@ void FNetworkObjectList::ForceActorRelevantNextUpdate(AActor* const Actor, UNetD
 	NetworkObjectInfo->ForceRelevantFrame = NetDriver->ReplicationFrame + 1;
 }
 
+void FNetworkObjectList::SetUpdateScheduleEnabled(const bool bEnabled)
+{
+	if (bEnabled == bUpdateScheduleEnabled)
+	{
+		return;
+	}
+
+	bUpdateScheduleEnabled = bEnabled;
+	UpdateSchedule.Reset();
+
+	if (bEnabled)
+	{
+		for (const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : AllNetworkObjects)
+		{
+			UpdateSchedule.Update(*ObjectInfo, 1);
+		}
+	}
+}
+
+void FNetworkObjectList::UpdateRelevancyGridSlice(const int32 NumFrames)
+{
+	const int32 MaxIndex = ActiveNetworkObjects.GetMaxIndex();
+	if (RelevancyGridSliceIndex >= MaxIndex)
+	{
+		RelevancyGridSliceIndex = 0;
+	}
+
+	const int32 EndIndex = FMath::Min(RelevancyGridSliceIndex + FMath::DivideAndRoundUp(MaxIndex, FMath::Max(NumFrames, 1)), MaxIndex);
+	for (int32 Index = RelevancyGridSliceIndex; Index < EndIndex; ++Index)
+	{
+		const FSetElementId ElementId = FSetElementId::FromInteger(Index);
+		if (ActiveNetworkObjects.IsValidId(ElementId))
+		{
+			FNetworkObjectInfo& ObjectInfo = *ActiveNetworkObjects[ElementId];
+			if (ObjectInfo.Actor && !ObjectInfo.Actor->IsPendingKillPending())
+			{
+				RelevancyGrid.Update(ObjectInfo);
+			}
+		}
+	}
+
+	RelevancyGridSliceIndex = EndIndex;
+}
+
 void FNetworkObjectList::Reset()
 {
 	// Reset all state
+	RelevancyGrid.Reset();
+	RelevancyGridSliceIndex = 0;
+	UpdateSchedule.Reset();
 	AllNetworkObjects.Empty();
 	ActiveNetworkObjects.Empty();
 	ObjectsDormantOnAllConnections.Empty();
@@ -371,6 +429,8 @@ void FNetworkObjectList::CountBytes(FArchive& Ar) const
 	ActiveNetworkObjects.CountBytes(Ar);
 	ObjectsDormantOnAllConnections.CountBytes(Ar);
 	NumDormantObjectsPerConnection.CountBytes(Ar);
+	RelevancyGrid.CountBytes(Ar);
+	UpdateSchedule.CountBytes(Ar);
  
 	// ObjectsDormantOnAllConnections and ActiveNetworkObjects are both sub sets of AllNetworkObjects
 	// and only have pointers back to the data there.
@@ -383,4 +443,442 @@ void FNetworkObjectList::CountBytes(FArchive& Ar) const
 			Info->CountBytes(Ar);
 		}
 	}
-}
\ No newline at end of file
+}
+
+FNetworkRelevancyGrid::FNetworkRelevancyGrid()
+	: bTrackChanges(false)
+	, bResetSinceChangesCleared(false)
+	, NumCellObjects(0)
+	, CellSize(10000.0f)
+	, QueryRadius(15000.0f)
+{
+}
+
+void FNetworkRelevancyGrid::SetCellSizeAndQueryRadius(const float InCellSize, const float InQueryRadius)
+{
+	const float NewCellSize = FMath::Max(InCellSize, 100.0f);
+	const float NewQueryRadius = FMath::Max(InQueryRadius, 0.0f);
+
+	if (NewCellSize != CellSize || NewQueryRadius != QueryRadius)
+	{
+		// Objects are added back as they are considered for replication
+		Reset();
+		CellSize = NewCellSize;
+		QueryRadius = NewQueryRadius;
+	}
+}
+
+FIntPoint FNetworkRelevancyGrid::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FNetworkRelevancyGrid::Update(FNetworkObjectInfo& ObjectInfo)
+{
+	const AActor* Actor = ObjectInfo.Actor;
+	const USceneComponent* RootComponent = Actor->GetRootComponent();
+
+	// Mirrors the early outs of AActor::IsNetRelevantFor, anything that can be relevant without being close to the viewer stays out of the cells
+	ENetRelevancyGridList NewList = ENetRelevancyGridList::Cell;
+	if (Actor->bAlwaysRelevant || RootComponent == nullptr || Actor->NetCullDistanceSquared > FMath::Square(QueryRadius))
+	{
+		NewList = ENetRelevancyGridList::AlwaysRelevant;
+	}
+	else if (Actor->bOnlyRelevantToOwner || Actor->bNetUseOwnerRelevancy || Actor->GetOwner() != nullptr || Actor->GetInstigator() != nullptr || RootComponent->GetAttachParent() != nullptr)
+	{
+		NewList = ENetRelevancyGridList::OwnerRelevant;
+	}
+
+	const ENetRelevancyGridList OldList = ObjectInfo.RelevancyGridList;
+	const FIntPoint OldCell = ObjectInfo.RelevancyGridCell;
+
+	if (NewList == ENetRelevancyGridList::Cell)
+	{
+		const FIntPoint NewCell = GetCell(RootComponent->GetComponentLocation());
+		if (OldList == ENetRelevancyGridList::Cell && OldCell == NewCell)
+		{
+			// Hasn't left its cell
+			return;
+		}
+
+		RemoveFromList(ObjectInfo);
+		Cells.FindOrAdd(NewCell).Add(&ObjectInfo);
+		ObjectInfo.RelevancyGridCell = NewCell;
+		NumCellObjects++;
+	}
+	else if (NewList != OldList)
+	{
+		RemoveFromList(ObjectInfo);
+		if (NewList == ENetRelevancyGridList::AlwaysRelevant)
+		{
+			AlwaysRelevantObjects.Add(&ObjectInfo);
+		}
+		else
+		{
+			OwnerRelevantObjects.Add(&ObjectInfo);
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	ObjectInfo.RelevancyGridList = NewList;
+	RecordChange(ObjectInfo, OldList, OldCell);
+}
+
+void FNetworkRelevancyGrid::Remove(FNetworkObjectInfo& ObjectInfo)
+{
+	const ENetRelevancyGridList OldList = ObjectInfo.RelevancyGridList;
+	if (OldList != ENetRelevancyGridList::None)
+	{
+		RemoveFromList(ObjectInfo);
+		RecordChange(ObjectInfo, OldList, ObjectInfo.RelevancyGridCell);
+	}
+}
+
+void FNetworkRelevancyGrid::RemoveFromList(FNetworkObjectInfo& ObjectInfo)
+{
+	switch (ObjectInfo.RelevancyGridList)
+	{
+		case ENetRelevancyGridList::Cell:
+		{
+			TArray<FNetworkObjectInfo*>* CellObjects = Cells.Find(ObjectInfo.RelevancyGridCell);
+			if (ensure(CellObjects != nullptr))
+			{
+				CellObjects->RemoveSingleSwap(&ObjectInfo, false);
+				if (CellObjects->Num() == 0)
+				{
+					Cells.Remove(ObjectInfo.RelevancyGridCell);
+				}
+			}
+			NumCellObjects--;
+			break;
+		}
+
+		case ENetRelevancyGridList::AlwaysRelevant:
+			AlwaysRelevantObjects.Remove(&ObjectInfo);
+			break;
+
+		case ENetRelevancyGridList::OwnerRelevant:
+			OwnerRelevantObjects.Remove(&ObjectInfo);
+			break;
+
+		default:
+			break;
+	}
+
+	ObjectInfo.RelevancyGridList = ENetRelevancyGridList::None;
+}
+
+void FNetworkRelevancyGrid::Reset()
+{
+	for (TPair<FIntPoint, TArray<FNetworkObjectInfo*>>& Cell : Cells)
+	{
+		for (FNetworkObjectInfo* ObjectInfo : Cell.Value)
+		{
+			ObjectInfo->RelevancyGridList = ENetRelevancyGridList::None;
+		}
+	}
+
+	for (FNetworkObjectInfo* ObjectInfo : AlwaysRelevantObjects)
+	{
+		ObjectInfo->RelevancyGridList = ENetRelevancyGridList::None;
+	}
+
+	for (FNetworkObjectInfo* ObjectInfo : OwnerRelevantObjects)
+	{
+		ObjectInfo->RelevancyGridList = ENetRelevancyGridList::None;
+	}
+
+	Cells.Reset();
+	AlwaysRelevantObjects.Reset();
+	OwnerRelevantObjects.Reset();
+	NumCellObjects = 0;
+
+	if (bTrackChanges)
+	{
+		Changes.Reset();
+		bResetSinceChangesCleared = true;
+	}
+}
+
+void FNetworkRelevancyGrid::RecordChange(const FNetworkObjectInfo& ObjectInfo, const ENetRelevancyGridList OldList, const FIntPoint& OldCell)
+{
+	if (!bTrackChanges || bResetSinceChangesCleared)
+	{
+		return;
+	}
+
+	// Nobody consumed the changes in a while, gathering the lists again is cheaper than replaying them
+	if (Changes.Num() >= FMath::Max(GetNumObjects(), 1024))
+	{
+		Changes.Empty();
+		bResetSinceChangesCleared = true;
+		return;
+	}
+
+	FNetRelevancyGridChange& Change = Changes.AddDefaulted_GetRef();
+	Change.ObjectInfo = &ObjectInfo;
+	Change.OldList = OldList;
+	Change.NewList = ObjectInfo.RelevancyGridList;
+	Change.OldCell = OldCell;
+	Change.NewCell = ObjectInfo.RelevancyGridCell;
+}
+
+void FNetworkRelevancyGrid::SetTrackChanges(const bool bInTrackChanges)
+{
+	bTrackChanges = bInTrackChanges;
+	Changes.Empty();
+
+	// Whatever was gathered before tracking started can't be kept up to date
+	bResetSinceChangesCleared = bTrackChanges;
+}
+
+void FNetworkRelevancyGrid::ClearChanges()
+{
+	Changes.Reset();
+	bResetSinceChangesCleared = false;
+}
+
+void FNetworkRelevancyGrid::GatherCandidateObjects(const TArray<FNetViewer>& Viewers, TArray<FNetworkObjectInfo*>& OutObjects) const
+{
+	OutObjects.Reserve(OutObjects.Num() + AlwaysRelevantObjects.Num() + OwnerRelevantObjects.Num());
+	for (FNetworkObjectInfo* ObjectInfo : AlwaysRelevantObjects)
+	{
+		OutObjects.Add(ObjectInfo);
+	}
+	for (FNetworkObjectInfo* ObjectInfo : OwnerRelevantObjects)
+	{
+		OutObjects.Add(ObjectInfo);
+	}
+
+	if (Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// Viewers of one connection are usually close together, so only visit each cell once
+	TArray<FIntPoint, TInlineAllocator<32>> VisitedCells;
+
+	for (const FNetViewer& Viewer : Viewers)
+	{
+		const FIntPoint MinCell = GetCell(Viewer.ViewLocation - FVector(QueryRadius, QueryRadius, 0.0f));
+		const FIntPoint MaxCell = GetCell(Viewer.ViewLocation + FVector(QueryRadius, QueryRadius, 0.0f));
+
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; CellY++)
+		{
+			for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+			{
+				const FIntPoint Cell(CellX, CellY);
+				if (VisitedCells.Contains(Cell))
+				{
+					continue;
+				}
+				VisitedCells.Add(Cell);
+
+				if (const TArray<FNetworkObjectInfo*>* CellObjects = Cells.Find(Cell))
+				{
+					OutObjects.Append(*CellObjects);
+				}
+			}
+		}
+	}
+}
+
+bool FNetworkRelevancyGrid::IsInNearbyCell(const FNetworkObjectInfo& ObjectInfo, const TArray<FNetViewer>& Viewers) const
+{
+	if (!IsInCell(ObjectInfo))
+	{
+		return false;
+	}
+
+	for (const FNetViewer& Viewer : Viewers)
+	{
+		const FIntPoint MinCell = GetCell(Viewer.ViewLocation - FVector(QueryRadius, QueryRadius, 0.0f));
+		const FIntPoint MaxCell = GetCell(Viewer.ViewLocation + FVector(QueryRadius, QueryRadius, 0.0f));
+
+		if (ObjectInfo.RelevancyGridCell.X >= MinCell.X && ObjectInfo.RelevancyGridCell.X <= MaxCell.X
+			&& ObjectInfo.RelevancyGridCell.Y >= MinCell.Y && ObjectInfo.RelevancyGridCell.Y <= MaxCell.Y)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FNetworkRelevancyGrid::GatherNearbyCells(const TArray<FNetViewer>& Viewers, TSet<FIntPoint>& OutCells) const
+{
+	// Covers the query radius around any point of the viewer's cell, so the result stays valid while the viewer stays in its cell
+	const int32 CellRadius = FMath::CeilToInt(QueryRadius / CellSize);
+
+	for (const FNetViewer& Viewer : Viewers)
+	{
+		const FIntPoint ViewerCell = GetCell(Viewer.ViewLocation);
+
+		for (int32 CellY = ViewerCell.Y - CellRadius; CellY <= ViewerCell.Y + CellRadius; CellY++)
+		{
+			for (int32 CellX = ViewerCell.X - CellRadius; CellX <= ViewerCell.X + CellRadius; CellX++)
+			{
+				OutCells.Add(FIntPoint(CellX, CellY));
+			}
+		}
+	}
+}
+
+void FNetworkRelevancyGrid::GatherObjectsInCells(const TSet<FIntPoint>& InCells, TSet<const FNetworkObjectInfo*>& OutObjects) const
+{
+	for (const FNetworkObjectInfo* ObjectInfo : AlwaysRelevantObjects)
+	{
+		OutObjects.Add(ObjectInfo);
+	}
+	for (const FNetworkObjectInfo* ObjectInfo : OwnerRelevantObjects)
+	{
+		OutObjects.Add(ObjectInfo);
+	}
+
+	for (const FIntPoint& Cell : InCells)
+	{
+		if (const TArray<FNetworkObjectInfo*>* CellObjects = Cells.Find(Cell))
+		{
+			for (const FNetworkObjectInfo* ObjectInfo : *CellObjects)
+			{
+				OutObjects.Add(ObjectInfo);
+			}
+		}
+	}
+}
+
+void FNetworkRelevancyGrid::CountBytes(FArchive& Ar) const
+{
+	Cells.CountBytes(Ar);
+	for (const TPair<FIntPoint, TArray<FNetworkObjectInfo*>>& Cell : Cells)
+	{
+		Cell.Value.CountBytes(Ar);
+	}
+
+	AlwaysRelevantObjects.CountBytes(Ar);
+	OwnerRelevantObjects.CountBytes(Ar);
+	Changes.CountBytes(Ar);
+}
+
+FNetworkUpdateSchedule::FNetworkUpdateSchedule()
+	: NumObjects(0)
+{
+}
+
+FNetworkUpdateSchedule::FBucket* FNetworkUpdateSchedule::FindBucket(const int32 IntervalFrames)
+{
+	const int32 BucketIndex = Algo::LowerBoundBy(Buckets, IntervalFrames, &FBucket::IntervalFrames);
+	return (Buckets.IsValidIndex(BucketIndex) && Buckets[BucketIndex].IntervalFrames == IntervalFrames) ? &Buckets[BucketIndex] : nullptr;
+}
+
+FNetworkUpdateSchedule::FBucket& FNetworkUpdateSchedule::FindOrAddBucket(const int32 IntervalFrames)
+{
+	const int32 BucketIndex = Algo::LowerBoundBy(Buckets, IntervalFrames, &FBucket::IntervalFrames);
+	if (Buckets.IsValidIndex(BucketIndex) && Buckets[BucketIndex].IntervalFrames == IntervalFrames)
+	{
+		return Buckets[BucketIndex];
+	}
+
+	FBucket& Bucket = Buckets.InsertDefaulted_GetRef(BucketIndex);
+	Bucket.IntervalFrames = IntervalFrames;
+	Bucket.NextSlot = 0;
+	Bucket.Slots.SetNum(IntervalFrames);
+	return Bucket;
+}
+
+void FNetworkUpdateSchedule::Update(FNetworkObjectInfo& ObjectInfo, const int32 IntervalFrames)
+{
+	const int32 ClampedInterval = FMath::Clamp(IntervalFrames, 1, MaxIntervalFrames);
+	if (ObjectInfo.UpdateScheduleInterval == ClampedInterval)
+	{
+		return;
+	}
+
+	Remove(ObjectInfo);
+
+	FBucket& Bucket = FindOrAddBucket(ClampedInterval);
+	const int32 Slot = Bucket.NextSlot;
+	Bucket.NextSlot = (Bucket.NextSlot + 1) % ClampedInterval;
+
+	ObjectInfo.UpdateScheduleInterval = ClampedInterval;
+	ObjectInfo.UpdateScheduleSlot = Slot;
+	ObjectInfo.UpdateScheduleSlotIndex = Bucket.Slots[Slot].Add(&ObjectInfo);
+	NumObjects++;
+}
+
+void FNetworkUpdateSchedule::Remove(FNetworkObjectInfo& ObjectInfo)
+{
+	if (ObjectInfo.UpdateScheduleInterval == 0)
+	{
+		return;
+	}
+
+	FBucket* Bucket = FindBucket(ObjectInfo.UpdateScheduleInterval);
+	if (ensure(Bucket != nullptr))
+	{
+		TArray<FNetworkObjectInfo*>& SlotObjects = Bucket->Slots[ObjectInfo.UpdateScheduleSlot];
+		const int32 Index = ObjectInfo.UpdateScheduleSlotIndex;
+		check(SlotObjects[Index] == &ObjectInfo);
+
+		SlotObjects.RemoveAtSwap(Index, 1, false);
+		if (SlotObjects.IsValidIndex(Index))
+		{
+			SlotObjects[Index]->UpdateScheduleSlotIndex = Index;
+		}
+	}
+
+	ObjectInfo.UpdateScheduleInterval = 0;
+	ObjectInfo.UpdateScheduleSlot = 0;
+	ObjectInfo.UpdateScheduleSlotIndex = INDEX_NONE;
+	NumObjects--;
+}
+
+void FNetworkUpdateSchedule::Reset()
+{
+	for (FBucket& Bucket : Buckets)
+	{
+		for (TArray<FNetworkObjectInfo*>& SlotObjects : Bucket.Slots)
+		{
+			for (FNetworkObjectInfo* ObjectInfo : SlotObjects)
+			{
+				ObjectInfo->UpdateScheduleInterval = 0;
+				ObjectInfo->UpdateScheduleSlot = 0;
+				ObjectInfo->UpdateScheduleSlotIndex = INDEX_NONE;
+			}
+		}
+	}
+
+	Buckets.Reset();
+	NumObjects = 0;
+}
+
+void FNetworkUpdateSchedule::GatherDueObjects(const uint32 Frame, TArray<FNetworkObjectInfo*>& OutObjects)
+{
+	for (FBucket& Bucket : Buckets)
+	{
+		for (FNetworkObjectInfo* ObjectInfo : Bucket.Slots[Frame % (uint32)Bucket.IntervalFrames])
+		{
+			if (ObjectInfo->UpdateScheduleGatherFrame != Frame)
+			{
+				ObjectInfo->UpdateScheduleGatherFrame = Frame;
+				OutObjects.Add(ObjectInfo);
+			}
+		}
+	}
+}
+
+void FNetworkUpdateSchedule::CountBytes(FArchive& Ar) const
+{
+	Buckets.CountBytes(Ar);
+	for (const FBucket& Bucket : Buckets)
+	{
+		Bucket.Slots.CountBytes(Ar);
+		for (const TArray<FNetworkObjectInfo*>& SlotObjects : Bucket.Slots)
+		{
+			SlotObjects.CountBytes(Ar);
+		}
+	}
+}
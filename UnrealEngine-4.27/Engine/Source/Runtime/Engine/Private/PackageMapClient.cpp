@@ -1376,6 +1376,8 @@ void UPackageMapClient::ReceiveNetGUIDBunch( FInBunch &InBunch )
 		return;
 	}
 
+	GuidCache->NoteExportBunchReceived(NumGUIDsInBunch);
+
 	NET_CHECKSUM(InBunch);
 
 	UE_LOG(LogNetPackageMap, Log, TEXT("UPackageMapClient::ReceiveNetGUIDBunch %d NetGUIDs. PacketId %d. ChSequence %d. ChIndex %d"), NumGUIDsInBunch, InBunch.PacketId, InBunch.ChSequence, InBunch.ChIndex );
@@ -2469,6 +2471,11 @@ FNetGUIDCache::FNetGUIDCache(UNetDriver* InDriver)
 	, AsyncLoadMode(EAsyncLoadMode::UseCVar)
 	, IsExportingNetGUIDBunch(false)
 	, DelinquentAsyncLoads(GDelinquencyNumberOfTopOffendersToTrack > 0 ? GDelinquencyNumberOfTopOffendersToTrack : 0)
+	, JoinStartTime(0.0)
+	, JoinNumExportBunches(0)
+	, JoinNumExportedGUIDs(0)
+	, JoinNumAsyncLoads(0)
+	, bJoinInProgressLogged(false)
 {
 	UniqueNetIDs[0] = UniqueNetIDs[1] = 0;
 	UniqueNetFieldExportGroupPathIndex = 0;
@@ -3055,9 +3062,47 @@ PRAGMA_ENABLE_DEPRECATION_WARNINGS
 	DelinquentAsyncLoads.MaxConcurrentAsyncLoads = FMath::Max<uint32>(DelinquentAsyncLoads.MaxConcurrentAsyncLoads, PendingAsyncLoadRequests.Num());
 
 	CacheObject.bIsPending = true;
+
+	if (!bJoinInProgressLogged)
+	{
+		JoinNumAsyncLoads++;
+	}
+
 	LoadPackageAsync(CacheObject.PathName.ToString(), FLoadPackageAsyncDelegate::CreateRaw(this, &FNetGUIDCache::AsyncPackageCallback));
 }
 
+void FNetGUIDCache::NoteExportBunchReceived(const int32 NumGUIDsInBunch)
+{
+	if (bJoinInProgressLogged || Driver == nullptr || Driver->ServerConnection == nullptr)
+	{
+		return;
+	}
+
+	if (JoinStartTime == 0.0)
+	{
+		JoinStartTime = FPlatformTime::Seconds();
+	}
+
+	JoinNumExportBunches++;
+	JoinNumExportedGUIDs += NumGUIDsInBunch;
+}
+
+void FNetGUIDCache::TryLogJoinInProgress()
+{
+	// Only meaningful once exports have required loading something, and all of those loads have finished
+	if (bJoinInProgressLogged || JoinStartTime == 0.0 || JoinNumAsyncLoads == 0 || PendingAsyncLoadRequests.Num() > 0)
+	{
+		return;
+	}
+
+	bJoinInProgressLogged = true;
+
+	const double JoinSeconds = FPlatformTime::Seconds() - JoinStartTime;
+	UE_LOG(LogNetPackageMap, Log, TEXT("Join in progress: %d exported NetGUIDs in %d bunches, %d async package loads, resolved in %.2f seconds. Driver: %s"),
+		JoinNumExportedGUIDs, JoinNumExportBunches, JoinNumAsyncLoads, JoinSeconds, *Driver->GetName());
+	CSV_EVENT(PackageMap, TEXT("Join In Progress Resolved (Seconds=%.2f|AsyncLoads=%d)"), JoinSeconds, JoinNumAsyncLoads);
+}
+
 void FNetGUIDCache::AsyncPackageCallback(const FName& PackageName, UPackage * Package, EAsyncLoadingResult::Type Result)
 {
 	check(Package == nullptr || Package->IsFullyLoaded());
@@ -3123,6 +3168,8 @@ void FNetGUIDCache::AsyncPackageCallback(const FName& PackageName, UPackage * Pa
 PRAGMA_DISABLE_DEPRECATION_WARNINGS
 		PendingAsyncPackages.Remove(PackageName);
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
+
+		TryLogJoinInProgress();
 	}
 	else
 	{
@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Rendering/MorphTargetCPUDeltas.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Animation/MorphTarget.h"
+#include "HAL/IConsoleManager.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "RHI.h"
+
+static TAutoConsoleVariable<int32> CVarMorphTargetQuantizedCPUDeltas(
+	TEXT("r.MorphTarget.QuantizedCPUDeltas"),
+	1,
+	TEXT("Whether the CPU morph target path uses quantized sparse deltas, built when the mesh is loaded.\n")
+	TEXT(" 0: Never, accumulate the source deltas of each morph\n")
+	TEXT(" 1: When the GPU path can't be used (default)\n")
+	TEXT(" 2: Always, so r.MorphTarget.Mode can be switched to 0 at runtime\n"),
+	ECVF_ReadOnly);
+
+bool FMorphTargetCPUDeltas::ShouldBuild()
+{
+	const int32 Mode = CVarMorphTargetQuantizedCPUDeltas.GetValueOnAnyThread();
+	if (Mode == 0)
+	{
+		return false;
+	}
+	if (Mode >= 2)
+	{
+		return true;
+	}
+
+	static const TConsoleVariableData<int32>* MorphTargetModeCVar = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.MorphTarget.Mode"));
+	const bool bGPUMorphTargets = (!MorphTargetModeCVar || MorphTargetModeCVar->GetValueOnAnyThread() != 0) && IsFeatureLevelSupported(GMaxRHIShaderPlatform, ERHIFeatureLevel::SM5);
+	return !bGPUMorphTargets;
+}
+
+static int16 QuantizeMorphDelta(float Value, float InvScale)
+{
+	return (int16)FMath::Clamp(FMath::RoundToInt(Value * InvScale), -MAX_int16, (int32)MAX_int16);
+}
+
+void FMorphTargetCPUDeltas::Build(const TArray<UMorphTarget*>& MorphTargets, int32 LODIndex, const TArray<FSkelMeshRenderSection>& Sections)
+{
+	Reset();
+
+	uint32 NumVertices = 0;
+	for (const FSkelMeshRenderSection& Section : Sections)
+	{
+		NumVertices = FMath::Max(NumVertices, Section.BaseVertexIndex + Section.NumVertices);
+	}
+
+	int32 NumTotalDeltas = 0;
+	for (UMorphTarget* MorphTarget : MorphTargets)
+	{
+		NumTotalDeltas += MorphTarget && MorphTarget->HasDataForLOD(LODIndex) ? MorphTarget->MorphLODModels[LODIndex].Vertices.Num() : 0;
+	}
+
+	Morphs.Reserve(MorphTargets.Num());
+	Deltas.Reserve(NumTotalDeltas);
+
+	for (UMorphTarget* MorphTarget : MorphTargets)
+	{
+		// Morphs keep their index even without data, it is the index of their weight
+		FMorph& Morph = Morphs.AddDefaulted_GetRef();
+		Morph.StartOffset = Deltas.Num();
+
+		int32 NumSourceDeltas = 0;
+		const FMorphTargetDelta* SourceDeltas = MorphTarget ? MorphTarget->GetMorphTargetDelta(LODIndex, NumSourceDeltas) : nullptr;
+		if (!SourceDeltas || NumSourceDeltas == 0)
+		{
+			continue;
+		}
+
+		// Morphs saved before section indices were recorded could move any section
+		const TArray<int32>& SectionIndices = MorphTarget->MorphLODModels[LODIndex].SectionIndices;
+		Morph.SectionMask = SectionIndices.Num() > 0 ? 0 : MAX_uint64;
+		for (const int32 SectionIndex : SectionIndices)
+		{
+			Morph.SectionMask |= SectionIndex < 64 ? (1ull << SectionIndex) : MAX_uint64;
+		}
+
+		FVector MaxPosition = FVector::ZeroVector;
+		float MaxTangentZ = 0.0f;
+		for (int32 DeltaIndex = 0; DeltaIndex < NumSourceDeltas; ++DeltaIndex)
+		{
+			MaxPosition = MaxPosition.ComponentMax(SourceDeltas[DeltaIndex].PositionDelta.GetAbs());
+			MaxTangentZ = FMath::Max(MaxTangentZ, SourceDeltas[DeltaIndex].TangentZDelta.GetAbsMax());
+		}
+
+		Morph.PositionScale = MaxPosition / MAX_int16;
+		Morph.TangentZScale = MaxTangentZ / MAX_int16;
+
+		const FVector InvPositionScale(
+			MaxPosition.X > 0.0f ? MAX_int16 / MaxPosition.X : 0.0f,
+			MaxPosition.Y > 0.0f ? MAX_int16 / MaxPosition.Y : 0.0f,
+			MaxPosition.Z > 0.0f ? MAX_int16 / MaxPosition.Z : 0.0f);
+		const float InvTangentZScale = MaxTangentZ > 0.0f ? MAX_int16 / MaxTangentZ : 0.0f;
+
+		for (int32 DeltaIndex = 0; DeltaIndex < NumSourceDeltas; ++DeltaIndex)
+		{
+			const FMorphTargetDelta& SourceDelta = SourceDeltas[DeltaIndex];
+
+			// Same guard as the source delta path, some imported morphs reference vertices past the end of the LOD
+			if (SourceDelta.SourceIdx >= NumVertices)
+			{
+				continue;
+			}
+
+			// Remapped to the morphed vertices once every morph is in
+			FQuantizedDelta& Delta = Deltas.AddUninitialized_GetRef();
+			Delta.MorphedVertexIndex = SourceDelta.SourceIdx;
+			Delta.Position[0] = QuantizeMorphDelta(SourceDelta.PositionDelta.X, InvPositionScale.X);
+			Delta.Position[1] = QuantizeMorphDelta(SourceDelta.PositionDelta.Y, InvPositionScale.Y);
+			Delta.Position[2] = QuantizeMorphDelta(SourceDelta.PositionDelta.Z, InvPositionScale.Z);
+			Delta.TangentZ[0] = QuantizeMorphDelta(SourceDelta.TangentZDelta.X, InvTangentZScale);
+			Delta.TangentZ[1] = QuantizeMorphDelta(SourceDelta.TangentZDelta.Y, InvTangentZScale);
+			Delta.TangentZ[2] = QuantizeMorphDelta(SourceDelta.TangentZDelta.Z, InvTangentZScale);
+		}
+
+		Morph.NumDeltas = Deltas.Num() - Morph.StartOffset;
+
+		// In vertex order the accumulation walks memory forward
+		Algo::Sort(MakeArrayView(Deltas.GetData() + Morph.StartOffset, Morph.NumDeltas), [](const FQuantizedDelta& A, const FQuantizedDelta& B)
+		{
+			return A.MorphedVertexIndex < B.MorphedVertexIndex;
+		});
+	}
+
+	// Vertices no morph moves never need a sum, the remapping keeps each morph's deltas in vertex order
+	TBitArray<> IsMorphed(false, NumVertices);
+	for (const FQuantizedDelta& Delta : Deltas)
+	{
+		IsMorphed[Delta.MorphedVertexIndex] = true;
+	}
+
+	TArray<uint32> MorphedVertexIndices;
+	MorphedVertexIndices.SetNumUninitialized(NumVertices);
+	for (TConstSetBitIterator<> It(IsMorphed); It; ++It)
+	{
+		MorphedVertexIndices[It.GetIndex()] = MorphedVertices.Num();
+		MorphedVertices.Add(It.GetIndex());
+	}
+
+	for (FQuantizedDelta& Delta : Deltas)
+	{
+		Delta.MorphedVertexIndex = MorphedVertexIndices[Delta.MorphedVertexIndex];
+	}
+
+	SectionMorphedVertexRanges.Reserve(Sections.Num());
+	for (const FSkelMeshRenderSection& Section : Sections)
+	{
+		const int32 First = Algo::LowerBound(MorphedVertices, Section.BaseVertexIndex);
+		const int32 End = Algo::LowerBound(MorphedVertices, Section.BaseVertexIndex + Section.NumVertices);
+		SectionMorphedVertexRanges.Add(FUintPoint(First, End - First));
+	}
+}
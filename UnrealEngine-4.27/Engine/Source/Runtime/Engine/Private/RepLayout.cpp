@@ -55,6 +55,10 @@ int32 GNetSharedSerializedData = 1;
 static FAutoConsoleVariableRef CVarNetShareSerializedData(TEXT("net.ShareSerializedData"), GNetSharedSerializedData,
 	TEXT("If true, enable shared serialization system used by replication to reduce CPU usage when multiple clients need the same data"));
 
+int32 GNetShareSerializedChangelists = 1;
+static FAutoConsoleVariableRef CVarNetShareSerializedChangelists(TEXT("net.ShareSerializedChangelists"), GNetShareSerializedChangelists,
+	TEXT("If true, when every property of a changelist comes from shared serialization, the whole serialized block is cached and copied to other connections sending the same changelist"));
+
 int32 GNetVerifyShareSerializedData = 0;
 static FAutoConsoleVariableRef CVarNetVerifyShareSerializedData(TEXT("net.VerifyShareSerializedData"), GNetVerifyShareSerializedData,
 	TEXT("Debug option to verify shared serialization data during replication"));
@@ -63,6 +67,10 @@ int32 LogSkippedRepNotifies = 0;
 static FAutoConsoleVariable CVarLogSkippedRepNotifies(TEXT("Net.LogSkippedRepNotifies"), LogSkippedRepNotifies, 
 	TEXT("Log when the networking code skips calling a repnotify clientside due to the property value not changing."), ECVF_Default);
 
+int32 GNetComparePodSpans = 1;
+static FAutoConsoleVariableRef CVarNetComparePodSpans(TEXT("net.ComparePodSpans"), GNetComparePodSpans,
+	TEXT("If true, properties made only of plain data (ints, floats, vectors, etc.) are first compared to the shadow state with a single memcmp, and only compared property by property if that finds a difference"));
+
 int32 GUsePackedShadowBuffers = 1;
 static FAutoConsoleVariableRef CVarUsePackedShadowBuffers(TEXT("Net.UsePackedShadowBuffers"), GUsePackedShadowBuffers,
 	TEXT("When enabled, FRepLayout will generate shadow buffers that are packed with only the necessary NetProperties, instead of copying entire object state."));
@@ -91,6 +99,7 @@ constexpr bool GbPushModelValidateProperties = false;
 #endif
 
 extern int32 GNumSharedSerializationHit;
+extern int32 GNumSharedChangelistHit;
 extern int32 GNumSharedSerializationMiss;
 
 extern TAutoConsoleVariable<int32> CVarNetEnableDetailedScopeCounters;
@@ -1274,11 +1283,15 @@ struct FComparePropertiesSharedParams
 	FRepChangelistState* const RepChangelistState;
 	FRepChangedPropertyTracker* const RepChangedPropertyTracker;
 	const TMap<FRepLayoutCmd*, TArray<FRepLayoutCmd>>& NetSerializeLayouts;
+	const TArray<FRepLayoutPodSpan>& PodSpans;
+	const TArray<FRepLayoutPodSpanRange>& ParentPodSpans;
+	const TArray<FRepLayoutPodSpanRange>& ArrayPodSpans;
 	UE4PushModelPrivate::FPushModelPerNetDriverState* const PushModelState = nullptr;
 	const TBitArray<>* const PushModelProperties = nullptr;
 	const bool bValidateProperties = false;
 	const bool bIsNetworkProfilerActive = false;
 	const bool bChangedNetOwner = false;
+	const bool bComparePodSpans = false;
 #if (WITH_PUSH_VALIDATION_SUPPORT || USE_NETWORK_PROFILER)
 	TBitArray<> PropertiesCompared;
 	TBitArray<> PropertiesChanged;
@@ -1306,6 +1319,32 @@ static void CompareProperties_Array_r(
 	const uint16 CmdIndex,
 	const uint16 Handle);
 
+// Returns true if every span in the range is bitwise identical in Data and ShadowData, meaning none of the commands it covers changed.
+// An empty range returns false, so those commands are compared one by one.
+static FORCEINLINE bool ArePodSpansIdentical(
+	const TArray<FRepLayoutPodSpan>& PodSpans,
+	const FRepLayoutPodSpanRange& Range,
+	const uint8* Data,
+	const uint8* ShadowData)
+{
+	if (Range.Num == 0)
+	{
+		return false;
+	}
+
+	const int32 SpanEnd = Range.Start + Range.Num;
+	for (int32 SpanIndex = Range.Start; SpanIndex < SpanEnd; ++SpanIndex)
+	{
+		const FRepLayoutPodSpan& Span = PodSpans[SpanIndex];
+		if (FMemory::Memcmp(Data + Span.Offset, ShadowData + Span.ShadowOffset, Span.Size) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 static bool CompareRoleProperty(
 	const FComparePropertiesSharedParams& SharedParams,
 	FComparePropertiesStackParams& StackParams,
@@ -1380,6 +1419,13 @@ static bool CompareParentProperty(
 		}
 	}
 		
+	// Most properties don't change between compares, so check plain data parents in one go before walking their commands.
+	if (SharedParams.bComparePodSpans && !SharedParams.bForceFail &&
+		ArePodSpansIdentical(SharedParams.PodSpans, SharedParams.ParentPodSpans[ParentIndex], StackParams.Data.Data, StackParams.ShadowData.Data))
+	{
+		return false;
+	}
+
 	const int32 NumChanges = StackParams.Changed.Num();
 
 	// Note, Handle - 1 to account for CompareProperties_r incrementing handles.
@@ -1575,6 +1621,10 @@ static void CompareProperties_Array_r(
 	const FConstRepObjectDataBuffer ArrayData(Array->GetData());
 	FRepShadowDataBuffer ShadowArrayData(ShadowArray->GetData());
 
+	// Elements made only of plain data can be skipped with a memcmp. They don't contain arrays, so each command is one handle.
+	const FRepLayoutPodSpanRange* ElementPodSpans = SharedParams.bComparePodSpans ? &SharedParams.ArrayPodSpans[CmdIndex] : nullptr;
+	const uint16 NumElementHandles = static_cast<uint16>(Cmd.EndCmd - CmdIndex - 2);
+
 	{
 		const bool bOldForceFail = SharedParams.bForceFail;
 		bool& bForceFail = const_cast<bool&>(SharedParams.bForceFail);
@@ -1585,6 +1635,13 @@ static void CompareProperties_Array_r(
 			const int32 ArrayElementOffset = i * Cmd.ElementSize;
 			bForceFail = bOldForceFail || i >= ShadowArrayNum;
 
+			if (ElementPodSpans && !bForceFail &&
+				ArePodSpansIdentical(SharedParams.PodSpans, *ElementPodSpans, ArrayData.Data + ArrayElementOffset, ShadowArrayData.Data + ArrayElementOffset))
+			{
+				LocalHandle += NumElementHandles;
+				continue;
+			}
+
 			FComparePropertiesStackParams NewStackParams{
 				ArrayData + ArrayElementOffset,
 				ShadowArrayData + ArrayElementOffset,
@@ -1664,11 +1721,15 @@ ERepLayoutResult FRepLayout::CompareProperties(
 		RepChangelistState,
 		(RepState ? RepState->RepChangedPropertyTracker.Get() : nullptr),
 		NetSerializeLayouts,
+		PodSpans,
+		ParentPodSpans,
+		ArrayPodSpans,
 		/*PushModelState=*/UE4_RepLayout_Private::GetPerNetDriverState(RepChangelistState),
 		/*PushModelProperties=*/ LocalPushModelProperties,	
 		/*bValidateProperties=*/GbPushModelValidateProperties,
 		/*bIsNetworkProfilerActive=*/UE4_RepLayout_Private::IsNetworkProfilerComparisonTrackingEnabled(),
-		/*bChangedNetOwner=*/ RepState && RepState->RepFlags.bNetOwner != RepFlags.bNetOwner
+		/*bChangedNetOwner=*/ RepState && RepState->RepFlags.bNetOwner != RepFlags.bNetOwner,
+		/*bComparePodSpans=*/ !!GNetComparePodSpans && ParentPodSpans.Num() == Parents.Num()
 	};
 
 	FComparePropertiesStackParams StackParams{
@@ -1999,7 +2060,62 @@ bool FRepLayout::ReplicateProperties(
 	}
 	else if (Changed.Num() > 0)
 	{
-		SendProperties(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, RepChangelistState->SharedSerialization);
+		FRepSerializationSharedInfo& SharedSerialization = RepChangelistState->SharedSerialization;
+		const bool bShareChangelist = (GNetSharedSerializedData != 0) && (GNetShareSerializedChangelists != 0) && SharedSerialization.IsValid();
+
+#ifdef ENABLE_PROPERTY_CHECKSUMS
+		const bool bDoChecksum = (GDoPropertyChecksum == 1);
+#else
+		const bool bDoChecksum = false;
+#endif
+
+		const FRepSerializationSharedInfo::FSharedChangelist* SharedChangelist = bShareChangelist ? SharedSerialization.FindSharedChangelist(Changed, bDoChecksum) : nullptr;
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		// Serialize normally below and compare against the cached block
+		const bool bVerifySharedChangelist = SharedChangelist && (GNetVerifyShareSerializedData != 0);
+		if (bVerifySharedChangelist)
+		{
+			FBitWriterMark BitWriterMark(Writer);
+			SendProperties(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, SharedSerialization);
+
+			TArray<uint8> StandardBuffer;
+			BitWriterMark.Copy(Writer, StandardBuffer);
+			BitWriterMark.Pop(Writer);
+
+			Writer.SerializeBitsWithOffset(SharedSerialization.SerializedProperties->GetData(), SharedChangelist->BitOffset, SharedChangelist->BitLength);
+
+			TArray<uint8> SharedBuffer;
+			BitWriterMark.Copy(Writer, SharedBuffer);
+			BitWriterMark.Pop(Writer);
+
+			if (StandardBuffer != SharedBuffer)
+			{
+				UE_LOG(LogRep, Error, TEXT("Shared changelist serialization data mismatch for %s!"), *GetNameSafe(ObjectClass));
+			}
+		}
+#endif
+
+		if (SharedChangelist)
+		{
+			UE_NET_TRACE_SCOPE(Properties, Writer, GetTraceCollector(Writer), ENetTraceVerbosity::Trace);
+			GNumSharedChangelistHit++;
+			Writer.SerializeBitsWithOffset(SharedSerialization.SerializedProperties->GetData(), SharedChangelist->BitOffset, SharedChangelist->BitLength);
+		}
+		else
+		{
+			// Properties that miss the shared serialization path can write connection specific data (NetGUIDs), so only
+			// cache the block if every property came from the shared buffer. Replication is game thread only, so the global counter is safe to use here.
+			const int32 StartBit = Writer.GetNumBits();
+			const int32 StartMisses = GNumSharedSerializationMiss;
+
+			SendProperties(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, SharedSerialization);
+
+			if (bShareChangelist && StartMisses == GNumSharedSerializationMiss && !Writer.IsError())
+			{
+				SharedSerialization.AddSharedChangelist(Changed, bDoChecksum, Writer, StartBit, Writer.GetNumBits() - StartBit);
+			}
+		}
 	}
 
 	// See if something actually sent (this may be false due to conditional checks inside the send properties function
@@ -2514,6 +2630,14 @@ void FRepSerializationSharedInfo::CountBytes(FArchive& Ar) const
 
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("SharedPropertyInfo", SharedPropertyInfo.CountBytes(Ar));
 
+	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("SharedChangelists",
+		SharedChangelists.CountBytes(Ar);
+		for (const FSharedChangelist& SharedChangelist : SharedChangelists)
+		{
+			SharedChangelist.Changed.CountBytes(Ar);
+		}
+	);
+
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("SerializedProperties",
 		if (FNetBitWriter const* const LocalSerializedProperties = SerializedProperties.Get())
 		{
@@ -2523,6 +2647,33 @@ void FRepSerializationSharedInfo::CountBytes(FArchive& Ar) const
 	);
 }
 
+const FRepSerializationSharedInfo::FSharedChangelist* FRepSerializationSharedInfo::FindSharedChangelist(const TArray<uint16>& Changed, const bool bDoChecksum) const
+{
+	return SharedChangelists.FindByPredicate([&Changed, bDoChecksum](const FSharedChangelist& SharedChangelist)
+	{
+		return SharedChangelist.bDoChecksum == bDoChecksum && SharedChangelist.Changed == Changed;
+	});
+}
+
+void FRepSerializationSharedInfo::AddSharedChangelist(const TArray<uint16>& Changed, const bool bDoChecksum, const FNetBitWriter& Writer, const int32 StartBit, const int32 NumBits)
+{
+	if (SharedChangelists.Num() >= MaxSharedChangelists)
+	{
+		return;
+	}
+
+	FSharedChangelist& SharedChangelist = SharedChangelists.Emplace_GetRef();
+	SharedChangelist.Changed = Changed;
+	SharedChangelist.BitOffset = SerializedProperties->GetNumBits();
+	SharedChangelist.BitLength = NumBits;
+	SharedChangelist.bDoChecksum = bDoChecksum;
+
+	if (NumBits > 0)
+	{
+		SerializedProperties->SerializeBitsWithOffset(const_cast<uint8*>(Writer.GetData()), StartBit, NumBits);
+	}
+}
+
 PRAGMA_DISABLE_DEPRECATION_WARNINGS
 const FRepSerializedPropertyInfo* FRepSerializationSharedInfo::WriteSharedProperty(
 	const FRepLayoutCmd& Cmd,
@@ -6099,6 +6250,11 @@ void FRepLayout::InitFromClass(
 
 	BuildShadowOffsets<ERepBuildType::Class>(InObjectClass, Parents, Cmds, ShadowDataBufferSize);
 
+	if (!ServerConnection || EnumHasAnyFlags(CreateFlags, ECreateRepLayoutFlags::MaySendProperties))
+	{
+		BuildComparePodSpans();
+	}
+
 	Owner = InObjectClass;
 }
 
@@ -6223,6 +6379,11 @@ void FRepLayout::InitFromStruct(
 
 	BuildShadowOffsets<ERepBuildType::Struct>(InStruct, Parents, Cmds, ShadowDataBufferSize);
 
+	if (!ServerConnection || EnumHasAnyFlags(CreateFlags, ECreateRepLayoutFlags::MaySendProperties))
+	{
+		BuildComparePodSpans();
+	}
+
 	Owner = InStruct;
 }
 
@@ -6802,6 +6963,100 @@ void FRepLayout::BuildHandleToCmdIndexTable_r(
 	}
 }
 
+// Types whose value is fully described by their bytes, so equal memory means an equal property.
+// Bitfield bools share their byte with other properties, and everything else may own memory or compare specially.
+static bool IsPodCompareCmdType(const ERepLayoutCmdType Type)
+{
+	switch (Type)
+	{
+		case ERepLayoutCmdType::PropertyNativeBool:
+		case ERepLayoutCmdType::PropertyByte:
+		case ERepLayoutCmdType::PropertyFloat:
+		case ERepLayoutCmdType::PropertyInt:
+		case ERepLayoutCmdType::PropertyUInt32:
+		case ERepLayoutCmdType::PropertyUInt64:
+		case ERepLayoutCmdType::PropertyVector:
+		case ERepLayoutCmdType::PropertyVector100:
+		case ERepLayoutCmdType::PropertyVectorQ:
+		case ERepLayoutCmdType::PropertyVectorNormal:
+		case ERepLayoutCmdType::PropertyVector10:
+		case ERepLayoutCmdType::PropertyPlane:
+		case ERepLayoutCmdType::PropertyRotator:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+void FRepLayout::BuildComparePodSpans()
+{
+	PodSpans.Reset();
+	ArrayPodSpans.Reset();
+	ParentPodSpans.Reset();
+	ParentPodSpans.SetNum(Parents.Num());
+
+	for (int32 ParentIndex = 0; ParentIndex < Parents.Num(); ++ParentIndex)
+	{
+		const FRepParentCmd& Parent = Parents[ParentIndex];
+		if (Parent.CmdEnd > Parent.CmdStart)
+		{
+			ParentPodSpans[ParentIndex] = BuildComparePodSpanRange(Parent.CmdStart, Parent.CmdEnd);
+		}
+	}
+
+	for (int32 CmdIndex = 0; CmdIndex < Cmds.Num(); ++CmdIndex)
+	{
+		const FRepLayoutCmd& Cmd = Cmds[CmdIndex];
+		if (Cmd.Type == ERepLayoutCmdType::DynamicArray)
+		{
+			if (ArrayPodSpans.Num() == 0)
+			{
+				ArrayPodSpans.SetNum(Cmds.Num());
+			}
+
+			// Array commands are followed by their element commands, and a Return command at EndCmd - 1
+			ArrayPodSpans[CmdIndex] = BuildComparePodSpanRange(CmdIndex + 1, Cmd.EndCmd - 1);
+		}
+	}
+
+	PodSpans.Shrink();
+}
+
+FRepLayoutPodSpanRange FRepLayout::BuildComparePodSpanRange(const int32 CmdStart, const int32 CmdEnd)
+{
+	FRepLayoutPodSpanRange Range;
+	Range.Start = PodSpans.Num();
+
+	for (int32 CmdIndex = CmdStart; CmdIndex < CmdEnd; ++CmdIndex)
+	{
+		const FRepLayoutCmd& Cmd = Cmds[CmdIndex];
+
+		if (!IsPodCompareCmdType(Cmd.Type))
+		{
+			PodSpans.SetNum(Range.Start);
+			return FRepLayoutPodSpanRange();
+		}
+
+		// Merge with the previous command if it ends right where this one starts, in both the object and the shadow buffer.
+		// Gaps (padding, or properties that aren't replicated) start a new span, since their bytes aren't kept in sync.
+		if (PodSpans.Num() > Range.Start)
+		{
+			FRepLayoutPodSpan& LastSpan = PodSpans.Last();
+			if (LastSpan.Offset + LastSpan.Size == Cmd.Offset && LastSpan.ShadowOffset + LastSpan.Size == Cmd.ShadowOffset)
+			{
+				LastSpan.Size += Cmd.ElementSize;
+				continue;
+			}
+		}
+
+		PodSpans.Add(FRepLayoutPodSpan{ Cmd.Offset, Cmd.ShadowOffset, Cmd.ElementSize });
+	}
+
+	Range.Num = PodSpans.Num() - Range.Start;
+	return Range;
+}
+
 TStaticBitArray<COND_Max> FSendingRepState::BuildConditionMapFromRepFlags(const FReplicationFlags RepFlags)
 {
 	TStaticBitArray<COND_Max> ConditionMap;
@@ -7911,6 +8166,11 @@ void FRepLayout::CountBytes(FArchive& Ar) const
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("Parents", Parents.CountBytes(Ar));
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("Cmds", Cmds.CountBytes(Ar));
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("BaseHandleToCmdIndex", BaseHandleToCmdIndex.CountBytes(Ar));
+	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("PodSpans",
+		PodSpans.CountBytes(Ar);
+		ParentPodSpans.CountBytes(Ar);
+		ArrayPodSpans.CountBytes(Ar);
+	);
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("SharedInfoRPC", SharedInfoRPC.CountBytes(Ar));
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("SharedInfoRPCParentsChanged", SharedInfoRPCParentsChanged.CountBytes(Ar));
 	GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("LifetimeCustomPropertyState",
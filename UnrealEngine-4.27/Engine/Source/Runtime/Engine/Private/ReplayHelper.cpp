@@ -15,12 +15,15 @@
 #include "Net/RepLayout.h"
 #include "Net/UnrealNetwork.h"
 #include "ProfilingDebugging/CsvProfiler.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/MemoryWriter.h"
 #include "UnrealEngine.h"
 #include "EngineUtils.h"
 #include "ReplayNetConnection.h"
 
 extern TAutoConsoleVariable<int32> CVarWithLevelStreamingFixes;
 extern TAutoConsoleVariable<int32> CVarWithDeltaCheckpoints;
+extern TAutoConsoleVariable<int32> CVarAsyncCheckpointGuidCache;
 extern TAutoConsoleVariable<int32> CVarWithGameSpecificFrameData;
 extern TAutoConsoleVariable<int32> CVarEnableCheckpoints;
 extern TAutoConsoleVariable<float> CVarCheckpointUploadDelayInSeconds;
@@ -850,7 +853,14 @@ void FReplayHelper::TickCheckpoint(UNetConnection* Connection)
 				SCOPED_NAMED_EVENT(FReplayHelper_SerializeGuidCache, FColor::Green);
 
 				// Save the current guid cache
-				bExecuteNextState = SerializeGuidCache(Connection, Params, CheckpointArchive);
+				if (CheckpointSaveContext.AsyncGuidCache.IsValid())
+				{
+					bExecuteNextState = SerializeGuidCacheAsync(Params, CheckpointArchive);
+				}
+				else
+				{
+					bExecuteNextState = SerializeGuidCache(Connection, Params, CheckpointArchive);
+				}
 				if (bExecuteNextState)
 				{
 					CheckpointSaveContext.CheckpointSaveState = ECheckpointSaveState::SerializeNetFieldExportGroupMap;
@@ -943,7 +953,10 @@ void FReplayHelper::TickCheckpoint(UNetConnection* Connection)
 		const float TotalCheckpointTimeInMS = CheckpointSaveContext.TotalCheckpointReplicationTimeSeconds * 1000.0f;
 		const float TotalCheckpointTimeWithOverheadInMS = CheckpointSaveContext.TotalCheckpointSaveTimeSeconds * 1000.0f;
 
-		UE_LOG(LogDemo, Log, TEXT("Finished checkpoint. Checkpoint Actors: %i, GuidCacheSize: %i, TotalSize: %i, TotalCheckpointSaveFrames: %i, TotalCheckpointTimeInMS: %2.2f, TotalCheckpointTimeWithOverheadInMS: %2.2f"), CheckpointSaveContext.TotalCheckpointActors, CheckpointSaveContext.GuidCacheSize, TotalCheckpointSize, CheckpointSaveContext.TotalCheckpointSaveFrames, TotalCheckpointTimeInMS, TotalCheckpointTimeWithOverheadInMS);
+		CSV_CUSTOM_STAT(Demo, DemoCheckpointSizeKB, TotalCheckpointSize / 1024.0f, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Demo, DemoCheckpointActors, CheckpointSaveContext.TotalCheckpointActors, ECsvCustomStatOp::Set);
+
+		UE_LOG(LogDemo, Log, TEXT("Finished checkpoint. Delta: %d, Checkpoint Actors: %i, GuidCacheSize: %i, TotalSize: %i, TotalCheckpointSaveFrames: %i, TotalCheckpointTimeInMS: %2.2f, TotalCheckpointTimeWithOverheadInMS: %2.2f"), HasDeltaCheckpoints() ? 1 : 0, CheckpointSaveContext.TotalCheckpointActors, CheckpointSaveContext.GuidCacheSize, TotalCheckpointSize, CheckpointSaveContext.TotalCheckpointSaveFrames, TotalCheckpointTimeInMS, TotalCheckpointTimeWithOverheadInMS);
 
 		// we are done, out
 		CheckpointSaveContext.CheckpointSaveState = ECheckpointSaveState::Idle;
@@ -1033,6 +1046,85 @@ bool FReplayHelper::SerializeGuidCache(UNetConnection* Connection, const FRepAct
 	return bCompleted;
 }
 
+bool FReplayHelper::SerializeGuidCacheAsync(const FRepActorsCheckpointParams& Params, FArchive* CheckpointArchive)
+{
+	check(CheckpointSaveContext.AsyncGuidCache.IsValid());
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (CheckpointSaveContext.AsyncGuidCacheEvent.IsValid() && !CheckpointSaveContext.AsyncGuidCacheEvent->IsComplete())
+	{
+		// When amortizing, don't stall the game thread on the worker, just look again next frame
+		if (Params.CheckpointMaxUploadTimePerFrame > 0)
+		{
+			return false;
+		}
+
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(CheckpointSaveContext.AsyncGuidCacheEvent);
+	}
+
+	FAsyncGuidCacheSerialize& AsyncGuidCache = *CheckpointSaveContext.AsyncGuidCache;
+
+	CheckpointArchive->Serialize(AsyncGuidCache.Buffer.GetData(), AsyncGuidCache.Buffer.Num());
+
+	CheckpointSaveContext.NumNetGuidsForRecording = AsyncGuidCache.NumNetGuids;
+	CheckpointSaveContext.NameTableMap = MoveTemp(AsyncGuidCache.NameTableMap);
+
+	UE_LOG(LogDemo, Log, TEXT("Checkpoint. SerializeGuidCacheAsync: %i guids, %i bytes, took %.3f (%.3f)"), AsyncGuidCache.NumNetGuids, AsyncGuidCache.Buffer.Num(), FPlatformTime::Seconds() - Params.StartCheckpointTime, FPlatformTime::Seconds() - StartTime);
+
+	CheckpointSaveContext.AsyncGuidCache.Reset();
+	CheckpointSaveContext.AsyncGuidCacheEvent = nullptr;
+
+	return true;
+}
+
+void FReplayHelper::FAsyncGuidCacheSerialize::Serialize()
+{
+	SCOPED_NAMED_EVENT(FReplayHelper_AsyncGuidCacheSerialize, FColor::Green);
+
+	// Same layout as SerializeGuidCache, so playback doesn't need to know which path wrote the checkpoint
+	FMemoryWriter Ar(Buffer);
+	Ar.SetForceUnicode(true);
+
+	const FArchivePos NetGuidsCountPos = Ar.Tell();
+	NumNetGuids = 0;
+	Ar << NumNetGuids;
+
+	for (FNetGuidCacheSnapshotItem& Item : Items)
+	{
+		Ar << Item.NetGuid;
+		Ar << Item.OuterGUID;
+
+		uint32* NametableIndex = NameTableMap.Find(Item.PathName);
+		if (NametableIndex == nullptr)
+		{
+			uint8 bExported = 1;
+			Ar << bExported;
+
+			Ar << ExportedPathNames.FindChecked(Item.PathName);
+
+			NameTableMap.Add(Item.PathName, NameTableMap.Num());
+		}
+		else
+		{
+			uint8 bExported = 0;
+			Ar << bExported;
+
+			uint32 TableIndex = *NametableIndex;
+			Ar.SerializeIntPacked(TableIndex);
+		}
+
+		Ar << Item.Flags;
+
+		++NumNetGuids;
+	}
+
+	const FArchivePos EndPos = Ar.Tell();
+	Ar.Seek(NetGuidsCountPos);
+	Ar << NumNetGuids;
+	Ar.Seek(EndPos);
+}
+
 void FReplayHelper::ResetLevelStatuses()
 {
 	ClearLevelStreamingState();
@@ -1225,6 +1317,17 @@ void FReplayHelper::CacheNetGuids(UNetConnection* Connection)
 		CheckpointSaveContext.NextNetGuidForRecording = 0;
 		CheckpointSaveContext.NumNetGuidsForRecording = 0;
 
+		// The async path copies out everything it needs now, so what gets written is the guid cache as of this frame
+		TSharedPtr<FAsyncGuidCacheSerialize, ESPMode::ThreadSafe> AsyncGuidCache;
+		if (CVarAsyncCheckpointGuidCache.GetValueOnAnyThread() != 0)
+		{
+			AsyncGuidCache = MakeShared<FAsyncGuidCacheSerialize, ESPMode::ThreadSafe>();
+			if (!bDeltaCheckpoint)
+			{
+				AsyncGuidCache->Items.Reserve(Connection->Driver->GuidCache->ObjectLookup.Num());
+			}
+		}
+
 		for (auto It = Connection->Driver->GuidCache->ObjectLookup.CreateIterator(); It; ++It)
 		{
 			FNetworkGUID& NetworkGUID = It.Key();
@@ -1238,7 +1341,27 @@ void FReplayHelper::CacheNetGuids(UNetConnection* Connection)
 			// Do not add guids we would filter out in the serialize step
 			if (NetworkGUID.IsValid() && CacheObject.Object.Get() && (NetworkGUID.IsStatic() || CacheObject.Object->IsNameStableForNetworking()))
 			{
-				CheckpointSaveContext.NetGuidCacheSnapshot.Add({ NetworkGUID, CacheObject });
+				if (AsyncGuidCache.IsValid())
+				{
+					uint8 Flags = 0;
+					Flags |= CacheObject.bNoLoad ? (1 << 0) : 0;
+					Flags |= CacheObject.bIgnoreWhenMissing ? (1 << 1) : 0;
+
+					AsyncGuidCache->Items.Add({ NetworkGUID, CacheObject.OuterGUID, CacheObject.PathName, Flags });
+
+					// NetworkRemapPath reads the world, so the names are remapped here and only the serialization moves to the worker
+					if (!CheckpointSaveContext.NameTableMap.Contains(CacheObject.PathName) && !AsyncGuidCache->ExportedPathNames.Contains(CacheObject.PathName))
+					{
+						FString PathName = CacheObject.PathName.ToString();
+						GEngine->NetworkRemapPath(Connection, PathName, false);
+
+						AsyncGuidCache->ExportedPathNames.Add(CacheObject.PathName, MoveTemp(PathName));
+					}
+				}
+				else
+				{
+					CheckpointSaveContext.NetGuidCacheSnapshot.Add({ NetworkGUID, CacheObject });
+				}
 
 				CacheObject.bDirtyForReplay = false;
 
@@ -1246,7 +1369,18 @@ void FReplayHelper::CacheNetGuids(UNetConnection* Connection)
 			}
 		}
 
-		UE_LOG(LogDemo, Verbose, TEXT("CacheNetGuids: %d, %.1f ms"), NumValues, (FPlatformTime::Seconds() - StartTime) * 1000);
+		if (AsyncGuidCache.IsValid())
+		{
+			AsyncGuidCache->NameTableMap = MoveTemp(CheckpointSaveContext.NameTableMap);
+
+			CheckpointSaveContext.AsyncGuidCache = AsyncGuidCache;
+			CheckpointSaveContext.AsyncGuidCacheEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([AsyncGuidCache]()
+			{
+				AsyncGuidCache->Serialize();
+			}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+		}
+
+		UE_LOG(LogDemo, Verbose, TEXT("CacheNetGuids: %d, %.1f ms, Async: %d"), NumValues, (FPlatformTime::Seconds() - StartTime) * 1000, AsyncGuidCache.IsValid() ? 1 : 0);
 	}
 }
 
@@ -1961,4 +2095,197 @@ const TCHAR* LexToString(EReplayHeaderFlags Flag)
 		check(false);
 		return TEXT("Unknown");
 	}
-}
\ No newline at end of file
+}
+
+bool FReplayChannelLifetimeIndex::SupportsEngineNetVersion(uint32 EngineNetVer)
+{
+	// DecodePacket only understands the current bunch header layout
+	return EngineNetVer >= HISTORY_CHANNEL_NAMES &&
+		EngineNetVer >= HISTORY_CHANNEL_CLOSE_REASON &&
+		EngineNetVer >= HISTORY_MAX_ACTOR_CHANNELS_CUSTOMIZATION &&
+		EngineNetVer >= HISTORY_ACKS_INCLUDED_IN_HEADER;
+}
+
+void FReplayChannelLifetimeIndex::Reset()
+{
+	DestroyedActors.Reset();
+	NumBunches = 0;
+}
+
+bool FReplayChannelLifetimeIndex::DecodePacket(const FPlaybackPacket& Packet, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, TArray<FChannelEvent>& OutEvents, int32& OutNumBunches)
+{
+	// Mirrors the parts of UNetConnection::ReceivedRawPacket and ReceivedPacket that apply to replay connections,
+	// which are InternalAck, so there's no packet header and reliable bunches don't carry a sequence.
+	const int32 Count = Packet.Data.Num();
+	if (Count == 0)
+	{
+		return true;
+	}
+
+	uint8 LastByte = Packet.Data[Count - 1];
+	if (LastByte == 0)
+	{
+		return false;
+	}
+
+	int32 BitSize = (Count * 8) - 1;
+	while (!(LastByte & 0x80))
+	{
+		LastByte *= 2;
+		BitSize--;
+	}
+
+	FBitReader Reader(const_cast<uint8*>(Packet.Data.GetData()), BitSize);
+	Reader.SetEngineNetVer(EngineNetVer);
+	Reader.SetGameNetVer(GameNetVer);
+
+	while (!Reader.AtEnd())
+	{
+		const uint8 bControl = Reader.ReadBit();
+		const uint8 bOpen = bControl ? Reader.ReadBit() : 0;
+		const uint8 bClose = bControl ? Reader.ReadBit() : 0;
+		const EChannelCloseReason CloseReason = bClose ? (EChannelCloseReason)Reader.ReadInt((uint32)EChannelCloseReason::MAX) : EChannelCloseReason::Destroyed;
+
+		Reader.ReadBit(); // bIsReplicationPaused
+		const uint8 bReliable = Reader.ReadBit();
+
+		uint32 ChIndex = 0;
+		Reader.SerializeIntPacked(ChIndex);
+
+		const uint8 bHasPackageMapExports = Reader.ReadBit();
+		const uint8 bHasMustBeMappedGUIDs = Reader.ReadBit();
+		const uint8 bPartial = Reader.ReadBit();
+		const uint8 bPartialInitial = bPartial ? Reader.ReadBit() : 0;
+		const uint8 bPartialFinal = bPartial ? Reader.ReadBit() : 0;
+
+		FName ChName = NAME_None;
+		if (bReliable || bOpen)
+		{
+			UPackageMap::StaticSerializeName(Reader, ChName);
+		}
+
+		const int32 BunchDataBits = Reader.ReadInt(MaxPacketSize * 8);
+		if (Reader.IsError() || BunchDataBits > Reader.GetBitsLeft())
+		{
+			return false;
+		}
+
+		FBitReader BunchData(nullptr, 0);
+		BunchData.SetData(Reader, BunchDataBits);
+
+		++OutNumBunches;
+
+		// Temporary actors open their channel with an unreliable bunch, and are kept alive on the client when it closes
+		const bool bOpenBunch = bOpen && bReliable && (ChName == NAME_Actor) && (!bPartial || bPartialInitial);
+		const bool bCloseBunch = bClose && (!bPartial || bPartialFinal);
+
+		if (!bOpenBunch && !bCloseBunch)
+		{
+			continue;
+		}
+
+		FChannelEvent& Event = OutEvents.AddDefaulted_GetRef();
+		Event.ChIndex = ChIndex;
+		Event.bOpen = bOpenBunch;
+		Event.bClose = bCloseBunch;
+		Event.CloseReason = CloseReason;
+
+		// Replay exports are written with the demo frame, an open bunch that has its own can't be peeked cheaply so leave its actor alone
+		if (bOpenBunch && !bHasPackageMapExports)
+		{
+			// Same layout UNetConnection::GetActorGUIDFromOpenBunch reads
+			if (bHasMustBeMappedGUIDs)
+			{
+				uint16 NumMustBeMappedGUIDs = 0;
+				BunchData << NumMustBeMappedGUIDs;
+
+				for (int32 i = 0; i < NumMustBeMappedGUIDs; i++)
+				{
+					FNetworkGUID NetGUID;
+					BunchData << NetGUID;
+				}
+			}
+
+			NET_CHECKSUM(BunchData);
+
+			BunchData << Event.ActorGUID;
+
+			if (BunchData.IsError())
+			{
+				Event.ActorGUID.Reset();
+			}
+		}
+	}
+
+	return !Reader.IsError();
+}
+
+bool FReplayChannelLifetimeIndex::Build(TArrayView<const FPlaybackPacket> Packets, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, bool bParallel)
+{
+	return Build(Packets, EngineNetVer, GameNetVer, MaxPacketSize, bParallel, [](const FNetworkGUID&) { return false; });
+}
+
+bool FReplayChannelLifetimeIndex::Build(TArrayView<const FPlaybackPacket> Packets, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, bool bParallel, TFunctionRef<bool(const FNetworkGUID&)> IsKnownActor)
+{
+	Reset();
+
+	if (!SupportsEngineNetVersion(EngineNetVer))
+	{
+		return false;
+	}
+
+	TArray<TArray<FChannelEvent>> PacketEvents;
+	PacketEvents.SetNum(Packets.Num());
+
+	TArray<int32> PacketNumBunches;
+	PacketNumBunches.SetNumZeroed(Packets.Num());
+
+	TArray<bool> PacketDecoded;
+	PacketDecoded.SetNumZeroed(Packets.Num());
+
+	// Packets only depend on their own bits, so they can be decoded in any order
+	ParallelFor(Packets.Num(), [&](int32 PacketIndex)
+	{
+		PacketDecoded[PacketIndex] = DecodePacket(Packets[PacketIndex], EngineNetVer, GameNetVer, MaxPacketSize, PacketEvents[PacketIndex], PacketNumBunches[PacketIndex]);
+	}, !bParallel);
+
+	if (PacketDecoded.Contains(false))
+	{
+		return false;
+	}
+
+	// Channel indices get reused, so opens and closes have to be matched up in playback order
+	TMap<uint32, FNetworkGUID> OpenActorChannels;
+
+	for (int32 PacketIndex = 0; PacketIndex < Packets.Num(); ++PacketIndex)
+	{
+		NumBunches += PacketNumBunches[PacketIndex];
+
+		for (const FChannelEvent& Event : PacketEvents[PacketIndex])
+		{
+			if (Event.bOpen)
+			{
+				// Startup actors would need to be cleaned up by hand if we skipped them, so only track dynamic ones.
+				// Actors that already exist have to see their close, or they would outlive the seek.
+				if (Event.ActorGUID.IsValid() && Event.ActorGUID.IsDynamic() && !Event.bClose && !IsKnownActor(Event.ActorGUID))
+				{
+					OpenActorChannels.Add(Event.ChIndex, Event.ActorGUID);
+				}
+				else
+				{
+					OpenActorChannels.Remove(Event.ChIndex);
+				}
+			}
+			else if (Event.bClose)
+			{
+				FNetworkGUID ActorGUID;
+				if (OpenActorChannels.RemoveAndCopyValue(Event.ChIndex, ActorGUID) && Event.CloseReason == EChannelCloseReason::Destroyed)
+				{
+					DestroyedActors.Add(ActorGUID);
+				}
+			}
+		}
+	}
+
+	return true;
+}
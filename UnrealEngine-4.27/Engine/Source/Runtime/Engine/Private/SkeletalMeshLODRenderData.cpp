@@ -247,6 +247,12 @@ void FSkeletalMeshLODRenderData::InitResources(bool bNeedsVertexColors, int32 LO
 			BeginInitResource(&MorphTargetVertexInfoBuffers);
 		}
 	}
+
+	MorphTargetCPUDeltas.Reset();
+	if (InMorphTargets.Num() > 0 && FMorphTargetCPUDeltas::ShouldBuild())
+	{
+		MorphTargetCPUDeltas.Build(InMorphTargets, LODIndex, RenderSections);
+	}
 }
 
 void FSkeletalMeshLODRenderData::ReleaseResources()
@@ -478,6 +484,7 @@ void FSkeletalMeshLODRenderData::GetResourceSizeEx(FResourceSizeEx& CumulativeRe
 	CumulativeResourceSize.AddUnknownMemoryBytes(StaticVertexBuffers.ColorVertexBuffer.GetAllocatedSize());
 	CumulativeResourceSize.AddUnknownMemoryBytes(ClothVertexBuffer.GetVertexDataSize());
 	CumulativeResourceSize.AddUnknownMemoryBytes(SkinWeightProfilesData.GetResourcesSize());	
+	CumulativeResourceSize.AddUnknownMemoryBytes(MorphTargetCPUDeltas.GetAllocatedSize());
 }
 
 int32 FSkeletalMeshLODRenderData::GetPlatformMinLODIdx(const ITargetPlatform* TargetPlatform, const USkeletalMesh* SkeletalMesh)
@@ -13,11 +13,41 @@
 #include "GPUSkinVertexFactory.h"
 #include "Rendering/SkinWeightVertexBuffer.h"
 #include "BoneIndices.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+
+#if INTEL_ISPC
+#include "SkeletalRenderCPUSkin.ispc.generated.h"
+#endif
 
 struct FMorphTargetDelta;
 
 template<typename VertexType>
-static void SkinVertices(FFinalSkinVertex* DestVertex, FMatrix* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, TArray<FActiveMorphTarget>& ActiveMorphTargets, TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight, const FMatrix& WorldToLocal);
+static void SkinVertices(FFinalSkinVertex* DestVertex, const FMatrix* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight, const FMatrix& WorldToLocal, FPositionVertexBuffer* OutPositionBuffer, FStaticMeshVertexBuffer* OutStaticMeshBuffer);
+
+#if INTEL_ISPC
+static TAutoConsoleVariable<int32> CVarCPUSkinningISPC(
+	TEXT("r.CPUSkinning.ISPC"),
+	1,
+	TEXT("If 1, sections without cloth are CPU skinned through the ISPC kernel that skins a vector of vertices at a time. If 0, they are skinned one vertex at a time."),
+	ECVF_RenderThreadSafe);
+#endif
+
+static TAutoConsoleVariable<int32> CVarCPUSkinningVerticesPerTask(
+	TEXT("r.CPUSkinning.VerticesPerTask"),
+	2048,
+	TEXT("Sections are CPU skinned in parallel tasks of up to this many vertices. 0 skins every vertex on the calling thread."),
+	ECVF_RenderThreadSafe);
+
+/** Whether sections without cloth go through the ISPC skinning kernel */
+static FORCEINLINE bool UseCPUSkinningISPC()
+{
+#if INTEL_ISPC
+	return CVarCPUSkinningISPC.GetValueOnAnyThread() != 0;
+#else
+	return false;
+#endif
+}
 
 #define INFLUENCE_0		0
 #define INFLUENCE_1		1
@@ -225,16 +255,11 @@ void FSkeletalMeshObjectCPUSkin::CacheVertices(int32 LODIndex, bool bForce) cons
 		{
 			check(GIsEditor || LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetAllowCPUAccess());
 			SCOPE_CYCLE_COUNTER(STAT_SkinningTime);
-			if (LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetUseFullPrecisionUVs())
-			{
-				// do actual skinning
-				SkinVertices< TGPUSkinVertexFloat32Uvs<1> >( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal);
-			}
-			else
-			{
-				// do actual skinning
-				SkinVertices< TGPUSkinVertexFloat16Uvs<1> >( DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights, DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal);
-			}
+
+			// The skinning tasks fill the vertex buffers too, unless the overlay rewrites the UVs afterwards
+			SkinLODVertices(DestVertex, ReferenceToLocal, DynamicData->LODIndex, LOD, *MeshLOD.MeshObjectWeightBuffer, DynamicData->ActiveMorphTargets, DynamicData->MorphTargetWeights,
+				DynamicData->ClothSimulUpdateData, DynamicData->ClothBlendWeight, DynamicData->WorldToLocal,
+				bRenderOverlayMaterial ? nullptr : &MeshLOD.PositionVertexBuffer, bRenderOverlayMaterial ? nullptr : &MeshLOD.StaticMeshVertexBuffer);
 
 			if (bRenderOverlayMaterial)
 			{
@@ -258,11 +283,14 @@ void FSkeletalMeshObjectCPUSkin::CacheVertices(int32 LODIndex, bool bForce) cons
 
 		check(LOD.GetNumVertices() == CachedFinalVertices.Num());
 
-		for (int i = 0; i < CachedFinalVertices.Num(); i++)
+		if (bRenderOverlayMaterial)
 		{
-			MeshLOD.PositionVertexBuffer.VertexPosition(i) = CachedFinalVertices[i].Position;
-			MeshLOD.StaticMeshVertexBuffer.SetVertexTangents(i, CachedFinalVertices[i].TangentX.ToFVector(), CachedFinalVertices[i].GetTangentY(), CachedFinalVertices[i].TangentZ.ToFVector());
-			MeshLOD.StaticMeshVertexBuffer.SetVertexUV(i, 0, FVector2D(CachedFinalVertices[i].U, CachedFinalVertices[i].V));
+			for (int i = 0; i < CachedFinalVertices.Num(); i++)
+			{
+				MeshLOD.PositionVertexBuffer.VertexPosition(i) = CachedFinalVertices[i].Position;
+				MeshLOD.StaticMeshVertexBuffer.SetVertexTangents(i, CachedFinalVertices[i].TangentX.ToFVector(), CachedFinalVertices[i].GetTangentY(), CachedFinalVertices[i].TangentZ.ToFVector());
+				MeshLOD.StaticMeshVertexBuffer.SetVertexUV(i, 0, FVector2D(CachedFinalVertices[i].U, CachedFinalVertices[i].V));
+			}
 		}
 
 		BeginUpdateResourceRHI(&MeshLOD.PositionVertexBuffer);
@@ -287,6 +315,20 @@ void FSkeletalMeshObjectCPUSkin::CacheVertices(int32 LODIndex, bool bForce) cons
 	}
 }
 
+void FSkeletalMeshObjectCPUSkin::SkinLODVertices(FFinalSkinVertex* OutVertices, const FMatrix* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer,
+	const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight,
+	const FMatrix& WorldToLocal, FPositionVertexBuffer* OutPositionBuffer, FStaticMeshVertexBuffer* OutStaticMeshBuffer)
+{
+	if (LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetUseFullPrecisionUVs())
+	{
+		SkinVertices< TGPUSkinVertexFloat32Uvs<1> >(OutVertices, ReferenceToLocal, LODIndex, LOD, WeightBuffer, ActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, OutPositionBuffer, OutStaticMeshBuffer);
+	}
+	else
+	{
+		SkinVertices< TGPUSkinVertexFloat16Uvs<1> >(OutVertices, ReferenceToLocal, LODIndex, LOD, WeightBuffer, ActiveMorphTargets, MorphTargetWeights, ClothSimulUpdateData, ClothBlendWeight, WorldToLocal, OutPositionBuffer, OutStaticMeshBuffer);
+	}
+}
+
 const FVertexFactory* FSkeletalMeshObjectCPUSkin::GetSkinVertexFactory(const FSceneView* View, int32 LODIndex,int32 /*ChunkIdx*/) const
 {
 	check( LODs.IsValidIndex(LODIndex) );
@@ -631,6 +673,18 @@ void TermEvalInfos(TArray<FMorphTargetInfo>& EvalInfos)
 	EvalInfos.Empty();
 }
 
+/** Moves the next delta of every morph to the first one affecting BaseVertIdx or a later vertex, to start blending from there */
+static void SeekEvalInfos(TArray<FMorphTargetInfo>& EvalInfos, int32 BaseVertIdx)
+{
+	for (FMorphTargetInfo& Info : EvalInfos)
+	{
+		if (Info.NextDeltaIndex != INDEX_NONE)
+		{
+			Info.NextDeltaIndex = Algo::LowerBoundBy(MakeArrayView(Info.Deltas, Info.NumDeltas), (uint32)BaseVertIdx, &FMorphTargetDelta::SourceIdx);
+		}
+	}
+}
+
 /** 
 * Derive the tanget/binormal using the new normal and the base tangent vectors for a vertex 
 */
@@ -716,7 +770,8 @@ static void SkinVertexSection(
 	const FSkelMeshRenderSection& Section,
 	const FSkeletalMeshLODRenderData &LOD,
 	FSkinWeightVertexBuffer& WeightBuffer,
-	int32 VertexBufferBaseIndex, 
+	int32 FirstVertexIndex,
+	int32 NumVertices,
 	uint32 NumValidMorphs, 
 	int32 &CurBaseVertIdx, 
 	int32 LODIndex, 
@@ -736,11 +791,10 @@ static void SkinVertexSection(
 
 	const int32 MaxSectionBoneInfluences = WeightBuffer.GetMaxBoneInfluences();
 	const bool bLODUsesCloth = LOD.HasClothData() && ClothSimData != nullptr && ClothBlendWeight > 0.0f;
-	const int32 NumSoftVertices = Section.GetNumVertices();
-	if (NumSoftVertices > 0)
+	if (NumVertices > 0)
 	{
-		INC_DWORD_STAT_BY(STAT_CPUSkinVertices,NumSoftVertices);
-		for(int32 VertexIndex = VertexBufferBaseIndex;VertexIndex < NumSoftVertices;VertexIndex++,DestVertex++)
+		INC_DWORD_STAT_BY(STAT_CPUSkinVertices,NumVertices);
+		for(int32 VertexIndex = FirstVertexIndex;VertexIndex < FirstVertexIndex + NumVertices;VertexIndex++,DestVertex++)
 		{
 			const int32 VertexBufferIndex = Section.GetVertexBufferIndex() + VertexIndex;
 
@@ -776,7 +830,7 @@ static void SkinVertexSection(
 			const FBoneIndexType* RESTRICT BoneIndices = SrcWeights.InfluenceBones;
 			const uint8* RESTRICT BoneWeights = SrcWeights.InfluenceWeights;
 
-			static VectorRegister	SrcNormals[3];
+			VectorRegister			SrcNormals[3];
 			VectorRegister			DstNormals[3];
 			SrcNormals[0] = VectorLoadFloat3_W1( &MorphedVertex->Position);
 			SrcNormals[1] = Unpack3( &MorphedVertex->TangentX.Vector.Packed );
@@ -1028,22 +1082,133 @@ static void SkinVertexSection(
 	}
 }
 
+/** Streams of ispc::SkinVerticesSoA, each as long as the vertices skinned. Must match SkeletalRenderCPUSkin.ispc */
+enum ECPUSkinStream
+{
+	CPUSkinStream_PositionX = 0,
+	CPUSkinStream_TangentXX = 3,
+	CPUSkinStream_TangentZX = 6,
+	CPUSkinStream_TangentZW = 9,
+	CPUSkinStream_Num = 10,
+};
+
+/**
+ * Same as SkinVertexSection without cloth, but the morphed source vertices are first transposed into streams of positions,
+ * tangents, bone indices and weights so the ISPC kernel skins a vector of vertices at a time.
+ */
+template<typename VertexType>
+static void SkinVertexSectionISPC(
+	FFinalSkinVertex* DestVertex,
+	TArray<FMorphTargetInfo>& MorphEvalInfos,
+	const TArray<float>& MorphWeights,
+	const FSkelMeshRenderSection& Section,
+	const FSkeletalMeshLODRenderData& LOD,
+	FSkinWeightVertexBuffer& WeightBuffer,
+	int32 FirstVertexIndex,
+	int32 NumVertices,
+	uint32 NumValidMorphs,
+	int32 CurBaseVertIdx,
+	int32 LODIndex,
+	const FMatrix* ReferenceToLocal)
+{
+#if INTEL_ISPC
+	if (NumVertices <= 0)
+	{
+		return;
+	}
+	INC_DWORD_STAT_BY(STAT_CPUSkinVertices, NumVertices);
+
+	const int32 NumInfluences = WeightBuffer.GetMaxBoneInfluences();
+	const FBoneIndexType* BoneMap = Section.BoneMap.GetData();
+
+	TArray<float> SourceStreams;
+	SourceStreams.SetNumUninitialized(NumVertices * CPUSkinStream_Num);
+	TArray<float> SkinnedStreams;
+	SkinnedStreams.SetNumUninitialized(NumVertices * CPUSkinStream_Num);
+	TArray<int32> BoneIndices;
+	BoneIndices.SetNumUninitialized(NumVertices * NumInfluences);
+	TArray<float> BoneWeights;
+	BoneWeights.SetNumUninitialized(NumVertices * NumInfluences);
+
+	VertexType VertexCopy;
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		const int32 VertexBufferIndex = Section.GetVertexBufferIndex() + FirstVertexIndex + Vertex;
+
+		VertexType SrcSoftVertex;
+		SrcSoftVertex.Position = LOD.StaticVertexBuffers.PositionVertexBuffer.VertexPosition(VertexBufferIndex);
+		SrcSoftVertex.TangentX = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.VertexTangentX(VertexBufferIndex);
+		SrcSoftVertex.TangentZ = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.VertexTangentZ(VertexBufferIndex);
+
+		const VertexType* MorphedVertex = &SrcSoftVertex;
+		if (NumValidMorphs)
+		{
+			for (uint32 j = 0; j < VertexType::NumTexCoords; j++)
+			{
+				SrcSoftVertex.UVs[j] = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetVertexUV_Typed<VertexType::StaticMeshVertexUVType>(VertexBufferIndex, j);
+			}
+			UpdateMorphedVertex<VertexType>(VertexCopy, SrcSoftVertex, CurBaseVertIdx, LODIndex, MorphEvalInfos, MorphWeights);
+			MorphedVertex = &VertexCopy;
+		}
+		CurBaseVertIdx++;
+
+		const FVector TangentX = MorphedVertex->TangentX.ToFVector();
+		const FVector4 TangentZ = MorphedVertex->TangentZ.ToFVector4();
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			SourceStreams[(CPUSkinStream_PositionX + Axis) * NumVertices + Vertex] = MorphedVertex->Position[Axis];
+			SourceStreams[(CPUSkinStream_TangentXX + Axis) * NumVertices + Vertex] = TangentX[Axis];
+			SourceStreams[(CPUSkinStream_TangentZX + Axis) * NumVertices + Vertex] = TangentZ[Axis];
+		}
+		SourceStreams[CPUSkinStream_TangentZW * NumVertices + Vertex] = TangentZ.W;
+
+		const FSkinWeightInfo SrcWeights = WeightBuffer.GetVertexSkinWeights(VertexBufferIndex);
+		for (int32 Influence = 0; Influence < NumInfluences; ++Influence)
+		{
+			BoneIndices[Influence * NumVertices + Vertex] = BoneMap[SrcWeights.InfluenceBones[Influence]];
+			BoneWeights[Influence * NumVertices + Vertex] = SrcWeights.InfluenceWeights[Influence] * (1.0f / 255.0f);
+		}
+	}
+
+	ispc::SkinVerticesSoA(SkinnedStreams.GetData(), SourceStreams.GetData(), BoneIndices.GetData(), BoneWeights.GetData(), (const float*)ReferenceToLocal, NumVertices, NumInfluences);
+
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex, ++DestVertex)
+	{
+		DestVertex->Position.X = SkinnedStreams[CPUSkinStream_PositionX * NumVertices + Vertex];
+		DestVertex->Position.Y = SkinnedStreams[(CPUSkinStream_PositionX + 1) * NumVertices + Vertex];
+		DestVertex->Position.Z = SkinnedStreams[(CPUSkinStream_PositionX + 2) * NumVertices + Vertex];
+		DestVertex->TangentX = FVector(
+			SkinnedStreams[CPUSkinStream_TangentXX * NumVertices + Vertex],
+			SkinnedStreams[(CPUSkinStream_TangentXX + 1) * NumVertices + Vertex],
+			SkinnedStreams[(CPUSkinStream_TangentXX + 2) * NumVertices + Vertex]);
+		DestVertex->TangentZ = FVector4(
+			SkinnedStreams[CPUSkinStream_TangentZX * NumVertices + Vertex],
+			SkinnedStreams[(CPUSkinStream_TangentZX + 1) * NumVertices + Vertex],
+			SkinnedStreams[(CPUSkinStream_TangentZX + 2) * NumVertices + Vertex],
+			SkinnedStreams[CPUSkinStream_TangentZW * NumVertices + Vertex]);
+
+		const FVector2D UVs = LOD.StaticVertexBuffers.StaticMeshVertexBuffer.GetVertexUV(Section.GetVertexBufferIndex() + FirstVertexIndex + Vertex, 0);
+		DestVertex->U = UVs.X;
+		DestVertex->V = UVs.Y;
+	}
+#endif
+}
+
 template<typename VertexType>
 static void SkinVertices(
 	FFinalSkinVertex* DestVertex, 
-	FMatrix* ReferenceToLocal, 
+	const FMatrix* ReferenceToLocal, 
 	int32 LODIndex, 
 	FSkeletalMeshLODRenderData& LOD,
 	FSkinWeightVertexBuffer& WeightBuffer,
-	TArray<FActiveMorphTarget>& ActiveMorphTargets, 
-	TArray<float>& MorphTargetWeights, 
+	const TArray<FActiveMorphTarget>& ActiveMorphTargets, 
+	const TArray<float>& MorphTargetWeights, 
 	const TMap<int32, FClothSimulData>& ClothSimulUpdateData, 
 	float ClothBlendWeight, 
-	const FMatrix& WorldToLocal)
+	const FMatrix& WorldToLocal,
+	FPositionVertexBuffer* OutPositionBuffer,
+	FStaticMeshVertexBuffer* OutStaticMeshBuffer)
 {
-	uint32 StatusRegister = VectorGetControlRegister();
-	VectorSetControlRegister( StatusRegister | VECTOR_ROUND_TOWARD_ZERO );
-
 	// Create array to track state during morph blending
 	TArray<FMorphTargetInfo> MorphEvalInfos;
 	uint32 NumValidMorphs = InitEvalInfos(ActiveMorphTargets, MorphTargetWeights, LODIndex, MorphEvalInfos);
@@ -1057,20 +1222,76 @@ static void SkinVertices(
 		FPlatformMisc::Prefetch( ReferenceToLocal + MatrixIndex );
 	}
 
-	int32 CurBaseVertIdx = 0;
+	// Sections are split into runs of vertices skinned by separate tasks
+	struct FSkinTask
+	{
+		int32 SectionIndex;
+		int32 FirstVertexIndex;
+		int32 NumVertices;
+	};
+	TArray<FSkinTask, TInlineAllocator<16>> Tasks;
+
+	const int32 VerticesPerTask = CVarCPUSkinningVerticesPerTask.GetValueOnAnyThread();
+	for (int32 SectionIndex = 0; SectionIndex < LOD.RenderSections.Num(); SectionIndex++)
+	{
+		const int32 NumSectionVertices = LOD.RenderSections[SectionIndex].GetNumVertices();
+		const int32 NumTaskVertices = VerticesPerTask > 0 ? VerticesPerTask : FMath::Max(NumSectionVertices, 1);
+		for (int32 FirstVertexIndex = 0; FirstVertexIndex < NumSectionVertices; FirstVertexIndex += NumTaskVertices)
+		{
+			Tasks.Add({ SectionIndex, FirstVertexIndex, FMath::Min(NumTaskVertices, NumSectionVertices - FirstVertexIndex) });
+		}
+	}
 
-	int32 VertexBufferBaseIndex=0;
+	const bool bUseISPC = UseCPUSkinningISPC();
 
-	for(int32 SectionIndex= 0;SectionIndex< LOD.RenderSections.Num();SectionIndex++)
+	ParallelFor(Tasks.Num(), [&](int32 TaskIndex)
 	{
-		FSkelMeshRenderSection& Section = LOD.RenderSections[SectionIndex];
+		const FSkinTask& Task = Tasks[TaskIndex];
+		const FSkelMeshRenderSection& Section = LOD.RenderSections[Task.SectionIndex];
+
+		// The rounding mode is per thread
+		uint32 StatusRegister = VectorGetControlRegister();
+		VectorSetControlRegister( StatusRegister | VECTOR_ROUND_TOWARD_ZERO );
+
+		// Sections follow each other in the vertex buffer, so the base vertex of a task is where its section starts plus its offset
+		int32 CurBaseVertIdx = Section.BaseVertexIndex + Task.FirstVertexIndex;
+		FFinalSkinVertex* TaskDestVertex = DestVertex + CurBaseVertIdx;
+
+		TArray<FMorphTargetInfo> TaskMorphEvalInfos;
+		if (NumValidMorphs)
+		{
+			TaskMorphEvalInfos = MorphEvalInfos;
+			SeekEvalInfos(TaskMorphEvalInfos, CurBaseVertIdx);
+		}
 
 		const FClothSimulData* ClothSimData = ClothSimulUpdateData.Find(Section.CorrespondClothAssetIndex);
+		const bool bSectionUsesCloth = LOD.HasClothData() && ClothSimData != nullptr && ClothBlendWeight > 0.0f;
 
-		SkinVertexSection<VertexType>(DestVertex, MorphEvalInfos, MorphTargetWeights, Section, LOD, WeightBuffer, VertexBufferBaseIndex, NumValidMorphs, CurBaseVertIdx, LODIndex, ReferenceToLocal, ClothSimData, ClothBlendWeight, WorldToLocal);
-	}
+		if (bUseISPC && !bSectionUsesCloth)
+		{
+			SkinVertexSectionISPC<VertexType>(TaskDestVertex, TaskMorphEvalInfos, MorphTargetWeights, Section, LOD, WeightBuffer, Task.FirstVertexIndex, Task.NumVertices, NumValidMorphs, CurBaseVertIdx, LODIndex, ReferenceToLocal);
+		}
+		else
+		{
+			FFinalSkinVertex* SectionDestVertex = TaskDestVertex;
+			SkinVertexSection<VertexType>(SectionDestVertex, TaskMorphEvalInfos, MorphTargetWeights, Section, LOD, WeightBuffer, Task.FirstVertexIndex, Task.NumVertices, NumValidMorphs, CurBaseVertIdx, LODIndex, ReferenceToLocal, ClothSimData, ClothBlendWeight, WorldToLocal);
+		}
 
-	VectorSetControlRegister( StatusRegister );
+		VectorSetControlRegister( StatusRegister );
+
+		// Fill the vertex buffers while the skinned vertices are still in cache
+		if (OutPositionBuffer && OutStaticMeshBuffer)
+		{
+			const int32 FirstBufferIndex = Section.BaseVertexIndex + Task.FirstVertexIndex;
+			for (int32 VertexIndex = FirstBufferIndex; VertexIndex < FirstBufferIndex + Task.NumVertices; VertexIndex++)
+			{
+				const FFinalSkinVertex& Vertex = DestVertex[VertexIndex];
+				OutPositionBuffer->VertexPosition(VertexIndex) = Vertex.Position;
+				OutStaticMeshBuffer->SetVertexTangents(VertexIndex, Vertex.TangentX.ToFVector(), Vertex.GetTangentY(), Vertex.TangentZ.ToFVector());
+				OutStaticMeshBuffer->SetVertexUV(VertexIndex, 0, FVector2D(Vertex.U, Vertex.V));
+			}
+		}
+	}, VerticesPerTask <= 0 || Tasks.Num() <= 1);
 }
 
 /**
@@ -151,6 +151,16 @@ public:
 	/** Access cached final vertices */
 	const TArray<FFinalSkinVertex>& GetCachedFinalVertices() const { return CachedFinalVertices; }
 
+	/**
+	 * Skins, morphs and applies cloth to every vertex of LOD, in parallel tasks of up to r.CPUSkinning.VerticesPerTask vertices of a section.
+	 * @param	OutVertices - receives LOD.GetNumVertices() skinned vertices
+	 * @param	OutPositionBuffer - optional, also receives the skinned positions from the tasks
+	 * @param	OutStaticMeshBuffer - optional, also receives the skinned tangents and first UV from the tasks
+	 */
+	static void SkinLODVertices(FFinalSkinVertex* OutVertices, const FMatrix* ReferenceToLocal, int32 LODIndex, FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer,
+		const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, const TMap<int32, FClothSimulData>& ClothSimulUpdateData, float ClothBlendWeight,
+		const FMatrix& WorldToLocal, FPositionVertexBuffer* OutPositionBuffer = nullptr, FStaticMeshVertexBuffer* OutStaticMeshBuffer = nullptr);
+
 
 	virtual void UpdateSkinWeightBuffer(USkinnedMeshComponent* InMeshComponent) override;
 
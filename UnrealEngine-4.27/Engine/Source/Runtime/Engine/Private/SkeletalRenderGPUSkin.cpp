@@ -14,6 +14,11 @@
 #include "ShaderParameterUtils.h"
 #include "SkeletalMeshTypes.h"
 #include "HAL/LowLevelMemTracker.h"
+#include "Hash/CityHash.h"
+
+#if INTEL_ISPC
+#include "SkeletalRenderGPUSkin.ispc.generated.h"
+#endif
 
 DEFINE_LOG_CATEGORY_STATIC(LogSkeletalGPUSkinMesh, Warning, All);
 
@@ -26,6 +31,7 @@ DECLARE_CYCLE_STAT(TEXT("Morph Vertex Buffer Apply Delta"),STAT_MorphVertexBuffe
 DECLARE_CYCLE_STAT(TEXT("Morph Vertex Buffer Alloc"), STAT_MorphVertexBuffer_Alloc, STATGROUP_MorphTarget);
 DECLARE_CYCLE_STAT(TEXT("Morph Vertex Buffer RHI Lock and copy"), STAT_MorphVertexBuffer_RhiLockAndCopy, STATGROUP_MorphTarget);
 DECLARE_CYCLE_STAT(TEXT("Morph Vertex Buffer RHI Unlock"), STAT_MorphVertexBuffer_RhiUnlock, STATGROUP_MorphTarget);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Morph Vertex Buffer Deltas Accumulated"), STAT_MorphVertexBuffer_NumDeltas, STATGROUP_MorphTarget);
 DECLARE_GPU_STAT_NAMED(MorphTargets, TEXT("Morph Target Compute"));
 
 static TAutoConsoleVariable<int32> CVarMotionBlurDebug(
@@ -61,6 +67,16 @@ static bool UseGPUMorphTargets(const EShaderPlatform Platform)
 	return GUseGPUMorphTargets != 0 && IsFeatureLevelSupported(Platform, ERHIFeatureLevel::SM5);
 }
 
+static int32 GMorphTargetCPURebuildInterval = 64;
+static FAutoConsoleVariableRef CVarMorphTargetCPURebuildInterval(
+	TEXT("r.MorphTarget.CPU.RebuildInterval"),
+	GMorphTargetCPURebuildInterval,
+	TEXT("With quantized CPU deltas, the CPU morph path only applies the morphs whose weight changed since the last update.\n")
+	TEXT("Every this many updates the accumulated deltas are rebuilt from all active morphs instead (default 64).\n")
+	TEXT(" 0: Always rebuild\n"),
+	ECVF_RenderThreadSafe
+	);
+
 static float GMorphTargetWeightThreshold = SMALL_NUMBER;
 static FAutoConsoleVariableRef CVarMorphTargetWeightThreshold(
 	TEXT("r.MorphTarget.WeightThreshold"),
@@ -474,6 +490,19 @@ void FSkeletalMeshObjectGPUSkin::ProcessUpdatedDynamicData(FGPUSkinCache* GPUSki
 
 	bool bGPUSkinCacheEnabled = GPUSkinCache && GEnableGPUSkinCache && (FeatureLevel >= ERHIFeatureLevel::SM5) && DynamicData->bIsSkinCacheAllowed;
 
+	if (bGPUSkinCacheEnabled && FGPUSkinCache::IsPoseSharingEnabled())
+	{
+		// Without previous matrices the previous bone buffer keeps the last uploaded pose
+		const TArray<FMatrix>& PreviousReferenceToLocal = DynamicData->PreviousReferenceToLocal;
+		PreviousPoseHash = PreviousReferenceToLocal.Num() > 0 ? CityHash64((const char*)PreviousReferenceToLocal.GetData(), PreviousReferenceToLocal.Num() * sizeof(FMatrix)) : PoseHash;
+		PoseHash = CityHash64((const char*)DynamicData->ReferenceToLocal.GetData(), DynamicData->ReferenceToLocal.Num() * sizeof(FMatrix));
+	}
+	else
+	{
+		PoseHash = 0;
+		PreviousPoseHash = 0;
+	}
+
 	if (DynamicData->PreSkinningOffsets.Num() > 0)
 	{
 		FPositionVertexBuffer& PositionBuffer = LOD.VertexOffsetVertexBuffers.PreSkinningOffsetsVertexBuffer;
@@ -978,6 +1007,193 @@ void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::UpdateSkinWeights(FSkel
 	
 }
 
+void FMorphTargetCPUAccumulation::Reset()
+{
+	Positions.Empty();
+	TangentZs.Empty();
+	AppliedWeights.Empty();
+	TargetWeights.Empty();
+	WeightedMorphs.Empty();
+	NumUpdatesSinceRebuild = 0;
+}
+
+static void AccumulateMorphDeltas(FVector4* RESTRICT Positions, FVector4* RESTRICT TangentZs, const FMorphTargetCPUDeltas::FQuantizedDelta* RESTRICT Deltas, const TArray<FMorphTargetCPUAccumulation::FWeightedMorph>& WeightedMorphs, bool bBlendTangents)
+{
+	if (INTEL_ISPC)
+	{
+#if INTEL_ISPC
+		static_assert(sizeof(ispc::FQuantizedMorphDelta) == sizeof(FMorphTargetCPUDeltas::FQuantizedDelta), "FMorphTargetCPUDeltas::FQuantizedDelta and ispc::FQuantizedMorphDelta sizes don't match!");
+		static_assert(sizeof(ispc::FWeightedMorph) == sizeof(FMorphTargetCPUAccumulation::FWeightedMorph), "FMorphTargetCPUAccumulation::FWeightedMorph and ispc::FWeightedMorph sizes don't match!");
+
+		ispc::AccumulateMorphDeltas(
+			(float*)Positions,
+			(float*)TangentZs,
+			(const ispc::FQuantizedMorphDelta*)Deltas,
+			(const ispc::FWeightedMorph*)WeightedMorphs.GetData(),
+			WeightedMorphs.Num(),
+			bBlendTangents);
+#endif
+	}
+	else
+	{
+		for (const FMorphTargetCPUAccumulation::FWeightedMorph& Morph : WeightedMorphs)
+		{
+			const VectorRegister PositionWeight = MakeVectorRegister(Morph.PositionWeight[0], Morph.PositionWeight[1], Morph.PositionWeight[2], 0.0f);
+			const VectorRegister TangentZWeight = MakeVectorRegister(Morph.TangentZWeight, Morph.TangentZWeight, Morph.TangentZWeight, Morph.AbsWeight);
+
+			const FMorphTargetCPUDeltas::FQuantizedDelta* MorphDeltas = Deltas + Morph.StartOffset;
+			for (uint32 DeltaIndex = 0; DeltaIndex < Morph.NumDeltas; ++DeltaIndex)
+			{
+				const FMorphTargetCPUDeltas::FQuantizedDelta& Delta = MorphDeltas[DeltaIndex];
+
+				float* Position = &Positions[Delta.MorphedVertexIndex].X;
+				const VectorRegister PositionDelta = MakeVectorRegister((float)Delta.Position[0], (float)Delta.Position[1], (float)Delta.Position[2], 0.0f);
+				VectorStore(VectorMultiplyAdd(PositionDelta, PositionWeight, VectorLoad(Position)), Position);
+
+				if (bBlendTangents)
+				{
+					// W counts the absolute weight the tangent was accumulated with
+					float* TangentZ = &TangentZs[Delta.MorphedVertexIndex].X;
+					const VectorRegister TangentZDelta = MakeVectorRegister((float)Delta.TangentZ[0], (float)Delta.TangentZ[1], (float)Delta.TangentZ[2], 1.0f);
+					VectorStore(VectorMultiplyAdd(TangentZDelta, TangentZWeight, VectorLoad(TangentZ)), TangentZ);
+				}
+			}
+		}
+	}
+}
+
+static void WriteMorphVertices(FMorphGPUSkinVertex* OutVertices, const FVector4* Positions, const FVector4* TangentZs, const uint32* MorphedVertices, uint32 StartMorphedVertex, uint32 NumMorphedVertices, bool bBlendTangents)
+{
+	if (INTEL_ISPC)
+	{
+#if INTEL_ISPC
+		ispc::WriteMorphVertices((float*)OutVertices, (const float*)Positions, (const float*)TangentZs, MorphedVertices, StartMorphedVertex, NumMorphedVertices, bBlendTangents);
+#endif
+	}
+	else
+	{
+		for (uint32 MorphedVertex = StartMorphedVertex; MorphedVertex < StartMorphedVertex + NumMorphedVertices; ++MorphedVertex)
+		{
+			FMorphGPUSkinVertex& OutVertex = OutVertices[MorphedVertices[MorphedVertex]];
+			OutVertex.DeltaPosition = FVector(Positions[MorphedVertex]);
+
+			if (bBlendTangents)
+			{
+				// Same normalization as the source delta path, only once the weights add up to more than 1
+				const FVector4& TangentZ = TangentZs[MorphedVertex];
+				OutVertex.DeltaTangentZ = FVector(TangentZ) / FMath::Max(TangentZ.W, 1.0f);
+			}
+			else
+			{
+				OutVertex.DeltaTangentZ = FVector::ZeroVector;
+			}
+		}
+	}
+}
+
+int32 FMorphTargetCPUAccumulation::Update(const FMorphTargetCPUDeltas& Deltas, const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, bool bBlendTangents, uint32 NumVertices, FMorphGPUSkinVertex* OutVertices)
+{
+	const int32 NumMorphs = Deltas.GetNumMorphs();
+	check(MorphTargetWeights.Num() == NumMorphs);
+
+	const TArray<uint32>& MorphedVertices = Deltas.GetMorphedVertices();
+	const int32 NumMorphedVertices = MorphedVertices.Num();
+	check(NumMorphedVertices == 0 || MorphedVertices.Last() < NumVertices);
+
+	TargetWeights.Reset(NumMorphs);
+	TargetWeights.AddZeroed(NumMorphs);
+
+	uint64 ActiveSectionMask = 0;
+	int32 NumActiveDeltas = 0;
+	for (const FActiveMorphTarget& ActiveMorphTarget : ActiveMorphTargets)
+	{
+		if (TargetWeights.IsValidIndex(ActiveMorphTarget.WeightIndex))
+		{
+			const FMorphTargetCPUDeltas::FMorph& Morph = Deltas.GetMorph(ActiveMorphTarget.WeightIndex);
+			TargetWeights[ActiveMorphTarget.WeightIndex] = MorphTargetWeights[ActiveMorphTarget.WeightIndex];
+			ActiveSectionMask |= Morph.SectionMask;
+			NumActiveDeltas += Morph.NumDeltas;
+		}
+	}
+
+	bool bRebuild = Positions.Num() != NumMorphedVertices || AppliedWeights.Num() != NumMorphs || bAppliedBlendTangents != bBlendTangents
+		|| NumUpdatesSinceRebuild >= GMorphTargetCPURebuildInterval;
+
+	int32 NumChangedDeltas = 0;
+	if (!bRebuild)
+	{
+		for (int32 MorphIndex = 0; MorphIndex < NumMorphs; ++MorphIndex)
+		{
+			if (TargetWeights[MorphIndex] != AppliedWeights[MorphIndex])
+			{
+				NumChangedDeltas += Deltas.GetMorph(MorphIndex).NumDeltas;
+			}
+		}
+
+		// Clearing costs about as much as accumulating a delta per vertex
+		bRebuild = NumChangedDeltas > NumActiveDeltas + NumMorphedVertices;
+	}
+
+	if (bRebuild)
+	{
+		Positions.Reset(NumMorphedVertices);
+		Positions.AddZeroed(NumMorphedVertices);
+		TangentZs.Reset(NumMorphedVertices);
+		TangentZs.AddZeroed(NumMorphedVertices);
+		AppliedWeights.Reset(NumMorphs);
+		AppliedWeights.AddZeroed(NumMorphs);
+		bAppliedBlendTangents = bBlendTangents;
+		NumUpdatesSinceRebuild = 0;
+	}
+	else
+	{
+		++NumUpdatesSinceRebuild;
+	}
+
+	WeightedMorphs.Reset();
+	int32 NumAccumulatedDeltas = 0;
+	for (int32 MorphIndex = 0; MorphIndex < NumMorphs; ++MorphIndex)
+	{
+		const float TargetWeight = TargetWeights[MorphIndex];
+		const float AppliedWeight = AppliedWeights[MorphIndex];
+		const FMorphTargetCPUDeltas::FMorph& Morph = Deltas.GetMorph(MorphIndex);
+		if (TargetWeight == AppliedWeight || Morph.NumDeltas == 0)
+		{
+			continue;
+		}
+
+		// Adding the difference of the weights takes the sums from the applied weight to the target one
+		const float Weight = TargetWeight - AppliedWeight;
+		FWeightedMorph& WeightedMorph = WeightedMorphs.AddUninitialized_GetRef();
+		WeightedMorph.StartOffset = Morph.StartOffset;
+		WeightedMorph.NumDeltas = Morph.NumDeltas;
+		WeightedMorph.PositionWeight[0] = Morph.PositionScale.X * Weight;
+		WeightedMorph.PositionWeight[1] = Morph.PositionScale.Y * Weight;
+		WeightedMorph.PositionWeight[2] = Morph.PositionScale.Z * Weight;
+		WeightedMorph.TangentZWeight = Morph.TangentZScale * Weight;
+		WeightedMorph.AbsWeight = FMath::Abs(TargetWeight) - FMath::Abs(AppliedWeight);
+		NumAccumulatedDeltas += Morph.NumDeltas;
+	}
+
+	AccumulateMorphDeltas(Positions.GetData(), TangentZs.GetData(), Deltas.GetDeltas().GetData(), WeightedMorphs, bBlendTangents);
+	Swap(AppliedWeights, TargetWeights);
+
+	// Vertices no morph moves are 0, and so are the ones of sections no active morph moves, whatever float error their sums have left
+	FMemory::Memzero(OutVertices, NumVertices * sizeof(FMorphGPUSkinVertex));
+
+	const TArray<FUintPoint>& SectionMorphedVertexRanges = Deltas.GetSectionMorphedVertexRanges();
+	for (int32 SectionIndex = 0; SectionIndex < SectionMorphedVertexRanges.Num(); ++SectionIndex)
+	{
+		const uint64 SectionBit = SectionIndex < 64 ? (1ull << SectionIndex) : MAX_uint64;
+		if ((ActiveSectionMask & SectionBit) && SectionMorphedVertexRanges[SectionIndex].Y > 0)
+		{
+			WriteMorphVertices(OutVertices, Positions.GetData(), TangentZs.GetData(), MorphedVertices.GetData(), SectionMorphedVertexRanges[SectionIndex].X, SectionMorphedVertexRanges[SectionIndex].Y, bBlendTangents);
+		}
+	}
+
+	return NumAccumulatedDeltas;
+}
+
 void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::UpdateMorphVertexBufferCPU(const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights)
 {
 	SCOPE_CYCLE_COUNTER(STAT_MorphVertexBuffer_Update);
@@ -995,6 +1211,30 @@ void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::UpdateMorphVertexBuffer
 
 		uint32 Size = LodData.GetNumVertices() * sizeof(FMorphGPUSkinVertex);
 
+		// Quantized deltas are accumulated straight into the locked buffer
+		const FMorphTargetCPUDeltas& CPUDeltas = LodData.MorphTargetCPUDeltas;
+		if (CPUDeltas.GetNumMorphs() > 0 && CPUDeltas.GetNumMorphs() == MorphTargetWeights.Num())
+		{
+			FMorphGPUSkinVertex* ActualBuffer = nullptr;
+			{
+				SCOPE_CYCLE_COUNTER(STAT_MorphVertexBuffer_RhiLockAndCopy);
+				ActualBuffer = (FMorphGPUSkinVertex*)RHILockVertexBuffer(MorphVertexBuffer.VertexBufferRHI, 0, Size, RLM_WriteOnly);
+			}
+
+			{
+				SCOPE_CYCLE_COUNTER(STAT_MorphVertexBuffer_ApplyDelta);
+				const int32 NumDeltas = MorphCPUAccumulation.Update(CPUDeltas, ActiveMorphTargets, MorphTargetWeights, bBlendTangentsOnCPU, LodData.GetNumVertices(), ActualBuffer);
+				INC_DWORD_STAT_BY(STAT_MorphVertexBuffer_NumDeltas, NumDeltas);
+			}
+
+			{
+				SCOPE_CYCLE_COUNTER(STAT_MorphVertexBuffer_RhiUnlock);
+				RHIUnlockVertexBuffer(MorphVertexBuffer.VertexBufferRHI);
+				MorphVertexBuffer.bHasBeenUpdated = true;
+			}
+			return;
+		}
+
 		FMorphGPUSkinVertex* Buffer = nullptr;
 		{
 			SCOPE_CYCLE_COUNTER(STAT_MorphVertexBuffer_Alloc);
@@ -1037,6 +1277,7 @@ void FSkeletalMeshObjectGPUSkin::FSkeletalMeshObjectLOD::UpdateMorphVertexBuffer
 				// Get deltas
 				int32 NumDeltas;
 				FMorphTargetDelta* Deltas = MorphTarget.MorphTarget->GetMorphTargetDelta(LODIndex, NumDeltas);
+				INC_DWORD_STAT_BY(STAT_MorphVertexBuffer_NumDeltas, NumDeltas);
 
 				// iterate over the vertices that this lod model has changed
 				for (int32 MorphVertIdx = 0; MorphVertIdx < NumDeltas; MorphVertIdx++)
@@ -1110,6 +1351,7 @@ const FVertexFactory* FSkeletalMeshObjectGPUSkin::GetSkinVertexFactory(const FSc
 	// If the GPU skinning cache was used, return the passthrough vertex factory
 	if (SkinCacheEntry && FGPUSkinCache::IsEntryValid(SkinCacheEntry, ChunkIdx) && DynamicData->bIsSkinCacheAllowed)
 	{
+		FGPUSkinCache::MarkEntryDrawn(SkinCacheEntry);
 		return LOD.GPUSkinVertexFactories.PassthroughVertexFactories[ChunkIdx].Get();
 	}
 
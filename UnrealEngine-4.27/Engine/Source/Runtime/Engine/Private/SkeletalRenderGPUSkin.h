@@ -142,6 +142,66 @@ struct FMorphGPUSkinVertex
 	}
 };
 
+/**
+ * Running sums of the quantized morph deltas of one LOD, for the CPU morph path, kept for the vertices some morph moves only. Only
+ * morphs whose weight changed since the last update are applied, with the difference of their weights, and the sums are rebuilt
+ * from scratch every r.MorphTarget.CPU.RebuildInterval updates so float error doesn't build up.
+ */
+class FMorphTargetCPUAccumulation
+{
+public:
+
+	// Changes to this struct must be reflected in SkeletalRenderGPUSkin.ispc
+	struct FWeightedMorph
+	{
+		uint32 StartOffset;
+		uint32 NumDeltas;
+		float PositionWeight[3];
+		float TangentZWeight;
+		float AbsWeight;
+	};
+
+	/**
+	 * Brings the sums up to date with MorphTargetWeights and writes them to OutVertices
+	 * @param Deltas - quantized deltas of the LOD, with one morph per weight
+	 * @param ActiveMorphTargets - morphs with a weight, every other morph is treated as 0
+	 * @param MorphTargetWeights - weight of every morph
+	 * @param bBlendTangents - whether tangents are accumulated, they are written as 0 otherwise
+	 * @param NumVertices - number of vertices of the LOD, and of OutVertices
+	 * @return number of deltas accumulated
+	 */
+	int32 Update(const FMorphTargetCPUDeltas& Deltas, const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, bool bBlendTangents, uint32 NumVertices, FMorphGPUSkinVertex* OutVertices);
+
+	void Reset();
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Positions.GetAllocatedSize() + TangentZs.GetAllocatedSize() + AppliedWeights.GetAllocatedSize() + TargetWeights.GetAllocatedSize() + WeightedMorphs.GetAllocatedSize();
+	}
+
+private:
+
+	/** Accumulated position delta of every morphed vertex, W is unused */
+	TArray<FVector4> Positions;
+
+	/** Accumulated tangent delta of every morphed vertex, W is the sum of the absolute weights it was accumulated with */
+	TArray<FVector4> TangentZs;
+
+	/** Weight of every morph in the sums */
+	TArray<float> AppliedWeights;
+
+	/** Weight of every morph asked for by the current update */
+	TArray<float> TargetWeights;
+
+	/** Morphs to accumulate in the current update */
+	TArray<FWeightedMorph> WeightedMorphs;
+
+	/** Updates since the sums were last rebuilt */
+	int32 NumUpdatesSinceRebuild = 0;
+
+	bool bAppliedBlendTangents = false;
+};
+
 /**
 * MorphTarget vertices which have been combined into single position/tangentZ deltas
 */
@@ -430,6 +490,10 @@ public:
 
 	FSkinWeightVertexBuffer* GetSkinWeightVertexBuffer(int32 LODIndex) const;
 
+	/** Hashes of the bone matrices in the current and previous bone buffers, 0 unless r.SkinCache.ShareIdenticalPoses is on */
+	uint64 GetPoseHash() const { return PoseHash; }
+	uint64 GetPreviousPoseHash() const { return PreviousPoseHash; }
+
 	/** 
 	 * Vertex buffers that can be used for GPU skinning factories 
 	 */
@@ -579,6 +643,7 @@ private:
 			CumulativeResourceSize.AddUnknownMemoryBytes(MorphVertexBuffer.GetResourceSize());
 			CumulativeResourceSize.AddUnknownMemoryBytes(VertexOffsetVertexBuffers.GetResourceSize());
 			CumulativeResourceSize.AddUnknownMemoryBytes(GPUSkinVertexFactories.GetResourceSize());
+			CumulativeResourceSize.AddUnknownMemoryBytes(MorphCPUAccumulation.GetAllocatedSize());
 		}
 
 		FSkeletalMeshRenderData* SkelMeshRenderData;
@@ -588,6 +653,9 @@ private:
 		/** Vertex buffer that stores the morph target vertex deltas. Updated on the CPU */
 		FMorphVertexBuffer MorphVertexBuffer;
 
+		/** Deltas accumulated so far by the CPU morph path when the LOD has quantized deltas. Render thread only */
+		FMorphTargetCPUAccumulation MorphCPUAccumulation;
+
 		FVertexOffsetBuffers VertexOffsetVertexBuffers;
 
 		/** Default GPU skinning vertex factories and matrices */
@@ -655,6 +723,10 @@ private:
 
 	/** last updated bone transform revision number */
 	uint32 LastBoneTransformRevisionNumber;
+
+	/** @see GetPoseHash */
+	uint64 PoseHash = 0;
+	uint64 PreviousPoseHash = 0;
 };
 
 
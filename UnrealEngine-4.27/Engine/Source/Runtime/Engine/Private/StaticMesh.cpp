@@ -5562,6 +5562,15 @@ bool UStaticMesh::BuildFromMeshDescriptions(const TArray<const FMeshDescription*
 		check(MeshDescriptionPtr != nullptr);
 		FStaticMeshLODResources& LODResources = GetRenderData()->LODResources[LODIndex];
 
+		if (Params.bUseFullPrecisionUVs)
+		{
+#if WITH_EDITOR
+			// So rebuilding from the committed mesh description keeps them
+			GetSourceModel(LODIndex).BuildSettings.bUseFullPrecisionUVs = true;
+#endif
+			LODResources.VertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(true);
+		}
+
 		BuildFromMeshDescription(*MeshDescriptionPtr, LODResources);
 
 #if WITH_EDITOR
@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "AnimEncoding.h"
+#include "Animation/AnimCompressionTypes.h"
+#include "Animation/AnimCompress_BitwiseCompressOnly.h"
+#include "Animation/AnimSequenceDecompressionContext.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+/**
+ * Decompresses poses of two sequences with a.Decompression.KeyPairCacheSize off then on and checks the key pair cache gives the codecs'
+ * pose when playing forwards, backwards, jumping around, sampling only some tracks and at the ends. Then rebinds the first sequence's
+ * compressed data to the second one's buffer, keeping its address, and checks the cache doesn't hand back the keys it decoded before.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimKeyPairCacheTest, "System.Engine.Animation.KeyPairCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace AnimKeyPairCacheTest
+{
+	static const int32 NumTracks = 8;
+	static const int32 NumFrames = 31;
+	static const float SequenceLength = 1.0f;
+	static const float Tolerance = KINDA_SMALL_NUMBER;
+	/** Translations are up to 100 units long */
+	static const float TranslationTolerance = 100.0f * KINDA_SMALL_NUMBER;
+
+	/** Random keys on every frame of every track, so no track is reduced to a constant key */
+	static FCompressibleAnimData BuildAnimData(FRandomStream& Random, const TCHAR* Name)
+	{
+		FCompressibleAnimData AnimData;
+		AnimData.Name = Name;
+		AnimData.AnimFName = Name;
+		AnimData.SequenceLength = SequenceLength;
+		AnimData.NumFrames = NumFrames;
+		AnimData.Interpolation = EAnimInterpolationType::Linear;
+
+		AnimData.RawAnimationData.SetNum(NumTracks);
+		for (FRawAnimSequenceTrack& Track : AnimData.RawAnimationData)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Track.PosKeys.Add(Random.GetUnitVector() * Random.FRandRange(1.0f, 100.0f));
+				Track.RotKeys.Add(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI)));
+				Track.ScaleKeys.Add(FVector(Random.FRandRange(0.5f, 2.0f)));
+			}
+		}
+		return AnimData;
+	}
+
+	static void DecompressPose(const UAnimCompress& Codec, const FUECompressedAnimData& AnimData, float Time, const BoneTrackArray& Pairs, TArray<FTransform>& OutPose)
+	{
+		OutPose.Init(FTransform::Identity, NumTracks);
+		TArrayView<FTransform> Atoms(OutPose);
+
+		FAnimSequenceDecompressionContext DecompContext(SequenceLength, EAnimInterpolationType::Linear, NAME_None, AnimData);
+		DecompContext.Seek(Time);
+		Codec.DecompressPose(DecompContext, Pairs, Pairs, Pairs, Atoms);
+	}
+
+	static bool PosesMatch(const TArray<FTransform>& A, const TArray<FTransform>& B)
+	{
+		for (int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			if (!A[Index].GetTranslation().Equals(B[Index].GetTranslation(), TranslationTolerance)
+				|| !A[Index].GetRotation().Equals(B[Index].GetRotation(), Tolerance)
+				|| !A[Index].GetScale3D().Equals(B[Index].GetScale3D(), Tolerance))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool FAnimKeyPairCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimKeyPairCacheTest;
+
+	AutomationBenchmark::FScopedCVarValue KeyPairCacheSize(TEXT("a.Decompression.KeyPairCacheSize"), 0);
+
+	UAnimCompress_BitwiseCompressOnly* Codec = NewObject<UAnimCompress_BitwiseCompressOnly>();
+	Codec->TranslationCompressionFormat = ACF_None;
+	Codec->RotationCompressionFormat = ACF_Float96NoW;
+	Codec->ScaleCompressionFormat = ACF_None;
+
+	FRandomStream Random(0x4b50);
+	const FCompressibleAnimData SourceA = BuildAnimData(Random, TEXT("KeyPairCacheTestA"));
+	const FCompressibleAnimData SourceB = BuildAnimData(Random, TEXT("KeyPairCacheTestB"));
+
+	FCompressibleAnimDataResult ResultA;
+	FCompressibleAnimDataResult ResultB;
+	if (!TestTrue(TEXT("Both sequences compress"), Codec->Compress(SourceA, ResultA) && Codec->Compress(SourceB, ResultB)))
+	{
+		return false;
+	}
+
+	FUECompressedAnimData& AnimDataA = static_cast<FUECompressedAnimData&>(*ResultA.AnimData);
+	FUECompressedAnimData& AnimDataB = static_cast<FUECompressedAnimData&>(*ResultB.AnimData);
+
+	BoneTrackArray AllPairs;
+	BoneTrackArray EvenPairs;
+	for (int32 TrackIndex = 0; TrackIndex < NumTracks; ++TrackIndex)
+	{
+		AllPairs.Add(BoneTrackPair(TrackIndex, TrackIndex));
+		if (TrackIndex % 2 == 0)
+		{
+			EvenPairs.Add(BoneTrackPair(TrackIndex, TrackIndex));
+		}
+	}
+
+	// Forwards at a bit under 60Hz so several samples land between the same two frames, backwards, random jumps and both ends
+	TArray<float> Times;
+	for (float Time = 0.0f; Time <= SequenceLength; Time += 1.0f / 57.0f)
+	{
+		Times.Add(Time);
+	}
+	for (float Time = SequenceLength; Time >= 0.0f; Time -= 1.0f / 43.0f)
+	{
+		Times.Add(Time);
+	}
+	for (int32 Index = 0; Index < 64; ++Index)
+	{
+		Times.Add(Random.FRandRange(0.0f, SequenceLength));
+	}
+	Times.Add(0.0f);
+	Times.Add(SequenceLength);
+	Times.Add(SequenceLength * (float)(NumFrames / 2) / (float)(NumFrames - 1));
+
+	TArray<FTransform> CodecPose;
+	TArray<FTransform> CachedPose;
+	int32 NumMismatches = 0;
+	for (int32 Index = 0; Index < Times.Num(); ++Index)
+	{
+		// Alternate the sequences and the tracks sampled, so entries are shared and only some of their keys decoded at a time
+		const FUECompressedAnimData& AnimData = (Index / 3) % 2 == 0 ? AnimDataA : AnimDataB;
+		const BoneTrackArray& Pairs = Index % 5 == 0 ? EvenPairs : AllPairs;
+
+		KeyPairCacheSize.Set(0);
+		DecompressPose(*Codec, AnimData, Times[Index], Pairs, CodecPose);
+		KeyPairCacheSize.Set(8);
+		DecompressPose(*Codec, AnimData, Times[Index], Pairs, CachedPose);
+
+		if (!PosesMatch(CodecPose, CachedPose))
+		{
+			AddError(FString::Printf(TEXT("The key pair cache doesn't match the codecs at %.4fs"), Times[Index]));
+			++NumMismatches;
+		}
+	}
+	TestEqual(TEXT("The key pair cache matches the codecs"), NumMismatches, 0);
+
+	// Same address, same layout, different keys: what recompressing or reloading a sequence in place looks like to the cache
+	const float RebindTime = SequenceLength * 0.37f;
+	DecompressPose(*Codec, AnimDataA, RebindTime, AllPairs, CachedPose);
+
+	if (TestEqual(TEXT("Both sequences have the same compressed layout"), ResultA.CompressedByteStream.Num(), ResultB.CompressedByteStream.Num()))
+	{
+		AnimDataA.Bind(ResultB.CompressedByteStream);
+
+		KeyPairCacheSize.Set(0);
+		DecompressPose(*Codec, AnimDataA, RebindTime, AllPairs, CodecPose);
+		KeyPairCacheSize.Set(8);
+		DecompressPose(*Codec, AnimDataA, RebindTime, AllPairs, CachedPose);
+
+		TArray<FTransform> PoseB;
+		KeyPairCacheSize.Set(0);
+		DecompressPose(*Codec, AnimDataB, RebindTime, AllPairs, PoseB);
+
+		TestTrue(TEXT("Rebound data decompresses the keys of its new buffer"), PosesMatch(CodecPose, PoseB));
+		TestTrue(TEXT("The key pair cache doesn't reuse keys decoded before the data was rebound"), PosesMatch(CodecPose, CachedPose));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/AnimNotifyBatchTestSubsystem.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimNotifies/AnimNotify_PlaySound.h"
+#include "Sound/SoundWave.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+void UAnimNotifyBatchTestSubsystem::SpawnSound(const FAnimNotifySpawnRequest& Request)
+{
+	SpawnedSounds.Add(Request);
+	if (OnSpawn)
+	{
+		OnSpawn(Request);
+	}
+}
+
+void UAnimNotifyBatchTestSubsystem::SpawnParticleSystem(const FAnimNotifySpawnRequest& Request)
+{
+	SpawnedParticleSystems.Add(Request);
+	if (OnSpawn)
+	{
+		OnSpawn(Request);
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Flushes requests queued on a notify batch subsystem and checks they are spawned grouped by asset in the order they were queued,
+ * at most a.Notify.MaxSpawnsPerAsset of each, that requests of unregistered components are skipped and that requests added while
+ * flushing wait for the next flush. Also checks notifies are only queued between the world's pre and post actor tick.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimNotifyBatchSubsystemTest, "System.Engine.Animation.NotifyBatch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace AnimNotifyBatchSubsystemTest
+{
+	static USkeletalMeshComponent* SpawnComponent(UWorld* World)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		USkeletalMeshComponent* Component = NewObject<USkeletalMeshComponent>(Actor);
+		Actor->SetRootComponent(Component);
+		Component->RegisterComponent();
+		return Component;
+	}
+
+	static FAnimNotifySpawnRequest MakeRequest(USkeletalMeshComponent* MeshComp, UObject* Asset)
+	{
+		FAnimNotifySpawnRequest Request;
+		Request.Notify = NewObject<UAnimNotify_PlaySound>();
+		Request.MeshComp = MeshComp;
+		Request.Asset = Asset;
+		return Request;
+	}
+
+	/** Notifies of the requests for Asset, in order */
+	static TArray<const UAnimNotify*> GetNotifiesForAsset(const TArray<FAnimNotifySpawnRequest>& Requests, const UObject* Asset)
+	{
+		TArray<const UAnimNotify*> Notifies;
+		for (const FAnimNotifySpawnRequest& Request : Requests)
+		{
+			if (Request.Asset == Asset)
+			{
+				Notifies.Add(Request.Notify);
+			}
+		}
+		return Notifies;
+	}
+
+	/** Whether every asset's requests were spawned next to each other, in the order they were queued */
+	static bool IsGroupedInOrder(const TArray<FAnimNotifySpawnRequest>& Spawned, const TArray<FAnimNotifySpawnRequest>& Queued)
+	{
+		TSet<const UObject*> FinishedAssets;
+		for (int32 Index = 1; Index < Spawned.Num(); ++Index)
+		{
+			if (Spawned[Index].Asset != Spawned[Index - 1].Asset)
+			{
+				FinishedAssets.Add(Spawned[Index - 1].Asset);
+				if (FinishedAssets.Contains(Spawned[Index].Asset))
+				{
+					return false;
+				}
+			}
+		}
+
+		for (const FAnimNotifySpawnRequest& Request : Queued)
+		{
+			if (GetNotifiesForAsset(Spawned, Request.Asset) != GetNotifiesForAsset(Queued, Request.Asset))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool FAnimNotifyBatchSubsystemTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimNotifyBatchSubsystemTest;
+
+	AutomationBenchmark::FScopedCVarValue BatchSpawns(TEXT("a.Notify.BatchSpawns"), 1);
+	AutomationBenchmark::FScopedCVarValue MaxSpawnsPerAsset(TEXT("a.Notify.MaxSpawnsPerAsset"), 0);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	USkeletalMeshComponent* Component = SpawnComponent(World);
+	USkeletalMeshComponent* UnregisteredComponent = NewObject<USkeletalMeshComponent>(World->SpawnActor<AActor>());
+
+	USoundWave* Assets[] = { NewObject<USoundWave>(), NewObject<USoundWave>(), NewObject<USoundWave>() };
+
+	UAnimNotifyBatchTestSubsystem* Subsystem = NewObject<UAnimNotifyBatchTestSubsystem>(World);
+
+	// Grouped by asset, in the order they were queued within an asset
+	{
+		TArray<FAnimNotifySpawnRequest> Queued;
+		for (int32 Index = 0; Index < 9; ++Index)
+		{
+			Queued.Add(MakeRequest(Component, Assets[(Index * 2) % UE_ARRAY_COUNT(Assets)]));
+			Subsystem->AddSoundRequest(Queued.Last());
+			Subsystem->AddParticleSystemRequest(Queued.Last());
+		}
+
+		Subsystem->Flush();
+
+		TestEqual(TEXT("Every sound is spawned"), Subsystem->SpawnedSounds.Num(), Queued.Num());
+		TestEqual(TEXT("Every particle system is spawned"), Subsystem->SpawnedParticleSystems.Num(), Queued.Num());
+		TestTrue(TEXT("Sounds are grouped by asset in the order they were queued"), IsGroupedInOrder(Subsystem->SpawnedSounds, Queued));
+		TestTrue(TEXT("Particle systems are grouped by asset in the order they were queued"), IsGroupedInOrder(Subsystem->SpawnedParticleSystems, Queued));
+		TestEqual(TEXT("Nothing is left queued after a flush"), Subsystem->GetNumQueued(), 0);
+	}
+
+	// At most a.Notify.MaxSpawnsPerAsset of each asset, the first ones queued
+	{
+		Subsystem->SpawnedSounds.Reset();
+		MaxSpawnsPerAsset.Set(2);
+
+		TArray<FAnimNotifySpawnRequest> Queued;
+		for (int32 Index = 0; Index < 5; ++Index)
+		{
+			Queued.Add(MakeRequest(Component, Assets[0]));
+			Subsystem->AddSoundRequest(Queued.Last());
+		}
+		Queued.Add(MakeRequest(Component, Assets[1]));
+		Subsystem->AddSoundRequest(Queued.Last());
+
+		Subsystem->Flush();
+		MaxSpawnsPerAsset.Set(0);
+
+		int32 NumFirstAsset = 0;
+		for (const FAnimNotifySpawnRequest& Request : Subsystem->SpawnedSounds)
+		{
+			NumFirstAsset += Request.Asset == Assets[0] ? 1 : 0;
+		}
+		TestEqual(TEXT("Spawns past a.Notify.MaxSpawnsPerAsset are dropped"), NumFirstAsset, 2);
+		TestEqual(TEXT("Other assets still spawn"), Subsystem->SpawnedSounds.Num(), 3);
+
+		const bool bFirstQueuedSpawned = Subsystem->SpawnedSounds.ContainsByPredicate([&Queued](const FAnimNotifySpawnRequest& Request) { return Request.Notify == Queued[0].Notify; })
+			&& Subsystem->SpawnedSounds.ContainsByPredicate([&Queued](const FAnimNotifySpawnRequest& Request) { return Request.Notify == Queued[1].Notify; });
+		TestTrue(TEXT("The first requests queued are the ones spawned"), bFirstQueuedSpawned);
+	}
+
+	// Components that went away since are skipped
+	{
+		Subsystem->SpawnedSounds.Reset();
+
+		Subsystem->AddSoundRequest(MakeRequest(UnregisteredComponent, Assets[0]));
+		Subsystem->AddSoundRequest(MakeRequest(nullptr, Assets[0]));
+		FAnimNotifySpawnRequest NoNotify = MakeRequest(Component, Assets[0]);
+		NoNotify.Notify = nullptr;
+		Subsystem->AddSoundRequest(NoNotify);
+		Subsystem->AddSoundRequest(MakeRequest(Component, Assets[0]));
+
+		Subsystem->Flush();
+
+		TestEqual(TEXT("Requests of unregistered components, or without a notify, are skipped"), Subsystem->SpawnedSounds.Num(), 1);
+		TestEqual(TEXT("Skipped requests aren't kept"), Subsystem->GetNumQueued(), 0);
+	}
+
+	// Requests added while flushing wait for the next flush
+	{
+		Subsystem->SpawnedSounds.Reset();
+
+		const FAnimNotifySpawnRequest Queued = MakeRequest(Component, Assets[0]);
+		const FAnimNotifySpawnRequest QueuedWhileFlushing = MakeRequest(Component, Assets[1]);
+		Subsystem->OnSpawn = [Subsystem, &Queued, &QueuedWhileFlushing](const FAnimNotifySpawnRequest& Request)
+		{
+			if (Request.Notify == Queued.Notify)
+			{
+				Subsystem->AddSoundRequest(QueuedWhileFlushing);
+			}
+		};
+
+		Subsystem->AddSoundRequest(Queued);
+		Subsystem->Flush();
+		Subsystem->OnSpawn = nullptr;
+
+		TestEqual(TEXT("Requests added while flushing aren't spawned by that flush"), Subsystem->SpawnedSounds.Num(), 1);
+		TestEqual(TEXT("Requests added while flushing stay queued"), Subsystem->GetNumQueued(), 1);
+
+		Subsystem->Flush();
+
+		TestTrue(TEXT("Requests added while flushing are spawned by the next flush"), Subsystem->SpawnedSounds.Num() == 2 && Subsystem->SpawnedSounds[1].Notify == QueuedWhileFlushing.Notify);
+	}
+
+	// The world's own subsystem only queues while actors tick, nothing else would flush
+	UAnimNotifyBatchSubsystem* WorldSubsystem = World->GetSubsystem<UAnimNotifyBatchSubsystem>();
+	if (TestNotNull(TEXT("Game worlds have a notify batch subsystem"), WorldSubsystem))
+	{
+		// Unregistered before the world flushes, so nothing is actually played
+		USkeletalMeshComponent* QueuingComponent = SpawnComponent(World);
+		UAnimNotify_PlaySound* Notify = NewObject<UAnimNotify_PlaySound>();
+		Notify->Sound = Assets[0];
+
+		TestFalse(TEXT("Notifies outside of the actor tick aren't queued"), UAnimNotifyBatchSubsystem::QueueSound(Notify, QueuingComponent, nullptr));
+		TestEqual(TEXT("Notifies outside of the actor tick leave nothing queued"), WorldSubsystem->GetNumQueued(), 0);
+
+		FWorldDelegates::OnWorldPreActorTick.Broadcast(World, LEVELTICK_All, 0.0f);
+		TestTrue(TEXT("Pre actor tick starts the actor tick"), WorldSubsystem->IsInActorTick());
+		TestTrue(TEXT("Notifies during the actor tick are queued"), UAnimNotifyBatchSubsystem::QueueSound(Notify, QueuingComponent, nullptr));
+		TestEqual(TEXT("Notifies during the actor tick wait for the flush"), WorldSubsystem->GetNumQueued(), 1);
+
+		QueuingComponent->UnregisterComponent();
+		FWorldDelegates::OnWorldPostActorTick.Broadcast(World, LEVELTICK_All, 0.0f);
+		TestFalse(TEXT("Post actor tick ends the actor tick"), WorldSubsystem->IsInActorTick());
+		TestEqual(TEXT("Post actor tick flushes"), WorldSubsystem->GetNumQueued(), 0);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimNotifyBatchSubsystem.h"
+
+#include "AnimNotifyBatchTestSubsystem.generated.h"
+
+/**
+ * Notify batch subsystem the notify batching tests flush by hand. Spawning records the requests in the order they were spawned
+ * instead of playing anything. Never created for a world on its own.
+ */
+UCLASS(transient, NotBlueprintable, HideDropdown)
+class UAnimNotifyBatchTestSubsystem : public UAnimNotifyBatchSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Sound and particle system requests Flush spawned, in order */
+	TArray<FAnimNotifySpawnRequest> SpawnedSounds;
+	TArray<FAnimNotifySpawnRequest> SpawnedParticleSystems;
+
+	/** Called for every request spawned, after it is recorded */
+	TFunction<void(const FAnimNotifySpawnRequest&)> OnSpawn;
+
+protected:
+
+	//~UWorldSubsystem interface
+	bool DoesSupportWorldType(EWorldType::Type WorldType) const override { return false; }
+	//~End of UWorldSubsystem interface
+
+	//~UAnimNotifyBatchSubsystem interface
+	virtual void SpawnSound(const FAnimNotifySpawnRequest& Request) override;
+	virtual void SpawnParticleSystem(const FAnimNotifySpawnRequest& Request) override;
+	//~End of UAnimNotifyBatchSubsystem interface
+};
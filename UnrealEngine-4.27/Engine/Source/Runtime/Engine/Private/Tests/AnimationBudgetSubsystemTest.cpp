@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/AnimationBudgetTestSubsystem.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Components/SkeletalMeshComponent.h"
+
+int32 UAnimationBudgetTestSubsystem::AddScheduledComponent(USkeletalMeshComponent* Component, float UpdateCostMs, float SkippedCostMs, bool bAlwaysUpdate)
+{
+	Component->EnableExternalTickRateControl(true);
+
+	const int32 Index = ComponentStates.AddDefaulted();
+	FAnimationBudgetComponentState& State = ComponentStates[Index];
+	State.Component = Component;
+	State.UpdateCostMs = UpdateCostMs;
+	State.SkippedCostMs = SkippedCostMs;
+	State.bAlwaysUpdate = bAlwaysUpdate;
+
+	SortedIndices.Add(Index);
+	return Index;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Allocates budgets to components with made up costs and checks the tick rates they get: every frame when they all fit, the fastest
+ * rate that fits for the most significant ones and the slowest for the rest when they don't, every frame for player controlled ones
+ * over budget too, and the cost of skipped frames counting against the budget. Then applies tick rates for a few frames and checks
+ * on which frames components update, the delta time they're handed and when they interpolate.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimationBudgetSubsystemTest, "System.Engine.Animation.AnimationBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+namespace AnimationBudgetSubsystemTest
+{
+	static const int32 MaxTickRate = 4;
+	static const int32 MaxInterpolationRate = 3;
+
+	/** Tick rates given to components of the given costs, in ms, scheduled in that order */
+	static TArray<int32> AllocateTickRates(float BudgetMs, const TArray<float>& UpdateCostsMs, float SkippedCostMs = 0.0f, bool bFirstAlwaysUpdates = false)
+	{
+		UAnimationBudgetTestSubsystem* Subsystem = NewObject<UAnimationBudgetTestSubsystem>();
+		for (int32 Index = 0; Index < UpdateCostsMs.Num(); ++Index)
+		{
+			Subsystem->AddScheduledComponent(NewObject<USkeletalMeshComponent>(), UpdateCostsMs[Index], SkippedCostMs, bFirstAlwaysUpdates && Index == 0);
+		}
+
+		Subsystem->AllocateBudget(BudgetMs, MaxTickRate);
+
+		TArray<int32> TickRates;
+		for (int32 Index = 0; Index < UpdateCostsMs.Num(); ++Index)
+		{
+			TickRates.Add(Subsystem->GetComponentState(Index).TickRate);
+		}
+		return TickRates;
+	}
+
+	/** Frames out of NumFrames on which a component at TickRate updates, starting FramesSinceUpdate frames after its last update */
+	static TArray<int32> ApplyTickRate(FAutomationTestBase& Test, int32 TickRate, int32 FramesSinceUpdate, bool bRecentlyRendered, int32 NumFrames)
+	{
+		const float DeltaSeconds = 0.25f;
+
+		UAnimationBudgetTestSubsystem* Subsystem = NewObject<UAnimationBudgetTestSubsystem>();
+		USkeletalMeshComponent* Component = NewObject<USkeletalMeshComponent>();
+		Component->bRecentlyRendered = bRecentlyRendered;
+
+		const int32 StateIndex = Subsystem->AddScheduledComponent(Component, 1.0f, 0.0f);
+		FAnimationBudgetComponentState& State = Subsystem->GetComponentState(StateIndex);
+		State.TickRate = TickRate;
+		State.FramesSinceUpdate = FramesSinceUpdate;
+		State.AccumulatedDeltaTime = FramesSinceUpdate * DeltaSeconds;
+
+		TArray<int32> UpdatedFrames;
+		int32 LastUpdatedFrame = -FramesSinceUpdate;
+		for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+		{
+			const float AccumulatedDeltaTime = State.AccumulatedDeltaTime + DeltaSeconds;
+			Subsystem->ApplyTickRate(StateIndex, DeltaSeconds, MaxInterpolationRate);
+
+			Test.TestEqual(TEXT("Components are handed their tick rate"), (int32)Component->GetExternalTickRate(), TickRate);
+			Test.TestTrue(TEXT("Components update when the state says they do"), Component->ShouldTickAnimation() == State.bUpdatedLastFrame);
+			Test.TestTrue(TEXT("Only visible components updating at most every a.Budget.MaxInterpolationRate frames interpolate"), Component->IsUsingExternalInterpolation() == (TickRate > 1 && TickRate <= MaxInterpolationRate && bRecentlyRendered));
+
+			if (State.bUpdatedLastFrame)
+			{
+				Test.TestEqual(TEXT("Updates are handed the time since the last one"), AccumulatedDeltaTime, (Frame - LastUpdatedFrame) * DeltaSeconds);
+				Test.TestEqual(TEXT("Updating starts accumulating time again"), State.AccumulatedDeltaTime, 0.0f);
+				UpdatedFrames.Add(Frame);
+				LastUpdatedFrame = Frame;
+			}
+		}
+		return UpdatedFrames;
+	}
+}
+
+bool FAnimationBudgetSubsystemTest::RunTest(const FString& Parameters)
+{
+	using namespace AnimationBudgetSubsystemTest;
+
+	// Costs and budgets are multiples of powers of two so the comparisons against what is left of the budget are exact
+	TestTrue(TEXT("Components update every frame when they all fit"), AllocateTickRates(4.0f, { 1.0f, 1.0f, 1.0f }) == TArray<int32>({ 1, 1, 1 }));
+	TestTrue(TEXT("Over budget, the most significant components take the fastest rate that fits and the rest the slowest"), AllocateTickRates(2.0f, { 1.0f, 1.0f, 1.0f, 1.0f }) == TArray<int32>({ 1, 2, 4, 4 }));
+	TestTrue(TEXT("Components costing more than what is left don't keep cheaper ones from it"), AllocateTickRates(2.75f, { 8.0f, 0.5f, 0.5f }) == TArray<int32>({ 4, 1, 2 }));
+	TestTrue(TEXT("Player controlled components update every frame even over budget"), AllocateTickRates(1.0f, { 1.0f, 1.0f, 1.0f }, 0.0f, true) == TArray<int32>({ 1, 4, 4 }));
+	TestTrue(TEXT("Skipped frames count against the budget"), AllocateTickRates(0.5f, { 1.0f }, 0.5f) == TArray<int32>({ 4 }));
+	TestTrue(TEXT("Components update at the slowest rate with no budget"), AllocateTickRates(0.0f, { 1.0f }) == TArray<int32>({ MaxTickRate }));
+
+	TestTrue(TEXT("Components at a tick rate of 1 update every frame"), ApplyTickRate(*this, 1, 0, true, 4) == TArray<int32>({ 1, 2, 3, 4 }));
+	TestTrue(TEXT("Throttled components update once every tick rate frames"), ApplyTickRate(*this, 3, 0, true, 7) == TArray<int32>({ 3, 6 }));
+	TestTrue(TEXT("Throttled components pick up from their last update"), ApplyTickRate(*this, 3, 1, false, 7) == TArray<int32>({ 2, 5 }));
+	TestTrue(TEXT("Components over a.Budget.MaxInterpolationRate update once every tick rate frames too"), ApplyTickRate(*this, 4, 3, true, 8) == TArray<int32>({ 1, 5 }));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/AnimationBudgetSubsystem.h"
+
+#include "AnimationBudgetTestSubsystem.generated.h"
+
+/**
+ * Animation budget subsystem the animation budget tests schedule by hand, with costs they pick instead of measured ones. Never
+ * created for a world on its own.
+ */
+UCLASS(transient, NotBlueprintable, HideDropdown)
+class UAnimationBudgetTestSubsystem : public UAnimationBudgetSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Schedules Component after the ones added before it, as if it were less significant, returning the index of its state */
+	int32 AddScheduledComponent(USkeletalMeshComponent* Component, float UpdateCostMs, float SkippedCostMs, bool bAlwaysUpdate = false);
+
+	FAnimationBudgetComponentState& GetComponentState(int32 Index) { return ComponentStates[Index]; }
+
+	/** Gives the scheduled components their tick rates, in the order they were added */
+	void AllocateBudget(float BudgetMs, int32 MaxTickRate) { Super::AllocateBudget(BudgetMs, MaxTickRate); }
+
+	/** Sets up the component of the state at Index to update, interpolate or skip this frame */
+	void ApplyTickRate(int32 Index, float DeltaSeconds, int32 MaxInterpolationRate) { Super::ApplyTickRate(ComponentStates[Index], DeltaSeconds, MaxInterpolationRate); }
+
+protected:
+
+	//~UWorldSubsystem interface
+	bool DoesSupportWorldType(EWorldType::Type WorldType) const override { return false; }
+	//~End of UWorldSubsystem interface
+};
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Helpers shared by the engine's automation tests, benchmarks report the timings with AddInfo */
+namespace AutomationBenchmark
+{
+	/** Calls Function(Iteration) NumIterations times, returns the seconds it took */
+	template<typename FunctionType>
+	double TimeIterations(const int32 NumIterations, FunctionType&& Function)
+	{
+		double Seconds = 0.0;
+		{
+			FScopedDurationTimer Timer(Seconds);
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				Function(Iteration);
+			}
+		}
+		return Seconds;
+	}
+
+	/** Seconds spent over NumIterations, as microseconds per iteration */
+	inline FString FormatMicroseconds(const double Seconds, const int32 NumIterations = 1)
+	{
+		return FString::Printf(TEXT("%.2f us"), (Seconds * 1000000.0) / FMath::Max(NumIterations, 1));
+	}
+
+	/** Seconds spent over NumIterations, as milliseconds per iteration */
+	inline FString FormatMilliseconds(const double Seconds, const int32 NumIterations = 1)
+	{
+		return FString::Printf(TEXT("%.2f ms"), (Seconds * 1000.0) / FMath::Max(NumIterations, 1));
+	}
+
+	/** Restores a console variable's value when it goes out of scope */
+	struct FScopedCVarValue
+	{
+		FScopedCVarValue(const TCHAR* Name, int32 Value)
+			: CVar(IConsoleManager::Get().FindConsoleVariable(Name))
+			, PreviousValue(CVar ? CVar->GetInt() : 0)
+		{
+			Set(Value);
+		}
+
+		~FScopedCVarValue()
+		{
+			Set(PreviousValue);
+		}
+
+		void Set(int32 Value)
+		{
+			if (CVar)
+			{
+				CVar->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* CVar;
+		int32 PreviousValue;
+	};
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,358 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/BakedVertexAnimationTestAsset.h"
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "AssetRegistryModule.h"
+#include "RenderingThread.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/BakedVertexAnimation.h"
+#include "Animation/BakedVertexAnimationSubsystem.h"
+#include "Animation/Skeleton.h"
+#include "AnimationRuntime.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+void UBakedVertexAnimationTestAsset::EvaluateComponentSpacePose(const float Time, const FBoneContainer& BoneContainer, TArray<FTransform>& OutComponentSpaceTransforms) const
+{
+	const FReferenceSkeleton& RefSkeleton = SourceMesh->GetRefSkeleton();
+	for (int32 BoneIndex = 0; BoneIndex < OutComponentSpaceTransforms.Num(); ++BoneIndex)
+	{
+		OutComponentSpaceTransforms[BoneIndex] = FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, BoneIndex);
+	}
+
+	if (OutComponentSpaceTransforms.Num() > 1)
+	{
+		OutComponentSpaceTransforms[1].AddToTranslation(FVector(Time * BoneSpeed, 0.0f, 0.0f));
+	}
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Bakes a procedural two bone mesh of a few thousand vertices, every other vertex skinned to the second bone, whose animation moves
+ * that bone along X. Checks every vertex is given its own texel column in UV channel 1 of the baked static mesh, and, in the editor,
+ * that the baked offsets and normals are those of the animation.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBakedVertexAnimationBakeTest, "System.Engine.Animation.BakedVertexAnimation Bake", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Spawns a crowd playing the source sequence of a baked vertex animation asset, seen from far enough to use it, and ticks the world
+ * a few frames with a.BakedVertexAnimation off then on. Reports the game thread cost of the world tick, and the render thread cost
+ * of the commands it queued, measured by flushing them. One test per UBakedVertexAnimation asset found.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FBakedVertexAnimationCrowdBenchmark, "System.Engine.Animation.BakedVertexAnimation Crowd Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace BakedVertexAnimationTest
+{
+	static const int32 NumCharacters = 1000;
+	static const int32 NumFrames = 30;
+	static const float DeltaSeconds = 1.0f / 30.0f;
+	static const float CrowdExtent = 5000.0f;
+	static const float BakedDistance = 10000.0f;
+
+	static TArray<USkeletalMeshComponent*> SpawnCrowd(UWorld* World, UBakedVertexAnimation* BakedVertexAnimation)
+	{
+		TArray<USkeletalMeshComponent*> Crowd;
+		Crowd.Reserve(NumCharacters);
+
+		FRandomStream Random(0xC40D);
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			USkeletalMeshComponent* Component = NewObject<USkeletalMeshComponent>(Actor);
+			Component->SetSkeletalMesh(BakedVertexAnimation->SourceMesh);
+			Component->BakedVertexAnimationDistance = BakedDistance;
+			Component->SetWorldLocation(FVector(Random.FRandRange(-CrowdExtent, CrowdExtent), Random.FRandRange(-CrowdExtent, CrowdExtent), 0.0f));
+			Actor->SetRootComponent(Component);
+
+			// Half of them get it once registered, the way gameplay code assigns it at runtime
+			const bool bSetOnceRegistered = (Index % 2) != 0;
+			if (!bSetOnceRegistered)
+			{
+				Component->BakedVertexAnimation = BakedVertexAnimation;
+			}
+			Component->RegisterComponent();
+			if (bSetOnceRegistered)
+			{
+				Component->SetBakedVertexAnimation(BakedVertexAnimation);
+			}
+			Component->PlayAnimation(BakedVertexAnimation->SourceSequence, true);
+			Crowd.Add(Component);
+		}
+
+		return Crowd;
+	}
+
+	/** Ticks the world NumFrames times as if rendered from ViewLocation, returning the game and render thread time in seconds */
+	static void TickCrowd(UWorld* World, const FVector& ViewLocation, double& OutGameThreadSeconds, double& OutRenderThreadSeconds)
+	{
+		OutGameThreadSeconds = 0.0;
+		OutRenderThreadSeconds = 0.0;
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World->ViewLocationsRenderedLastFrame.Reset();
+			World->ViewLocationsRenderedLastFrame.Add(ViewLocation);
+
+			OutGameThreadSeconds += AutomationBenchmark::TimeIterations(1, [World](int32)
+			{
+				World->Tick(LEVELTICK_All, DeltaSeconds);
+				World->SendAllEndOfFrameUpdates();
+			});
+
+			OutRenderThreadSeconds += AutomationBenchmark::TimeIterations(1, [](int32)
+			{
+				FlushRenderingCommands();
+			});
+		}
+	}
+}
+
+namespace BakedVertexAnimationBakeTest
+{
+	/** Past what half float UVs can tell apart */
+	static const int32 NumVertices = 3 * 1366;
+	static const float SampleRate = 10.0f;
+	static const float PlayLength = 1.0f;
+
+	/** Builds a mesh of two bones, the second one 100 units above the root, with LOD 0 a strip of triangles */
+	static USkeletalMesh* CreateSkeletalMesh(const int32 InNumVertices)
+	{
+		USkeletalMesh* SkeletalMesh = NewObject<USkeletalMesh>();
+		{
+			FReferenceSkeletonModifier Modifier(SkeletalMesh->GetRefSkeleton(), nullptr);
+			Modifier.Add(FMeshBoneInfo(TEXT("Root"), TEXT("Root"), INDEX_NONE), FTransform::Identity);
+			Modifier.Add(FMeshBoneInfo(TEXT("Moving"), TEXT("Moving"), 0), FTransform(FVector(0.0f, 0.0f, 100.0f)));
+		}
+		SkeletalMesh->CalculateInvRefMatrices();
+
+		USkeleton* Skeleton = NewObject<USkeleton>();
+		Skeleton->MergeAllBonesToBoneTree(SkeletalMesh);
+		SkeletalMesh->SetSkeleton(Skeleton);
+
+		SkeletalMesh->AllocateResourceForRendering();
+		FSkeletalMeshLODRenderData* LOD = new FSkeletalMeshLODRenderData();
+		SkeletalMesh->GetResourceForRendering()->LODRenderData.Add(LOD);
+
+		FSkelMeshRenderSection& Section = LOD->RenderSections.AddDefaulted_GetRef();
+		Section.BaseVertexIndex = 0;
+		Section.NumVertices = InNumVertices;
+		Section.BaseIndex = 0;
+		Section.NumTriangles = InNumVertices / 3;
+		Section.MaxBoneInfluences = 1;
+		Section.BoneMap = { 0, 1 };
+
+		TArray<FVector> Positions;
+		Positions.Reserve(InNumVertices);
+		TArray<FSkinWeightInfo> Weights;
+		Weights.AddZeroed(InNumVertices);
+		TArray<uint32> Indices;
+		Indices.Reserve(InNumVertices);
+
+		LOD->StaticVertexBuffers.StaticMeshVertexBuffer.Init(InNumVertices, 1, true);
+		for (int32 VertexIndex = 0; VertexIndex < InNumVertices; ++VertexIndex)
+		{
+			Positions.Add(FVector((VertexIndex % 64) * 10.0f, (VertexIndex / 64) * 10.0f, 0.0f));
+			LOD->StaticVertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(VertexIndex, FVector::ForwardVector, FVector::RightVector, FVector::UpVector);
+			LOD->StaticVertexBuffers.StaticMeshVertexBuffer.SetVertexUV(VertexIndex, 0, FVector2D::ZeroVector);
+
+			Weights[VertexIndex].InfluenceBones[0] = (FBoneIndexType)(VertexIndex % 2);
+			Weights[VertexIndex].InfluenceWeights[0] = 255;
+			Indices.Add(VertexIndex);
+		}
+		LOD->StaticVertexBuffers.PositionVertexBuffer.Init(Positions, true);
+		LOD->MultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), Indices);
+
+		LOD->SkinWeightVertexBuffer.SetNeedsCPUAccess(true);
+		LOD->SkinWeightVertexBuffer.SetMaxBoneInfluences(1);
+		LOD->SkinWeightVertexBuffer = Weights;
+
+		return SkeletalMesh;
+	}
+}
+
+bool FBakedVertexAnimationBakeTest::RunTest(const FString& Parameters)
+{
+	using namespace BakedVertexAnimationBakeTest;
+
+	const int32 NumMeshVertices = FMath::Min(NumVertices, (int32)GetMax2DTextureDimension() / 3 * 3);
+	USkeletalMesh* SkeletalMesh = CreateSkeletalMesh(NumMeshVertices);
+
+	UAnimSequence* Sequence = NewObject<UAnimSequence>();
+	Sequence->SetSkeleton(SkeletalMesh->GetSkeleton());
+	Sequence->SequenceLength = PlayLength;
+
+	UBakedVertexAnimationTestAsset* BakedVertexAnimation = NewObject<UBakedVertexAnimationTestAsset>();
+	BakedVertexAnimation->SourceMesh = SkeletalMesh;
+	BakedVertexAnimation->SourceSequence = Sequence;
+	BakedVertexAnimation->SampleRate = SampleRate;
+
+	FString Error;
+	const bool bBaked = BakedVertexAnimation->Bake(Error);
+	if (!TestTrue(FString::Printf(TEXT("Bake (%s)"), *Error), bBaked))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Every vertex is baked"), BakedVertexAnimation->NumVertices, NumMeshVertices);
+	TestEqual(TEXT("A frame is baked per sample"), BakedVertexAnimation->NumFrames, FMath::CeilToInt(PlayLength * SampleRate));
+
+	const FStaticMeshVertexBuffer& VertexBuffer = BakedVertexAnimation->StaticMesh->GetRenderData()->LODResources[0].VertexBuffers.StaticMeshVertexBuffer;
+	if (TestEqual(TEXT("The static mesh has a vertex per baked vertex"), (int32)VertexBuffer.GetNumVertices(), NumMeshVertices))
+	{
+		int32 NumWrongColumns = 0;
+		for (int32 VertexIndex = 0; VertexIndex < NumMeshVertices; ++VertexIndex)
+		{
+			NumWrongColumns += FMath::FloorToInt(VertexBuffer.GetVertexUV(VertexIndex, 1).X * NumMeshVertices) != VertexIndex ? 1 : 0;
+		}
+		TestEqual(TEXT("Every vertex samples its own texel column"), NumWrongColumns, 0);
+	}
+
+#if WITH_EDITOR
+	TArray64<uint8> PositionData;
+	TArray64<uint8> NormalData;
+	const int64 ExpectedSize = (int64)NumMeshVertices * BakedVertexAnimation->NumFrames * sizeof(FFloat16Color);
+	if (TestTrue(TEXT("The position texture has a texel per vertex and frame"), BakedVertexAnimation->PositionTexture->Source.GetMipData(PositionData, 0) && PositionData.Num() == ExpectedSize)
+		&& TestTrue(TEXT("The normal texture has a texel per vertex and frame"), BakedVertexAnimation->NormalTexture->Source.GetMipData(NormalData, 0) && NormalData.Num() == ExpectedSize))
+	{
+		const FFloat16Color* PositionTexels = (const FFloat16Color*)PositionData.GetData();
+		const FFloat16Color* NormalTexels = (const FFloat16Color*)NormalData.GetData();
+
+		int32 NumWrongOffsets = 0;
+		int32 NumWrongNormals = 0;
+		for (int32 FrameIndex = 0; FrameIndex < BakedVertexAnimation->NumFrames; ++FrameIndex)
+		{
+			const float BoneOffset = (FrameIndex / SampleRate) * BakedVertexAnimation->BoneSpeed;
+			for (int32 VertexIndex = 0; VertexIndex < NumMeshVertices; ++VertexIndex)
+			{
+				const FLinearColor Offset(PositionTexels[FrameIndex * NumMeshVertices + VertexIndex]);
+				const FVector ExpectedOffset((VertexIndex % 2) ? BoneOffset : 0.0f, 0.0f, 0.0f);
+				NumWrongOffsets += FVector(Offset.R, Offset.G, Offset.B).Equals(ExpectedOffset, 0.05f) ? 0 : 1;
+
+				const FLinearColor Normal(NormalTexels[FrameIndex * NumMeshVertices + VertexIndex]);
+				NumWrongNormals += FVector(Normal.R, Normal.G, Normal.B).Equals(FVector::UpVector, 0.01f) ? 0 : 1;
+			}
+		}
+		TestEqual(TEXT("Baked offsets follow the bones"), NumWrongOffsets, 0);
+		TestEqual(TEXT("Baked normals follow the bones"), NumWrongNormals, 0);
+	}
+#endif
+
+	return true;
+}
+
+void FBakedVertexAnimationCrowdBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+
+	TArray<FAssetData> AssetList;
+	AssetRegistryModule.Get().GetAssetsByClass(UBakedVertexAnimation::StaticClass()->GetFName(), AssetList);
+
+	for (const FAssetData& Asset : AssetList)
+	{
+		OutBeautifiedNames.Add(Asset.AssetName.ToString());
+		OutTestCommands.Add(Asset.ObjectPath.ToString());
+	}
+}
+
+bool FBakedVertexAnimationCrowdBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace BakedVertexAnimationTest;
+
+	UBakedVertexAnimation* BakedVertexAnimation = LoadObject<UBakedVertexAnimation>(nullptr, *Parameters);
+	if (!TestNotNull(TEXT("Baked vertex animation loads"), BakedVertexAnimation) || !TestNotNull(TEXT("Source mesh is set"), BakedVertexAnimation->SourceMesh)
+		|| !TestNotNull(TEXT("Source sequence is set"), BakedVertexAnimation->SourceSequence))
+	{
+		return false;
+	}
+
+	if (!BakedVertexAnimation->IsBaked())
+	{
+		FString Error;
+		const bool bBaked = BakedVertexAnimation->Bake(Error);
+		if (!TestTrue(FString::Printf(TEXT("Bake %s (%s)"), *BakedVertexAnimation->GetName(), *Error), bBaked))
+		{
+			return false;
+		}
+	}
+
+	IConsoleVariable* BakedVertexAnimationCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("a.BakedVertexAnimation"));
+	if (!TestNotNull(TEXT("a.BakedVertexAnimation exists"), BakedVertexAnimationCVar))
+	{
+		return false;
+	}
+	const int32 PreviousCVarValue = BakedVertexAnimationCVar->GetInt();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	const TArray<USkeletalMeshComponent*> Crowd = SpawnCrowd(World, BakedVertexAnimation);
+	const FVector ViewLocation(BakedDistance + CrowdExtent * 2.0f, 0.0f, 0.0f);
+
+	double SkeletalGameThreadSeconds = 0.0;
+	double SkeletalRenderThreadSeconds = 0.0;
+	BakedVertexAnimationCVar->Set(0, ECVF_SetByCode);
+	TickCrowd(World, ViewLocation, SkeletalGameThreadSeconds, SkeletalRenderThreadSeconds);
+
+	UBakedVertexAnimationSubsystem* Subsystem = World->GetSubsystem<UBakedVertexAnimationSubsystem>();
+	if (!TestNotNull(TEXT("Game worlds have a baked vertex animation subsystem"), Subsystem))
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		BakedVertexAnimationCVar->Set(PreviousCVarValue, ECVF_SetByCode);
+		return false;
+	}
+	TestEqual(TEXT("No component is baked with a.BakedVertexAnimation 0"), Subsystem->GetNumBakedComponents(), 0);
+
+	double BakedGameThreadSeconds = 0.0;
+	double BakedRenderThreadSeconds = 0.0;
+	BakedVertexAnimationCVar->Set(1, ECVF_SetByCode);
+	TickCrowd(World, ViewLocation, BakedGameThreadSeconds, BakedRenderThreadSeconds);
+
+	TestEqual(TEXT("Every component past the distance is baked"), Subsystem->GetNumBakedComponents(), NumCharacters);
+
+	// Close enough for everything to switch back
+	double UnusedGameThreadSeconds = 0.0;
+	double UnusedRenderThreadSeconds = 0.0;
+	TickCrowd(World, FVector::ZeroVector, UnusedGameThreadSeconds, UnusedRenderThreadSeconds);
+
+	TestEqual(TEXT("Every component within the distance animates again"), Subsystem->GetNumBakedComponents(), 0);
+
+	int32 NumTicking = 0;
+	for (const USkeletalMeshComponent* Component : Crowd)
+	{
+		NumTicking += Component->IsComponentTickEnabled() && !Component->IsUsingBakedVertexAnimation() ? 1 : 0;
+	}
+	TestEqual(TEXT("Components switching back tick again"), NumTicking, NumCharacters);
+
+	AddInfo(FString::Printf(TEXT("%s, %d characters x %d frames"), *BakedVertexAnimation->GetName(), NumCharacters, NumFrames));
+	AddInfo(FString::Printf(TEXT("Skeletal: game thread %s/frame, render thread %s/frame"),
+		*AutomationBenchmark::FormatMilliseconds(SkeletalGameThreadSeconds, NumFrames), *AutomationBenchmark::FormatMilliseconds(SkeletalRenderThreadSeconds, NumFrames)));
+	AddInfo(FString::Printf(TEXT("Baked: game thread %s/frame, render thread %s/frame"),
+		*AutomationBenchmark::FormatMilliseconds(BakedGameThreadSeconds, NumFrames), *AutomationBenchmark::FormatMilliseconds(BakedRenderThreadSeconds, NumFrames)));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	BakedVertexAnimationCVar->Set(PreviousCVarValue, ECVF_SetByCode);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
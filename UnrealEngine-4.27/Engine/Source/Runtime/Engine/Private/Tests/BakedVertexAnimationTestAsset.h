@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Animation/BakedVertexAnimation.h"
+
+#include "BakedVertexAnimationTestAsset.generated.h"
+
+/**
+ * Baked vertex animation the bake tests build procedurally. Its poses move the second bone of SourceMesh along X by
+ * BoneSpeed units per second from the reference pose, instead of sampling SourceSequence.
+ */
+UCLASS(transient, NotBlueprintable, HideDropdown)
+class UBakedVertexAnimationTestAsset : public UBakedVertexAnimation
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Units per second the second bone moves along X */
+	float BoneSpeed = 100.0f;
+
+protected:
+
+	//~UBakedVertexAnimation interface
+	virtual void EvaluateComponentSpacePose(float Time, const FBoneContainer& BoneContainer, TArray<FTransform>& OutComponentSpaceTransforms) const override;
+	//~End of UBakedVertexAnimation interface
+};
@@ -0,0 +1,154 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+#include "GameFramework/Actor.h"
+#include "Components/BoxComponent.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Runs a perception style set of line traces, with a share of duplicate requests, once as individual
+ * LineTraceSingleByChannel calls and once through UWorld::BatchTraceByChannel, and compares cost and results.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchTraceBenchmark, "System.Engine.Collision.BatchTrace Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace BatchTraceTest
+{
+	static const int32 NumBlockers = 500;
+	static const int32 NumTraces = 20000;
+	static const int32 NumUniqueTraces = 12000;
+	static const int32 NumMultiTraces = 200;
+	static const float WorldExtent = 10000.0f;
+
+	static void SpawnBlockers(UWorld* World)
+	{
+		FRandomStream Random(0x0BA7C4);
+		for (int32 Index = 0; Index < NumBlockers; ++Index)
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+			Box->SetBoxExtent(FVector(Random.FRandRange(50.0f, 300.0f)), false);
+			Box->SetCollisionProfileName(TEXT("BlockAll"));
+			Box->SetWorldLocation(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0.0f));
+			Actor->SetRootComponent(Box);
+			Box->RegisterComponent();
+		}
+	}
+
+	static TArray<FBatchTraceRequest> MakeRequests()
+	{
+		FRandomStream Random(0x0BA7C5);
+
+		TArray<FBatchTraceRequest> Requests;
+		Requests.Reserve(NumTraces);
+		for (int32 Index = 0; Index < NumUniqueTraces; ++Index)
+		{
+			const FVector Start(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 50.0f);
+			const FVector End(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 50.0f);
+			Requests.Emplace(Start, End, ECC_Visibility, EAsyncTraceType::Single);
+		}
+
+		// Several observers tracing to the same target the same frame.
+		while (Requests.Num() < NumTraces)
+		{
+			Requests.Add(Requests[Random.RandHelper(NumUniqueTraces)]);
+		}
+		return Requests;
+	}
+}
+
+bool FBatchTraceBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace BatchTraceTest;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	SpawnBlockers(World);
+	const TArray<FBatchTraceRequest> Requests = MakeRequests();
+
+	TArray<FHitResult> IndividualHits;
+	IndividualHits.SetNum(Requests.Num());
+	const double IndividualSeconds = AutomationBenchmark::TimeIterations(Requests.Num(), [World, &Requests, &IndividualHits](int32 Index)
+	{
+		World->LineTraceSingleByChannel(IndividualHits[Index], Requests[Index].Start, Requests[Index].End, Requests[Index].TraceChannel);
+	});
+
+	TArray<FHitResult> BatchHits;
+	int32 NumBlockingHits = 0;
+	const double BatchSeconds = AutomationBenchmark::TimeIterations(1, [World, &Requests, &BatchHits, &NumBlockingHits](int32)
+	{
+		NumBlockingHits = World->BatchTraceByChannel(Requests, BatchHits);
+	});
+
+	if (TestEqual(TEXT("Batch returns one result per request"), BatchHits.Num(), Requests.Num()))
+	{
+		int32 NumMismatches = 0;
+		for (int32 Index = 0; Index < Requests.Num(); ++Index)
+		{
+			const FHitResult& Individual = IndividualHits[Index];
+			const FHitResult& Batch = BatchHits[Index];
+			if (Individual.bBlockingHit != Batch.bBlockingHit || Individual.GetComponent() != Batch.GetComponent() || !Individual.ImpactPoint.Equals(Batch.ImpactPoint, KINDA_SMALL_NUMBER))
+			{
+				++NumMismatches;
+			}
+		}
+		TestEqual(TEXT("Batched traces hit the same components as individual traces"), NumMismatches, 0);
+	}
+
+	// Multi requests return every hit, like LineTraceMultiByChannel, and their blocking hit in OutHits
+	{
+		TArray<FBatchTraceRequest> MultiRequests;
+		for (int32 Index = 0; Index < NumMultiTraces; ++Index)
+		{
+			MultiRequests.Emplace(Requests[Index].Start, Requests[Index].End, Requests[Index].TraceChannel, EAsyncTraceType::Multi);
+		}
+
+		TArray<FHitResult> MultiBlockingHits;
+		TArray<TArray<FHitResult>> MultiHits;
+		World->BatchTraceByChannel(MultiRequests, MultiBlockingHits, FCollisionShape::LineShape, FCollisionQueryParams::DefaultQueryParam, FCollisionResponseParams::DefaultResponseParam, &MultiHits);
+
+		if (TestEqual(TEXT("Multi batch returns every hit list"), MultiHits.Num(), MultiRequests.Num()))
+		{
+			int32 NumMismatches = 0;
+			TArray<FHitResult> IndividualMultiHits;
+			for (int32 Index = 0; Index < MultiRequests.Num(); ++Index)
+			{
+				World->LineTraceMultiByChannel(IndividualMultiHits, MultiRequests[Index].Start, MultiRequests[Index].End, MultiRequests[Index].TraceChannel);
+
+				bool bMatch = IndividualMultiHits.Num() == MultiHits[Index].Num();
+				for (int32 HitIndex = 0; bMatch && HitIndex < IndividualMultiHits.Num(); ++HitIndex)
+				{
+					bMatch = IndividualMultiHits[HitIndex].GetComponent() == MultiHits[Index][HitIndex].GetComponent();
+				}
+
+				const bool bIndividualBlocking = IndividualMultiHits.Num() > 0 && IndividualMultiHits.Last().bBlockingHit;
+				bMatch = bMatch && bIndividualBlocking == MultiBlockingHits[Index].bBlockingHit;
+
+				NumMismatches += bMatch ? 0 : 1;
+			}
+			TestEqual(TEXT("Batched multi traces hit the same components as individual multi traces"), NumMismatches, 0);
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%d traces (%d unique) against %d blockers: individual %s, batched %s (%d blocking hits)"),
+		NumTraces, NumUniqueTraces, NumBlockers, *AutomationBenchmark::FormatMilliseconds(IndividualSeconds), *AutomationBenchmark::FormatMilliseconds(BatchSeconds), NumBlockingHits));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,239 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Templates/RefCounting.h"
+#include "UObject/Package.h"
+#include "Animation/MorphTarget.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "Rendering/SkinWeightVertexBuffer.h"
+#include "SkeletalRenderCPUSkin.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * CPU skins synthetic LODs of 5k to 80k vertices weighted to 32 to 128 bones with 4 and 8 influences, with and without morph targets, one
+ * section per task, then in tasks splitting the sections, then in tasks through the ISPC kernel. Checks every run gives the same vertices and
+ * reports the time per skinning.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCPUSkinningBenchmark, "System.Engine.Rendering.CPUSkinning Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace CPUSkinningTest
+{
+	static const int32 VertexCounts[] = { 5000, 20000, 80000 };
+	static const int32 BoneCounts[] = { 32, 128 };
+	static const int32 InfluenceCounts[] = { 4, 8 };
+	static const int32 MorphTargetCounts[] = { 0, 2 };
+	static const int32 NumSections = 2;
+	static const int32 NumIterations = 20;
+
+	/** Splits NumVertices between NumSections sections, each weighted to every bone */
+	static void BuildLOD(FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, const int32 NumVertices, const int32 NumBones, const int32 NumInfluences, FRandomStream& Random)
+	{
+		const int32 NumSectionVertices = NumVertices / NumSections;
+		for (int32 SectionIndex = 0; SectionIndex < NumSections; ++SectionIndex)
+		{
+			FSkelMeshRenderSection& Section = LOD.RenderSections.AddDefaulted_GetRef();
+			Section.BaseVertexIndex = SectionIndex * NumSectionVertices;
+			Section.NumVertices = SectionIndex == NumSections - 1 ? NumVertices - Section.BaseVertexIndex : NumSectionVertices;
+			Section.MaxBoneInfluences = NumInfluences;
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				Section.BoneMap.Add((FBoneIndexType)BoneIndex);
+			}
+		}
+
+		TArray<FVector> Positions;
+		Positions.Reserve(NumVertices);
+		TArray<FSkinWeightInfo> Weights;
+		Weights.AddZeroed(NumVertices);
+
+		LOD.StaticVertexBuffers.StaticMeshVertexBuffer.Init(NumVertices, 1, true);
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			Positions.Add(Random.GetUnitVector() * Random.FRandRange(10.0f, 100.0f));
+
+			const FVector TangentZ = Random.GetUnitVector();
+			const FVector TangentX = (Random.GetUnitVector() ^ TangentZ).GetSafeNormal();
+			LOD.StaticVertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(VertexIndex, TangentX, TangentZ ^ TangentX, TangentZ);
+			LOD.StaticVertexBuffers.StaticMeshVertexBuffer.SetVertexUV(VertexIndex, 0, FVector2D(Random.FRand(), Random.FRand()));
+
+			// Weights adding up to 255, heaviest first
+			FSkinWeightInfo& Weight = Weights[VertexIndex];
+			int32 RemainingWeight = 255;
+			for (int32 Influence = 0; Influence < NumInfluences; ++Influence)
+			{
+				const int32 InfluenceWeight = Influence == NumInfluences - 1 ? RemainingWeight : RemainingWeight / 2;
+				Weight.InfluenceBones[Influence] = (FBoneIndexType)Random.RandRange(0, NumBones - 1);
+				Weight.InfluenceWeights[Influence] = (uint8)InfluenceWeight;
+				RemainingWeight -= InfluenceWeight;
+			}
+		}
+		LOD.StaticVertexBuffers.PositionVertexBuffer.Init(Positions, true);
+
+		WeightBuffer.SetNeedsCPUAccess(true);
+		WeightBuffer.SetMaxBoneInfluences(NumInfluences);
+		WeightBuffer = Weights;
+	}
+
+	static void BuildBoneMatrices(TArray<FMatrix>& OutMatrices, const int32 NumBones, FRandomStream& Random)
+	{
+		OutMatrices.Reset(NumBones);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const FQuat Rotation(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f));
+			OutMatrices.Add(FTransform(Rotation.GetNormalized(), Random.GetUnitVector() * 20.0f).ToMatrixWithScale());
+		}
+	}
+
+	/** Morph targets moving about a third of the vertices each, so tasks start both on and between deltas */
+	static void BuildMorphTargets(TArray<FActiveMorphTarget>& OutActiveMorphTargets, TArray<float>& OutWeights, const int32 NumMorphTargets, const int32 NumVertices, FRandomStream& Random)
+	{
+		OutActiveMorphTargets.Reset(NumMorphTargets);
+		OutWeights.Reset(NumMorphTargets);
+		for (int32 MorphIndex = 0; MorphIndex < NumMorphTargets; ++MorphIndex)
+		{
+			UMorphTarget* MorphTarget = NewObject<UMorphTarget>(GetTransientPackage());
+			FMorphTargetLODModel& MorphLOD = MorphTarget->MorphLODModels.AddDefaulted_GetRef();
+			MorphLOD.NumBaseMeshVerts = NumVertices;
+
+			// Deltas are sorted by the vertex they move
+			for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+			{
+				if (Random.RandRange(0, 2) == 0)
+				{
+					FMorphTargetDelta& Delta = MorphLOD.Vertices.AddDefaulted_GetRef();
+					Delta.PositionDelta = Random.GetUnitVector() * Random.FRandRange(0.0f, 5.0f);
+					Delta.TangentZDelta = Random.GetUnitVector() * 0.25f;
+					Delta.SourceIdx = (uint32)VertexIndex;
+				}
+			}
+
+			OutActiveMorphTargets.Add(FActiveMorphTarget(MorphTarget, MorphIndex));
+			OutWeights.Add(Random.FRandRange(0.2f, 1.0f));
+		}
+	}
+
+	static double Skin(FSkeletalMeshLODRenderData& LOD, FSkinWeightVertexBuffer& WeightBuffer, const TArray<FMatrix>& Matrices, const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, TArray<FFinalSkinVertex>& OutVertices)
+	{
+		const TMap<int32, FClothSimulData> NoClothData;
+
+		OutVertices.SetNumUninitialized(LOD.GetNumVertices());
+
+		return AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+		{
+			FSkeletalMeshObjectCPUSkin::SkinLODVertices(OutVertices.GetData(), Matrices.GetData(), 0, LOD, WeightBuffer, ActiveMorphTargets, MorphTargetWeights, NoClothData, 0.0f, FMatrix::Identity);
+		});
+	}
+
+	static bool VerticesMatch(const TArray<FFinalSkinVertex>& A, const TArray<FFinalSkinVertex>& B)
+	{
+		for (int32 VertexIndex = 0; VertexIndex < A.Num(); ++VertexIndex)
+		{
+			// Tangents are packed to 8 bits, a rounding apart is a match
+			if (!A[VertexIndex].Position.Equals(B[VertexIndex].Position, 0.01f)
+				|| !A[VertexIndex].TangentX.ToFVector().Equals(B[VertexIndex].TangentX.ToFVector(), 0.02f)
+				|| !A[VertexIndex].TangentZ.ToFVector4().Equals(B[VertexIndex].TangentZ.ToFVector4(), 0.02f)
+				|| A[VertexIndex].U != B[VertexIndex].U || A[VertexIndex].V != B[VertexIndex].V)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool FCPUSkinningBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace CPUSkinningTest;
+
+	IConsoleVariable* ISPCCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.CPUSkinning.ISPC"));
+	IConsoleVariable* VerticesPerTaskCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.CPUSkinning.VerticesPerTask"));
+	if (!TestNotNull(TEXT("r.CPUSkinning.VerticesPerTask exists"), VerticesPerTaskCVar))
+	{
+		return false;
+	}
+	const int32 PreviousISPC = ISPCCVar ? ISPCCVar->GetInt() : 0;
+	const int32 PreviousVerticesPerTask = VerticesPerTaskCVar->GetInt();
+	const int32 VerticesPerTask = PreviousVerticesPerTask > 0 ? PreviousVerticesPerTask : 2048;
+	if (!ISPCCVar)
+	{
+		AddInfo(TEXT("Built without ISPC, only timing the scalar skinning"));
+	}
+
+	FRandomStream Random(0x5C1D);
+
+	for (const int32 NumVertices : VertexCounts)
+	{
+		for (const int32 NumBones : BoneCounts)
+		{
+			for (const int32 NumInfluences : InfluenceCounts)
+			{
+				TRefCountPtr<FSkeletalMeshLODRenderData> LOD = new FSkeletalMeshLODRenderData(false);
+				FSkinWeightVertexBuffer WeightBuffer;
+				BuildLOD(*LOD, WeightBuffer, NumVertices, NumBones, NumInfluences, Random);
+
+				TArray<FMatrix> Matrices;
+				BuildBoneMatrices(Matrices, NumBones, Random);
+
+				for (const int32 NumMorphTargets : MorphTargetCounts)
+				{
+					TArray<FActiveMorphTarget> ActiveMorphTargets;
+					TArray<float> MorphTargetWeights;
+					BuildMorphTargets(ActiveMorphTargets, MorphTargetWeights, NumMorphTargets, NumVertices, Random);
+
+					const FString Description = FString::Printf(TEXT("%d vertices, %d bones, %d influences, %d morph targets"), NumVertices, NumBones, NumInfluences, NumMorphTargets);
+
+					if (ISPCCVar)
+					{
+						ISPCCVar->Set(0, ECVF_SetByCode);
+					}
+
+					// A task per section seeks the morph deltas at section starts only, smaller tasks seek them mid section
+					TArray<FFinalSkinVertex> SerialVertices;
+					VerticesPerTaskCVar->Set(0, ECVF_SetByCode);
+					const double SerialSeconds = Skin(*LOD, WeightBuffer, Matrices, ActiveMorphTargets, MorphTargetWeights, SerialVertices);
+
+					TArray<FFinalSkinVertex> ParallelVertices;
+					VerticesPerTaskCVar->Set(VerticesPerTask, ECVF_SetByCode);
+					const double ParallelSeconds = Skin(*LOD, WeightBuffer, Matrices, ActiveMorphTargets, MorphTargetWeights, ParallelVertices);
+
+					TestTrue(FString::Printf(TEXT("%s, parallel skinning matches"), *Description), VerticesMatch(SerialVertices, ParallelVertices));
+
+					FString Timings = FString::Printf(TEXT("%s: serial %s, parallel %s"), *Description, *AutomationBenchmark::FormatMicroseconds(SerialSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ParallelSeconds, NumIterations));
+
+					if (ISPCCVar)
+					{
+						TArray<FFinalSkinVertex> ISPCVertices;
+						ISPCCVar->Set(1, ECVF_SetByCode);
+						const double ISPCSeconds = Skin(*LOD, WeightBuffer, Matrices, ActiveMorphTargets, MorphTargetWeights, ISPCVertices);
+
+						TestTrue(FString::Printf(TEXT("%s, ISPC skinning matches"), *Description), VerticesMatch(SerialVertices, ISPCVertices));
+						Timings += FString::Printf(TEXT(", parallel ISPC %s"), *AutomationBenchmark::FormatMicroseconds(ISPCSeconds, NumIterations));
+					}
+
+					AddInfo(Timings);
+
+					for (const FActiveMorphTarget& ActiveMorphTarget : ActiveMorphTargets)
+					{
+						ActiveMorphTarget.MorphTarget->MarkPendingKill();
+					}
+				}
+			}
+		}
+	}
+
+	if (ISPCCVar)
+	{
+		ISPCCVar->Set(PreviousISPC, ECVF_SetByCode);
+	}
+	VerticesPerTaskCVar->Set(PreviousVerticesPerTask, ECVF_SetByCode);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Blends random curves of 50 and 500 curve rigs, with a quarter and with all of the curves valid, the way a graph does: a lerp of two
+ * poses, a weighted additive, a combine and a weighted override. Runs them a curve at a time the way FBaseBlendedCurve used to, then with
+ * a.CurveBlending.ISPC off then on, checks every run gives the same curves and reports the time per blend.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCurveBlendingBenchmark, "System.Engine.Animation.CurveBlending Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace CurveBlendingTest
+{
+	static const int32 CurveCounts[] = { 50, 500 };
+	static const float ValidFractions[] = { 0.25f, 1.0f };
+	static const int32 NumIterations = 5000;
+
+	struct FCurveSet
+	{
+		FBlendedHeapCurve A;
+		FBlendedHeapCurve B;
+		FBlendedHeapCurve Additive;
+		FBlendedHeapCurve Combined;
+	};
+
+	static void BuildCurve(FBlendedHeapCurve& OutCurve, const TArray<uint16>& UIDToArrayIndexLUT, const float ValidFraction, FRandomStream& Random)
+	{
+		OutCurve.InitFrom(&UIDToArrayIndexLUT);
+		for (int32 CurveIndex = 0; CurveIndex < OutCurve.Num(); ++CurveIndex)
+		{
+			if (Random.FRand() < ValidFraction)
+			{
+				OutCurve.Set((USkeleton::AnimCurveUID)CurveIndex, Random.FRandRange(-1.0f, 1.0f));
+			}
+		}
+	}
+
+	/** The blends as FBaseBlendedCurve ran them before the kernels, visiting the valid curves one at a time */
+	static void BlendCurveAtATime(const FCurveSet& Curves, FBlendedHeapCurve& OutCurve)
+	{
+		OutCurve.InitFrom(Curves.A);
+		for (TConstDualEitherSetBitIterator<FDefaultAllocator, FDefaultAllocator> It(Curves.A.ValidCurveWeights, Curves.B.ValidCurveWeights); It; ++It)
+		{
+			const int32 Idx = It.GetIndex();
+			OutCurve.ValidCurveWeights[Idx] = true;
+			OutCurve.CurveWeights[Idx] = FMath::Lerp(Curves.A.CurveWeights[Idx], Curves.B.CurveWeights[Idx], 0.3f);
+		}
+
+		for (TConstDualEitherSetBitIterator<FDefaultAllocator, FDefaultAllocator> It(OutCurve.ValidCurveWeights, Curves.Additive.ValidCurveWeights); It; ++It)
+		{
+			const int32 Idx = It.GetIndex();
+			OutCurve.ValidCurveWeights[Idx] = true;
+			OutCurve.CurveWeights[Idx] += Curves.Additive.CurveWeights[Idx] * 0.5f;
+		}
+
+		for (TConstSetBitIterator<FDefaultAllocator> It(Curves.Combined.ValidCurveWeights); It; ++It)
+		{
+			const int32 Idx = It.GetIndex();
+			OutCurve.CurveWeights[Idx] = Curves.Combined.CurveWeights[Idx];
+			OutCurve.ValidCurveWeights[Idx] = true;
+		}
+
+		for (TConstSetBitIterator<FDefaultAllocator> It(OutCurve.ValidCurveWeights); It; ++It)
+		{
+			OutCurve.CurveWeights[It.GetIndex()] *= 0.7f;
+		}
+	}
+
+	static void BlendCurves(const FCurveSet& Curves, FBlendedHeapCurve& OutCurve, FBlendedHeapCurve& Scratch)
+	{
+		Scratch.Lerp(Curves.A, Curves.B, 0.3f);
+		Scratch.Accumulate(Curves.Additive, 0.5f);
+		Scratch.Combine(Curves.Combined);
+		OutCurve.Override(Scratch, 0.7f);
+	}
+
+	/** Curves invalid in both are left undefined, only the valid ones have to match */
+	static bool CurvesMatch(const FBlendedHeapCurve& A, const FBlendedHeapCurve& B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return false;
+		}
+		for (int32 CurveIndex = 0; CurveIndex < A.Num(); ++CurveIndex)
+		{
+			if (A.ValidCurveWeights[CurveIndex] != B.ValidCurveWeights[CurveIndex]
+				|| (A.ValidCurveWeights[CurveIndex] && !FMath::IsNearlyEqual(A.CurveWeights[CurveIndex], B.CurveWeights[CurveIndex], KINDA_SMALL_NUMBER)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool FCurveBlendingBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace CurveBlendingTest;
+
+	IConsoleVariable* ISPCCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("a.CurveBlending.ISPC"));
+	const int32 PreviousISPC = ISPCCVar ? ISPCCVar->GetInt() : 0;
+	if (!ISPCCVar)
+	{
+		AddInfo(TEXT("Built without ISPC, only timing the scalar blends"));
+	}
+
+	FRandomStream Random(0xC0B7E);
+
+	for (const int32 NumCurves : CurveCounts)
+	{
+		// Curve UIDs map straight to array indices
+		TArray<uint16> UIDToArrayIndexLUT;
+		UIDToArrayIndexLUT.Reserve(NumCurves);
+		for (int32 CurveIndex = 0; CurveIndex < NumCurves; ++CurveIndex)
+		{
+			UIDToArrayIndexLUT.Add((uint16)CurveIndex);
+		}
+
+		for (const float ValidFraction : ValidFractions)
+		{
+			FCurveSet Curves;
+			BuildCurve(Curves.A, UIDToArrayIndexLUT, ValidFraction, Random);
+			BuildCurve(Curves.B, UIDToArrayIndexLUT, ValidFraction, Random);
+			BuildCurve(Curves.Additive, UIDToArrayIndexLUT, ValidFraction, Random);
+			BuildCurve(Curves.Combined, UIDToArrayIndexLUT, ValidFraction * 0.5f, Random);
+
+			const FString Description = FString::Printf(TEXT("%d curves, %d%% valid"), NumCurves, FMath::RoundToInt(ValidFraction * 100.0f));
+
+			FBlendedHeapCurve CurveAtATimeResult;
+			const double CurveAtATimeSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+			{
+				BlendCurveAtATime(Curves, CurveAtATimeResult);
+			});
+
+			// The scratch curve is kept between iterations, as an anim node would keep it between frames
+			FBlendedHeapCurve Scratch;
+
+			if (ISPCCVar)
+			{
+				ISPCCVar->Set(0, ECVF_SetByCode);
+			}
+
+			FBlendedHeapCurve ScalarResult;
+			const double ScalarSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+			{
+				BlendCurves(Curves, ScalarResult, Scratch);
+			});
+			TestTrue(FString::Printf(TEXT("%s, scalar kernels match"), *Description), CurvesMatch(CurveAtATimeResult, ScalarResult));
+
+			FString Timings = FString::Printf(TEXT("%s: curve at a time %s, scalar kernels %s"), *Description, *AutomationBenchmark::FormatMicroseconds(CurveAtATimeSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ScalarSeconds, NumIterations));
+
+			if (ISPCCVar)
+			{
+				ISPCCVar->Set(1, ECVF_SetByCode);
+
+				FBlendedHeapCurve ISPCResult;
+				const double ISPCSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+				{
+					BlendCurves(Curves, ISPCResult, Scratch);
+				});
+				TestTrue(FString::Printf(TEXT("%s, ISPC kernels match"), *Description), CurvesMatch(CurveAtATimeResult, ISPCResult));
+				Timings += FString::Printf(TEXT(", ISPC kernels %s"), *AutomationBenchmark::FormatMicroseconds(ISPCSeconds, NumIterations));
+			}
+
+			AddInfo(Timings);
+		}
+	}
+
+	if (ISPCCVar)
+	{
+		ISPCCVar->Set(PreviousISPC, ECVF_SetByCode);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
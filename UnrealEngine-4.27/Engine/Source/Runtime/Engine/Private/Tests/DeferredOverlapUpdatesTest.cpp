@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Actor.h"
+#include "Components/SphereComponent.h"
+#include "DeferredOverlapUpdates.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Moves a large number of overlap volumes around for a few frames, once with immediate UpdateOverlaps
+ * and once with deferred overlap updates, and compares both the cost and the resulting overlap state.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeferredOverlapUpdatesBenchmark, "System.Engine.Collision.DeferredOverlapUpdates Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace DeferredOverlapUpdatesTest
+{
+	static const int32 NumVolumes = 5000;
+	static const int32 NumFrames = 10;
+	static const float VolumeRadius = 50.0f;
+	static const float WorldExtent = 10000.0f;
+
+	static TArray<USphereComponent*> SpawnVolumes(UWorld* World)
+	{
+		TArray<USphereComponent*> Volumes;
+		Volumes.Reserve(NumVolumes);
+
+		for (int32 Index = 0; Index < NumVolumes; ++Index)
+		{
+			AActor* Actor = World->SpawnActor<AActor>();
+			USphereComponent* Sphere = NewObject<USphereComponent>(Actor);
+			Sphere->SetSphereRadius(VolumeRadius, false);
+			Sphere->SetMobility(EComponentMobility::Movable);
+			Sphere->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+			Sphere->SetGenerateOverlapEvents(true);
+			Actor->SetRootComponent(Sphere);
+			Sphere->RegisterComponent();
+			Volumes.Add(Sphere);
+		}
+
+		return Volumes;
+	}
+
+	/** Moves every volume NumFrames times and returns the time spent in seconds. */
+	static double MoveVolumes(UWorld* World, const TArray<USphereComponent*>& Volumes, bool bDefer)
+	{
+		for (USphereComponent* Sphere : Volumes)
+		{
+			Sphere->bDeferOverlapUpdates = bDefer;
+		}
+
+		// Same seed for both runs so the volumes follow the same paths.
+		FRandomStream Random(0x0DEF0E1A);
+
+		return AutomationBenchmark::TimeIterations(NumFrames, [World, &Volumes, &Random](int32 Frame)
+		{
+			for (USphereComponent* Sphere : Volumes)
+			{
+				const FVector NewLocation(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0.0f);
+				Sphere->SetWorldLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
+			}
+			World->GetDeferredOverlapUpdates().Flush(World);
+		});
+	}
+
+	static int32 CountOverlaps(const TArray<USphereComponent*>& Volumes)
+	{
+		int32 NumOverlaps = 0;
+		for (const USphereComponent* Sphere : Volumes)
+		{
+			NumOverlaps += Sphere->GetOverlapInfos().Num();
+		}
+		return NumOverlaps;
+	}
+}
+
+bool FDeferredOverlapUpdatesBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace DeferredOverlapUpdatesTest;
+
+	IConsoleVariable* DeferredOverlapsCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("p.DeferredOverlapUpdates"));
+	if (!TestNotNull(TEXT("p.DeferredOverlapUpdates exists"), DeferredOverlapsCVar))
+	{
+		return false;
+	}
+	const int32 PreviousCVarValue = DeferredOverlapsCVar->GetInt();
+	DeferredOverlapsCVar->Set(1, ECVF_SetByCode);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	const TArray<USphereComponent*> Volumes = SpawnVolumes(World);
+
+	// A component moved several times in a frame is queried once, with notifies if any of the moves wanted them
+	FDeferredOverlapUpdates& DeferredOverlapUpdates = World->GetDeferredOverlapUpdates();
+	DeferredOverlapUpdates.Enqueue(Volumes[0], false);
+	DeferredOverlapUpdates.Enqueue(Volumes[1], false);
+	DeferredOverlapUpdates.Enqueue(Volumes[0], true);
+	TestEqual(TEXT("Components queued twice are only queued once"), DeferredOverlapUpdates.Num(), 2);
+	DeferredOverlapUpdates.Reset();
+
+	const double ImmediateSeconds = MoveVolumes(World, Volumes, false);
+	const int32 ImmediateOverlaps = CountOverlaps(Volumes);
+
+	const double DeferredSeconds = MoveVolumes(World, Volumes, true);
+	const int32 DeferredOverlaps = CountOverlaps(Volumes);
+
+	TestEqual(TEXT("Deferred overlap updates produce the same overlaps as immediate updates"), DeferredOverlaps, ImmediateOverlaps);
+	TestEqual(TEXT("Deferred overlap queue is empty after flush"), World->GetDeferredOverlapUpdates().Num(), 0);
+
+	AddInfo(FString::Printf(TEXT("%d volumes x %d frames: immediate %s/frame, deferred %s/frame (%d overlaps)"),
+		NumVolumes, NumFrames, *AutomationBenchmark::FormatMilliseconds(ImmediateSeconds, NumFrames), *AutomationBenchmark::FormatMilliseconds(DeferredSeconds, NumFrames), DeferredOverlaps));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	DeferredOverlapsCVar->Set(PreviousCVarValue, ECVF_SetByCode);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "GenericQuadTree.h"
+#include "GenericLooseQuadTree.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Compares TQuadTree and TLooseQuadTree for insert, bulk insert, query and remove at 10k to 1M elements,
+ * and checks that both trees return the same elements for every query.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLooseQuadTreeBenchmark, "System.Engine.QuadTree.LooseQuadTree Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace LooseQuadTreeTest
+{
+	static const float WorldExtent = 100000.0f;
+	static const int32 NumQueries = 2000;
+
+	struct FTimings
+	{
+		double Insert = 0.0;
+		double Query = 0.0;
+		double Remove = 0.0;
+		int64 NumFound = 0;
+
+		FString ToString() const
+		{
+			return FString::Printf(TEXT("insert %s query %s remove %s"), *AutomationBenchmark::FormatMilliseconds(Insert), *AutomationBenchmark::FormatMilliseconds(Query), *AutomationBenchmark::FormatMilliseconds(Remove));
+		}
+	};
+
+	static void MakeBoxes(int32 NumElements, TArray<int32>& OutElements, TArray<FBox2D>& OutBoxes)
+	{
+		FRandomStream Random(0x10053);
+		OutElements.SetNumUninitialized(NumElements);
+		OutBoxes.SetNumUninitialized(NumElements);
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			const FVector2D Center(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent));
+			const FVector2D Extent(Random.FRandRange(5.0f, 200.0f), Random.FRandRange(5.0f, 200.0f));
+			OutElements[Index] = Index;
+			OutBoxes[Index] = FBox2D(Center - Extent, Center + Extent);
+		}
+	}
+
+	static void MakeQueries(TArray<FBox2D>& OutQueries)
+	{
+		FRandomStream Random(0x10054);
+		OutQueries.SetNumUninitialized(NumQueries);
+		for (FBox2D& Query : OutQueries)
+		{
+			const FVector2D Center(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent));
+			const FVector2D Extent(Random.FRandRange(100.0f, 2000.0f), Random.FRandRange(100.0f, 2000.0f));
+			Query = FBox2D(Center - Extent, Center + Extent);
+		}
+	}
+
+	template <typename QuadTreeType>
+	static void RunQueries(const QuadTreeType& Tree, const TArray<FBox2D>& Queries, TArray<TArray<int32>>& OutResults, FTimings& Timings)
+	{
+		OutResults.SetNum(Queries.Num());
+		Timings.Query = AutomationBenchmark::TimeIterations(Queries.Num(), [&Tree, &Queries, &OutResults](int32 Index)
+		{
+			OutResults[Index].Reset();
+			Tree.GetElements(Queries[Index], OutResults[Index]);
+		});
+
+		for (TArray<int32>& Result : OutResults)
+		{
+			Timings.NumFound += Result.Num();
+			Result.Sort();
+		}
+	}
+
+	template <typename QuadTreeType>
+	static void RunRemoves(QuadTreeType& Tree, const TArray<int32>& Elements, const TArray<FBox2D>& Boxes, FTimings& Timings)
+	{
+		// Remove every other element
+		Timings.Remove = AutomationBenchmark::TimeIterations((Elements.Num() + 1) / 2, [&Tree, &Elements, &Boxes](int32 Iteration)
+		{
+			Tree.Remove(Elements[Iteration * 2], Boxes[Iteration * 2]);
+		});
+	}
+}
+
+bool FLooseQuadTreeBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace LooseQuadTreeTest;
+
+	const FBox2D TreeBox(FVector2D(-WorldExtent, -WorldExtent), FVector2D(WorldExtent, WorldExtent));
+	const int32 ElementCounts[] = { 10000, 100000, 1000000 };
+
+	TArray<FBox2D> Queries;
+	MakeQueries(Queries);
+
+	for (const int32 NumElements : ElementCounts)
+	{
+		TArray<int32> Elements;
+		TArray<FBox2D> Boxes;
+		MakeBoxes(NumElements, Elements, Boxes);
+
+		TArray<TArray<int32>> QuadTreeResults;
+		TArray<TArray<int32>> LooseResults;
+		TArray<TArray<int32>> BulkResults;
+		FTimings QuadTreeTimings;
+		FTimings LooseTimings;
+		FTimings BulkTimings;
+
+		{
+			TQuadTree<int32> QuadTree(TreeBox);
+			QuadTreeTimings.Insert = AutomationBenchmark::TimeIterations(NumElements, [&QuadTree, &Elements, &Boxes](int32 Index)
+			{
+				QuadTree.Insert(Elements[Index], Boxes[Index]);
+			});
+			RunQueries(QuadTree, Queries, QuadTreeResults, QuadTreeTimings);
+			RunRemoves(QuadTree, Elements, Boxes, QuadTreeTimings);
+		}
+
+		{
+			TLooseQuadTree<int32> LooseTree(TreeBox);
+			LooseTimings.Insert = AutomationBenchmark::TimeIterations(NumElements, [&LooseTree, &Elements, &Boxes](int32 Index)
+			{
+				LooseTree.Insert(Elements[Index], Boxes[Index]);
+			});
+			RunQueries(LooseTree, Queries, LooseResults, LooseTimings);
+			RunRemoves(LooseTree, Elements, Boxes, LooseTimings);
+			TestEqual(FString::Printf(TEXT("%d elements: loose tree removes every requested element"), NumElements), LooseTree.Num(), NumElements / 2);
+		}
+
+		{
+			TLooseQuadTree<int32> BulkTree(TreeBox);
+			BulkTimings.Insert = AutomationBenchmark::TimeIterations(1, [&BulkTree, &Elements, &Boxes](int32)
+			{
+				BulkTree.BulkInsert(Elements, Boxes);
+			});
+			RunQueries(BulkTree, Queries, BulkResults, BulkTimings);
+			RunRemoves(BulkTree, Elements, Boxes, BulkTimings);
+			TestEqual(FString::Printf(TEXT("%d elements: bulk built tree removes every requested element"), NumElements), BulkTree.Num(), NumElements / 2);
+		}
+
+		int32 NumLooseMismatches = 0;
+		int32 NumBulkMismatches = 0;
+		for (int32 Index = 0; Index < Queries.Num(); ++Index)
+		{
+			NumLooseMismatches += (LooseResults[Index] != QuadTreeResults[Index]) ? 1 : 0;
+			NumBulkMismatches += (BulkResults[Index] != QuadTreeResults[Index]) ? 1 : 0;
+		}
+		TestEqual(FString::Printf(TEXT("%d elements: loose tree queries match TQuadTree"), NumElements), NumLooseMismatches, 0);
+		TestEqual(FString::Printf(TEXT("%d elements: bulk built tree queries match TQuadTree"), NumElements), NumBulkMismatches, 0);
+
+		AddInfo(FString::Printf(TEXT("%d elements, %d queries (%lld found): TQuadTree %s | loose %s | loose bulk %s"),
+			NumElements, Queries.Num(), QuadTreeTimings.NumFound, *QuadTreeTimings.ToString(), *LooseTimings.ToString(), *BulkTimings.ToString()));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
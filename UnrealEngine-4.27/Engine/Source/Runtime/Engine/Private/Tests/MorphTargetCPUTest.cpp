@@ -0,0 +1,239 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Animation/MorphTarget.h"
+#include "Rendering/MorphTargetCPUDeltas.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "SkeletalRenderGPUSkin.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Plays back facial animation on a synthetic 50k vertex face with 120 morph targets, a few of which change weight every frame, through
+ * the CPU morph path: once accumulating the source deltas of every active morph like the original loop, once rebuilding from quantized
+ * deltas every frame and once applying only the morphs that changed. Checks the quantized results match and reports the time per frame.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMorphTargetCPUBenchmark, "System.Engine.Rendering.MorphTargetCPU Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace MorphTargetCPUTest
+{
+	/** Face and eyes plus teeth */
+	static const uint32 SectionNumVertices[] = { 42000, 8000 };
+	static const int32 NumMorphs = 120;
+	static const int32 NumFrames = 300;
+	static const int32 NumChangedMorphsPerFrame = 6;
+	static const float Tolerance = 0.01f;
+
+	static UMorphTarget* CreateMorphTarget(const TArray<FSkelMeshRenderSection>& Sections, FRandomStream& Random)
+	{
+		UMorphTarget* MorphTarget = NewObject<UMorphTarget>();
+		FMorphTargetLODModel& LODModel = MorphTarget->MorphLODModels.AddDefaulted_GetRef();
+		LODModel.NumBaseMeshVerts = Sections.Last().BaseVertexIndex + Sections.Last().NumVertices;
+
+		// Most morphs move a patch of the face, some the eyes
+		const int32 SectionIndex = Random.RandRange(0, 9) == 0 ? 1 : 0;
+		const FSkelMeshRenderSection& Section = Sections[SectionIndex];
+		const uint32 NumDeltas = FMath::Min((uint32)Random.RandRange(500, 4000), Section.NumVertices);
+		const uint32 FirstVertex = Section.BaseVertexIndex + Random.RandRange(0, Section.NumVertices - NumDeltas);
+
+		LODModel.SectionIndices.Add(SectionIndex);
+		LODModel.Vertices.Reserve(NumDeltas);
+		for (uint32 DeltaIndex = 0; DeltaIndex < NumDeltas; ++DeltaIndex)
+		{
+			FMorphTargetDelta& Delta = LODModel.Vertices.AddDefaulted_GetRef();
+			Delta.SourceIdx = FirstVertex + DeltaIndex;
+			Delta.PositionDelta = Random.GetUnitVector() * Random.FRandRange(0.0f, 1.5f);
+			Delta.TangentZDelta = Random.GetUnitVector() * Random.FRandRange(0.0f, 0.3f);
+		}
+
+		// Source deltas aren't sorted by vertex
+		for (int32 DeltaIndex = LODModel.Vertices.Num() - 1; DeltaIndex > 0; --DeltaIndex)
+		{
+			LODModel.Vertices.Swap(DeltaIndex, Random.RandRange(0, DeltaIndex));
+		}
+
+		return MorphTarget;
+	}
+
+	/** The accumulation the CPU morph path does without quantized deltas */
+	static void AccumulateSourceDeltas(const TArray<UMorphTarget*>& MorphTargets, const TArray<FActiveMorphTarget>& ActiveMorphTargets, const TArray<float>& MorphTargetWeights, TArray<float>& AccumulatedWeights, TArray<FMorphGPUSkinVertex>& OutVertices)
+	{
+		FMemory::Memzero(OutVertices.GetData(), OutVertices.Num() * sizeof(FMorphGPUSkinVertex));
+		FMemory::Memzero(AccumulatedWeights.GetData(), AccumulatedWeights.Num() * sizeof(float));
+
+		for (const FActiveMorphTarget& ActiveMorphTarget : ActiveMorphTargets)
+		{
+			const float Weight = MorphTargetWeights[ActiveMorphTarget.WeightIndex];
+			const float AbsWeight = FMath::Abs(Weight);
+
+			int32 NumDeltas = 0;
+			const FMorphTargetDelta* Deltas = ActiveMorphTarget.MorphTarget->GetMorphTargetDelta(0, NumDeltas);
+			for (int32 DeltaIndex = 0; DeltaIndex < NumDeltas; ++DeltaIndex)
+			{
+				const FMorphTargetDelta& Delta = Deltas[DeltaIndex];
+				FMorphGPUSkinVertex& Vertex = OutVertices[Delta.SourceIdx];
+				Vertex.DeltaPosition += Delta.PositionDelta * Weight;
+				Vertex.DeltaTangentZ += Delta.TangentZDelta * Weight;
+				AccumulatedWeights[Delta.SourceIdx] += AbsWeight;
+			}
+		}
+
+		for (int32 VertexIndex = 0; VertexIndex < OutVertices.Num(); ++VertexIndex)
+		{
+			if (AccumulatedWeights[VertexIndex] > 1.0f)
+			{
+				OutVertices[VertexIndex].DeltaTangentZ /= AccumulatedWeights[VertexIndex];
+			}
+		}
+	}
+
+	/** Weights of every frame, with a handful of morphs moving to a new weight, or to 0, each frame */
+	static void BuildFrames(FRandomStream& Random, TArray<TArray<float>>& OutWeights, TArray<TArray<FActiveMorphTarget>>& OutActiveMorphTargets, const TArray<UMorphTarget*>& MorphTargets)
+	{
+		TArray<float> Weights;
+		Weights.SetNumZeroed(NumMorphs);
+		for (int32 MorphIndex = 0; MorphIndex < NumMorphs; MorphIndex += 3)
+		{
+			Weights[MorphIndex] = Random.FRandRange(0.1f, 1.0f);
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 Change = 0; Change < NumChangedMorphsPerFrame; ++Change)
+			{
+				Weights[Random.RandRange(0, NumMorphs - 1)] = Random.RandRange(0, 3) == 0 ? 0.0f : Random.FRandRange(-0.5f, 1.0f);
+			}
+
+			TArray<FActiveMorphTarget>& ActiveMorphTargets = OutActiveMorphTargets.AddDefaulted_GetRef();
+			for (int32 MorphIndex = 0; MorphIndex < NumMorphs; ++MorphIndex)
+			{
+				if (Weights[MorphIndex] != 0.0f)
+				{
+					ActiveMorphTargets.Add(FActiveMorphTarget(MorphTargets[MorphIndex], MorphIndex));
+				}
+			}
+			OutWeights.Add(Weights);
+		}
+	}
+
+	static float GetMaxDifference(const TArray<FMorphGPUSkinVertex>& A, const TArray<FMorphGPUSkinVertex>& B)
+	{
+		float MaxDifference = 0.0f;
+		for (int32 VertexIndex = 0; VertexIndex < A.Num(); ++VertexIndex)
+		{
+			MaxDifference = FMath::Max(MaxDifference, (A[VertexIndex].DeltaPosition - B[VertexIndex].DeltaPosition).GetAbsMax());
+			MaxDifference = FMath::Max(MaxDifference, (A[VertexIndex].DeltaTangentZ - B[VertexIndex].DeltaTangentZ).GetAbsMax());
+		}
+		return MaxDifference;
+	}
+}
+
+bool FMorphTargetCPUBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace MorphTargetCPUTest;
+
+	FRandomStream Random(0xFACE5);
+
+	TArray<FSkelMeshRenderSection> Sections;
+	uint32 NumVertices = 0;
+	for (const uint32 NumSectionVertices : SectionNumVertices)
+	{
+		FSkelMeshRenderSection& Section = Sections.AddDefaulted_GetRef();
+		Section.BaseVertexIndex = NumVertices;
+		Section.NumVertices = NumSectionVertices;
+		NumVertices += NumSectionVertices;
+	}
+
+	TArray<UMorphTarget*> MorphTargets;
+	int32 NumSourceDeltas = 0;
+	for (int32 MorphIndex = 0; MorphIndex < NumMorphs; ++MorphIndex)
+	{
+		MorphTargets.Add(CreateMorphTarget(Sections, Random));
+		NumSourceDeltas += MorphTargets.Last()->MorphLODModels[0].Vertices.Num();
+	}
+
+	FMorphTargetCPUDeltas Deltas;
+	Deltas.Build(MorphTargets, 0, Sections);
+	if (!TestEqual(TEXT("Every morph is quantized"), Deltas.GetNumMorphs(), NumMorphs) || !TestEqual(TEXT("Every delta is quantized"), Deltas.GetDeltas().Num(), NumSourceDeltas))
+	{
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("%u vertices, %d morphs, %d deltas: %d KB of source deltas, %d KB quantized"), NumVertices, NumMorphs, NumSourceDeltas,
+		(int32)(NumSourceDeltas * sizeof(FMorphTargetDelta) / 1024), (int32)(Deltas.GetAllocatedSize() / 1024)));
+
+	TArray<TArray<float>> FrameWeights;
+	TArray<TArray<FActiveMorphTarget>> FrameActiveMorphTargets;
+	BuildFrames(Random, FrameWeights, FrameActiveMorphTargets, MorphTargets);
+
+	TArray<float> AccumulatedWeights;
+	AccumulatedWeights.SetNumZeroed(NumVertices);
+	TArray<FMorphGPUSkinVertex> SourceVertices;
+	SourceVertices.SetNumZeroed(NumVertices);
+	TArray<FMorphGPUSkinVertex> RebuiltVertices;
+	RebuiltVertices.SetNumZeroed(NumVertices);
+	TArray<FMorphGPUSkinVertex> IncrementalVertices;
+	IncrementalVertices.SetNumZeroed(NumVertices);
+
+	IConsoleVariable* RebuildIntervalCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.MorphTarget.CPU.RebuildInterval"));
+	const int32 PreviousRebuildInterval = RebuildIntervalCVar ? RebuildIntervalCVar->GetInt() : 0;
+
+	FMorphTargetCPUAccumulation RebuiltAccumulation;
+	FMorphTargetCPUAccumulation IncrementalAccumulation;
+
+	double SourceSeconds = 0.0;
+	double RebuiltSeconds = 0.0;
+	double IncrementalSeconds = 0.0;
+	int64 NumRebuiltDeltas = 0;
+	int64 NumIncrementalDeltas = 0;
+	float MaxRebuiltDifference = 0.0f;
+	float MaxIncrementalDifference = 0.0f;
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const TArray<float>& Weights = FrameWeights[Frame];
+		const TArray<FActiveMorphTarget>& ActiveMorphTargets = FrameActiveMorphTargets[Frame];
+
+		SourceSeconds += AutomationBenchmark::TimeIterations(1, [&](int32)
+		{
+			AccumulateSourceDeltas(MorphTargets, ActiveMorphTargets, Weights, AccumulatedWeights, SourceVertices);
+		});
+
+		if (RebuildIntervalCVar)
+		{
+			RebuildIntervalCVar->Set(0, ECVF_SetByCode);
+		}
+		RebuiltSeconds += AutomationBenchmark::TimeIterations(1, [&](int32)
+		{
+			NumRebuiltDeltas += RebuiltAccumulation.Update(Deltas, ActiveMorphTargets, Weights, true, NumVertices, RebuiltVertices.GetData());
+		});
+
+		if (RebuildIntervalCVar)
+		{
+			RebuildIntervalCVar->Set(PreviousRebuildInterval, ECVF_SetByCode);
+		}
+		IncrementalSeconds += AutomationBenchmark::TimeIterations(1, [&](int32)
+		{
+			NumIncrementalDeltas += IncrementalAccumulation.Update(Deltas, ActiveMorphTargets, Weights, true, NumVertices, IncrementalVertices.GetData());
+		});
+
+		MaxRebuiltDifference = FMath::Max(MaxRebuiltDifference, GetMaxDifference(SourceVertices, RebuiltVertices));
+		MaxIncrementalDifference = FMath::Max(MaxIncrementalDifference, GetMaxDifference(SourceVertices, IncrementalVertices));
+	}
+
+	TestTrue(FString::Printf(TEXT("Rebuilt quantized deltas match the source deltas (max difference %f)"), MaxRebuiltDifference), MaxRebuiltDifference < Tolerance);
+	TestTrue(FString::Printf(TEXT("Incremental quantized deltas match the source deltas (max difference %f)"), MaxIncrementalDifference), MaxIncrementalDifference < Tolerance);
+
+	AddInfo(FString::Printf(TEXT("Source deltas: %s per frame"), *AutomationBenchmark::FormatMicroseconds(SourceSeconds, NumFrames)));
+	AddInfo(FString::Printf(TEXT("Quantized, rebuilt every frame: %s per frame, %lld deltas per frame"), *AutomationBenchmark::FormatMicroseconds(RebuiltSeconds, NumFrames), NumRebuiltDeltas / NumFrames));
+	AddInfo(FString::Printf(TEXT("Quantized, changed morphs only: %s per frame, %lld deltas per frame"), *AutomationBenchmark::FormatMicroseconds(IncrementalSeconds, NumFrames), NumIncrementalDeltas / NumFrames));
+	AddInfo(FString::Printf(TEXT("Sums kept for %d of %u vertices: %d KB per mesh object LOD"), Deltas.GetMorphedVertices().Num(), NumVertices, (int32)(IncrementalAccumulation.GetAllocatedSize() / 1024)));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
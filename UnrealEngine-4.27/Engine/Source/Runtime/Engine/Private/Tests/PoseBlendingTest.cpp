@@ -0,0 +1,243 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "AnimationRuntime.h"
+#include "BonePose.h"
+#include "Animation/AnimationAsset.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/CustomAttributesRuntime.h"
+#include "Animation/Skeleton.h"
+#include "Engine/SkeletalMesh.h"
+#include "Tests/AutomationBenchmarkHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Blends random poses of 50, 150 and 300 bone skeletons the way a blend space samples them: a weighted blend of four samples, a per bone
+ * blend of the same samples, a two pose per bone blend and a weighted additive. Runs each with a.PoseBlending.ISPC off then on, checks
+ * both give the same pose and reports the time per blend.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseBlendingBenchmark, "System.Engine.Animation.PoseBlending Benchmark", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+namespace PoseBlendingTest
+{
+	static const int32 BoneCounts[] = { 50, 150, 300 };
+	static const int32 NumSamples = 4;
+	static const int32 NumIterations = 2000;
+
+	/** Every third bone blends with its own weight, like a blend space with per bone interpolation on some bones */
+	class FEveryThirdBoneIndexProvider : public IInterpolationIndexProvider
+	{
+	public:
+		virtual int32 GetPerBoneInterpolationIndex(int32 BoneIndex, const FBoneContainer& RequiredBones) const override
+		{
+			return BoneIndex % 3 == 0 ? 0 : INDEX_NONE;
+		}
+	};
+
+	/** Builds a skeleton of NumBones bones, each parented to the bone half its index */
+	static USkeleton* CreateSkeleton(const int32 NumBones)
+	{
+		USkeletalMesh* SkeletalMesh = NewObject<USkeletalMesh>();
+		{
+			FReferenceSkeletonModifier Modifier(SkeletalMesh->GetRefSkeleton(), nullptr);
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				const FName BoneName(*FString::Printf(TEXT("Bone_%d"), BoneIndex));
+				Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), BoneIndex > 0 ? (BoneIndex - 1) / 2 : INDEX_NONE), FTransform(FVector(10.0f, 0.0f, 0.0f)));
+			}
+		}
+
+		USkeleton* Skeleton = NewObject<USkeleton>();
+		Skeleton->MergeAllBonesToBoneTree(SkeletalMesh);
+		return Skeleton;
+	}
+
+	static void RandomizePose(FCompactPose& Pose, FRandomStream& Random)
+	{
+		for (FTransform& Bone : Pose.GetMutableBones())
+		{
+			const FQuat Rotation(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f));
+			Bone.SetRotation(Rotation.GetNormalized());
+			Bone.SetTranslation(Random.GetUnitVector() * Random.FRandRange(0.0f, 50.0f));
+			Bone.SetScale3D(FVector(Random.FRandRange(0.9f, 1.1f)));
+		}
+	}
+
+	static bool PosesMatch(const FCompactPose& A, const FCompactPose& B)
+	{
+		for (const FCompactPoseBoneIndex BoneIndex : A.ForEachBoneIndex())
+		{
+			if (!A[BoneIndex].Equals(B[BoneIndex], KINDA_SMALL_NUMBER * 10.0f))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	struct FBlendResults
+	{
+		FCompactPose Weighted;
+		FCompactPose PerBone;
+		FCompactPose TwoPosesPerBone;
+		FCompactPose Additive;
+
+		double WeightedSeconds = 0.0;
+		double PerBoneSeconds = 0.0;
+		double TwoPosesPerBoneSeconds = 0.0;
+		double AdditiveSeconds = 0.0;
+	};
+
+	static void RunBlends(const FBoneContainer& BoneContainer, const TArray<FCompactPose>& Samples, FBlendResults& Results)
+	{
+		const int32 NumBones = BoneContainer.GetCompactPoseNumBones();
+
+		FBlendedCurve Curve;
+		FStackCustomAttributes Attributes;
+
+		TArray<float> SampleWeights = { 0.4f, 0.3f, 0.2f, 0.1f };
+		TArray<FBlendSampleData> SampleData;
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			FBlendSampleData& Sample = SampleData.Add_GetRef(FBlendSampleData(SampleIndex));
+			Sample.TotalWeight = SampleWeights[SampleIndex];
+			Sample.PerBoneBlendData.Add(SampleIndex == 0 ? 0.7f : 0.1f);
+		}
+
+		TArray<float> WeightsOfSourceTwo;
+		WeightsOfSourceTwo.SetNumUninitialized(NumBones);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			// Mix of bones taken from either pose and bones blended
+			WeightsOfSourceTwo[BoneIndex] = (BoneIndex % 4) / 3.0f;
+		}
+
+		const FEveryThirdBoneIndexProvider IndexProvider;
+
+		Results.Weighted.SetBoneContainer(&BoneContainer);
+		Results.PerBone.SetBoneContainer(&BoneContainer);
+		Results.TwoPosesPerBone.SetBoneContainer(&BoneContainer);
+		Results.Additive.SetBoneContainer(&BoneContainer);
+
+		{
+			FAnimationPoseData PoseData(Results.Weighted, Curve, Attributes);
+			Results.WeightedSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+			{
+				FAnimationRuntime::BlendPosesTogether(Samples, {}, {}, SampleWeights, PoseData);
+			});
+		}
+
+		{
+			FAnimationPoseData PoseData(Results.PerBone, Curve, Attributes);
+			Results.PerBoneSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+			{
+				FAnimationRuntime::BlendPosesTogetherPerBone(Samples, {}, {}, &IndexProvider, SampleData, PoseData);
+			});
+		}
+
+		{
+			FAnimationPoseData PoseData(Results.TwoPosesPerBone, Curve, Attributes);
+			const FAnimationPoseData PoseOneData(const_cast<FCompactPose&>(Samples[0]), Curve, Attributes);
+			const FAnimationPoseData PoseTwoData(const_cast<FCompactPose&>(Samples[1]), Curve, Attributes);
+			Results.TwoPosesPerBoneSeconds = AutomationBenchmark::TimeIterations(NumIterations, [&](int32)
+			{
+				FAnimationRuntime::BlendTwoPosesTogetherPerBone(PoseOneData, PoseTwoData, WeightsOfSourceTwo, PoseData);
+			});
+		}
+
+		{
+			FAnimationPoseData PoseData(Results.Additive, Curve, Attributes);
+			const FAnimationPoseData AdditiveData(const_cast<FCompactPose&>(Samples[2]), Curve, Attributes);
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				// Start from the same base every time so both runs end up with the same pose
+				Results.Additive.CopyBonesFrom(Samples[3]);
+
+				Results.AdditiveSeconds += AutomationBenchmark::TimeIterations(1, [&](int32)
+				{
+					FAnimationRuntime::AccumulateAdditivePose(PoseData, AdditiveData, 0.5f, AAT_LocalSpaceBase);
+				});
+			}
+		}
+	}
+}
+
+bool FPoseBlendingBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace PoseBlendingTest;
+
+	IConsoleVariable* ISPCCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("a.PoseBlending.ISPC"));
+	const int32 PreviousCVarValue = ISPCCVar ? ISPCCVar->GetInt() : 0;
+	if (!ISPCCVar)
+	{
+		AddInfo(TEXT("Built without ISPC, only timing the scalar blends"));
+	}
+
+	FRandomStream Random(0xB1E4D);
+
+	for (const int32 NumBones : BoneCounts)
+	{
+		USkeleton* Skeleton = CreateSkeleton(NumBones);
+
+		TArray<FBoneIndexType> RequiredBoneIndices;
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			RequiredBoneIndices.Add((FBoneIndexType)BoneIndex);
+		}
+		const FBoneContainer BoneContainer(RequiredBoneIndices, FCurveEvaluationOption(false), *Skeleton);
+		if (!TestEqual(FString::Printf(TEXT("%d bone skeleton is built"), NumBones), BoneContainer.GetCompactPoseNumBones(), NumBones))
+		{
+			continue;
+		}
+
+		FMemMark Mark(FMemStack::Get());
+
+		TArray<FCompactPose> Samples;
+		Samples.SetNum(NumSamples);
+		for (FCompactPose& Sample : Samples)
+		{
+			Sample.SetBoneContainer(&BoneContainer);
+			RandomizePose(Sample, Random);
+		}
+
+		FBlendResults ScalarResults;
+		if (ISPCCVar)
+		{
+			ISPCCVar->Set(0, ECVF_SetByCode);
+		}
+		RunBlends(BoneContainer, Samples, ScalarResults);
+
+		AddInfo(FString::Printf(TEXT("%d bones, scalar: weighted %s, per bone %s, two poses per bone %s, additive %s"), NumBones,
+			*AutomationBenchmark::FormatMicroseconds(ScalarResults.WeightedSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ScalarResults.PerBoneSeconds, NumIterations),
+			*AutomationBenchmark::FormatMicroseconds(ScalarResults.TwoPosesPerBoneSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ScalarResults.AdditiveSeconds, NumIterations)));
+
+		if (ISPCCVar)
+		{
+			FBlendResults ISPCResults;
+			ISPCCVar->Set(1, ECVF_SetByCode);
+			RunBlends(BoneContainer, Samples, ISPCResults);
+
+			TestTrue(FString::Printf(TEXT("%d bones weighted blend matches"), NumBones), PosesMatch(ScalarResults.Weighted, ISPCResults.Weighted));
+			TestTrue(FString::Printf(TEXT("%d bones per bone blend matches"), NumBones), PosesMatch(ScalarResults.PerBone, ISPCResults.PerBone));
+			TestTrue(FString::Printf(TEXT("%d bones two poses per bone blend matches"), NumBones), PosesMatch(ScalarResults.TwoPosesPerBone, ISPCResults.TwoPosesPerBone));
+			TestTrue(FString::Printf(TEXT("%d bones additive matches"), NumBones), PosesMatch(ScalarResults.Additive, ISPCResults.Additive));
+
+			AddInfo(FString::Printf(TEXT("%d bones, ISPC: weighted %s, per bone %s, two poses per bone %s, additive %s"), NumBones,
+				*AutomationBenchmark::FormatMicroseconds(ISPCResults.WeightedSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ISPCResults.PerBoneSeconds, NumIterations),
+				*AutomationBenchmark::FormatMicroseconds(ISPCResults.TwoPosesPerBoneSeconds, NumIterations), *AutomationBenchmark::FormatMicroseconds(ISPCResults.AdditiveSeconds, NumIterations)));
+		}
+	}
+
+	if (ISPCCVar)
+	{
+		ISPCCVar->Set(PreviousCVarValue, ECVF_SetByCode);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
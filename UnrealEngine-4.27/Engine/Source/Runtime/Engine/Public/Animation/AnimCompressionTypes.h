@@ -466,6 +466,14 @@ struct ENGINE_API FUECompressedAnimData : public ICompressedAnimData, public FCo
 
 	void InitViewsFromBuffer(const TArrayView<uint8> BulkData);
 
+	/**
+	 * Unique to this data for as long as it is bound to the same buffer. Decompression caches key on it rather than on the address, which
+	 * recompressed or reloaded data can end up reusing.
+	 */
+	uint32 DecompressionCacheId = MakeDecompressionCacheId();
+
+	static uint32 MakeDecompressionCacheId();
+
 	template<typename TArchive>
 	void ByteSwapData(TArrayView<uint8> CompresedData, TArchive& MemoryStream);
 
@@ -788,6 +796,36 @@ struct FRootMotionReset
 	}
 };
 
+/** One pose to decompress as part of a DecompressPoses batch, holding what DecompressPose takes */
+struct FAnimPoseDecompressionRequest
+{
+	FAnimPoseDecompressionRequest(FCompactPose& InOutPose, const FCompressedAnimSequence& InCompressedData, const FAnimExtractContext& InExtractionContext, USkeleton* InSkeleton, float InSequenceLength,
+		EAnimInterpolationType InInterpolation, bool bInIsBakedAdditive, const TArray<FTransform>& InRetargetTransforms, FName InSourceName, const FRootMotionReset& InRootMotionReset)
+		: OutPose(&InOutPose)
+		, CompressedData(&InCompressedData)
+		, ExtractionContext(&InExtractionContext)
+		, Skeleton(InSkeleton)
+		, SequenceLength(InSequenceLength)
+		, Interpolation(InInterpolation)
+		, bIsBakedAdditive(bInIsBakedAdditive)
+		, RetargetTransforms(&InRetargetTransforms)
+		, SourceName(InSourceName)
+		, RootMotionReset(InRootMotionReset)
+	{
+	}
+
+	FCompactPose* OutPose;
+	const FCompressedAnimSequence* CompressedData;
+	const FAnimExtractContext* ExtractionContext;
+	USkeleton* Skeleton;
+	float SequenceLength;
+	EAnimInterpolationType Interpolation;
+	bool bIsBakedAdditive;
+	const TArray<FTransform>* RetargetTransforms;
+	FName SourceName;
+	FRootMotionReset RootMotionReset;
+};
+
 extern void DecompressPose(FCompactPose& OutPose,
 							const FCompressedAnimSequence& CompressedData,
 							const FAnimExtractContext& ExtractionContext,
@@ -808,4 +846,12 @@ extern void DecompressPose(	FCompactPose& OutPose,
 							bool bIsBakedAdditive,
 							FName RetargetSource,
 							FName SourceName,
-							const FRootMotionReset& RootMotionReset);
\ No newline at end of file
+							const FRootMotionReset& RootMotionReset);
+
+extern void DecompressPose(const FAnimPoseDecompressionRequest& Request);
+
+/**
+ * Decompresses several poses, possibly of different sequences, times and bone containers. Requests on the same sequence are decompressed
+ * back to back in time order, so the keys they share are decoded once, and each request's data is prefetched while the previous one decodes.
+ */
+extern void DecompressPoses(TArrayView<const FAnimPoseDecompressionRequest> Requests);
\ No newline at end of file
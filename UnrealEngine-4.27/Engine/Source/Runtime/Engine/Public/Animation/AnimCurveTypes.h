@@ -247,6 +247,28 @@ struct FTransformCurve: public FAnimCurveBase
 
 
 
+/**
+ * Blends behind FBaseBlendedCurve. Each one runs over all Num weights a vector of curves at a time and selects by the valid bits, packed
+ * 32 to a word as in TBitArray, rather than visiting the valid curves one by one.
+ */
+struct ENGINE_API FBlendedCurveKernels
+{
+	/** OutWeights = Lerp(A, B, Alpha) where either is valid and 0 elsewhere, OutValid = ValidA | ValidB */
+	static void Lerp(float* OutWeights, uint32* OutValid, const float* WeightsA, const uint32* ValidA, const float* WeightsB, const uint32* ValidB, float Alpha, int32 Num);
+
+	/** Weights = Lerp(Weights, Other, Alpha) where either is valid, Valid |= OtherValid */
+	static void LerpTo(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, float Alpha, int32 Num);
+
+	/** Weights += Other * Scale where either is valid, Valid |= OtherValid */
+	static void Accumulate(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, float Scale, int32 Num);
+
+	/** Weights = Other where Other is valid, Valid |= OtherValid */
+	static void Combine(float* Weights, uint32* Valid, const float* OtherWeights, const uint32* OtherValid, int32 Num);
+
+	/** Weights *= Scale where valid */
+	static void Scale(float* Weights, const uint32* Valid, float Scale, int32 Num);
+};
+
 /**
  * This struct is used to create curve snap shot of current time when extracted
  */
@@ -425,12 +447,7 @@ struct FBaseBlendedCurve
 			InitFrom(A);
 
 			// Only consider curve elements where either or both elements are valid.
-			for (TConstDualEitherSetBitIterator<InAllocator, InAllocator> It(A.ValidCurveWeights, B.ValidCurveWeights); It; ++It)
-			{
-				int32 Idx = It.GetIndex();
-				ValidCurveWeights[Idx] = true;
-				CurveWeights[Idx] = FMath::Lerp(A.CurveWeights[Idx], B.CurveWeights[Idx], Alpha);
-			}
+			FBlendedCurveKernels::Lerp(CurveWeights.GetData(), ValidCurveWeights.GetData(), A.CurveWeights.GetData(), A.ValidCurveWeights.GetData(), B.CurveWeights.GetData(), B.ValidCurveWeights.GetData(), Alpha, Num());
 		}
 	}
 
@@ -452,12 +469,7 @@ struct FBaseBlendedCurve
 		else
 		{
 			// Only consider curve elements where either or both elements are valid.
-			for (TConstDualEitherSetBitIterator<InAllocator, InAllocator> It(ValidCurveWeights, Other.ValidCurveWeights); It; ++It)
-			{
-				int32 Idx = It.GetIndex();
-				ValidCurveWeights[Idx] = true;
-				CurveWeights[Idx] = FMath::Lerp(CurveWeights[Idx], Other.CurveWeights[Idx], Alpha);
-			}
+			FBlendedCurveKernels::LerpTo(CurveWeights.GetData(), ValidCurveWeights.GetData(), Other.CurveWeights.GetData(), Other.ValidCurveWeights.GetData(), Alpha, Num());
 		}
 	}
 	/**
@@ -468,12 +480,7 @@ struct FBaseBlendedCurve
 		check(bInitialized);
 		check(Num() == BaseCurve.Num());
 
-		for (TConstDualEitherSetBitIterator<InAllocator, InAllocator> It(ValidCurveWeights, BaseCurve.ValidCurveWeights); It; ++It)
-		{
-			int32 Idx = It.GetIndex();
-			ValidCurveWeights[Idx] = true;
-			CurveWeights[Idx] -= BaseCurve.CurveWeights[Idx];
-		}
+		FBlendedCurveKernels::Accumulate(CurveWeights.GetData(), ValidCurveWeights.GetData(), BaseCurve.CurveWeights.GetData(), BaseCurve.ValidCurveWeights.GetData(), -1.f, Num());
 	}
 	/**
 	 * Accumulate the input curve with input Weight
@@ -485,12 +492,7 @@ struct FBaseBlendedCurve
 
 		if (FAnimWeight::IsRelevant(Weight))
 		{
-			for (TConstDualEitherSetBitIterator<InAllocator, InAllocator> It(ValidCurveWeights, AdditiveCurve.ValidCurveWeights); It; ++It)
-			{
-				int32 Idx = It.GetIndex();
-				ValidCurveWeights[Idx] = true;
-				CurveWeights[Idx] += AdditiveCurve.CurveWeights[Idx] * Weight;
-			}
+			FBlendedCurveKernels::Accumulate(CurveWeights.GetData(), ValidCurveWeights.GetData(), AdditiveCurve.CurveWeights.GetData(), AdditiveCurve.ValidCurveWeights.GetData(), Weight, Num());
 		}
 	}
 
@@ -566,12 +568,7 @@ struct FBaseBlendedCurve
 		check(bInitialized);
 		check(Num() == CurveToCombine.Num());
 
-		for (TConstSetBitIterator<InAllocator> It(CurveToCombine.ValidCurveWeights); It; ++It)
-		{
-			int32 Idx = It.GetIndex();
-			CurveWeights[Idx] = CurveToCombine.CurveWeights[Idx];
-			ValidCurveWeights[Idx] = true;
-		}
+		FBlendedCurveKernels::Combine(CurveWeights.GetData(), ValidCurveWeights.GetData(), CurveToCombine.CurveWeights.GetData(), CurveToCombine.ValidCurveWeights.GetData(), Num());
 	}
 
 	/**
@@ -586,10 +583,7 @@ struct FBaseBlendedCurve
 
 		if (!FMath::IsNearlyEqual(Weight, 1.f))
 		{
-			for (TConstSetBitIterator<InAllocator> It(ValidCurveWeights); It; ++It)
-			{
-				CurveWeights[It.GetIndex()] *= Weight;
-			}
+			FBlendedCurveKernels::Scale(CurveWeights.GetData(), ValidCurveWeights.GetData(), Weight, Num());
 		}
 	}
 
@@ -62,6 +62,25 @@ struct FAnimNotifyArray
 	TArray<FAnimNotifyEventReference> Notifies;
 };
 
+/**
+ * Borrows an empty array to harvest notifies into while ticking an asset player, instead of allocating one per tick. Arrays come from
+ * a pool kept per thread, as players tick on the animation worker threads, and keep their capacity when returned. Scopes can nest,
+ * as composites and montages harvest from their segments while their own array is borrowed.
+ */
+struct ENGINE_API FScopedAnimNotifyScratch
+{
+	FScopedAnimNotifyScratch();
+	~FScopedAnimNotifyScratch();
+
+	TArray<FAnimNotifyEventReference>& Get() const { return Notifies; }
+
+private:
+	FScopedAnimNotifyScratch(const FScopedAnimNotifyScratch&) = delete;
+	FScopedAnimNotifyScratch& operator=(const FScopedAnimNotifyScratch&) = delete;
+
+	TArray<FAnimNotifyEventReference>& Notifies;
+};
+
 USTRUCT()
 struct FAnimNotifyQueue
 {
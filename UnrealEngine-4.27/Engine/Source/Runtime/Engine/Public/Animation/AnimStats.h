@@ -18,6 +18,11 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("StateMachine Find Transition"), STAT_AnimStateMa
 DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshBoneTransforms"), STAT_RefreshBoneTransforms, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Post Anim Evaluation"), STAT_PostAnimEvaluation, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Trigger Notifies"), STAT_AnimTriggerAnimNotifies, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Notifies Triggered"), STAT_AnimNotifiesTriggered, STATGROUP_Anim, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Notify Spawn Batch Flush"), STAT_AnimNotifyBatchFlush, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Notify Batched Sounds"), STAT_AnimNotifyBatchSounds, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Notify Batched Particle Systems"), STAT_AnimNotifyBatchParticleSystems, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Notify Batched Spawns Dropped"), STAT_AnimNotifyBatchDropped, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Anim Decompression"), STAT_GetAnimationPose, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("InterpolateSkippedFrames"), STAT_InterpolateSkippedFrames, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateKinematicBonesToAnim"), STAT_UpdateRBBones, STATGROUP_Anim, );
@@ -43,6 +48,20 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateCurvesToEvaluationContext"), STAT_UpdateCu
 DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateCurvesPostEvaluation"), STAT_UpdateCurvesPostEvaluation, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("TickAssetPlayerInstances"), STAT_TickAssetPlayerInstances, STATGROUP_Anim, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("TickAssetPlayerInstance"), STAT_TickAssetPlayerInstance, STATGROUP_Anim, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Shared Pose Copy"), STAT_SharedPoseEvaluationCopy, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shared Pose Hits"), STAT_SharedPoseEvaluationHits, STATGROUP_Anim, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shared Pose Misses"), STAT_SharedPoseEvaluationMisses, STATGROUP_Anim, );
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Shared Pose Saved Time (ms)"), STAT_SharedPoseEvaluationSavedTime, STATGROUP_Anim, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Baked Vertex Animation Update"), STAT_BakedVertexAnimationUpdate, STATGROUP_Anim, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Baked Vertex Animation Instances"), STAT_NumBakedVertexAnimationInstances, STATGROUP_Anim, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Animation Budget Update"), STAT_AnimationBudgetUpdate, STATGROUP_Anim, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget (ms)"), STAT_AnimationBudget, STATGROUP_Anim, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Used (ms)"), STAT_AnimationBudgetUsed, STATGROUP_Anim, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Components"), STAT_AnimationBudgetNumComponents, STATGROUP_Anim, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Throttled Components"), STAT_AnimationBudgetNumThrottled, STATGROUP_Anim, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Interpolated Components"), STAT_AnimationBudgetNumInterpolated, STATGROUP_Anim, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Average Added Latency (ms)"), STAT_AnimationBudgetAverageLatency, STATGROUP_Anim, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Animation Budget Max Added Latency (ms)"), STAT_AnimationBudgetMaxLatency, STATGROUP_Anim, );
 
 #define DO_ANIMSTAT_PROCESSING(StatName) DECLARE_CYCLE_STAT_EXTERN(TEXT(#StatName), STAT_ ## StatName, STATGROUP_Anim, ENGINE_API)
 #include "Animation/AnimMTStats.h"
@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/UniquePtr.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Animation/CustomAttributesRuntime.h"
+
+class UAnimInstance;
+class UAnimSequenceBase;
+class USkeletalMesh;
+
+/** What a shared pose evaluation of the current frame is keyed on */
+struct FSharedPoseEvaluationKey
+{
+	const UAnimSequenceBase* Sequence = nullptr;
+	const USkeletalMesh* SkeletalMesh = nullptr;
+
+	/** LOD and bone count of the required bones the pose was evaluated with */
+	int32 LODIndex = INDEX_NONE;
+	int32 NumRequiredBones = 0;
+
+	/** Playback time divided by a.SharedPoseEvaluation.TimeStep, rounded down */
+	int32 TimeStepIndex = 0;
+
+	uint8 RootMotionMode = 0;
+
+	/** Time in the middle of the step the shared pose is evaluated at, whichever component claims it. Not compared or hashed. */
+	float EvaluationTime = 0.0f;
+
+	bool operator==(const FSharedPoseEvaluationKey& Other) const
+	{
+		return Sequence == Other.Sequence && SkeletalMesh == Other.SkeletalMesh && LODIndex == Other.LODIndex && NumRequiredBones == Other.NumRequiredBones
+			&& TimeStepIndex == Other.TimeStepIndex && RootMotionMode == Other.RootMotionMode;
+	}
+
+	friend uint32 GetTypeHash(const FSharedPoseEvaluationKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.Sequence), GetTypeHash(Key.SkeletalMesh));
+		Hash = HashCombine(Hash, GetTypeHash(Key.LODIndex | (Key.NumRequiredBones << 8)));
+		return HashCombine(Hash, GetTypeHash(Key.TimeStepIndex | (int32(Key.RootMotionMode) << 24)));
+	}
+};
+
+/**
+ * Evaluation results of USkeletalMeshComponent::PerformAnimationProcessing shared between components of the same frame, used by a.SharedPoseEvaluation.
+ *
+ * Components playing a sequence through a UAnimSingleNodeInstance on the same mesh and LOD, at a time within the same step, end up with the
+ * same pose, evaluated at the middle of the step. The first one to ask for it this frame evaluates it and stores the component and bone space transforms, and the others copy them.
+ * Components asking while it is being evaluated on another thread evaluate it themselves without storing it rather than wait.
+ */
+class ENGINE_API FSharedPoseEvaluationCache
+{
+public:
+	enum class EAcquireResult : uint8
+	{
+		/** The pose was copied to the outputs, nothing left to do */
+		Copied,
+		/** The caller evaluates the pose at the key's EvaluationTime and has to call Store or Abandon with the key */
+		Claimed,
+		/** The pose can't be shared right now, the caller evaluates it without storing it */
+		Evaluate,
+	};
+
+	static FSharedPoseEvaluationCache& Get();
+
+	static bool IsEnabled();
+
+	/**
+	 * Returns whether the pose of InAnimInstance can be shared with other components this frame, and the key to share it under.
+	 * Only single node instances playing a sequence, with nothing else contributing to the pose, are shared.
+	 */
+	static bool GetKey(const USkeletalMesh* InSkeletalMesh, const UAnimInstance* InAnimInstance, FSharedPoseEvaluationKey& OutKey);
+
+	/** Copies the pose stored for Key this frame to the outputs if there is one, or claims its evaluation for the caller */
+	EAcquireResult Acquire(const FSharedPoseEvaluationKey& Key, const UAnimInstance* InAnimInstance, TArray<FTransform>& OutSpaceBases, TArray<FTransform>& OutBoneSpaceTransforms, FVector& OutRootBoneTranslation, FBlendedHeapCurve& OutCurve, FHeapCustomAttributes& OutAttributes);
+
+	/** Stores the pose the caller evaluated after claiming Key, EvaluationCycles being how long that took */
+	void Store(const FSharedPoseEvaluationKey& Key, const TArray<FTransform>& SpaceBases, const TArray<FTransform>& BoneSpaceTransforms, const FVector& RootBoneTranslation, const FBlendedHeapCurve& Curve, const FHeapCustomAttributes& Attributes, const uint32 EvaluationCycles);
+
+	/** Releases a claim without storing anything, the next component asking evaluates the pose instead */
+	void Abandon(const FSharedPoseEvaluationKey& Key);
+
+	/** Frees every stored pose */
+	void Reset();
+
+private:
+	struct FEntry
+	{
+		/** GFrameCounter the pose was evaluated on, poses of other frames are never copied */
+		uint64 Frame = 0;
+
+		/** Whether the pose is stored, or still being evaluated by the component that claimed it */
+		FThreadSafeBool bReady;
+
+		TArray<FTransform> SpaceBases;
+		TArray<FTransform> BoneSpaceTransforms;
+		FVector RootBoneTranslation = FVector::ZeroVector;
+		FBlendedHeapCurve Curve;
+		FHeapCustomAttributes Attributes;
+
+		uint32 EvaluationCycles = 0;
+	};
+
+	/** Frees entries that haven't been used for a few frames, called with the lock held for writing */
+	void EvictStaleEntries(const uint64 Frame);
+
+	TMap<FSharedPoseEvaluationKey, TUniquePtr<FEntry>> Entries;
+
+	/** Last frame EvictStaleEntries ran on */
+	uint64 LastEvictionFrame = 0;
+
+	FRWLock Lock;
+};
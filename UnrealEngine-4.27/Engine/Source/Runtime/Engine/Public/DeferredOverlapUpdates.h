@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// World-level batching of UPrimitiveComponent::UpdateOverlaps queries.
+// Components with bDeferOverlapUpdates set are collected during the frame instead of running
+// their own ComponentOverlapMulti query on every move. At the end of the frame all gathered
+// queries run as one parallel batch against the physics scene, and begin/end overlap events
+// are dispatched afterwards on the game thread in a deterministic order.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "CollisionQueryParams.h"
+
+class UPrimitiveComponent;
+class UWorld;
+struct FOverlapResult;
+
+struct ENGINE_API FDeferredOverlapUpdates
+{
+	FDeferredOverlapUpdates();
+	~FDeferredOverlapUpdates();
+
+	/** Whether deferred overlap updates are enabled (p.DeferredOverlapUpdates). */
+	static bool IsEnabled();
+
+	/**
+	 * Queue an overlap update for the given component, to be performed by the next Flush().
+	 * @return false if the component can not be deferred right now and should update immediately.
+	 */
+	bool Enqueue(UPrimitiveComponent* Component, bool bDoNotifies);
+
+	/** Run all queued overlap queries in parallel, then dispatch the resulting overlap events. */
+	void Flush(UWorld* World);
+
+	/** Drop all queued updates without running them. */
+	void Reset();
+
+	/**
+	 * Overlaps gathered by the current Flush() for the component being dispatched, or null if the
+	 * component should run its own query (not batched, or it moved after the batch ran).
+	 * The result can only be consumed once, so nested updates triggered by overlap events query again.
+	 */
+	const TArray<FOverlapResult>* ConsumeBatchedOverlaps(const UPrimitiveComponent* Component);
+
+	/** Number of updates waiting for the next Flush(). */
+	int32 Num() const { return PendingUpdates.Num(); }
+
+	/** True while Flush() is dispatching events. Updates requested during that time run immediately. */
+	bool IsFlushing() const { return bIsFlushing; }
+
+private:
+	struct FPendingUpdate
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		bool bDoNotifies;
+	};
+
+	struct FBatchedQuery
+	{
+		FBatchedQuery(UPrimitiveComponent* InComponent, const FVector& InLocation, const FQuat& InRotation, ECollisionChannel InChannel, const FComponentQueryParams& InParams, bool bInDoNotifies)
+			: Component(InComponent)
+			, Location(InLocation)
+			, Rotation(InRotation)
+			, Channel(InChannel)
+			, Params(InParams)
+			, bDoNotifies(bInDoNotifies)
+		{
+		}
+
+		UPrimitiveComponent* Component;
+		FVector Location;
+		FQuat Rotation;
+		ECollisionChannel Channel;
+		FComponentQueryParams Params;
+		bool bDoNotifies;
+	};
+
+	/** Updates requested this frame, in request order. */
+	TArray<FPendingUpdate> PendingUpdates;
+
+	/** Index in PendingUpdates of each component already queued, to avoid querying the same component twice per frame. */
+	TMap<const UPrimitiveComponent*, int32> PendingComponents;
+
+	/** Component whose batched result is currently being dispatched. */
+	const UPrimitiveComponent* DispatchingComponent;
+	const TArray<FOverlapResult>* DispatchingOverlaps;
+
+	bool bIsFlushing;
+};
@@ -213,6 +213,15 @@ DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Actors"),STAT_NumActors,STATGROU
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Network Actors"),STAT_NumNetActors,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Dormant Actors"),STAT_NumDormantActors,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Initially Dormant Actors"),STAT_NumInitiallyDormantActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Relevancy Grid Cell Actors"),STAT_NumRelevancyGridCellActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Relevancy Grid Cells"),STAT_NumRelevancyGridCells,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Relevancy Grid Always Relevant Actors"),STAT_NumRelevancyGridAlwaysRelevantActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Relevancy Grid Owner Relevant Actors"),STAT_NumRelevancyGridOwnerRelevantActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Relevancy Grid Culled Actors"),STAT_NumRelevancyGridCulledActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replication Policy Due Actors"),STAT_NumReplicationPolicyDueActors,STATGROUP_Net, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replication Policy Buckets"),STAT_NumReplicationPolicyBuckets,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replication Policy Cell Rebuilds"),STAT_NumReplicationPolicyCellRebuilds,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replication Policy Grid Changes"),STAT_NumReplicationPolicyGridChanges,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num ACKd NetGUIDs"),STAT_NumNetGUIDsAckd,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Pending NetGUIDs"),STAT_NumNetGUIDsPending,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num UnACKd NetGUIDs"),STAT_NumNetGUIDsUnAckd,STATGROUP_Net, );
@@ -225,6 +234,12 @@ DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pending Outer NetGuids"),STAT_Pendin
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Unmapped Replicators"),STAT_UnmappedReplicators,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Replicated Actors Sent"),STAT_NumReplicatedActors,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num Replicated Actor Bytes Sent"),STAT_NumReplicatedActorBytes,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("In Bunch Allocations"),STAT_InBunchAllocations,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("In Bunch Buffer Allocations"),STAT_InBunchBufferAllocations,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("In Bunch Pool Reuses"),STAT_InBunchPoolReuses,STATGROUP_Net, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("In Bunch Pool Memory"),STAT_InBunchPoolMemory,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Send Calls"),STAT_NetBatchedSendCalls,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Batched Send Packets"),STAT_NetBatchedSendPackets,STATGROUP_Net, );
 
 #if !UE_BUILD_SHIPPING
 /**
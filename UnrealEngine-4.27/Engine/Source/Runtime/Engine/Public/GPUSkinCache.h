@@ -16,7 +16,8 @@
 // * Saves vertex shader computations when we render an object multiple times (EarlyZ, velocity, shadow, BasePass, CustomDepth, Shadow masking)
 // * Fixes velocity rendering (needed for MotionBlur and TemporalAA) for WorldPosOffset animation and morph target animation
 // * RecomputeTangents results in improved tangent space for WorldPosOffset animation and morph target animation
-// * fixed amount of memory per Scene (r.SkinCache.SceneMemoryLimitInMB)
+// * fixed amount of memory per Scene (r.SkinCache.SceneMemoryLimitInMB), least recently used entries are evicted to make room (r.SkinCache.Eviction)
+// * Components with the same mesh and pose can draw one shared skinned output (r.SkinCache.ShareIdenticalPoses)
 // * Velocity Rendering for MotionBlur and TemporalAA (test Velocity in BasePass)
 // * r.SkinCache.Mode and r.SkinCache.RecomputeTangents can be toggled at runtime
 
@@ -48,6 +49,7 @@ class FMorphVertexBuffer;
 class FSkeletalMeshLODRenderData;
 class FSkeletalMeshObjectGPUSkin;
 class FSkeletalMeshVertexClothBuffer;
+class FSkinWeightVertexBuffer;
 class FVertexOffsetBuffers;
 struct FClothSimulData;
 struct FSkelMeshRenderSection;
@@ -202,6 +204,12 @@ public:
 
 	static bool IsEntryValid(FGPUSkinCacheEntry* SkinCacheEntry, int32 Section);
 
+	/** Keeps the entry, and the entry it shares the output of, from being evicted this frame as it is about to be drawn */
+	static void MarkEntryDrawn(FGPUSkinCacheEntry* SkinCacheEntry);
+
+	/** Whether mesh objects need to hash their poses for r.SkinCache.ShareIdenticalPoses */
+	static bool IsPoseSharingEnabled();
+
 	static bool UseIntermediateTangents();
 
 	inline uint64 GetExtraRequiredMemoryAndReset()
@@ -405,11 +413,38 @@ protected:
 	uint64 RayTracingGeometryMemoryPendingRelease = 0;
 #endif // RHI_RAYTRACING
 
+	/** Identifies the skinned output of a section, entries with the same key this frame can draw a single output */
+	struct FSharedSectionKey
+	{
+		const FSkeletalMeshLODRenderData* LODData = nullptr;
+		const FSkinWeightVertexBuffer* WeightBuffer = nullptr;
+		uint64 PoseHash = 0;
+		uint64 PreviousPoseHash = 0;
+		int32 Section = INDEX_NONE;
+
+		friend bool operator==(const FSharedSectionKey& A, const FSharedSectionKey& B)
+		{
+			return A.LODData == B.LODData && A.WeightBuffer == B.WeightBuffer && A.PoseHash == B.PoseHash && A.PreviousPoseHash == B.PreviousPoseHash && A.Section == B.Section;
+		}
+
+		friend uint32 GetTypeHash(const FSharedSectionKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.LODData), GetTypeHash(Key.WeightBuffer)), HashCombine(GetTypeHash(Key.PoseHash ^ Key.PreviousPoseHash), GetTypeHash(Key.Section)));
+		}
+	};
+
 	TArray<FRWBuffersAllocation*> Allocations;
 	TArray<FGPUSkinCacheEntry*> Entries;
 	TArray<FDispatchEntry> BatchDispatches;
 
+	/** Sections skinned this frame into their own allocation, that entries with the same key can share */
+	TMap<FSharedSectionKey, FGPUSkinCacheEntry*> SharedSections;
+	uint32 SharedSectionsFrameNumber = 0;
+
 	FRWBuffersAllocation* TryAllocBuffer(uint32 NumVertices, bool WithTangnents);
+
+	/** Evicts the least recently used entries not drawn or skinned this frame until BytesToFree are released, returns false without evicting anything if they can't */
+	bool EvictEntries(uint64 BytesToFree);
 	void DoDispatch(FRHICommandListImmediate& RHICmdList);
 	void DoDispatch(FRHICommandListImmediate& RHICmdList, FGPUSkinCacheEntry* SkinCacheEntry, int32 Section, int32 RevisionNumber);
 	void DispatchUpdateSkinTangents(FRHICommandListImmediate& RHICmdList, FGPUSkinCacheEntry* Entry, int32 SectionIndex);
@@ -430,6 +465,9 @@ protected:
 
 	void Cleanup();
 	static void ReleaseSkinCacheEntry(FGPUSkinCacheEntry* SkinCacheEntry);
+	static void ReleaseAllocation(FGPUSkinCacheEntry* SkinCacheEntry);
+	/** Drops the entries sharing SkinCacheEntry's output back to vertex shader skinning until they are re-created */
+	static void InvalidateSharingEntries(FGPUSkinCacheEntry* SkinCacheEntry);
 	static FGPUSkinBatchElementUserData* InternalGetFactoryUserData(FGPUSkinCacheEntry* Entry, int32 Section);
 	void InvalidateAllEntries();
 	uint64 UsedMemoryInBytes;
@@ -455,3 +493,6 @@ DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Triangles for Recompute Tangents"),
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Sections Processed"), STAT_GPUSkinCache_NumSectionsProcessed, STATGROUP_GPUSkinCache, );
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num SetVertexStreams"), STAT_GPUSkinCache_NumSetVertexStreams, STATGROUP_GPUSkinCache, );
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num PreGDME"), STAT_GPUSkinCache_NumPreGDME, STATGROUP_GPUSkinCache, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Entries Evicted"), STAT_GPUSkinCache_NumEvictions, STATGROUP_GPUSkinCache, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Entries Rebuilt"), STAT_GPUSkinCache_NumRebuilds, STATGROUP_GPUSkinCache, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Sections Shared"), STAT_GPUSkinCache_NumSectionsShared, STATGROUP_GPUSkinCache, );
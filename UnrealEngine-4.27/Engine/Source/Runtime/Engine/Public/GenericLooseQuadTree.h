@@ -0,0 +1,507 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/Sort.h"
+#include "GenericQuadTree.h"
+
+/**
+ * Loose variant of TQuadTree for large numbers of small 2D elements.
+ *
+ * Every node's bounds are twice the size of its cell, so an element is stored in the deepest node whose cell
+ * contains its center and that is at least as large as the element, rather than staying in whichever internal
+ * node it happens to straddle. All nodes live in one contiguous array. Elements live in a pool of blocks of four
+ * shared by every node, each block keeping the bounds of its elements as one packet (SoA) so that queries can test
+ * four elements at a time with SIMD compares. ElementType must be default constructible.
+ */
+template <typename ElementType, int32 NodeCapacity = 16>
+class TLooseQuadTree
+{
+	typedef TLooseQuadTree<ElementType, NodeCapacity> TreeType;
+public:
+
+	TLooseQuadTree(const FBox2D& InBox, float InMinimumQuadSize = 100.f);
+
+	/** Gets the TreeBox so systems can test insertions before trying to do so with invalid regions */
+	const FBox2D& GetTreeBox() const { return TreeBox; }
+
+	/** Inserts an object of type ElementType with an associated 2D box of size Box (log n). Pass in a DebugContext so when an issue occurs the log can report what requested this insert. */
+	void Insert(const ElementType& Element, const FBox2D& Box, const TCHAR* DebugContext = nullptr);
+
+	/**
+	 * Inserts many elements at once. Elements are sorted by the Morton code of their center so they are added in spatial order,
+	 * and an empty tree is built top-down instead of splitting leaves one insert at a time.
+	 */
+	void BulkInsert(TArrayView<const ElementType> Elements, TArrayView<const FBox2D> Boxes);
+
+	/** Given a 2D box, returns an array of elements within the box. There will not be any duplicates in the list. */
+	template<typename ElementAllocatorType>
+	void GetElements(const FBox2D& Box, TArray<ElementType, ElementAllocatorType>& ElementsOut) const;
+
+	/** Removes an object of type ElementType with an associated 2D box of size Box (log n). Does not cleanup tree*/
+	bool Remove(const ElementType& Element, const FBox2D& Box);
+
+	/** Removes all elements of the tree, keeping the node and element storage allocated for reuse */
+	void Empty();
+
+	/** Number of elements in the tree */
+	int32 Num() const { return NumElements; }
+
+private:
+	enum QuadNames
+	{
+		BottomLeft = 0,
+		BottomRight = 1,
+		TopLeft = 2,
+		TopRight = 3
+	};
+
+	/** Bounds of four elements of a node, one component per array so they can be loaded straight into vector registers */
+	struct alignas(16) FBoundsPacket
+	{
+		float MinX[4];
+		float MinY[4];
+		float MaxX[4];
+		float MaxY[4];
+	};
+
+	/** Four elements of a node and their bounds, lane i of Bounds is the box of Elements[i] */
+	struct FElementBlock
+	{
+		FBoundsPacket Bounds;
+		ElementType Elements[4];
+
+		/** Next block of the same node, or of the free list */
+		int32 Next;
+	};
+
+	struct FTreeNode
+	{
+		/** Center and half size of the cell this node covers */
+		FVector2D Center;
+		FVector2D Extent;
+
+		/** Cell grown by Extent on every side. Any element stored in this node or below is inside these bounds. */
+		FBox2D LooseBox;
+
+		/** Index of the first of the four children in TreeNodes, INDEX_NONE for leaves */
+		int32 FirstChild;
+
+		/** Most recently allocated block of this node's elements in ElementBlocks, only that one can be partially filled */
+		int32 FirstBlock;
+
+		/** Number of elements stored in this node */
+		int32 NumElements;
+
+		FTreeNode(const FVector2D& InCenter, const FVector2D& InExtent)
+			: Center(InCenter)
+			, Extent(InExtent)
+			, LooseBox(InCenter - InExtent * 2.f, InCenter + InExtent * 2.f)
+			, FirstChild(INDEX_NONE)
+			, FirstBlock(INDEX_NONE)
+			, NumElements(0)
+		{}
+
+		/** Number of elements used in BlockIndex, given it is one of this node's blocks */
+		int32 GetNumLanes(int32 BlockIndex) const
+		{
+			return BlockIndex == FirstBlock ? ((NumElements - 1) & 3) + 1 : 4;
+		}
+	};
+
+	/** Returns the child of NodeIndex whose loose bounds fully contain Box, or INDEX_NONE if the box has to stay in this node */
+	int32 GetChildForBox(int32 NodeIndex, const FBox2D& Box) const;
+
+	/** Whether NodeIndex is still larger than the minimum quad size */
+	bool CanSplit(int32 NodeIndex) const;
+
+	/** Give a leaf four children and move down the elements that fit in them */
+	void Split(int32 NodeIndex);
+
+	void AddElementToNode(int32 NodeIndex, const ElementType& Element, const FBox2D& Box);
+	void RemoveElementFromNode(int32 NodeIndex, int32 BlockIndex, int32 Lane);
+	FBox2D GetElementBox(int32 BlockIndex, int32 Lane) const;
+
+	/** Takes a block from the free list, or grows the pool. This can grow ElementBlocks, so don't hold on to block references across it. */
+	int32 AllocateBlock();
+
+	/** Top-down build of NodeIndex from a range of Order, which indexes into Elements/Boxes */
+	void BuildRecursive(int32 NodeIndex, TArrayView<const ElementType> Elements, TArrayView<const FBox2D> Boxes, int32* Order, int32 NumOrder, TArray<int32>& Scratch);
+
+private:
+
+	/** All nodes of the tree, the root is always at index 0 and the four children of a node are contiguous */
+	TArray<FTreeNode> TreeNodes;
+
+	/** Element storage of every node, blocks freed by removes are linked from FirstFreeBlock and reused first */
+	TArray<FElementBlock, TAlignedHeapAllocator<16>> ElementBlocks;
+	int32 FirstFreeBlock;
+
+	/** AABB of the tree */
+	FBox2D TreeBox;
+
+	/** The smallest size of a quad allowed in the tree */
+	float MinimumQuadSize;
+
+	int32 NumElements;
+};
+
+template <typename ElementType, int32 NodeCapacity>
+TLooseQuadTree<ElementType, NodeCapacity>::TLooseQuadTree(const FBox2D& InBox, float InMinimumQuadSize)
+	: TreeBox(InBox)
+	, MinimumQuadSize(InMinimumQuadSize)
+	, FirstFreeBlock(INDEX_NONE)
+	, NumElements(0)
+{
+	TreeNodes.Emplace(TreeBox.GetCenter(), TreeBox.GetExtent());
+}
+
+template <typename ElementType, int32 NodeCapacity>
+int32 TLooseQuadTree<ElementType, NodeCapacity>::GetChildForBox(int32 NodeIndex, const FBox2D& Box) const
+{
+	const FTreeNode& Node = TreeNodes[NodeIndex];
+	if (Node.FirstChild == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector2D BoxCenter = Box.GetCenter();
+	const int32 Quad = (BoxCenter.X >= Node.Center.X ? 1 : 0) | (BoxCenter.Y >= Node.Center.Y ? 2 : 0);
+	const int32 ChildIndex = Node.FirstChild + Quad;
+	return TreeNodes[ChildIndex].LooseBox.IsInside(Box) ? ChildIndex : INDEX_NONE;
+}
+
+template <typename ElementType, int32 NodeCapacity>
+bool TLooseQuadTree<ElementType, NodeCapacity>::CanSplit(int32 NodeIndex) const
+{
+	// Same rule as TQuadTree, stop splitting once the cell reaches the minimum size
+	return (TreeNodes[NodeIndex].Extent * 2.f).SizeSquared() > FMath::Square(MinimumQuadSize);
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::Split(int32 NodeIndex)
+{
+	check(TreeNodes[NodeIndex].FirstChild == INDEX_NONE);
+
+	const FVector2D Center = TreeNodes[NodeIndex].Center;
+	const FVector2D ChildExtent = TreeNodes[NodeIndex].Extent * 0.5f;
+
+	// Children are added in QuadNames order. This can grow TreeNodes, so don't hold on to node references across it.
+	const int32 FirstChild = TreeNodes.Num();
+	TreeNodes.Emplace(Center + FVector2D(-ChildExtent.X, -ChildExtent.Y), ChildExtent);
+	TreeNodes.Emplace(Center + FVector2D( ChildExtent.X, -ChildExtent.Y), ChildExtent);
+	TreeNodes.Emplace(Center + FVector2D(-ChildExtent.X,  ChildExtent.Y), ChildExtent);
+	TreeNodes.Emplace(Center + FVector2D( ChildExtent.X,  ChildExtent.Y), ChildExtent);
+	TreeNodes[NodeIndex].FirstChild = FirstChild;
+
+	// Move down everything that fits in a child, elements larger than a child cell stay here. Removing moves this node's
+	// last element into the freed lane. Walking from the last element backwards, that element has always been visited and stays.
+	int32 NextBlock = INDEX_NONE;
+	for (int32 BlockIndex = TreeNodes[NodeIndex].FirstBlock; BlockIndex != INDEX_NONE; BlockIndex = NextBlock)
+	{
+		NextBlock = ElementBlocks[BlockIndex].Next;
+		for (int32 Lane = TreeNodes[NodeIndex].GetNumLanes(BlockIndex) - 1; Lane >= 0; --Lane)
+		{
+			const FBox2D Box = GetElementBox(BlockIndex, Lane);
+			const int32 ChildIndex = GetChildForBox(NodeIndex, Box);
+			if (ChildIndex != INDEX_NONE)
+			{
+				const ElementType Element = ElementBlocks[BlockIndex].Elements[Lane];
+				RemoveElementFromNode(NodeIndex, BlockIndex, Lane);
+				AddElementToNode(ChildIndex, Element, Box);
+			}
+		}
+	}
+}
+
+template <typename ElementType, int32 NodeCapacity>
+int32 TLooseQuadTree<ElementType, NodeCapacity>::AllocateBlock()
+{
+	if (FirstFreeBlock != INDEX_NONE)
+	{
+		const int32 BlockIndex = FirstFreeBlock;
+		FirstFreeBlock = ElementBlocks[BlockIndex].Next;
+		return BlockIndex;
+	}
+
+	return ElementBlocks.AddDefaulted();
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::AddElementToNode(int32 NodeIndex, const ElementType& Element, const FBox2D& Box)
+{
+	const int32 Lane = TreeNodes[NodeIndex].NumElements & 3;
+	if (Lane == 0)
+	{
+		const int32 NewBlock = AllocateBlock();
+		ElementBlocks[NewBlock].Next = TreeNodes[NodeIndex].FirstBlock;
+		TreeNodes[NodeIndex].FirstBlock = NewBlock;
+	}
+
+	FTreeNode& Node = TreeNodes[NodeIndex];
+	FElementBlock& Block = ElementBlocks[Node.FirstBlock];
+	Block.Elements[Lane] = Element;
+	Block.Bounds.MinX[Lane] = Box.Min.X;
+	Block.Bounds.MinY[Lane] = Box.Min.Y;
+	Block.Bounds.MaxX[Lane] = Box.Max.X;
+	Block.Bounds.MaxY[Lane] = Box.Max.Y;
+	++Node.NumElements;
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::RemoveElementFromNode(int32 NodeIndex, int32 BlockIndex, int32 Lane)
+{
+	FTreeNode& Node = TreeNodes[NodeIndex];
+	const int32 LastBlockIndex = Node.FirstBlock;
+	const int32 LastLane = (Node.NumElements - 1) & 3;
+	FElementBlock& LastBlock = ElementBlocks[LastBlockIndex];
+	if (BlockIndex != LastBlockIndex || Lane != LastLane)
+	{
+		FElementBlock& Block = ElementBlocks[BlockIndex];
+		Block.Elements[Lane] = MoveTemp(LastBlock.Elements[LastLane]);
+		Block.Bounds.MinX[Lane] = LastBlock.Bounds.MinX[LastLane];
+		Block.Bounds.MinY[Lane] = LastBlock.Bounds.MinY[LastLane];
+		Block.Bounds.MaxX[Lane] = LastBlock.Bounds.MaxX[LastLane];
+		Block.Bounds.MaxY[Lane] = LastBlock.Bounds.MaxY[LastLane];
+	}
+
+	// Don't keep whatever the element references alive in the pool
+	LastBlock.Elements[LastLane] = ElementType();
+	--Node.NumElements;
+
+	if (LastLane == 0)
+	{
+		Node.FirstBlock = LastBlock.Next;
+		LastBlock.Next = FirstFreeBlock;
+		FirstFreeBlock = LastBlockIndex;
+	}
+}
+
+template <typename ElementType, int32 NodeCapacity>
+FBox2D TLooseQuadTree<ElementType, NodeCapacity>::GetElementBox(int32 BlockIndex, int32 Lane) const
+{
+	const FBoundsPacket& Packet = ElementBlocks[BlockIndex].Bounds;
+	return FBox2D(FVector2D(Packet.MinX[Lane], Packet.MinY[Lane]), FVector2D(Packet.MaxX[Lane], Packet.MaxY[Lane]));
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::Insert(const ElementType& Element, const FBox2D& Box, const TCHAR* DebugContext)
+{
+	if (!Box.Intersect(TreeBox))
+	{
+		// Elements shouldn't be added outside the bounds of the top-level quad
+		UE_LOG(LogQuadTree, Warning, TEXT("[%s] Adding element (%s) that is outside the bounds of the quadtree root (%s). Consider resizing."), DebugContext ? DebugContext : TEXT("Unknown Source"), *Box.ToString(), *TreeBox.ToString());
+	}
+
+	int32 NodeIndex = 0;
+	for (;;)
+	{
+		const int32 ChildIndex = GetChildForBox(NodeIndex, Box);
+		if (ChildIndex != INDEX_NONE)
+		{
+			NodeIndex = ChildIndex;
+		}
+		else if (TreeNodes[NodeIndex].FirstChild == INDEX_NONE && TreeNodes[NodeIndex].NumElements >= NodeCapacity && CanSplit(NodeIndex))
+		{
+			// This leaf is at capacity, so split and try again
+			Split(NodeIndex);
+		}
+		else
+		{
+			AddElementToNode(NodeIndex, Element, Box);
+			break;
+		}
+	}
+
+	++NumElements;
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::BulkInsert(TArrayView<const ElementType> Elements, TArrayView<const FBox2D> Boxes)
+{
+	check(Elements.Num() == Boxes.Num());
+
+	// Quantize each center to 16 bits per axis over the tree box and sort by the interleaved code, keeping the element index in the low bits
+	const FVector2D QuantizeScale = FVector2D(65535.f, 65535.f) / TreeBox.GetSize().ComponentMax(FVector2D(KINDA_SMALL_NUMBER, KINDA_SMALL_NUMBER));
+	TArray<uint64> SortKeys;
+	SortKeys.SetNumUninitialized(Elements.Num());
+	for (int32 Idx = 0; Idx < Elements.Num(); ++Idx)
+	{
+		const FVector2D Quantized = (Boxes[Idx].GetCenter() - TreeBox.Min) * QuantizeScale;
+		const uint32 QuantizedX = (uint32)FMath::Clamp(FMath::FloorToInt(Quantized.X), 0, 65535);
+		const uint32 QuantizedY = (uint32)FMath::Clamp(FMath::FloorToInt(Quantized.Y), 0, 65535);
+		const uint32 MortonCode = FMath::MortonCode2(QuantizedX) | (FMath::MortonCode2(QuantizedY) << 1);
+		SortKeys[Idx] = ((uint64)MortonCode << 32) | (uint32)Idx;
+	}
+	Algo::Sort(SortKeys);
+
+	TArray<int32> Order;
+	Order.SetNumUninitialized(SortKeys.Num());
+	for (int32 Idx = 0; Idx < SortKeys.Num(); ++Idx)
+	{
+		Order[Idx] = (int32)(SortKeys[Idx] & 0xFFFFFFFF);
+	}
+
+	if (NumElements == 0 && TreeNodes.Num() == 1)
+	{
+		TArray<int32> Scratch;
+		Scratch.SetNumUninitialized(Order.Num());
+		BuildRecursive(0, Elements, Boxes, Order.GetData(), Order.Num(), Scratch);
+		NumElements = Order.Num();
+	}
+	else
+	{
+		// The tree already has a structure, so just insert in spatial order to keep consecutive inserts on the same path
+		for (int32 ElementIdx : Order)
+		{
+			Insert(Elements[ElementIdx], Boxes[ElementIdx]);
+		}
+	}
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::BuildRecursive(int32 NodeIndex, TArrayView<const ElementType> Elements, TArrayView<const FBox2D> Boxes, int32* Order, int32 NumOrder, TArray<int32>& Scratch)
+{
+	if (NumOrder <= NodeCapacity || !CanSplit(NodeIndex))
+	{
+		for (int32 Idx = 0; Idx < NumOrder; ++Idx)
+		{
+			AddElementToNode(NodeIndex, Elements[Order[Idx]], Boxes[Order[Idx]]);
+		}
+		return;
+	}
+
+	Split(NodeIndex);
+	const int32 FirstChild = TreeNodes[NodeIndex].FirstChild;
+
+	// Stable partition into the four children. The input is in Morton order, so each child's range stays in Morton order.
+	int32 ChildCounts[4] = { 0, 0, 0, 0 };
+	int32 NumRemaining = 0;
+	for (int32 Idx = 0; Idx < NumOrder; ++Idx)
+	{
+		const int32 ElementIdx = Order[Idx];
+		const int32 ChildIndex = GetChildForBox(NodeIndex, Boxes[ElementIdx]);
+		if (ChildIndex == INDEX_NONE)
+		{
+			AddElementToNode(NodeIndex, Elements[ElementIdx], Boxes[ElementIdx]);
+		}
+		else
+		{
+			Order[NumRemaining++] = ElementIdx;
+			++ChildCounts[ChildIndex - FirstChild];
+		}
+	}
+
+	int32 ChildStarts[4];
+	ChildStarts[0] = 0;
+	for (int32 Quad = 1; Quad < 4; ++Quad)
+	{
+		ChildStarts[Quad] = ChildStarts[Quad - 1] + ChildCounts[Quad - 1];
+	}
+
+	int32 ChildWrite[4] = { ChildStarts[0], ChildStarts[1], ChildStarts[2], ChildStarts[3] };
+	for (int32 Idx = 0; Idx < NumRemaining; ++Idx)
+	{
+		const int32 ElementIdx = Order[Idx];
+		Scratch[ChildWrite[GetChildForBox(NodeIndex, Boxes[ElementIdx]) - FirstChild]++] = ElementIdx;
+	}
+	FMemory::Memcpy(Order, Scratch.GetData(), NumRemaining * sizeof(int32));
+
+	for (int32 Quad = 0; Quad < 4; ++Quad)
+	{
+		if (ChildCounts[Quad] > 0)
+		{
+			BuildRecursive(FirstChild + Quad, Elements, Boxes, Order + ChildStarts[Quad], ChildCounts[Quad], Scratch);
+		}
+	}
+}
+
+template <typename ElementType, int32 NodeCapacity>
+bool TLooseQuadTree<ElementType, NodeCapacity>::Remove(const ElementType& Element, const FBox2D& Box)
+{
+	// Elements only ever move down to the child GetChildForBox picks, so the same walk as Insert finds them
+	for (int32 NodeIndex = 0; NodeIndex != INDEX_NONE; NodeIndex = GetChildForBox(NodeIndex, Box))
+	{
+		const FTreeNode& Node = TreeNodes[NodeIndex];
+		for (int32 BlockIndex = Node.FirstBlock; BlockIndex != INDEX_NONE; BlockIndex = ElementBlocks[BlockIndex].Next)
+		{
+			const FElementBlock& Block = ElementBlocks[BlockIndex];
+			for (int32 Lane = 0, NumLanes = Node.GetNumLanes(BlockIndex); Lane < NumLanes; ++Lane)
+			{
+				if (Block.Elements[Lane] == Element)
+				{
+					RemoveElementFromNode(NodeIndex, BlockIndex, Lane);
+					--NumElements;
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+template <typename ElementType, int32 NodeCapacity>
+template <typename ElementAllocatorType>
+void TLooseQuadTree<ElementType, NodeCapacity>::GetElements(const FBox2D& Box, TArray<ElementType, ElementAllocatorType>& ElementsOut) const
+{
+	const VectorRegister QueryMinX = VectorSetFloat1(Box.Min.X);
+	const VectorRegister QueryMinY = VectorSetFloat1(Box.Min.Y);
+	const VectorRegister QueryMaxX = VectorSetFloat1(Box.Max.X);
+	const VectorRegister QueryMaxY = VectorSetFloat1(Box.Max.Y);
+
+	TArray<int32, TInlineAllocator<64>> NodeStack;
+	NodeStack.Add(0);
+
+	while (NodeStack.Num() > 0)
+	{
+		const FTreeNode& Node = TreeNodes[NodeStack.Pop(false)];
+
+		// Same test as FBox2D::Intersect, four elements at a time
+		for (int32 BlockIndex = Node.FirstBlock; BlockIndex != INDEX_NONE; BlockIndex = ElementBlocks[BlockIndex].Next)
+		{
+			const FElementBlock& Block = ElementBlocks[BlockIndex];
+			const FBoundsPacket& Packet = Block.Bounds;
+			const VectorRegister OverlapX = VectorBitwiseAnd(VectorCompareGE(QueryMaxX, VectorLoadAligned(Packet.MinX)), VectorCompareGE(VectorLoadAligned(Packet.MaxX), QueryMinX));
+			const VectorRegister OverlapY = VectorBitwiseAnd(VectorCompareGE(QueryMaxY, VectorLoadAligned(Packet.MinY)), VectorCompareGE(VectorLoadAligned(Packet.MaxY), QueryMinY));
+			uint32 Mask = (uint32)VectorMaskBits(VectorBitwiseAnd(OverlapX, OverlapY));
+
+			// Lanes past the last element of a partial block hold stale data
+			const int32 NumLanes = Node.GetNumLanes(BlockIndex);
+			if (NumLanes < 4)
+			{
+				Mask &= (1u << NumLanes) - 1;
+			}
+
+			while (Mask)
+			{
+				const uint32 Lane = FMath::CountTrailingZeros(Mask);
+				ElementsOut.Add(Block.Elements[Lane]);
+				Mask &= Mask - 1;
+			}
+		}
+
+		if (Node.FirstChild != INDEX_NONE)
+		{
+			for (int32 Quad = 0; Quad < 4; ++Quad)
+			{
+				if (Box.Intersect(TreeNodes[Node.FirstChild + Quad].LooseBox))
+				{
+					NodeStack.Add(Node.FirstChild + Quad);
+				}
+			}
+		}
+	}
+}
+
+template <typename ElementType, int32 NodeCapacity>
+void TLooseQuadTree<ElementType, NodeCapacity>::Empty()
+{
+	// Reset rather than Empty so the node and block arrays keep their allocation for the next fill
+	TreeNodes.Reset();
+	TreeNodes.Emplace(TreeBox.GetCenter(), TreeBox.GetExtent());
+	ElementBlocks.Reset();
+	FirstFreeBlock = INDEX_NONE;
+	NumElements = 0;
+}
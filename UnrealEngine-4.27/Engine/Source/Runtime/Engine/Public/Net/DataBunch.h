@@ -160,7 +160,77 @@ public:
 	FInBunch( UNetConnection* InConnection, uint8* Src=NULL, int64 CountBits=0 );
 	FInBunch( FInBunch &InBunch, bool CopyBuffer );
 
+	/** Reinitializes this bunch as a copy of InBunch, reusing its existing buffer allocation. Used by FInBunchArena. */
+	void ResetFrom( FInBunch &InBunch, bool CopyBuffer );
+
+	/** Number of bytes allocated for the buffer, which can be more than GetNumBytes on a reused bunch */
+	int64 GetBufferCapacity() const
+	{
+		return Buffer.Max();
+	}
+
 	virtual void CountMemory(FArchive& Ar) const override;
+
+private:
+	void CopyHeaderFrom( const FInBunch &InBunch );
+};
+
+/**
+ * Per connection pool of FInBunch copies. Channels use it for the bunches that outlive the packet they arrived in:
+ * reliable bunches queued behind a lost sequence, partial bunches being merged and actor channel bunches waiting
+ * on unresolved guids. Released bunches keep their buffers and are binned by buffer capacity, so a connection
+ * under packet loss reuses the same handful of allocations instead of going back to the allocator for each bunch.
+ */
+class ENGINE_API FInBunchArena
+{
+public:
+	struct FStats
+	{
+		/** Bunches handed out by Acquire */
+		uint64 NumAcquired = 0;
+		/** Acquires that had to construct a new bunch */
+		uint64 NumBunchAllocations = 0;
+		/** Acquires, and appends to acquired partial bunches, that had to grow a buffer */
+		uint64 NumBufferAllocations = 0;
+		/** Bunches returned to the pool by Release */
+		uint64 NumPooled = 0;
+	};
+
+	FInBunchArena() = default;
+	~FInBunchArena();
+
+	FInBunchArena(const FInBunchArena&) = delete;
+	FInBunchArena& operator=(const FInBunchArena&) = delete;
+
+	/** Returns a bunch initialized like FInBunch(Source, bCopyBuffer), reusing a pooled bunch when one is large enough */
+	FInBunch* Acquire(FInBunch& Source, bool bCopyBuffer);
+
+	/** Returns a bunch from Acquire to the pool, or deletes it if the pool is full or disabled */
+	void Release(FInBunch* Bunch);
+
+	/** Call after appending to an acquired bunch, so buffer growth shows up in the allocation stats */
+	void NoteBufferGrowth(const FInBunch& Bunch, int64 PreviousCapacity);
+
+	/** Frees all pooled bunches */
+	void Empty();
+
+	int32 GetNumPooledBunches() const;
+
+	const FStats& GetStats() const
+	{
+		return Stats;
+	}
+
+	void CountMemory(FArchive& Ar) const;
+
+private:
+	static constexpr int32 NumSizeClasses = 4;
+
+	static int32 GetSizeClass(int64 NumBytes);
+
+	TArray<FInBunch*> FreeBunches[NumSizeClasses];
+	int64 PooledBytes = 0;
+	FStats Stats;
 };
 
 /** out bunch for the control channel (special restrictions) */
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "Net/Common/Packets/PacketTraits.h"
+
+/** An outgoing packet held by FNetPacketSendQueue, Data points into the queue's storage and is valid until the queue is flushed */
+struct FQueuedOutPacket
+{
+	uint8* Data;
+	int32 CountBits;
+	FOutPacketTraits Traits;
+};
+
+/**
+ * Outgoing packets a connection has finished building but not handed to the socket yet.
+ *
+ * Packets are copied into one contiguous buffer, so queuing doesn't allocate once the buffer has grown to a tick's worth
+ * of traffic, and flushing hands all of them to the connection at once so it can write them with a single batched send.
+ */
+class ENGINE_API FNetPacketSendQueue
+{
+public:
+	/** Copies the packet to the end of the queue */
+	void Enqueue(const uint8* Data, int32 CountBits, const FOutPacketTraits& Traits);
+
+	/**
+	 * Hands every queued packet to SendBatch in the order they were queued, then empties the queue keeping its storage.
+	 * Packets queued from within SendBatch stay queued until the next flush.
+	 */
+	void Flush(TFunctionRef<void(TArrayView<FQueuedOutPacket>)> SendBatch);
+
+	/** Drops the queued packets without sending them */
+	void Reset();
+
+	bool IsEmpty() const
+	{
+		return Entries.Num() == 0;
+	}
+
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	/** Whether the queue is handing packets to a Flush callback */
+	bool IsFlushing() const
+	{
+		return bIsFlushing;
+	}
+
+	void CountBytes(FArchive& Ar) const;
+
+private:
+	struct FEntry
+	{
+		int32 Offset;
+		int32 CountBits;
+		FOutPacketTraits Traits;
+	};
+
+	/** Storage can move while packets are queued, so entries hold offsets and the packet pointers are made at flush time */
+	TArray<uint8> Storage;
+	TArray<FEntry> Entries;
+
+	/** The packets being flushed, swapped with Storage each flush so neither array gives up its allocation */
+	TArray<FQueuedOutPacket> FlushPackets;
+	TArray<uint8> FlushStorage;
+
+	bool bIsFlushing = false;
+};
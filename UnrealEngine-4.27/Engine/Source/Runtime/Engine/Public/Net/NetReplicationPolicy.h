@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class FArchive;
+class UNetConnection;
+class UNetDriver;
+class FNetworkRelevancyGrid;
+enum class ENetRelevancyGridList : uint8;
+struct FNetworkObjectInfo;
+struct FNetViewer;
+
+/**
+ * Server replication policy used by UNetDriver::ServerReplicateActors with net.ReplicationPolicy, a lightweight take on what
+ * the ReplicationGraph plugin does, without replacing how actors are replicated.
+ *
+ * Instead of checking every active actor each frame, the driver considers the actors of the FNetworkUpdateSchedule bucket slots
+ * due this frame, plus actors that asked for an early update, and only sorts those by priority. Each connection keeps the list of
+ * actors in the relevancy grid cells around its viewers and in the grid's side lists. The list is updated from the objects the grid
+ * saw enter or leave a cell, and only gathered again when a viewer moves to another cell.
+ *
+ * Subclass and override UNetDriver::CreateReplicationPolicy to change how often actors are considered.
+ */
+class ENGINE_API FNetReplicationPolicy
+{
+public:
+	explicit FNetReplicationPolicy(UNetDriver* InNetDriver);
+	virtual ~FNetReplicationPolicy();
+
+	FNetReplicationPolicy(const FNetReplicationPolicy&) = delete;
+	FNetReplicationPolicy& operator=(const FNetReplicationPolicy&) = delete;
+
+	/** Starts a new replication frame, and gathers the actors to consider on it, shortest update intervals first */
+	void GatherDueActors(TArray<FNetworkObjectInfo*>& OutActors);
+
+	/** Moves a considered actor to the bucket for its current update interval */
+	void RescheduleActor(FNetworkObjectInfo& ActorInfo, const float ServerTickTime);
+
+	/** Has the actor considered on the next frame whatever its bucket, for ForceNetUpdate and actors a connection couldn't replicate */
+	void RequestUpdate(FNetworkObjectInfo& ActorInfo);
+
+	/**
+	 * Returns the actors in the relevancy grid cells within range of the connection's viewers, and in the grid's side lists.
+	 * The set is kept between frames and only gathered again when one of the viewers moves to another cell or the grid layout changes.
+	 */
+	const TSet<const FNetworkObjectInfo*>& GetNearbyActors(UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const FNetworkRelevancyGrid& RelevancyGrid);
+
+	/** Updates the nearby actors of every connection with the objects that entered or left a grid cell or side list, and clears the grid's changes */
+	void ApplyRelevancyGridChanges(FNetworkRelevancyGrid& RelevancyGrid);
+
+	/** Forgets the state kept for a connection that is going away */
+	void RemoveConnection(UNetConnection* Connection);
+
+	uint32 GetFrame() const { return Frame; }
+
+	void CountBytes(FArchive& Ar) const;
+
+protected:
+	/** Returns how many replication frames apart the actor wants to be considered */
+	virtual int32 GetUpdateIntervalFrames(const FNetworkObjectInfo& ActorInfo, const float ServerTickTime) const;
+
+	UNetDriver* NetDriver;
+
+private:
+	struct FConnectionState
+	{
+		/** Cell of each viewer when NearbyCells was built */
+		TArray<FIntPoint, TInlineAllocator<2>> ViewerCells;
+
+		/** Layout of the grid when NearbyCells was built */
+		float CellSize = 0.0f;
+		float QueryRadius = 0.0f;
+
+		TSet<FIntPoint> NearbyCells;
+
+		/** Objects in NearbyCells or in a side list of the grid, only used as keys */
+		TSet<const FNetworkObjectInfo*> NearbyActors;
+
+		/** False until NearbyActors is gathered from the grid, and again when the grid is reset or NearbyCells changes */
+		bool bNearbyActorsValid = false;
+
+		/** Returns true if an object in this list and cell of the grid belongs in NearbyActors */
+		bool IsNearby(const ENetRelevancyGridList List, const FIntPoint& Cell) const;
+	};
+
+	TMap<UNetConnection*, FConnectionState> ConnectionStates;
+
+	/** Actors to consider on the next frame regardless of their bucket, an actor can be requested several times a frame */
+	TSet<TWeakObjectPtr<AActor>> RequestedActors;
+
+	uint32 Frame;
+};
@@ -19,6 +19,9 @@ namespace GranularNetworkMemoryTrackingPrivate
 
 		void LogCustomWork(const FString& WorkName, const uint64 Bytes) const;
 
+		/** Reports a value that isn't a size, like an allocation count. It is listed with the scope's fields but not added to its total bytes. */
+		void LogCustomCount(const FString& CountName, const uint64 Count) const;
+
 		const bool IsEnabled() const
 		{
 			return ScopeStack != nullptr;
@@ -49,11 +52,13 @@ namespace GranularNetworkMemoryTrackingPrivate
 		GranularNetworkMemoryScope.EndWork(Id); \
 	}
 #define GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_WORK(Id, Value) GranularNetworkMemoryScope.LogCustomWork(Id, Value);
+#define GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT(Id, Value) GranularNetworkMemoryScope.LogCustomCount(Id, Value);
 
 #else
 
 #define GRANULAR_NETWORK_MEMORY_TRACKING_INIT(Archive, ScopeName) 
 #define GRANULAR_NETWORK_MEMORY_TRACKING_TRACK(Id, Work) { Work; }
 #define GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_WORK(Id, Work) 
+#define GRANULAR_NETWORK_MEMORY_TRACKING_CUSTOM_COUNT(Id, Value) 
 
 #endif
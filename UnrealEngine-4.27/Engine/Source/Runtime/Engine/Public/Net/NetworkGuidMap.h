@@ -0,0 +1,341 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/NetworkGuid.h"
+
+/**
+ * Map from FNetworkGUID to ValueType, with the subset of the TMap interface the guid cache uses.
+ *
+ * Lookups go through an open addressing table of { guid value, element index } slots with linear probing, so a
+ * probe compares guids within a cache line instead of chasing hash chains through the elements like TMap does.
+ * Elements live in a TSparseArray, which keeps them where they are when other entries are removed, same as TMap.
+ * As with TMap, adding entries can move elements, so don't hold value pointers across an Add.
+ */
+template<typename ValueType>
+class TNetworkGUIDMap
+{
+public:
+	typedef TPair<FNetworkGUID, ValueType> ElementType;
+
+private:
+	typedef TSparseArray<ElementType> ElementArrayType;
+
+	struct FSlot
+	{
+		uint32 Key;
+		int32 ElementIndex;
+	};
+
+	template<bool bConst>
+	class TBaseIterator
+	{
+		typedef typename TChooseClass<bConst, const TNetworkGUIDMap, TNetworkGUIDMap>::Result MapType;
+		typedef typename TChooseClass<bConst, typename ElementArrayType::TConstIterator, typename ElementArrayType::TIterator>::Result ElementItType;
+		typedef typename TChooseClass<bConst, const FNetworkGUID, FNetworkGUID>::Result ItKeyType;
+		typedef typename TChooseClass<bConst, const ValueType, ValueType>::Result ItValueType;
+
+	public:
+		explicit TBaseIterator(MapType& InMap)
+			: Map(InMap)
+			, ElementIt(InMap.Elements)
+		{
+		}
+
+		TBaseIterator& operator++()
+		{
+			++ElementIt;
+			return *this;
+		}
+
+		explicit operator bool() const
+		{
+			return !!ElementIt;
+		}
+
+		bool operator!() const
+		{
+			return !(bool)*this;
+		}
+
+		ItKeyType& Key() const
+		{
+			return ElementIt->Key;
+		}
+
+		ItValueType& Value() const
+		{
+			return ElementIt->Value;
+		}
+
+	protected:
+		MapType& Map;
+		ElementItType ElementIt;
+	};
+
+public:
+	class TIterator : public TBaseIterator<false>
+	{
+	public:
+		explicit TIterator(TNetworkGUIDMap& InMap)
+			: TBaseIterator<false>(InMap)
+		{
+		}
+
+		/** Removes the current element, the iterator moves on to the next element when incremented as usual */
+		void RemoveCurrent()
+		{
+			this->Map.RemoveSlot(this->ElementIt->Key.Value);
+			this->ElementIt.RemoveCurrent();
+		}
+	};
+
+	class TConstIterator : public TBaseIterator<true>
+	{
+	public:
+		explicit TConstIterator(const TNetworkGUIDMap& InMap)
+			: TBaseIterator<true>(InMap)
+		{
+		}
+	};
+
+	int32 Num() const
+	{
+		return Elements.Num();
+	}
+
+	ValueType* Find(const FNetworkGUID& Key)
+	{
+		const int32 ElementIndex = FindElementIndex(Key.Value);
+		return ElementIndex != INDEX_NONE ? &Elements[ElementIndex].Value : nullptr;
+	}
+
+	const ValueType* Find(const FNetworkGUID& Key) const
+	{
+		return const_cast<TNetworkGUIDMap*>(this)->Find(Key);
+	}
+
+	ValueType FindRef(const FNetworkGUID& Key) const
+	{
+		const ValueType* Value = Find(Key);
+		return Value ? *Value : ValueType();
+	}
+
+	bool Contains(const FNetworkGUID& Key) const
+	{
+		return FindElementIndex(Key.Value) != INDEX_NONE;
+	}
+
+	ValueType& FindChecked(const FNetworkGUID& Key)
+	{
+		ValueType* Value = Find(Key);
+		check(Value);
+		return *Value;
+	}
+
+	ValueType& operator[](const FNetworkGUID& Key)
+	{
+		return FindChecked(Key);
+	}
+
+	const ValueType& operator[](const FNetworkGUID& Key) const
+	{
+		return const_cast<TNetworkGUIDMap*>(this)->FindChecked(Key);
+	}
+
+	/** Adds or replaces the value for Key */
+	ValueType& Add(const FNetworkGUID& Key, const ValueType& Value)
+	{
+		ValueType& Existing = FindOrAdd(Key);
+		Existing = Value;
+		return Existing;
+	}
+
+	ValueType& FindOrAdd(const FNetworkGUID& Key)
+	{
+		if (ValueType* Existing = Find(Key))
+		{
+			return *Existing;
+		}
+
+		ReserveSlots(Elements.Num() + 1);
+
+		const int32 ElementIndex = Elements.Emplace(Key, ValueType());
+		InsertSlot(Key.Value, ElementIndex);
+		return Elements[ElementIndex].Value;
+	}
+
+	/** @return the number of elements removed, 0 or 1 */
+	int32 Remove(const FNetworkGUID& Key)
+	{
+		const int32 ElementIndex = RemoveSlot(Key.Value);
+		if (ElementIndex == INDEX_NONE)
+		{
+			return 0;
+		}
+
+		Elements.RemoveAt(ElementIndex);
+		return 1;
+	}
+
+	void Reserve(int32 Number)
+	{
+		Elements.Reserve(Number);
+		ReserveSlots(Number);
+	}
+
+	/** Removes all elements, keeping the allocations */
+	void Reset()
+	{
+		Elements.Reset();
+		for (FSlot& Slot : Slots)
+		{
+			Slot.ElementIndex = INDEX_NONE;
+		}
+	}
+
+	void Empty()
+	{
+		Elements.Empty();
+		Slots.Empty();
+	}
+
+	void CountBytes(FArchive& Ar) const
+	{
+		Elements.CountBytes(Ar);
+		Slots.CountBytes(Ar);
+	}
+
+	TIterator CreateIterator()
+	{
+		return TIterator(*this);
+	}
+
+	TConstIterator CreateConstIterator() const
+	{
+		return TConstIterator(*this);
+	}
+
+	/** Ranged for support, iterates the element pairs like TMap */
+	FORCEINLINE auto begin() { return Elements.begin(); }
+	FORCEINLINE auto begin() const { return Elements.begin(); }
+	FORCEINLINE auto end() { return Elements.end(); }
+	FORCEINLINE auto end() const { return Elements.end(); }
+
+private:
+	static constexpr int32 MinSlots = 64;
+
+	FORCEINLINE uint32 GetSlotMask() const
+	{
+		return (uint32)Slots.Num() - 1;
+	}
+
+	FORCEINLINE static uint32 HashKey(uint32 Key)
+	{
+		// Fibonacci hashing, static and dynamic guids are sequential with a shared low bit
+		return Key * 0x9E3779B9u;
+	}
+
+	int32 FindElementIndex(uint32 Key) const
+	{
+		if (Slots.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const uint32 Mask = GetSlotMask();
+		for (uint32 SlotIndex = (HashKey(Key) >> HashShift) & Mask; ; SlotIndex = (SlotIndex + 1) & Mask)
+		{
+			const FSlot& Slot = Slots[SlotIndex];
+			if (Slot.ElementIndex == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			if (Slot.Key == Key)
+			{
+				return Slot.ElementIndex;
+			}
+		}
+	}
+
+	void InsertSlot(uint32 Key, int32 ElementIndex)
+	{
+		const uint32 Mask = GetSlotMask();
+		uint32 SlotIndex = (HashKey(Key) >> HashShift) & Mask;
+		while (Slots[SlotIndex].ElementIndex != INDEX_NONE)
+		{
+			SlotIndex = (SlotIndex + 1) & Mask;
+		}
+
+		Slots[SlotIndex].Key = Key;
+		Slots[SlotIndex].ElementIndex = ElementIndex;
+	}
+
+	/** Removes Key from the slot table with backward shift deletion, returns the element index it referred to */
+	int32 RemoveSlot(uint32 Key)
+	{
+		if (Slots.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const uint32 Mask = GetSlotMask();
+		uint32 SlotIndex = (HashKey(Key) >> HashShift) & Mask;
+		while (Slots[SlotIndex].ElementIndex != INDEX_NONE && Slots[SlotIndex].Key != Key)
+		{
+			SlotIndex = (SlotIndex + 1) & Mask;
+		}
+
+		const int32 ElementIndex = Slots[SlotIndex].ElementIndex;
+		if (ElementIndex == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		// Pull later entries of the probe run back into the hole, so lookups never need tombstones
+		uint32 HoleIndex = SlotIndex;
+		for (uint32 NextIndex = (HoleIndex + 1) & Mask; Slots[NextIndex].ElementIndex != INDEX_NONE; NextIndex = (NextIndex + 1) & Mask)
+		{
+			const uint32 IdealIndex = (HashKey(Slots[NextIndex].Key) >> HashShift) & Mask;
+			const bool bCanMove = (HoleIndex <= NextIndex) ? (IdealIndex <= HoleIndex || IdealIndex > NextIndex) : (IdealIndex <= HoleIndex && IdealIndex > NextIndex);
+			if (bCanMove)
+			{
+				Slots[HoleIndex] = Slots[NextIndex];
+				HoleIndex = NextIndex;
+			}
+		}
+
+		Slots[HoleIndex].ElementIndex = INDEX_NONE;
+		return ElementIndex;
+	}
+
+	/** Keeps the table at most half full, so probe runs stay short */
+	void ReserveSlots(int32 NumElements)
+	{
+		const int32 NeededSlots = FMath::Max(MinSlots, (int32)FMath::RoundUpToPowerOfTwo(NumElements * 2));
+		if (NeededSlots <= Slots.Num())
+		{
+			return;
+		}
+
+		Slots.Reset(NeededSlots);
+		Slots.SetNumUninitialized(NeededSlots);
+		for (FSlot& Slot : Slots)
+		{
+			Slot.ElementIndex = INDEX_NONE;
+		}
+		HashShift = 32 - FMath::FloorLog2(NeededSlots);
+
+		for (auto It = Elements.CreateConstIterator(); It; ++It)
+		{
+			InsertSlot(It->Key.Value, It.GetIndex());
+		}
+	}
+
+	ElementArrayType Elements;
+	TArray<FSlot> Slots;
+
+	/** Use the high bits of the hash, the low bits of a Fibonacci hash are as regular as the guids */
+	uint32 HashShift = 0;
+};
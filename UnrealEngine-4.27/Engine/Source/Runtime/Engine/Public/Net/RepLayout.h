@@ -297,6 +297,7 @@ struct FRepSerializationSharedInfo
 		if (bIsValid)
 		{
 			SharedPropertyInfo.Reset();
+			SharedChangelists.Reset();
 			SerializedProperties->Reset();
 
 			bIsValid = false;
@@ -347,6 +348,36 @@ struct FRepSerializationSharedInfo
 	/** Metadata for properties in the shared data blob. */
 	TArray<FRepSerializedPropertyInfo> SharedPropertyInfo;
 
+	/**
+	 * A complete SendProperties block that only contained shared properties.
+	 * It doesn't depend on the connection, so any connection sending exactly the same changelist can copy it as is.
+	 */
+	struct FSharedChangelist
+	{
+		/** Final (filtered) changelist that was sent */
+		TArray<uint16> Changed;
+
+		/** Bit offset into the shared buffer of the serialized block */
+		int32 BitOffset = 0;
+
+		/** Length in bits of the serialized block, including handles, checksums and the terminator */
+		int32 BitLength = 0;
+
+		bool bDoChecksum = false;
+	};
+
+	/** Maximum number of distinct changelists cached until the next Reset */
+	static constexpr int32 MaxSharedChangelists = 16;
+
+	/** Returns a previously serialized block for this changelist, if one was cached since the last Reset */
+	const FSharedChangelist* FindSharedChangelist(const TArray<uint16>& Changed, const bool bDoChecksum) const;
+
+	/** Copies NumBits bits written to Writer at StartBit into the shared buffer, so other connections can reuse them for the same changelist */
+	void AddSharedChangelist(const TArray<uint16>& Changed, const bool bDoChecksum, const FNetBitWriter& Writer, const int32 StartBit, const int32 NumBits);
+
+	/** Serialized changelists that were built only from shared properties. */
+	TArray<FSharedChangelist> SharedChangelists;
+
 	/** Binary blob of net serialized data to be shared */
 	TUniquePtr<FNetBitWriter> SerializedProperties;
 
@@ -904,6 +935,27 @@ public:
 	ERepLayoutCmdType Type;
 	ERepLayoutCmdFlags Flags;
 };
+
+/**
+ * A run of contiguous, trivially comparable memory covering one or more FRepLayoutCmds.
+ * Offset and ShadowOffset are relative to the same buffers as FRepLayoutCmd::Offset and FRepLayoutCmd::ShadowOffset.
+ */
+struct FRepLayoutPodSpan
+{
+	int32 Offset;
+	int32 ShadowOffset;
+	int32 Size;
+};
+
+/**
+ * Range of FRepLayout POD spans that together cover every command of a Parent Command, or of one Dynamic Array element.
+ * Empty if any of those commands needs to be compared on its own (strings, arrays, object references, custom types).
+ */
+struct FRepLayoutPodSpanRange
+{
+	int32 Start = 0;
+	int32 Num = 0;
+};
 	
 /** Converts a relative handle to the appropriate index into the Cmds array */
 class FHandleToCmdIndex
@@ -1189,6 +1241,7 @@ class FRepLayout : public FGCObject, public TSharedFromThis<FRepLayout>
 private:
 
 	friend struct FRepStateStaticBuffer;
+	friend struct FRepLayoutTestUtil;
 	friend class UPackageMapClient;
 	friend class FNetSerializeCB;
 	friend struct FCustomDeltaPropertyIterator;
@@ -1785,6 +1838,12 @@ private:
 		const int32 CmdEnd,
 		TArray<FHandleToCmdIndex>& HandleToCmdIndex);
 
+	/** Builds PodSpans, ParentPodSpans and ArrayPodSpans once Cmd offsets and shadow offsets are final. */
+	void BuildComparePodSpans();
+
+	/** Merges the commands in [CmdStart, CmdEnd) into POD spans, returns an empty range if any of them isn't trivially comparable. */
+	FRepLayoutPodSpanRange BuildComparePodSpanRange(const int32 CmdStart, const int32 CmdEnd);
+
 	ERepLayoutResult UpdateChangelistMgr(
 		FSendingRepState* RESTRICT RepState,
 		FReplicationChangelistMgr& InChangelistMgr,
@@ -1883,4 +1942,13 @@ private:
 #endif
 
 	TMap<FRepLayoutCmd*, TArray<FRepLayoutCmd>> NetSerializeLayouts;
+
+	/** Contiguous POD memory compared in one go by CompareProperties before falling back to comparing command by command. */
+	TArray<FRepLayoutPodSpan> PodSpans;
+
+	/** PodSpans covering each Parent Command. */
+	TArray<FRepLayoutPodSpanRange> ParentPodSpans;
+
+	/** PodSpans covering one element of each Dynamic Array command, indexed by command. Empty for other commands. */
+	TArray<FRepLayoutPodSpanRange> ArrayPodSpans;
 };
\ No newline at end of file
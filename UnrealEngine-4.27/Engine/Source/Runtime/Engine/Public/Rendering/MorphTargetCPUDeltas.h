@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMorphTarget;
+struct FSkelMeshRenderSection;
+
+/**
+ * Morph target deltas of one LOD laid out for the CPU morph path: per morph, the vertices it moves sorted by index, with their
+ * position and tangent deltas quantized to 16 bits against the largest delta of the morph. Half the size of FMorphTargetDelta.
+ * Deltas point into the list of vertices some morph moves rather than at the LOD's vertices, so what is accumulated per vertex
+ * only needs room for those.
+ */
+class FMorphTargetCPUDeltas
+{
+public:
+
+	// Changes to this struct must be reflected in SkeletalRenderGPUSkin.ispc
+	struct FQuantizedDelta
+	{
+		/** Index of the vertex in GetMorphedVertices() */
+		uint32 MorphedVertexIndex;
+		int16 Position[3];
+		int16 TangentZ[3];
+	};
+
+	struct FMorph
+	{
+		/** Deltas of the morph in GetDeltas() */
+		uint32 StartOffset = 0;
+		uint32 NumDeltas = 0;
+
+		/** Multiply a quantized delta by these to get the delta back */
+		FVector PositionScale = FVector::ZeroVector;
+		float TangentZScale = 0.0f;
+
+		/** Bit per section the morph moves vertices of, every bit for sections past the 64th */
+		uint64 SectionMask = 0;
+	};
+
+	/** Whether the CPU morph path should use quantized deltas on this platform, see r.MorphTarget.QuantizedCPUDeltas */
+	static ENGINE_API bool ShouldBuild();
+
+	/** Quantizes the deltas MorphTargets have for LODIndex, whose sections are Sections */
+	ENGINE_API void Build(const TArray<UMorphTarget*>& MorphTargets, int32 LODIndex, const TArray<FSkelMeshRenderSection>& Sections);
+
+	void Reset()
+	{
+		Morphs.Empty();
+		Deltas.Empty();
+		MorphedVertices.Empty();
+		SectionMorphedVertexRanges.Empty();
+	}
+
+	/** Same as the number of morph targets of the mesh once built */
+	int32 GetNumMorphs() const { return Morphs.Num(); }
+
+	const FMorph& GetMorph(int32 MorphIndex) const { return Morphs[MorphIndex]; }
+
+	const TArray<FQuantizedDelta>& GetDeltas() const { return Deltas; }
+
+	/** Vertex index in the LOD of every vertex at least one morph moves, sorted */
+	const TArray<uint32>& GetMorphedVertices() const { return MorphedVertices; }
+
+	/** First index in GetMorphedVertices() and number of morphed vertices of each section */
+	const TArray<FUintPoint>& GetSectionMorphedVertexRanges() const { return SectionMorphedVertexRanges; }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Morphs.GetAllocatedSize() + Deltas.GetAllocatedSize() + MorphedVertices.GetAllocatedSize() + SectionMorphedVertexRanges.GetAllocatedSize();
+	}
+
+private:
+
+	TArray<FMorph> Morphs;
+
+	TArray<FQuantizedDelta> Deltas;
+
+	TArray<uint32> MorphedVertices;
+
+	TArray<FUintPoint> SectionMorphedVertexRanges;
+};
@@ -10,6 +10,7 @@
 #include "Rendering/SkeletalMeshDuplicatedVerticesBuffer.h"
 #include "Rendering/SkeletalMeshVertexClothBuffer.h"
 #include "Rendering/MorphTargetVertexInfoBuffers.h"
+#include "Rendering/MorphTargetCPUDeltas.h"
 #include "SkeletalMeshTypes.h"
 #include "BoneIndices.h"
 #include "StaticMeshResources.h"
@@ -125,6 +126,9 @@ public:
 	/** GPU friendly access data for MorphTargets for an LOD */
 	FMorphTargetVertexInfoBuffers	MorphTargetVertexInfoBuffers;
 
+	/** Quantized deltas the CPU morph target path accumulates, empty when it uses the source deltas */
+	FMorphTargetCPUDeltas			MorphTargetCPUDeltas;
+
 	/** Skin weight profile data structures, can contain multiple profiles and their runtime FSkinWeightVertexBuffer */
 	FSkinWeightProfilesData SkinWeightProfilesData;
 
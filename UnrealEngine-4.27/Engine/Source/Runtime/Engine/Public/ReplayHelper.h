@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/EngineBaseTypes.h"
 #include "Engine/PackageMapClient.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "NetworkReplayStreaming.h"
 #include "ReplayTypes.h"
 
@@ -144,6 +145,9 @@ private:
 
 	bool SerializeGuidCache(UNetConnection* Connection, const FRepActorsCheckpointParams& Params, FArchive* CheckpointArchive);
 
+	/** Appends the guid cache serialized by the worker task started in CacheNetGuids. Returns false if we need to wait for it another frame. */
+	bool SerializeGuidCacheAsync(const FRepActorsCheckpointParams& Params, FArchive* CheckpointArchive);
+
 	/**
 	* Replicates the given prioritized actors, so their packets can be captured for recording.
 	* This should be used for normal frame recording.
@@ -249,6 +253,41 @@ private:
 		FNetGuidCacheObject NetGuidCacheObject;
 	};
 
+	/** Guid cache entry copied out on the game thread, holds no object references so it can be serialized on any thread */
+	struct FNetGuidCacheSnapshotItem
+	{
+		FNetworkGUID NetGuid;
+		FNetworkGUID OuterGUID;
+		FName PathName;
+		uint8 Flags;
+	};
+
+	/** Snapshot of the guid cache for a checkpoint, serialized into Buffer by a worker task when demo.AsyncCheckpointGuidCache is enabled */
+	struct FAsyncGuidCacheSerialize
+	{
+		TArray<FNetGuidCacheSnapshotItem> Items;
+
+		// Remapped path names for names not yet in the checkpoint name table. UEngine::NetworkRemapPath is a virtual engine hook that reads
+		// the world's levels and streaming levels, so it runs on the game thread, once per path name the recording hasn't exported yet.
+		TMap<FName, FString> ExportedPathNames;
+
+		// Owned by the task while it's in flight, handed back to the checkpoint context when we're done
+		TMap<FName, uint32> NameTableMap;
+
+		TArray<uint8> Buffer;
+		int32 NumNetGuids = 0;
+
+		void Serialize();
+
+		void CountBytes(FArchive& Ar) const
+		{
+			Items.CountBytes(Ar);
+			ExportedPathNames.CountBytes(Ar);
+			NameTableMap.CountBytes(Ar);
+			Buffer.CountBytes(Ar);
+		}
+	};
+
 	/** Checkpoint state */
 	struct FCheckpointSaveStateContext
 	{
@@ -286,6 +325,9 @@ private:
 
 		TMap<FName, uint32> NameTableMap;
 
+		TSharedPtr<FAsyncGuidCacheSerialize, ESPMode::ThreadSafe> AsyncGuidCache;
+		FGraphEventRef AsyncGuidCacheEvent;
+
 		void CountBytes(FArchive& Ar) const
 		{
 			CheckpointAckState.CountBytes(Ar);
@@ -293,6 +335,12 @@ private:
 			DeltaCheckpointData.CountBytes(Ar);
 			NetGuidCacheSnapshot.CountBytes(Ar);
 			NameTableMap.CountBytes(Ar);
+
+			// Still being written by the serialize task otherwise, skipped rather than waited on
+			if (AsyncGuidCache.IsValid() && (!AsyncGuidCacheEvent.IsValid() || AsyncGuidCacheEvent->IsComplete()))
+			{
+				AsyncGuidCache->CountBytes(Ar);
+			}
 		}
 	};
 
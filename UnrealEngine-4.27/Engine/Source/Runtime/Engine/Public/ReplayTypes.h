@@ -10,6 +10,7 @@
 #include "Net/Common/Packets/PacketTraits.h"
 #include "IPAddress.h"
 #include "Serialization/BitReader.h"
+#include "Templates/Function.h"
 #include "ReplayTypes.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogDemo, Log, All);
@@ -258,6 +259,53 @@ struct FDeltaCheckpointData
 	}
 };
 
+/**
+ * Actor channel opens and closes found by decoding the bunch headers of a run of replay packets.
+ * Used while fast forwarding to skip actors that are spawned and destroyed before the target time.
+ */
+class ENGINE_API FReplayChannelLifetimeIndex
+{
+public:
+	/** Whether packets recorded with this engine network version use a bunch header layout we can decode */
+	static bool SupportsEngineNetVersion(uint32 EngineNetVer);
+
+	/**
+	 * Decodes the bunch headers of Packets, which must be in playback order. Packets are decoded independently,
+	 * on worker threads if bParallel is set, and the results are merged in order afterwards.
+	 *
+	 * @return false if a packet couldn't be decoded, the index is left empty in that case.
+	 */
+	bool Build(TArrayView<const FPlaybackPacket> Packets, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, bool bParallel);
+
+	/**
+	 * Same as above, but actors IsKnownActor returns true for are never reported as destroyed. Their channel reopening within
+	 * the packets means they already exist, a dormant actor waking up for instance, so their close has to be processed.
+	 */
+	bool Build(TArrayView<const FPlaybackPacket> Packets, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, bool bParallel, TFunctionRef<bool(const FNetworkGUID&)> IsKnownActor);
+
+	void Reset();
+
+	/** Dynamic actors whose channel was opened and then closed because the actor was destroyed, within the indexed packets */
+	const TSet<FNetworkGUID>& GetDestroyedActors() const { return DestroyedActors; }
+
+	int32 GetNumBunches() const { return NumBunches; }
+
+private:
+	struct FChannelEvent
+	{
+		FNetworkGUID ActorGUID;
+		uint32 ChIndex = 0;
+		bool bOpen = false;
+		bool bClose = false;
+		EChannelCloseReason CloseReason = EChannelCloseReason::Destroyed;
+	};
+
+	static bool DecodePacket(const FPlaybackPacket& Packet, uint32 EngineNetVer, uint32 GameNetVer, int32 MaxPacketSize, TArray<FChannelEvent>& OutEvents, int32& OutNumBunches);
+
+	TSet<FNetworkGUID> DestroyedActors;
+	int32 NumBunches = 0;
+};
+
 class FRepActorsCheckpointParams
 {
 public:
@@ -226,6 +226,45 @@ struct FOverlapDatum : FBaseTraceDatum
 	}
 };
 
+/**
+ * One request of a batched trace, see UWorld::BatchTraceByChannel
+ *
+ * Requests with the same Start, End, TraceChannel and TraceType within one batch are only traced once, batches don't share results
+ */
+struct FBatchTraceRequest
+{
+	FVector Start;
+	FVector End;
+	ECollisionChannel TraceChannel;
+
+	/** Test only fills in bBlockingHit, Single returns the full blocking hit, Multi also returns every touching hit through OutMultiHits */
+	EAsyncTraceType TraceType;
+
+	FBatchTraceRequest()
+		: Start(ForceInit)
+		, End(ForceInit)
+		, TraceChannel(ECC_Visibility)
+		, TraceType(EAsyncTraceType::Single)
+	{}
+
+	FBatchTraceRequest(const FVector& InStart, const FVector& InEnd, ECollisionChannel InTraceChannel, EAsyncTraceType InTraceType = EAsyncTraceType::Single)
+		: Start(InStart)
+		, End(InEnd)
+		, TraceChannel(InTraceChannel)
+		, TraceType(InTraceType)
+	{}
+
+	bool operator==(const FBatchTraceRequest& Other) const
+	{
+		return Start == Other.Start && End == Other.End && TraceChannel == Other.TraceChannel && TraceType == Other.TraceType;
+	}
+
+	friend inline uint32 GetTypeHash(const FBatchTraceRequest& Request)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Request.Start), GetTypeHash(Request.End)), ((uint32)Request.TraceChannel << 8) | (uint32)Request.TraceType);
+	}
+};
+
 #define ASYNC_TRACE_BUFFER_SIZE 64
 
 /**